@@ -6,18 +6,6 @@ endif()
 
 set(FETCHCONTENT_UPDATES_DISCONNECTED ON)
 
-# --- MinHook ---------------------------------------------------------------
-
-FetchContent_Declare(
-    minhook
-    GIT_REPOSITORY https://github.com/TsudaKageyu/minhook.git
-    GIT_TAG master
-)
-
-FetchContent_MakeAvailable(minhook)
-
-add_library(minhook::minhook ALIAS minhook)
-
 # --- spdlog ----------------------------------------------------------------
 
 set(SPDLOG_BUILD_SHARED OFF CACHE BOOL "" FORCE)
@@ -35,17 +23,18 @@ FetchContent_Declare(
 
 FetchContent_MakeAvailable(spdlog)
 
-# --- cpp-httplib ----------------------------------------------------------
+# --- nlohmann/json --------------------------------------------------------
+
+set(JSON_BuildTests OFF CACHE INTERNAL "" FORCE)
+set(JSON_Install OFF CACHE INTERNAL "" FORCE)
 
 FetchContent_Declare(
-    cpp_httplib
-    GIT_REPOSITORY https://github.com/yhirose/cpp-httplib.git
-    GIT_TAG v0.18.3
+    nlohmann_json
+    GIT_REPOSITORY https://github.com/nlohmann/json.git
+    GIT_TAG v3.11.3
 )
 
-FetchContent_MakeAvailable(cpp_httplib)
-
-add_library(cpp-httplib::cpp-httplib ALIAS httplib)
+FetchContent_MakeAvailable(nlohmann_json)
 
 # --- asio (standalone) -----------------------------------------------------
 
@@ -63,18 +52,50 @@ if(NOT asio_POPULATED)
     target_compile_definitions(asio INTERFACE ASIO_STANDALONE)
 endif()
 
-# --- nlohmann/json --------------------------------------------------------
+# --- zlib ----------------------------------------------------------------
 
-set(JSON_BuildTests OFF CACHE INTERNAL "" FORCE)
-set(JSON_Install OFF CACHE INTERNAL "" FORCE)
+set(ZLIB_BUILD_EXAMPLES OFF CACHE BOOL "" FORCE)
 
 FetchContent_Declare(
-    nlohmann_json
-    GIT_REPOSITORY https://github.com/nlohmann/json.git
-    GIT_TAG v3.11.3
+    zlib
+    GIT_REPOSITORY https://github.com/madler/zlib.git
+    GIT_TAG v1.3.1
 )
 
-FetchContent_MakeAvailable(nlohmann_json)
+FetchContent_MakeAvailable(zlib)
+
+# zlib sets its include directories on the directory rather than the target; zconf.h is generated.
+target_include_directories(zlibstatic INTERFACE ${zlib_SOURCE_DIR} ${zlib_BINARY_DIR})
+add_library(zlib::zlib ALIAS zlibstatic)
+
+# Everything below is only needed by the helper and the overlay DLL.
+if(EF_OVERLAY_IPC_ONLY)
+    return()
+endif()
+
+# --- MinHook ---------------------------------------------------------------
+
+FetchContent_Declare(
+    minhook
+    GIT_REPOSITORY https://github.com/TsudaKageyu/minhook.git
+    GIT_TAG master
+)
+
+FetchContent_MakeAvailable(minhook)
+
+add_library(minhook::minhook ALIAS minhook)
+
+# --- cpp-httplib ----------------------------------------------------------
+
+FetchContent_Declare(
+    cpp_httplib
+    GIT_REPOSITORY https://github.com/yhirose/cpp-httplib.git
+    GIT_TAG v0.18.3
+)
+
+FetchContent_MakeAvailable(cpp_httplib)
+
+add_library(cpp-httplib::cpp-httplib ALIAS httplib)
 
 # --- ImGui -----------------------------------------------------------------
 
@@ -0,0 +1,348 @@
+#include "file_change_notifier.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace helper::logs
+{
+    namespace
+    {
+#if defined(_WIN32)
+        class DirectoryChangesNotifier final : public FileChangeNotifier
+        {
+        public:
+            DirectoryChangesNotifier()
+                : wakeEvent_(::CreateEventW(nullptr, FALSE, FALSE, nullptr))
+            {
+            }
+
+            ~DirectoryChangesNotifier() override
+            {
+                watches_.clear();
+                if (wakeEvent_)
+                {
+                    ::CloseHandle(wakeEvent_);
+                }
+            }
+
+            bool valid() const
+            {
+                return wakeEvent_ != nullptr;
+            }
+
+            bool watch(const std::vector<std::filesystem::path>& directories) override
+            {
+                watches_.clear();
+                for (const auto& directory : directories)
+                {
+                    auto entry = std::make_unique<Watch>();
+                    entry->directory = directory;
+                    entry->handle = ::CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+                    if (entry->handle == INVALID_HANDLE_VALUE)
+                    {
+                        spdlog::warn("Unable to watch log directory {} (error {})", directory.string(), ::GetLastError());
+                        continue;
+                    }
+
+                    entry->overlapped.hEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                    if (!entry->overlapped.hEvent || !arm(*entry))
+                    {
+                        continue;
+                    }
+                    watches_.push_back(std::move(entry));
+                }
+                return !watches_.empty();
+            }
+
+            bool wait(std::chrono::milliseconds timeout, std::vector<FileChange>& changes) override
+            {
+                std::vector<HANDLE> handles;
+                handles.reserve(watches_.size() + 1);
+                for (const auto& entry : watches_)
+                {
+                    handles.push_back(entry->overlapped.hEvent);
+                }
+                handles.push_back(wakeEvent_);
+
+                const auto result = ::WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, static_cast<DWORD>(timeout.count()));
+                if (result == WAIT_TIMEOUT || result == WAIT_FAILED)
+                {
+                    return false;
+                }
+
+                // Collect every directory that completed, not just the first one signalled.
+                const auto before = changes.size();
+                for (auto& entry : watches_)
+                {
+                    DWORD bytes = 0;
+                    if (!::GetOverlappedResult(entry->handle, &entry->overlapped, &bytes, FALSE))
+                    {
+                        const auto error = ::GetLastError();
+                        if (error == ERROR_IO_INCOMPLETE)
+                        {
+                            continue;
+                        }
+                        // The read is over, but its event stays signalled until reset; arm() resets it and
+                        // issues a new read. A watch that cannot be re-armed is dropped below.
+                        spdlog::warn("Watching log directory {} failed (error {})", entry->directory.string(), error);
+                        entry->armed = false;
+                        changes.push_back(FileChange{entry->directory, {}, true});
+                        arm(*entry);
+                        continue;
+                    }
+
+                    if (bytes == 0)
+                    {
+                        // The buffer overflowed and the individual changes were lost.
+                        changes.push_back(FileChange{entry->directory, {}, true});
+                    }
+                    else
+                    {
+                        collect(*entry, changes);
+                    }
+                    arm(*entry);
+                }
+                std::erase_if(watches_, [](const std::unique_ptr<Watch>& entry) {
+                    return !entry->armed;
+                });
+                return changes.size() > before;
+            }
+
+            bool watching() const override
+            {
+                return !watches_.empty();
+            }
+
+            void wake() override
+            {
+                ::SetEvent(wakeEvent_);
+            }
+
+        private:
+            struct Watch
+            {
+                std::filesystem::path directory;
+                HANDLE handle{INVALID_HANDLE_VALUE};
+                OVERLAPPED overlapped{};
+                bool armed{false};
+                std::array<DWORD, 8 * 1024> buffer{};   // FILE_NOTIFY_INFORMATION records must be DWORD aligned
+
+                ~Watch()
+                {
+                    if (handle != INVALID_HANDLE_VALUE)
+                    {
+                        // The kernel writes into buffer until the read is cancelled and completed.
+                        if (armed)
+                        {
+                            DWORD bytes = 0;
+                            ::CancelIoEx(handle, &overlapped);
+                            ::GetOverlappedResult(handle, &overlapped, &bytes, TRUE);
+                        }
+                        ::CloseHandle(handle);
+                    }
+                    if (overlapped.hEvent)
+                    {
+                        ::CloseHandle(overlapped.hEvent);
+                    }
+                }
+            };
+
+            static bool arm(Watch& entry)
+            {
+                ::ResetEvent(entry.overlapped.hEvent);
+                entry.armed = ::ReadDirectoryChangesW(entry.handle, entry.buffer.data(), static_cast<DWORD>(sizeof(entry.buffer)), FALSE,
+                    FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE, nullptr, &entry.overlapped, nullptr) != FALSE;
+                if (!entry.armed)
+                {
+                    spdlog::warn("ReadDirectoryChangesW failed for {} (error {})", entry.directory.string(), ::GetLastError());
+                }
+                return entry.armed;
+            }
+
+            static void collect(const Watch& entry, std::vector<FileChange>& changes)
+            {
+                const auto* cursor = reinterpret_cast<const std::byte*>(entry.buffer.data());
+                while (true)
+                {
+                    const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+                    FileChange change;
+                    change.directory = entry.directory;
+                    change.fileName = std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                    change.renamed = info->Action != FILE_ACTION_MODIFIED;
+                    changes.push_back(std::move(change));
+
+                    if (info->NextEntryOffset == 0)
+                    {
+                        break;
+                    }
+                    cursor += info->NextEntryOffset;
+                }
+            }
+
+            HANDLE wakeEvent_{nullptr};
+            std::vector<std::unique_ptr<Watch>> watches_;
+        };
+#elif defined(__linux__)
+        class InotifyNotifier final : public FileChangeNotifier
+        {
+        public:
+            InotifyNotifier()
+                : inotify_(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+                , wake_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+            {
+            }
+
+            ~InotifyNotifier() override
+            {
+                if (inotify_ >= 0)
+                {
+                    ::close(inotify_);
+                }
+                if (wake_ >= 0)
+                {
+                    ::close(wake_);
+                }
+            }
+
+            bool valid() const
+            {
+                return inotify_ >= 0 && wake_ >= 0;
+            }
+
+            bool watch(const std::vector<std::filesystem::path>& directories) override
+            {
+                for (const auto& [descriptor, directory] : watches_)
+                {
+                    ::inotify_rm_watch(inotify_, descriptor);
+                }
+                watches_.clear();
+
+                for (const auto& directory : directories)
+                {
+                    const int descriptor = ::inotify_add_watch(inotify_, directory.c_str(), IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO);
+                    if (descriptor < 0)
+                    {
+                        spdlog::warn("Unable to watch log directory {} (errno {})", directory.string(), errno);
+                        continue;
+                    }
+                    watches_[descriptor] = directory;
+                }
+                return !watches_.empty();
+            }
+
+            bool wait(std::chrono::milliseconds timeout, std::vector<FileChange>& changes) override
+            {
+                std::array<pollfd, 2> descriptors{{{inotify_, POLLIN, 0}, {wake_, POLLIN, 0}}};
+                if (::poll(descriptors.data(), descriptors.size(), static_cast<int>(timeout.count())) <= 0)
+                {
+                    return false;
+                }
+
+                if ((descriptors[1].revents & POLLIN) != 0)
+                {
+                    std::uint64_t count = 0;
+                    [[maybe_unused]] const auto drained = ::read(wake_, &count, sizeof(count));
+                }
+
+                const auto before = changes.size();
+                alignas(inotify_event) std::array<char, 16 * 1024> buffer{};
+                while (true)
+                {
+                    const auto length = ::read(inotify_, buffer.data(), buffer.size());
+                    if (length <= 0)
+                    {
+                        break;
+                    }
+
+                    for (std::size_t position = 0; position < static_cast<std::size_t>(length);)
+                    {
+                        const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + position);
+                        position += sizeof(inotify_event) + event->len;
+
+                        if ((event->mask & IN_Q_OVERFLOW) != 0)
+                        {
+                            for (const auto& [descriptor, directory] : watches_)
+                            {
+                                changes.push_back(FileChange{directory, {}, true});
+                            }
+                            continue;
+                        }
+
+                        const auto found = watches_.find(event->wd);
+                        if (found == watches_.end())
+                        {
+                            continue;
+                        }
+                        if ((event->mask & IN_IGNORED) != 0)
+                        {
+                            // The directory was deleted or unmounted and the kernel removed the watch.
+                            changes.push_back(FileChange{found->second, {}, true});
+                            watches_.erase(found);
+                            continue;
+                        }
+
+                        FileChange change;
+                        change.directory = found->second;
+                        if (event->len > 0)
+                        {
+                            change.fileName = std::string(event->name);
+                        }
+                        change.renamed = (event->mask & IN_MODIFY) == 0;
+                        changes.push_back(std::move(change));
+                    }
+                }
+                return changes.size() > before;
+            }
+
+            bool watching() const override
+            {
+                return !watches_.empty();
+            }
+
+            void wake() override
+            {
+                const std::uint64_t one = 1;
+                [[maybe_unused]] const auto written = ::write(wake_, &one, sizeof(one));
+            }
+
+        private:
+            int inotify_{-1};
+            int wake_{-1};
+            std::map<int, std::filesystem::path> watches_;
+        };
+#endif
+    }
+
+    std::unique_ptr<FileChangeNotifier> make_file_change_notifier()
+    {
+#if defined(_WIN32)
+        auto notifier = std::make_unique<DirectoryChangesNotifier>();
+#elif defined(__linux__)
+        auto notifier = std::make_unique<InotifyNotifier>();
+#else
+        return nullptr;
+#endif
+#if defined(_WIN32) || defined(__linux__)
+        if (!notifier->valid())
+        {
+            return nullptr;
+        }
+        return notifier;
+#endif
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace helper::logs
+{
+    struct FileChange
+    {
+        std::filesystem::path directory;
+        std::filesystem::path fileName;    // empty when the platform lost track and the whole directory may have changed
+        bool renamed{false};               // created, deleted or renamed rather than written
+    };
+
+    // Wakes the log watcher when something in its log directories changes, so it reads as soon as a line is
+    // written instead of on the next poll. ReadDirectoryChangesW on Windows, inotify on Linux.
+    class FileChangeNotifier
+    {
+    public:
+        virtual ~FileChangeNotifier() = default;
+
+        // Replaces the watched set (non-recursive). Returns false if no directory could be watched; the
+        // caller then polls instead.
+        virtual bool watch(const std::vector<std::filesystem::path>& directories) = 0;
+
+        // Blocks until a watched directory changes, wake() is called or `timeout` elapses, appending what
+        // changed to `changes`. Returns true if anything was appended.
+        virtual bool wait(std::chrono::milliseconds timeout, std::vector<FileChange>& changes) = 0;
+
+        // False once every watch has failed or its directory was removed; the caller then polls instead.
+        virtual bool watching() const = 0;
+
+        // Makes a concurrent or the next wait() return early. Thread-safe.
+        virtual void wake() = 0;
+    };
+
+    // Platform notifier, or nullptr where change notifications are unavailable.
+    std::unique_ptr<FileChangeNotifier> make_file_change_notifier();
+}
@@ -11,6 +11,7 @@
 
 #include <chrono>
 #include <filesystem>
+#include <limits>
 #include <string>
 #include <utility>
 #include <sstream>
@@ -122,33 +123,37 @@ namespace
         return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
     }
 
-    std::string normalize_bucket_id(const std::string& label)
+    nlohmann::json telemetry_history_json(const helper::logs::TelemetryHistorySnapshot& history)
     {
-        std::string id;
-        id.reserve(label.size());
-        for (char ch : label)
-        {
-            if (std::isalnum(static_cast<unsigned char>(ch)))
-            {
-                id.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
-            }
-            else if (!id.empty() && id.back() != '-')
-            {
-                id.push_back('-');
-            }
-        }
+        nlohmann::json historyJson = {
+            {"slice_seconds", history.sliceSeconds},
+            {"capacity", history.capacity},
+            {"saturated", history.saturated}
+        };
 
-        while (!id.empty() && id.back() == '-')
+        if (!history.resetMarkersMs.empty())
         {
-            id.pop_back();
+            historyJson["reset_markers_ms"] = history.resetMarkersMs;
         }
 
-        if (id.empty())
+        if (!history.slices.empty())
         {
-            id = "resource";
+            nlohmann::json slices = nlohmann::json::array();
+            slices.get_ref<nlohmann::json::array_t&>().reserve(history.slices.size());
+            for (const auto& slice : history.slices)
+            {
+                slices.push_back({
+                    {"start_ms", slice.startMs},
+                    {"duration_seconds", slice.durationSeconds},
+                    {"damage_dealt", slice.damageDealt},
+                    {"damage_taken", slice.damageTaken},
+                    {"mining_volume_m3", slice.miningVolumeM3}
+                });
+            }
+            historyJson["slices"] = std::move(slices);
         }
 
-        return id;
+        return historyJson;
     }
 
     nlohmann::json telemetry_metrics_json(const helper::logs::TelemetrySummary& summary)
@@ -200,8 +205,8 @@ namespace
                 for (const auto& bucket : mining.buckets)
                 {
                     buckets.push_back({
-                        {"id", normalize_bucket_id(bucket.resource)},
-                        {"label", bucket.resource},
+                        {"id", bucket.bucketId.view()},
+                        {"label", bucket.resource.view()},
                         {"session_total_m3", bucket.sessionTotalM3},
                         {"recent_total_m3", bucket.recentVolumeM3}
                     });
@@ -214,36 +219,7 @@ namespace
 
         if (summary.history.has_value())
         {
-            const auto& history = *summary.history;
-            nlohmann::json historyJson = {
-                {"slice_seconds", history.sliceSeconds},
-                {"capacity", history.capacity},
-                {"saturated", history.saturated}
-            };
-
-            if (!history.resetMarkersMs.empty())
-            {
-                historyJson["reset_markers_ms"] = history.resetMarkersMs;
-            }
-
-            if (!history.slices.empty())
-            {
-                nlohmann::json slices = nlohmann::json::array();
-                slices.get_ref<nlohmann::json::array_t&>().reserve(history.slices.size());
-                for (const auto& slice : history.slices)
-                {
-                    slices.push_back({
-                        {"start_ms", slice.startMs},
-                        {"duration_seconds", slice.durationSeconds},
-                        {"damage_dealt", slice.damageDealt},
-                        {"damage_taken", slice.damageTaken},
-                        {"mining_volume_m3", slice.miningVolumeM3}
-                    });
-                }
-                historyJson["slices"] = std::move(slices);
-            }
-
-            metrics["history"] = std::move(historyJson);
+            metrics["history"] = telemetry_history_json(*summary.history);
         }
         
         // Serialize high-granularity sparkline buffers (always include, even if empty)
@@ -295,6 +271,68 @@ namespace
         return payload;
     }
 
+    // Hourly totals of every stored event, live or backfilled. Whole-hour buckets come from chunk headers alone.
+    constexpr std::uint64_t telemetry_archive_resolution_ms = 60ull * 60 * 1000;
+
+    nlohmann::json telemetry_archive_json(const std::vector<helper::telemetry::TelemetryPoint>& points)
+    {
+        nlohmann::json rows = nlohmann::json::array();
+        rows.get_ref<nlohmann::json::array_t&>().reserve(points.size());
+        for (const auto& point : points)
+        {
+            rows.push_back({
+                {"start_ms", point.startMs},
+                {"damage_dealt", point.dealt},
+                {"damage_taken", point.taken},
+                {"mining_volume_m3", point.miningM3},
+                {"combat_events", point.combatEvents},
+                {"mining_events", point.miningEvents}
+            });
+        }
+
+        return nlohmann::json{
+            {"bucket_seconds", telemetry_archive_resolution_ms / 1000},
+            {"buckets", std::move(rows)}
+        };
+    }
+
+    nlohmann::json telemetry_range_json(const std::vector<helper::telemetry::TelemetryPoint>& points, std::uint64_t fromMs, std::uint64_t toMs, std::uint64_t resolutionMs, double elapsedMs)
+    {
+        nlohmann::json rows = nlohmann::json::array();
+        rows.get_ref<nlohmann::json::array_t&>().reserve(points.size());
+        for (const auto& point : points)
+        {
+            rows.push_back({
+                {"start_ms", point.startMs},
+                {"damage_dealt", point.dealt},
+                {"damage_taken", point.taken},
+                {"mining_volume_m3", point.miningM3},
+                {"combat_events", point.combatEvents},
+                {"mining_events", point.miningEvents}
+            });
+        }
+
+        return nlohmann::json{
+            {"status", "ok"},
+            {"from_ms", fromMs},
+            {"to_ms", toMs},
+            {"resolution_ms", resolutionMs},
+            {"query_ms", elapsedMs},
+            {"points", std::move(rows)}
+        };
+    }
+
+    nlohmann::json backfill_result_json(const helper::logs::BackfillResult& result)
+    {
+        return nlohmann::json{
+            {"files_scanned", result.filesScanned},
+            {"files_parsed", result.filesParsed},
+            {"bytes_parsed", result.bytesParsed},
+            {"elapsed_ms", result.elapsedMs},
+            {"cancelled", result.cancelled}
+        };
+    }
+
     std::filesystem::path get_session_persistence_path()
     {
         PWSTR rawPath = nullptr;
@@ -328,7 +366,7 @@ namespace
             for (const auto& bucket : mining.buckets)
             {
                 nlohmann::json bucketObj;
-                bucketObj["resource"] = bucket.resource;
+                bucketObj["resource"] = bucket.resource.view();
                 bucketObj["session_total_m3"] = bucket.sessionTotalM3;
                 bucketsArray.push_back(bucketObj);
             }
@@ -380,7 +418,7 @@ namespace
                 for (const auto& bucketJson : j["buckets"])
                 {
                     helper::logs::MiningBucketSnapshot bucket;
-                    bucket.resource = bucketJson.value("resource", "");
+                    bucket.resource = helper::InternedString(bucketJson.value("resource", ""));
                     bucket.sessionTotalM3 = bucketJson.value("session_total_m3", 0.0);
                     snapshot.buckets.push_back(bucket);
                 }
@@ -402,6 +440,8 @@ HelperRuntime::HelperRuntime(Config config)
     : server_(config.host, config.port, config.token)
     , executableDirectory_(config.executableDirectory)
 {
+    server_.setSharedStateJson(config.sharedStateJson);
+
     if (executableDirectory_.empty())
     {
         executableDirectory_ = std::filesystem::current_path();
@@ -434,7 +474,9 @@ HelperRuntime::HelperRuntime(Config config)
 
     std::error_code ec;
     std::filesystem::create_directories(dataDir, ec);
+    dataDirectory_ = dataDir;
     sessionTracker_ = std::make_unique<helper::SessionTracker>(dataDir);
+    telemetryStore_ = std::make_unique<helper::telemetry::TelemetryStore>(helper::telemetry::TelemetryStore::Config{dataDir / L"telemetry"});
 }
 
 HelperRuntime::~HelperRuntime()
@@ -465,6 +507,7 @@ bool HelperRuntime::start()
     if (!logWatcher_)
     {
         helper::logs::LogWatcher::Config watcherConfig{};
+        watcherConfig.telemetryStore = telemetryStore_.get();
         logWatcher_ = std::make_unique<helper::logs::LogWatcher>(
             std::move(watcherConfig),
             systemResolver_,
@@ -558,6 +601,53 @@ bool HelperRuntime::start()
         return sessionTracker_.get();
     });
 
+    server_.setRouteComputeHandler([this](const helper::routing::RouteRequest& request) {
+        std::lock_guard<std::mutex> guard(routePlannerMutex_);
+        if (!routePlanner_)
+        {
+            helper::routing::RouteResult result;
+            result.failure = helper::routing::RouteFailure::CatalogUnavailable;
+            result.error = "Star catalog not loaded";
+            return result;
+        }
+
+        auto result = routePlanner_->plan(request);
+        if (result.success)
+        {
+            spdlog::info("Route computed {} -> {} ({} hops, {:.1f} ly, {} nodes expanded, {:.2f} ms)",
+                request.origin,
+                request.destination,
+                result.route.size() - 1,
+                result.totalDistanceLy,
+                result.expandedNodes,
+                result.elapsedMs);
+        }
+        return result;
+    });
+
+    server_.setRouteRepairHandler([this](const std::vector<overlay::RouteNode>& route, const std::string& currentSystemId)
+        -> std::optional<std::vector<overlay::RouteNode>> {
+        std::lock_guard<std::mutex> guard(routePlannerMutex_);
+        if (!routePlanner_)
+        {
+            return std::nullopt;
+        }
+
+        auto result = routePlanner_->repair(route, currentSystemId);
+        if (!result.success)
+        {
+            spdlog::debug("Route repair from {} failed: {}", currentSystemId, result.error);
+            return std::nullopt;
+        }
+
+        spdlog::debug("Route repaired from {} ({} nodes expanded, {:.2f} ms, reused={})",
+            currentSystemId,
+            result.expandedNodes,
+            result.elapsedMs,
+            result.reusedSearch);
+        return std::move(result.route);
+    });
+
     // Log path reload handler
     server_.setLogPathReloadHandler([this]() {
         if (logWatcher_)
@@ -566,6 +656,65 @@ bool HelperRuntime::start()
         }
     });
 
+    server_.setLogBackfillStatusHandler([this]() -> std::optional<nlohmann::json> {
+        std::lock_guard<std::mutex> guard(backfillMutex_);
+        nlohmann::json payload{
+            {"status", "ok"},
+            {"running", backfillRunning_.load()}
+        };
+        if (lastBackfill_.has_value())
+        {
+            payload["last_run"] = backfill_result_json(*lastBackfill_);
+        }
+        return payload;
+    });
+
+    server_.setLogBackfillStartHandler([this]() -> std::optional<nlohmann::json> {
+        if (!startLogBackfill())
+        {
+            return std::nullopt;
+        }
+        return nlohmann::json{{"status", "ok"}, {"running", true}};
+    });
+
+    server_.setTelemetryHistoryHandler(
+        [this]() -> std::optional<nlohmann::json> {
+            if (!logWatcher_)
+            {
+                return std::nullopt;
+            }
+            nlohmann::json payload = nlohmann::json::object();
+            if (auto history = logWatcher_->telemetryHistorySnapshot())
+            {
+                payload["history"] = telemetry_history_json(*history);
+            }
+            if (telemetryStore_)
+            {
+                const auto points = telemetryStore_->query(0, std::numeric_limits<std::uint64_t>::max(), telemetry_archive_resolution_ms);
+                if (!points.empty())
+                {
+                    payload["archive"] = telemetry_archive_json(points);
+                }
+            }
+            return payload;
+        },
+        [this]() -> std::uint64_t {
+            // Both counters only grow, so their sum moves whenever either does.
+            const auto history = logWatcher_ ? logWatcher_->telemetryHistoryRevision() : 0;
+            return history + (telemetryStore_ ? telemetryStore_->revision() : 0);
+        });
+
+    server_.setTelemetryRangeHandler([this](std::uint64_t fromMs, std::uint64_t toMs, std::uint64_t resolutionMs) -> std::optional<nlohmann::json> {
+        if (!telemetryStore_)
+        {
+            return std::nullopt;
+        }
+        const auto started = std::chrono::steady_clock::now();
+        const auto points = telemetryStore_->query(fromMs, toMs, resolutionMs);
+        const auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        return telemetry_range_json(points, fromMs, toMs, resolutionMs, elapsedMs);
+    });
+
     // Restore persisted mining session BEFORE starting log processing
     // This ensures session state is loaded before any new mining events are processed
     loadMiningSession();
@@ -583,6 +732,13 @@ bool HelperRuntime::start()
 
     loadStarCatalog();
 
+    // Once the logs have been backfilled, each start picks up what was written since.
+    std::error_code ec;
+    if (std::filesystem::exists(dataDirectory_ / "log_backfill_index.json", ec))
+    {
+        startLogBackfill();
+    }
+
     spdlog::info("Helper runtime started ({}:{})", server_.host(), server_.port());
     return true;
 }
@@ -594,10 +750,20 @@ void HelperRuntime::stop()
         return;
     }
 
+    backfillCancel_.store(true);
+    if (backfillThread_.joinable())
+    {
+        backfillThread_.join();
+    }
+
     if (logWatcher_)
     {
         logWatcher_->stop();
     }
+    if (telemetryStore_)
+    {
+        telemetryStore_->flush();
+    }
 
     server_.publishOfflineState();
 
@@ -1277,7 +1443,13 @@ void HelperRuntime::loadStarCatalog()
 {
     HelperServer::StarCatalogSummary summary;
 
-    const auto catalogPath = resolveArtifact(std::filesystem::path(L"data/star_catalog_v1.bin"));
+    // Prefer the EFSTARS2 conversion (precomputed lookup indexes) when it ships alongside the v1 catalog.
+    auto catalogPath = resolveArtifact(std::filesystem::path(L"data/star_catalog_v2.bin"));
+    std::error_code v2Ec;
+    if (catalogPath.empty() || !std::filesystem::exists(catalogPath, v2Ec))
+    {
+        catalogPath = resolveArtifact(std::filesystem::path(L"data/star_catalog_v1.bin"));
+    }
     summary.path = catalogPath;
 
     std::optional<overlay::StarCatalog> loadedCatalog;
@@ -1331,6 +1503,12 @@ void HelperRuntime::loadStarCatalog()
         }
     }
 
+    {
+        std::lock_guard<std::mutex> guard(routePlannerMutex_);
+        std::lock_guard<std::mutex> statusGuard(statusMutex_);
+        routePlanner_ = starCatalog_ ? std::make_unique<helper::routing::RoutePlanner>(*starCatalog_) : nullptr;
+    }
+
     if (summary.loaded)
     {
         spdlog::info("Star catalog loaded from {} (records={}, version={})",
@@ -1432,6 +1610,69 @@ void HelperRuntime::loadMiningSession()
     }
 }
 
+bool HelperRuntime::startLogBackfill()
+{
+    if (!logWatcher_ || backfillRunning_.exchange(true))
+    {
+        return false;
+    }
+    if (backfillThread_.joinable())
+    {
+        backfillThread_.join();
+    }
+
+    backfillCancel_.store(false);
+    backfillThread_ = std::thread([this]() {
+        // The watcher finds its directories and current files on its first pass; those files stay with it.
+        auto watcherStatus = logWatcher_->status();
+        for (int attempt = 0; attempt < 50 && !backfillCancel_.load() && watcherStatus.chatDirectory.empty() && watcherStatus.combatDirectory.empty(); ++attempt)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            watcherStatus = logWatcher_->status();
+        }
+
+        helper::logs::LogBackfill::Config config;
+        if (!watcherStatus.chatDirectory.empty())
+        {
+            config.chatDirectory = watcherStatus.chatDirectory;
+        }
+        if (!watcherStatus.combatDirectory.empty())
+        {
+            config.combatDirectory = watcherStatus.combatDirectory;
+        }
+        config.followedFiles = logWatcher_->followedFiles();
+        config.indexPath = dataDirectory_ / "log_backfill_index.json";
+        config.telemetryStore = telemetryStore_.get();
+
+        helper::logs::LogBackfill backfill(std::move(config), systemResolver_);
+        auto result = backfill.run(&backfillCancel_);
+        if (telemetryStore_)
+        {
+            telemetryStore_->flush();
+        }
+        if (sessionTracker_)
+        {
+            sessionTracker_->mergeAllTimeVisits(result.visits);
+        }
+
+        spdlog::info("Log backfill parsed {} of {} logs ({:.1f} MiB, {} systems) in {:.0f} ms{}",
+            result.filesParsed,
+            result.filesScanned,
+            static_cast<double>(result.bytesParsed) / (1024.0 * 1024.0),
+            result.visits.size(),
+            result.elapsedMs,
+            result.cancelled ? ", cancelled" : "");
+
+        {
+            std::lock_guard<std::mutex> guard(backfillMutex_);
+            result.visits.clear();
+            lastBackfill_ = std::move(result);
+        }
+        backfillRunning_.store(false);
+    });
+    return true;
+}
+
 bool HelperRuntime::applyFollowModeSetting(bool enabled, std::string_view source)
 {
     const bool previous = followModeEnabled_.exchange(enabled);
@@ -6,6 +6,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -14,11 +15,14 @@
 #include <thread>
 
 #include "event_channel.hpp"
+#include "log_backfill.hpp"
 #include "log_watcher.hpp"
 #include "system_resolver.hpp"
 #include "overlay_schema.hpp"
 #include "star_catalog.hpp"
+#include "route_planner.hpp"
 #include "session_tracker.hpp"
+#include "telemetry_store.hpp"
 
 class HelperRuntime
 {
@@ -29,6 +33,7 @@ public:
         int port{38765};
         std::string token;
         std::filesystem::path executableDirectory;
+        bool sharedStateJson{false}; // publish JSON instead of the binary encoding to shared memory (debugging)
     };
 
     struct Status
@@ -83,6 +88,10 @@ public:
     void saveMiningSession();
     void loadMiningSession();
 
+    // Backfills visited systems and hourly telemetry from the historical logs on a background thread.
+    // Returns false if a run is already in progress.
+    bool startLogBackfill();
+
     HelperServer& server() noexcept { return server_; }
     const HelperServer& server() const noexcept { return server_; }
 
@@ -102,6 +111,8 @@ private:
     HelperServer server_;
     overlay::OverlayEventReader eventReader_;
 
+    // Declared before the watcher so it outlives it; the watcher and the backfill append to it.
+    std::unique_ptr<helper::telemetry::TelemetryStore> telemetryStore_;
     std::unique_ptr<helper::logs::LogWatcher> logWatcher_;
     std::optional<helper::logs::LogWatcherStatus> lastLogWatcherStatus_;
 
@@ -116,6 +127,10 @@ private:
     std::filesystem::path starCatalogPath_;
     std::string starCatalogError_;
 
+    // Shares the star catalog mapping; rebuilt whenever the catalog is reloaded.
+    std::mutex routePlannerMutex_;
+    std::unique_ptr<helper::routing::RoutePlanner> routePlanner_;
+
     std::filesystem::path executableDirectory_;
     std::filesystem::path artifactRoot_;
 
@@ -127,5 +142,12 @@ private:
 
     helper::logs::SystemResolver systemResolver_;
     std::atomic_bool followModeEnabled_{true};
+    std::filesystem::path dataDirectory_;
     std::unique_ptr<helper::SessionTracker> sessionTracker_;
+
+    mutable std::mutex backfillMutex_;
+    std::thread backfillThread_;
+    std::atomic_bool backfillRunning_{false};
+    std::atomic_bool backfillCancel_{false};
+    std::optional<helper::logs::BackfillResult> lastBackfill_;    // totals only; visits are merged
 };
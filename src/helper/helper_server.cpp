@@ -1,10 +1,14 @@
 #include "helper_server.hpp"
+#include "overlay_state_binary.hpp"
+#include "server_streams.hpp"
 #include "session_tracker.hpp"
 
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <charconv>
 #include <cstdlib>
 #include <sstream>
 #include <utility>
@@ -16,6 +20,9 @@ namespace
 {
     constexpr const char* application_json = "application/json";
     constexpr const char* text_plain = "text/plain";
+    constexpr std::uint64_t telemetry_range_default_ms = 24ull * 60 * 60 * 1000;
+    constexpr std::uint64_t telemetry_range_max_buckets = 20000;
+    constexpr const char* text_event_stream = "text/event-stream";
 
     nlohmann::json make_error(std::string_view message)
     {
@@ -28,6 +35,67 @@ namespace
         return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
     }
 
+    // Decimal query parameter; the whole value must be a number that fits in 64 bits.
+    std::optional<std::uint64_t> parse_unsigned(std::string_view text)
+    {
+        std::uint64_t value = 0;
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (result.ec != std::errc{} || result.ptr != text.data() + text.size())
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    // Strong validator for a rendered response body (64-bit FNV-1a).
+    std::string make_etag(std::string_view body)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const auto c : body)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string etag(18, '"');
+        for (int i = 16; i >= 1; --i)
+        {
+            etag[i] = digits[hash & 0xF];
+            hash >>= 4;
+        }
+        return etag;
+    }
+
+    // If-None-Match holds "*" or a comma-separated list of entity tags, compared weakly (RFC 9110 13.1.2).
+    bool etag_matches(std::string_view header, std::string_view etag)
+    {
+        while (!header.empty())
+        {
+            const auto comma = header.find(',');
+            auto candidate = header.substr(0, comma);
+            header = comma == std::string_view::npos ? std::string_view() : header.substr(comma + 1);
+
+            while (!candidate.empty() && (candidate.front() == ' ' || candidate.front() == '\t'))
+            {
+                candidate.remove_prefix(1);
+            }
+            while (!candidate.empty() && (candidate.back() == ' ' || candidate.back() == '\t'))
+            {
+                candidate.remove_suffix(1);
+            }
+            if (candidate.starts_with("W/"))
+            {
+                candidate.remove_prefix(2);
+            }
+            if (candidate == "*" || candidate == etag)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     // Helper: Convert UTF-8 to wide string
     std::wstring utf8_to_wstring(const std::string& utf8)
     {
@@ -149,7 +217,7 @@ HelperServer::HelperServer(std::string host, int port, std::string authToken)
     // route vector is empty by default
     const auto initialJson = overlay::serialize_overlay_state(initialState);
     const auto initialSerialized = initialJson.dump();
-    sharedMemoryWriter_.write(initialSerialized, initialState.version, initialState.generated_at_ms);
+    publishSharedState(initialState, initialSerialized);
     spdlog::info("Helper initialized with empty overlay state (cleared stale data)");
 }
 
@@ -188,6 +256,37 @@ void HelperServer::setLogPathReloadHandler(LogPathReloadHandler handler)
     logPathReloadHandler_ = std::move(handler);
 }
 
+void HelperServer::setLogBackfillStatusHandler(LogBackfillHandler handler)
+{
+    logBackfillStatusHandler_ = std::move(handler);
+}
+
+void HelperServer::setLogBackfillStartHandler(LogBackfillHandler handler)
+{
+    logBackfillStartHandler_ = std::move(handler);
+}
+
+void HelperServer::setTelemetryHistoryHandler(TelemetryHistoryHandler handler, RevisionProvider revision)
+{
+    telemetryHistoryHandler_ = std::move(handler);
+    telemetryHistoryRevision_ = std::move(revision);
+}
+
+void HelperServer::setTelemetryRangeHandler(TelemetryRangeHandler handler)
+{
+    telemetryRangeHandler_ = std::move(handler);
+}
+
+void HelperServer::setRouteComputeHandler(RouteComputeHandler handler)
+{
+    routeComputeHandler_ = std::move(handler);
+}
+
+void HelperServer::setRouteRepairHandler(RouteRepairHandler handler)
+{
+    routeRepairHandler_ = std::move(handler);
+}
+
 bool HelperServer::updateFollowModeFlag(bool enabled)
 {
     std::string serialized;
@@ -207,6 +306,8 @@ bool HelperServer::updateFollowModeFlag(bool enabled)
         json = latestOverlayStateJson_;
         serialized = json.dump();
         latestOverlayState_ = serialized;
+        latestOverlayStateStale_ = false;
+        noteOverlayStateChangeLocked();
         if (json.contains("version"))
         {
             version = json.at("version").get<std::uint32_t>();
@@ -219,7 +320,7 @@ bool HelperServer::updateFollowModeFlag(bool enabled)
         lastOverlayGeneratedAtMs_ = generatedAt;
     }
 
-    const bool sharedOk = sharedMemoryWriter_.write(serialized, version, generatedAt);
+    const bool sharedOk = publishSharedState(json, serialized, version, generatedAt);
     if (!sharedOk)
     {
         spdlog::warn("Failed to publish follow mode update to shared memory");
@@ -253,6 +354,8 @@ bool HelperServer::updateTrackingFlag(bool enabled)
         json = latestOverlayStateJson_;
         serialized = json.dump();
         latestOverlayState_ = serialized;
+        latestOverlayStateStale_ = false;
+        noteOverlayStateChangeLocked();
         if (json.contains("version"))
         {
             version = json.at("version").get<std::uint32_t>();
@@ -265,7 +368,7 @@ bool HelperServer::updateTrackingFlag(bool enabled)
         lastOverlayGeneratedAtMs_ = generatedAt;
     }
 
-    const bool sharedOk = sharedMemoryWriter_.write(serialized, version, generatedAt);
+    const bool sharedOk = publishSharedState(json, serialized, version, generatedAt);
     if (!sharedOk)
     {
         spdlog::warn("Failed to publish tracking update to shared memory");
@@ -312,6 +415,8 @@ bool HelperServer::updateSessionState(bool hasActiveSession, std::optional<std::
         json = latestOverlayStateJson_;
         serialized = json.dump();
         latestOverlayState_ = serialized;
+        latestOverlayStateStale_ = false;
+        noteOverlayStateChangeLocked();
         if (json.contains("version"))
         {
             version = json.at("version").get<std::uint32_t>();
@@ -324,7 +429,7 @@ bool HelperServer::updateSessionState(bool hasActiveSession, std::optional<std::
         lastOverlayGeneratedAtMs_ = generatedAt;
     }
 
-    const bool sharedOk = sharedMemoryWriter_.write(serialized, version, generatedAt);
+    const bool sharedOk = publishSharedState(json, serialized, version, generatedAt);
     if (!sharedOk)
     {
         spdlog::warn("Failed to publish session update to shared memory");
@@ -389,11 +494,13 @@ bool HelperServer::start()
         }
     }
 
+    streamsStopping_.store(false);
     running_.store(true);
     startedAt_ = std::chrono::steady_clock::now();
     stoppedAt_ = startedAt_;
 
     startHeartbeat();
+    startRouteRepair();
 
     serverThread_ = std::thread([this]() {
     spdlog::info("Helper server listening on {}:{} (auth: {})", host_, port_, requireAuth_ ? "required" : "disabled");
@@ -414,12 +521,14 @@ void HelperServer::stop()
     }
 
     stopHeartbeat();
+    stopRouteRepair();
 
     if (websocketHub_)
     {
         websocketHub_->stop();
     }
 
+    wakeStreams();
     server_.stop();
 
     if (serverThread_.joinable())
@@ -456,6 +565,113 @@ std::optional<nlohmann::json> HelperServer::latestOverlayStateJson() const
     return latestOverlayStateJson_;
 }
 
+std::string HelperServer::latestOverlayStateTextLocked()
+{
+    if (latestOverlayStateStale_)
+    {
+        latestOverlayState_ = latestOverlayStateJson_.dump();
+        latestOverlayStateStale_ = false;
+    }
+    return latestOverlayState_;
+}
+
+void HelperServer::noteOverlayStateChangeLocked()
+{
+    ++overlayStateGeneration_;
+    ++overlayStateRevision_;
+    overlayStateChanged_.notify_all();
+}
+
+void HelperServer::respondCached(const httplib::Request& req, httplib::Response& res, const std::string& key, std::uint64_t revision, const ResponseRenderer& render)
+{
+    std::shared_ptr<const CachedResponse> cached;
+    {
+        std::lock_guard<std::mutex> guard(responseCacheMutex_);
+        const auto it = responseCache_.find(key);
+        if (it != responseCache_.end() && it->second->revision == revision)
+        {
+            cached = it->second;
+        }
+    }
+
+    if (!cached)
+    {
+        // Rendered outside the lock; two requests racing on a miss both render and the later one is kept.
+        auto rendered = render();
+        if (rendered.status != 200)
+        {
+            res.set_content(rendered.body, application_json);
+            res.status = rendered.status;
+            return;
+        }
+
+        rendered.revision = revision;
+        rendered.etag = make_etag(rendered.body);
+        cached = std::make_shared<const CachedResponse>(std::move(rendered));
+
+        std::lock_guard<std::mutex> guard(responseCacheMutex_);
+        if (responseCache_.size() >= maxCachedResponses_ && responseCache_.find(key) == responseCache_.end())
+        {
+            responseCache_.clear();
+        }
+        responseCache_[key] = cached;
+    }
+
+    res.set_header("ETag", cached->etag);
+    res.set_header("Cache-Control", "no-cache");
+    if (etag_matches(req.get_header_value("If-None-Match"), cached->etag))
+    {
+        res.status = 304;
+        return;
+    }
+
+    res.set_content(cached->body, application_json);
+    res.status = 200;
+}
+
+bool HelperServer::acquireStream()
+{
+    auto open = openStreams_.load();
+    while (open < maxOpenStreams_)
+    {
+        if (openStreams_.compare_exchange_weak(open, open + 1))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void HelperServer::releaseStream()
+{
+    openStreams_.fetch_sub(1);
+}
+
+bool HelperServer::waitForStreamsStopping(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(streamsMutex_);
+    return streamsStopped_.wait_for(lock, timeout, [this]() { return streamsStopping_.load(); });
+}
+
+void HelperServer::wakeStreams()
+{
+    streamsStopping_.store(true);
+
+    // Taking each mutex orders the store before any waiter's next predicate check.
+    {
+        std::lock_guard<std::mutex> guard(overlayStateMutex_);
+    }
+    overlayStateChanged_.notify_all();
+    {
+        std::lock_guard<std::mutex> guard(eventsMutex_);
+    }
+    eventsChanged_.notify_all();
+    {
+        std::lock_guard<std::mutex> guard(streamsMutex_);
+    }
+    streamsStopped_.notify_all();
+}
+
 bool HelperServer::authorize(const httplib::Request& req, httplib::Response& res) const
 {
     if (!requireAuth_)
@@ -506,8 +722,8 @@ bool HelperServer::ingestOverlayState(const overlay::OverlayState& state, std::s
         }
     }
 
-    // If this update is from the web app (HTTP POST), preserve player_marker from log watcher
-    if (source == "http")
+    // If this update is from the web app (HTTP POST) or a route repair, preserve player_marker from log watcher
+    if (source == "http" || source == "route-repair")
     {
         std::lock_guard<std::mutex> guard(overlayStateMutex_);
         if (!latestOverlayStateJson_.empty())
@@ -636,15 +852,17 @@ bool HelperServer::ingestOverlayState(const overlay::OverlayState& state, std::s
     {
         std::lock_guard<std::mutex> guard(overlayStateMutex_);
         latestOverlayState_ = serialized;
+        latestOverlayStateStale_ = false;
         latestOverlayStateJson_ = stateJson;
         lastOverlayGeneratedAtMs_ = enriched.generated_at_ms;
         lastOverlayAcceptedAt_ = std::chrono::system_clock::now();
+        noteOverlayStateChangeLocked();
     }
 
     hasOverlayState_.store(true);
 
     spdlog::debug("Writing to shared memory: route size={}, source={}", enriched.route.size(), source);
-    const bool sharedOk = sharedMemoryWriter_.write(serialized, static_cast<std::uint32_t>(enriched.version), enriched.generated_at_ms);
+    const bool sharedOk = publishSharedState(enriched, serialized);
     if (!sharedOk)
     {
         spdlog::warn("Overlay state accepted via {} but failed to publish to shared memory", source);
@@ -656,10 +874,56 @@ bool HelperServer::ingestOverlayState(const overlay::OverlayState& state, std::s
         websocketHub_->broadcastOverlayState(envelope);
     }
 
+    // Player jumped to a system that is not on the preserved route: repair it locally so the overlay
+    // shows a valid next hop without waiting for the web app to push a new route. The position is
+    // published now; the repaired route follows from the repair thread. It is scheduled only once this state
+    // is stored and published, since the repair is checked against it and must not be overwritten by it.
+    if (source == "log-watcher" && routeRepairHandler_ && enriched.route.size() > 1
+        && enriched.player_marker.has_value() && !enriched.player_marker->system_id.empty())
+    {
+        const auto& currentSystemId = enriched.player_marker->system_id;
+        const bool onRoute = std::any_of(enriched.route.begin(), enriched.route.end(), [&currentSystemId](const overlay::RouteNode& node) {
+            return node.system_id == currentSystemId;
+        });
+
+        if (!onRoute)
+        {
+            scheduleRouteRepair(RouteRepairJob{enriched.route, stateJson["route"], currentSystemId, enriched.player_marker->display_name});
+        }
+    }
+
     spdlog::info("Overlay state accepted via {} ({} bytes)", std::move(source), static_cast<unsigned long long>(requestBytes));
     return true;
 }
 
+bool HelperServer::publishSharedState(const overlay::OverlayState& state, const std::string& serialized)
+{
+    const auto version = static_cast<std::uint32_t>(state.version);
+    if (sharedStateJson_.load())
+    {
+        return sharedMemoryWriter_.write(serialized, version, state.generated_at_ms);
+    }
+
+    return sharedMemoryWriter_.write_binary(overlay::encode_overlay_state_binary(state), version, state.generated_at_ms);
+}
+
+bool HelperServer::publishSharedState(const nlohmann::json& stateJson, const std::string& serialized, std::uint32_t version, std::uint64_t generatedAt)
+{
+    if (!sharedStateJson_.load())
+    {
+        try
+        {
+            return publishSharedState(overlay::parse_overlay_state(stateJson), serialized);
+        }
+        catch (const std::exception& ex)
+        {
+            spdlog::warn("Overlay state could not be binary encoded ({}); publishing JSON", ex.what());
+        }
+    }
+
+    return sharedMemoryWriter_.write(serialized, version, generatedAt);
+}
+
 void HelperServer::publishOfflineState()
 {
     if (!hasOverlayState_.load())
@@ -684,6 +948,8 @@ void HelperServer::publishOfflineState()
         json["heartbeat_ms"] = now_ms();
         serialized = json.dump();
         latestOverlayState_ = serialized;
+        latestOverlayStateStale_ = false;
+        noteOverlayStateChangeLocked();
         latestOverlayStateJson_ = json;
         if (json.contains("version"))
         {
@@ -697,7 +963,7 @@ void HelperServer::publishOfflineState()
         lastOverlayAcceptedAt_ = std::chrono::system_clock::now();
     }
 
-    const bool sharedOk = sharedMemoryWriter_.write(serialized, version, generatedAt);
+    const bool sharedOk = publishSharedState(json, serialized, version, generatedAt);
     if (!sharedOk)
     {
         spdlog::warn("Failed to publish offline overlay state to shared memory");
@@ -730,8 +996,11 @@ void HelperServer::startHeartbeat()
             }
 
             std::string serialized;
+            nlohmann::json json;
             std::uint32_t version = overlay::schema_version;
             std::uint64_t generatedAt = 0;
+            const auto heartbeatMs = now_ms();
+            bool wasOnline = true;
 
             {
                 std::lock_guard<std::mutex> guard(overlayStateMutex_);
@@ -740,22 +1009,38 @@ void HelperServer::startHeartbeat()
                     continue;
                 }
 
-                latestOverlayStateJson_["heartbeat_ms"] = now_ms();
-                latestOverlayStateJson_["source_online"] = true;
-                serialized = latestOverlayStateJson_.dump();
-                latestOverlayState_ = serialized;
-                if (latestOverlayStateJson_.contains("version"))
+                latestOverlayStateJson_["heartbeat_ms"] = heartbeatMs;
+                wasOnline = latestOverlayStateJson_.value("source_online", false);
+                if (wasOnline)
                 {
-                    version = latestOverlayStateJson_.at("version").get<std::uint32_t>();
+                    // Only the heartbeat moved; the cached text is refreshed when someone asks for it.
+                    latestOverlayStateStale_ = true;
+                    ++overlayStateRevision_;
                 }
-                if (latestOverlayStateJson_.contains("generated_at_ms"))
+                else
                 {
-                    generatedAt = latestOverlayStateJson_.at("generated_at_ms").get<std::uint64_t>();
+                    latestOverlayStateJson_["source_online"] = true;
+                    json = latestOverlayStateJson_;
+                    serialized = json.dump();
+                    latestOverlayState_ = serialized;
+                    latestOverlayStateStale_ = false;
+                    noteOverlayStateChangeLocked();
+                    if (latestOverlayStateJson_.contains("version"))
+                    {
+                        version = latestOverlayStateJson_.at("version").get<std::uint32_t>();
+                    }
+                    if (latestOverlayStateJson_.contains("generated_at_ms"))
+                    {
+                        generatedAt = latestOverlayStateJson_.at("generated_at_ms").get<std::uint64_t>();
+                    }
+                    lastOverlayGeneratedAtMs_ = generatedAt;
                 }
-                lastOverlayGeneratedAtMs_ = generatedAt;
             }
 
-            const bool sharedOk = sharedMemoryWriter_.write(serialized, version, generatedAt);
+            // Steady-state heartbeats are a fixed 8-byte record; coming back online is a real state change.
+            const bool sharedOk = wasOnline
+                ? sharedMemoryWriter_.write_heartbeat(heartbeatMs)
+                : publishSharedState(json, serialized, version, generatedAt);
             if (!sharedOk)
             {
                 spdlog::warn("Heartbeat publication failed to update shared memory");
@@ -773,13 +1058,113 @@ void HelperServer::stopHeartbeat()
     }
 }
 
+void HelperServer::startRouteRepair()
+{
+    {
+        std::lock_guard<std::mutex> guard(routeRepairMutex_);
+        routeRepairRunning_ = true;
+    }
+
+    routeRepairThread_ = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(routeRepairMutex_);
+        while (true)
+        {
+            routeRepairRequested_.wait(lock, [this]() {
+                return !routeRepairRunning_ || pendingRouteRepair_.has_value();
+            });
+            if (!routeRepairRunning_)
+            {
+                return;
+            }
+
+            auto job = std::move(*pendingRouteRepair_);
+            pendingRouteRepair_.reset();
+            lock.unlock();
+
+            // The handler serialises access to the planner; the search runs without any server lock held.
+            if (auto repaired = routeRepairHandler_(job.route, job.currentSystemId))
+            {
+                applyRouteRepair(job, std::move(*repaired));
+            }
+
+            lock.lock();
+        }
+    });
+}
+
+void HelperServer::stopRouteRepair()
+{
+    {
+        std::lock_guard<std::mutex> guard(routeRepairMutex_);
+        routeRepairRunning_ = false;
+        pendingRouteRepair_.reset();
+    }
+    routeRepairRequested_.notify_all();
+
+    if (routeRepairThread_.joinable())
+    {
+        routeRepairThread_.join();
+    }
+}
+
+void HelperServer::scheduleRouteRepair(RouteRepairJob job)
+{
+    {
+        std::lock_guard<std::mutex> guard(routeRepairMutex_);
+        if (!routeRepairRunning_)
+        {
+            return;
+        }
+        pendingRouteRepair_ = std::move(job);
+    }
+    routeRepairRequested_.notify_one();
+}
+
+void HelperServer::applyRouteRepair(const RouteRepairJob& job, std::vector<overlay::RouteNode> repaired)
+{
+    overlay::OverlayState state;
+    {
+        std::lock_guard<std::mutex> guard(overlayStateMutex_);
+
+        // A newer jump or a route pushed by the web app since the request makes this repair stale.
+        const auto& latest = latestOverlayStateJson_;
+        const bool sameRoute = latest.contains("route") && latest["route"] == job.routeJson;
+        const bool samePosition = latest.contains("player_marker") && latest["player_marker"].is_object()
+            && latest["player_marker"].value("system_id", std::string{}) == job.currentSystemId;
+        if (!sameRoute || !samePosition)
+        {
+            spdlog::debug("Discarding route repair from {}: state changed while it ran", job.currentSystemId);
+            return;
+        }
+
+        try
+        {
+            state = overlay::parse_overlay_state(latest);
+        }
+        catch (const std::exception& ex)
+        {
+            spdlog::warn("Route repair could not reuse latest overlay state: {}", ex.what());
+            return;
+        }
+    }
+
+    spdlog::info("Player left the route at {}; repaired route has {} hops",
+        job.currentSystemName,
+        repaired.empty() ? 0 : repaired.size() - 1);
+    state.route = std::move(repaired);
+    state.active_route_node_id = state.route.size() > 1 ? std::optional<std::string>{state.route[1].system_id} : std::nullopt;
+    state.generated_at_ms = now_ms();
+    ingestOverlayState(state, 0, "route-repair");
+}
+
 void HelperServer::configureRoutes()
 {
     using namespace std::chrono;
 
     server_.set_default_headers({
         {"Access-Control-Allow-Origin", "*"},
-        {"Access-Control-Allow-Headers", "Content-Type, X-EF-Helper-Auth, x-ef-overlay-token"},
+        {"Access-Control-Allow-Headers", "Content-Type, X-EF-Helper-Auth, x-ef-overlay-token, If-None-Match"},
+        {"Access-Control-Expose-Headers", "ETag"},
         {"Access-Control-Allow-Methods", "GET, POST, OPTIONS"}
     });
 
@@ -836,14 +1221,58 @@ void HelperServer::configureRoutes()
             return;
         }
 
-        std::string snapshot;
+        std::uint64_t revision = 0;
         {
             std::lock_guard<std::mutex> guard(overlayStateMutex_);
-            snapshot = latestOverlayState_;
+            revision = overlayStateRevision_;
         }
 
-        res.set_content(snapshot, application_json);
-        res.status = 200;
+        respondCached(req, res, "overlay/state", revision, [this]() {
+            CachedResponse rendered;
+            std::lock_guard<std::mutex> guard(overlayStateMutex_);
+            rendered.body = latestOverlayStateTextLocked();
+            return rendered;
+        });
+    });
+
+    // Server-sent events: the current state on connect, then every change (heartbeat ticks excepted) as it
+    // is accepted. A comment line every 15 s keeps idle connections open.
+    server_.Get("/overlay/state/stream", [this](const httplib::Request& req, httplib::Response& res) {
+        if (!authorize(req, res))
+        {
+            return;
+        }
+
+        if (!acquireStream())
+        {
+            res.set_content(make_error("Too many open streams").dump(), application_json);
+            res.status = 503;
+            return;
+        }
+
+        res.set_header("Cache-Control", "no-cache");
+        res.set_chunked_content_provider(
+            text_event_stream,
+            [this, stream = helper::streams::GenerationStream{}](std::size_t, httplib::DataSink& sink) mutable {
+                using Step = helper::streams::GenerationStream::Step;
+                std::string message;
+                {
+                    std::unique_lock<std::mutex> lock(overlayStateMutex_);
+                    const auto step = stream.next(lock, overlayStateChanged_, helper::streams::keepalive_interval,
+                        overlayStateGeneration_, streamsStopping_, hasOverlayState_.load());
+                    if (step == Step::Stop)
+                    {
+                        lock.unlock();
+                        sink.done();
+                        return true;
+                    }
+                    message = step == Step::Send
+                        ? helper::streams::make_event("overlay_state", stream.sent(), latestOverlayStateTextLocked())
+                        : std::string(helper::streams::keepalive);
+                }
+                return sink.write(message.data(), message.size());
+            },
+            [this](bool) { releaseStream(); });
     });
 
     server_.Get("/overlay/events", [this](const httplib::Request& req, httplib::Response& res) {
@@ -852,19 +1281,33 @@ void HelperServer::configureRoutes()
             return;
         }
 
-        std::uint64_t sinceId = 0;
-        if (req.has_param("since"))
+        // ?wait_ms= turns the poll into a long poll: with nothing newer than `since`, the response is held
+        // until an event arrives or the wait (at most 25 s) runs out.
+        const auto sinceParam = req.has_param("since") ? parse_unsigned(req.get_param_value("since")) : std::uint64_t{0};
+        const auto waitParam = req.has_param("wait_ms") ? parse_unsigned(req.get_param_value("wait_ms")) : std::uint64_t{0};
+        if (!sinceParam || !waitParam)
         {
-            const auto& value = req.get_param_value("since");
-            sinceId = static_cast<std::uint64_t>(::_strtoui64(value.c_str(), nullptr, 10));
+            res.set_content(make_error("Parameters since and wait_ms must be unsigned integers").dump(), application_json);
+            res.status = 400;
+            return;
         }
+        const std::uint64_t sinceId = *sinceParam;
+        const auto waitMs = std::min(*waitParam, static_cast<std::uint64_t>(helper::streams::long_poll_max.count()));
 
         nlohmann::json eventsJson = nlohmann::json::array();
         std::uint64_t latestId = sinceId;
         std::uint32_t dropped = 0;
 
         {
-            std::lock_guard<std::mutex> guard(eventsMutex_);
+            std::unique_lock<std::mutex> lock(eventsMutex_);
+            if (waitMs > 0 && acquireStream())
+            {
+                helper::streams::wait_long_poll(lock, eventsChanged_, milliseconds(waitMs), streamsStopping_, [this, sinceId]() {
+                    return !recentEvents_.empty() && recentEvents_.back().id > sinceId;
+                });
+                releaseStream();
+            }
+
             for (const auto& record : recentEvents_)
             {
                 if (record.id <= sinceId)
@@ -918,7 +1361,9 @@ void HelperServer::configureRoutes()
         res.status = 200;
     });
 
-    server_.Get("/telemetry/history", [this](const httplib::Request& req, httplib::Response& res) {
+    // Server-sent events: the telemetry summary is sampled every interval_ms (250-10000, default 1000) and
+    // pushed only when the metrics differ from the last one sent.
+    server_.Get("/telemetry/stream", [this](const httplib::Request& req, httplib::Response& res) {
         if (!authorize(req, res))
         {
             return;
@@ -931,30 +1376,190 @@ void HelperServer::configureRoutes()
             return;
         }
 
-        auto payload = telemetrySummaryHandler_();
-        if (!payload.has_value())
+        const auto intervalMs = req.has_param("interval_ms") ? parse_unsigned(req.get_param_value("interval_ms")) : std::uint64_t{1000};
+        if (!intervalMs)
+        {
+            res.set_content(make_error("Parameter interval_ms must be an unsigned integer").dump(), application_json);
+            res.status = 400;
+            return;
+        }
+        const milliseconds interval(std::clamp<std::uint64_t>(*intervalMs, 250, 10000));
+
+        if (!acquireStream())
+        {
+            res.set_content(make_error("Too many open streams").dump(), application_json);
+            res.status = 503;
+            return;
+        }
+
+        res.set_header("Cache-Control", "no-cache");
+        res.set_chunked_content_provider(
+            text_event_stream,
+            [this, interval, started = false, sentId = std::uint64_t{0}, sentMetrics = std::string(), quietFor = milliseconds{0}](std::size_t, httplib::DataSink& sink) mutable {
+                if (started && waitForStreamsStopping(interval))
+                {
+                    sink.done();
+                    return true;
+                }
+                started = true;
+
+                std::string message;
+                if (auto payload = telemetrySummaryHandler_())
+                {
+                    // generated_at_ms is stamped on every sample, so it is left out of the comparison.
+                    const auto generatedAt = payload->value("generated_at_ms", std::uint64_t{0});
+                    payload->erase("generated_at_ms");
+                    auto metrics = payload->dump();
+                    if (metrics != sentMetrics)
+                    {
+                        sentMetrics = std::move(metrics);
+                        (*payload)["generated_at_ms"] = generatedAt;
+                        message = helper::streams::make_event("telemetry", ++sentId, payload->dump());
+                    }
+                }
+
+                if (message.empty())
+                {
+                    quietFor += interval;
+                    if (quietFor < helper::streams::keepalive_interval)
+                    {
+                        return true;
+                    }
+                    message = helper::streams::keepalive;
+                }
+                quietFor = milliseconds{0};
+                return sink.write(message.data(), message.size());
+            },
+            [this](bool) { releaseStream(); });
+    });
+
+    server_.Get("/telemetry/history", [this](const httplib::Request& req, httplib::Response& res) {
+        if (!authorize(req, res))
+        {
+            return;
+        }
+
+        // A from/to/resolution query reads the telemetry store instead of the in-memory session history.
+        if (req.has_param("from") || req.has_param("to") || req.has_param("resolution"))
+        {
+            const auto param = [&req](const char* name, std::uint64_t fallback) -> std::optional<std::uint64_t> {
+                return req.has_param(name) ? parse_unsigned(req.get_param_value(name)) : fallback;
+            };
+            const auto to = param("to", now_ms());
+            const auto from = to ? param("from", *to > telemetry_range_default_ms ? *to - telemetry_range_default_ms : 0) : std::nullopt;
+            const auto resolution = param("resolution", 60 * 60 * 1000);
+            if (!to || !from || !resolution)
+            {
+                res.set_content(make_error("Parameters from, to and resolution must be unsigned integers").dump(), application_json);
+                res.status = 400;
+                return;
+            }
+
+            const auto toMs = *to;
+            const auto fromMs = *from;
+            const auto resolutionMs = *resolution;
+            if (fromMs >= toMs || resolutionMs < 1000 || (toMs - fromMs) / resolutionMs > telemetry_range_max_buckets)
+            {
+                res.set_content(make_error("Require from < to and a resolution of at least 1000 ms and at most " + std::to_string(telemetry_range_max_buckets) + " buckets").dump(), application_json);
+                res.status = 400;
+                return;
+            }
+
+            auto range = telemetryRangeHandler_ ? telemetryRangeHandler_(fromMs, toMs, resolutionMs) : std::nullopt;
+            if (!range.has_value())
+            {
+                res.set_content(make_error("Telemetry store unavailable").dump(), application_json);
+                res.status = 503;
+                return;
+            }
+
+            res.set_content(range->dump(), application_json);
+            res.status = 200;
+            return;
+        }
+
+        if (!telemetryHistoryHandler_)
         {
             res.set_content(make_error("Telemetry summary unavailable").dump(), application_json);
             res.status = 503;
             return;
         }
 
-        if (!payload->contains("history"))
+        const auto revision = telemetryHistoryRevision_ ? telemetryHistoryRevision_() : 0;
+        respondCached(req, res, "telemetry/history", revision, [this]() {
+            CachedResponse rendered;
+            auto payload = telemetryHistoryHandler_();
+            if (!payload.has_value())
+            {
+                rendered.status = 503;
+                rendered.body = make_error("Telemetry summary unavailable").dump();
+                return rendered;
+            }
+
+            if (!payload->contains("history") && !payload->contains("archive"))
+            {
+                rendered.status = 404;
+                rendered.body = make_error("Telemetry history unavailable").dump();
+                return rendered;
+            }
+
+            nlohmann::json response{
+                {"status", "ok"},
+                {"history", payload->value("history", nlohmann::json())}
+            };
+            if (payload->contains("archive"))
+            {
+                response["archive"] = std::move((*payload)["archive"]);
+            }
+
+            rendered.body = response.dump();
+            return rendered;
+        });
+    });
+
+    server_.Get("/logs/backfill", [this](const httplib::Request& req, httplib::Response& res) {
+        if (!authorize(req, res))
         {
-            res.set_content(make_error("Telemetry history unavailable").dump(), application_json);
-            res.status = 404;
             return;
         }
 
-        nlohmann::json response{
-            {"status", "ok"},
-            {"history", payload->at("history")}
-        };
+        auto payload = logBackfillStatusHandler_ ? logBackfillStatusHandler_() : std::nullopt;
+        if (!payload.has_value())
+        {
+            res.set_content(make_error("Log backfill unavailable").dump(), application_json);
+            res.status = 503;
+            return;
+        }
 
-        res.set_content(response.dump(), application_json);
+        res.set_content(payload->dump(), application_json);
         res.status = 200;
     });
 
+    server_.Post("/logs/backfill", [this](const httplib::Request& req, httplib::Response& res) {
+        if (!authorize(req, res))
+        {
+            return;
+        }
+
+        if (!logBackfillStartHandler_)
+        {
+            res.set_content(make_error("Log backfill unavailable").dump(), application_json);
+            res.status = 503;
+            return;
+        }
+
+        auto payload = logBackfillStartHandler_();
+        if (!payload.has_value())
+        {
+            res.set_content(make_error("Log backfill already running").dump(), application_json);
+            res.status = 409;
+            return;
+        }
+
+        res.set_content(payload->dump(), application_json);
+        res.status = 202;
+    });
+
     server_.Get("/settings/follow", [this](const httplib::Request& req, httplib::Response& res) {
         if (!authorize(req, res))
         {
@@ -1188,38 +1793,204 @@ void HelperServer::configureRoutes()
             return;
         }
 
-        const auto summary = getStarCatalogSummary();
+        std::uint64_t revision = 0;
+        {
+            std::lock_guard<std::mutex> guard(catalogMutex_);
+            revision = starCatalogRevision_;
+        }
 
-        nlohmann::json payload{
-            {"loaded", summary.loaded},
-            {"version", summary.version},
-            {"record_count", summary.record_count}
+        respondCached(req, res, "overlay/catalog", revision, [this]() {
+            const auto summary = getStarCatalogSummary();
+
+            nlohmann::json payload{
+                {"loaded", summary.loaded},
+                {"version", summary.version},
+                {"record_count", summary.record_count}
+            };
+
+            if (!summary.path.empty())
+            {
+                payload["path"] = summary.path.string();
+            }
+            else
+            {
+                payload["path"] = nullptr;
+            }
+
+            if (summary.loaded)
+            {
+                payload["bbox"] = {
+                    {"min", {summary.bbox_min.x, summary.bbox_min.y, summary.bbox_min.z}},
+                    {"max", {summary.bbox_max.x, summary.bbox_max.y, summary.bbox_max.z}}
+                };
+            }
+
+            if (!summary.error.empty())
+            {
+                payload["error"] = summary.error;
+            }
+
+            CachedResponse rendered;
+            rendered.status = summary.loaded ? 200 : 503;
+            rendered.body = payload.dump();
+            return rendered;
+        });
+    });
+
+    server_.Post("/route/compute", [this](const httplib::Request& req, httplib::Response& res) {
+        if (!authorize(req, res))
+        {
+            return;
+        }
+
+        if (!routeComputeHandler_)
+        {
+            res.set_content(make_error("Route planner unavailable").dump(), application_json);
+            res.status = 503;
+            return;
+        }
+
+        auto json = nlohmann::json::parse(req.body, nullptr, false);
+        if (json.is_discarded() || !json.is_object())
+        {
+            res.set_content(make_error("Request body must be a JSON object").dump(), application_json);
+            res.status = 400;
+            return;
+        }
+
+        // Systems may be given as numeric ids or names; ids are accepted as non-negative JSON integers or strings.
+        // Any other type yields nullopt, so a negative or fractional id is rejected rather than wrapped.
+        const auto readSystem = [&json](const char* key) -> std::optional<std::string> {
+            if (!json.contains(key))
+            {
+                return std::string{};
+            }
+            const auto& value = json[key];
+            if (value.is_string())
+            {
+                return value.get<std::string>();
+            }
+            if (value.is_number_unsigned())
+            {
+                return std::to_string(value.get<std::uint64_t>());
+            }
+            return std::nullopt;
         };
 
-        if (!summary.path.empty())
+        const auto origin = readSystem("from");
+        const auto destination = readSystem("to");
+        if (!origin || !destination)
         {
-            payload["path"] = summary.path.string();
+            res.set_content(make_error("Fields 'from' and 'to' must be system names or non-negative integer ids").dump(), application_json);
+            res.status = 400;
+            return;
+        }
+
+        helper::routing::RouteRequest request;
+        request.origin = *origin;
+        request.destination = *destination;
+        if (request.origin.empty() || request.destination.empty())
+        {
+            res.set_content(make_error("Fields 'from' and 'to' are required").dump(), application_json);
+            res.status = 400;
+            return;
+        }
+
+        if (!json.contains("max_jump_ly") || !json["max_jump_ly"].is_number())
+        {
+            res.set_content(make_error("Field 'max_jump_ly' must be a number").dump(), application_json);
+            res.status = 400;
+            return;
+        }
+        request.maxJumpLy = json["max_jump_ly"].get<double>();
+
+        if (json.contains("apply") && !json["apply"].is_boolean())
+        {
+            res.set_content(make_error("Field 'apply' must be a boolean").dump(), application_json);
+            res.status = 400;
+            return;
+        }
+
+        // json.value() throws type_error on a mistyped field, so types are checked before any value is read.
+        const auto optimize = json.contains("optimize") && !json["optimize"].is_string() ? std::string{} : json.value("optimize", std::string{"distance"});
+        if (optimize == "hops")
+        {
+            request.metric = helper::routing::RouteMetric::Hops;
+        }
+        else if (optimize == "distance")
+        {
+            request.metric = helper::routing::RouteMetric::Distance;
         }
         else
         {
-            payload["path"] = nullptr;
+            res.set_content(make_error("Field 'optimize' must be 'hops' or 'distance'").dump(), application_json);
+            res.status = 400;
+            return;
         }
 
-        if (summary.loaded)
+        const auto result = routeComputeHandler_(request);
+        if (!result.success)
         {
-            payload["bbox"] = {
-                {"min", {summary.bbox_min.x, summary.bbox_min.y, summary.bbox_min.z}},
-                {"max", {summary.bbox_max.x, summary.bbox_max.y, summary.bbox_max.z}}
-            };
+            res.set_content(make_error(result.error).dump(), application_json);
+            switch (result.failure)
+            {
+            case helper::routing::RouteFailure::InvalidRequest:
+                res.status = 400;
+                break;
+            case helper::routing::RouteFailure::UnknownSystem:
+                res.status = 404;
+                break;
+            case helper::routing::RouteFailure::CatalogUnavailable:
+                res.status = 503;
+                break;
+            default:
+                res.status = 422;
+                break;
+            }
+            return;
         }
 
-        if (!summary.error.empty())
+        overlay::OverlayState routeState;
+        routeState.route = result.route;
+        const auto routeJson = overlay::serialize_overlay_state(routeState)["route"];
+
+        // "apply": true publishes the route to the overlay, keeping the rest of the latest state intact.
+        bool applied = false;
+        if (json.value("apply", false))
         {
-            payload["error"] = summary.error;
+            overlay::OverlayState state;
+            if (const auto latest = latestOverlayStateJson())
+            {
+                try
+                {
+                    state = overlay::parse_overlay_state(*latest);
+                }
+                catch (const std::exception& ex)
+                {
+                    spdlog::warn("Route planner could not reuse latest overlay state: {}", ex.what());
+                    state = overlay::OverlayState{};
+                }
+            }
+
+            state.route = result.route;
+            state.active_route_node_id = state.route.size() > 1 ? std::optional<std::string>{state.route[1].system_id} : std::nullopt;
+            state.generated_at_ms = now_ms();
+            applied = ingestOverlayState(state, req.body.size(), "route-planner");
         }
 
+        const nlohmann::json payload{
+            {"status", "ok"},
+            {"route", routeJson},
+            {"hops", result.route.empty() ? 0 : result.route.size() - 1},
+            {"total_distance_ly", result.totalDistanceLy},
+            {"expanded_nodes", result.expandedNodes},
+            {"elapsed_ms", result.elapsedMs},
+            {"reused_search", result.reusedSearch},
+            {"applied", applied}
+        };
+
         res.set_content(payload.dump(), application_json);
-        res.status = summary.loaded ? 200 : 503;
+        res.status = 200;
     });
 
     server_.Post("/overlay/state", [this](const httplib::Request& req, httplib::Response& res) {
@@ -1288,98 +2059,74 @@ void HelperServer::configureRoutes()
         }
 
         const auto type = req.has_param("type") ? req.get_param_value("type") : "all";
+        if (type != "all" && type != "session" && type != "active-session")
+        {
+            res.set_content(make_error("Invalid type parameter (must be 'all', 'session', or 'active-session')").dump(), application_json);
+            res.status = 400;
+            return;
+        }
+        if (type == "session" && !req.has_param("session_id"))
+        {
+            res.set_content(make_error("session_id parameter required for type=session").dump(), application_json);
+            res.status = 400;
+            return;
+        }
+        const auto sessionId = type == "session" ? req.get_param_value("session_id") : std::string();
 
         try
         {
-            nlohmann::json payload;
+            respondCached(req, res, "session/visited-systems:" + type + ":" + sessionId, tracker->revision(), [&type, &sessionId, tracker]() {
+                CachedResponse rendered;
+                nlohmann::json payload;
 
-            if (type == "all")
-            {
-                auto data = tracker->getAllTimeData();
-                payload["version"] = data.version;
-                payload["tracking_enabled"] = data.tracking_enabled;
-                payload["last_updated_ms"] = data.last_updated_ms;
-                
-                nlohmann::json systems_obj = nlohmann::json::object();
-                for (const auto& [system_id, sys_data] : data.systems)
-                {
-                    systems_obj[system_id] = {
-                        {"name", sys_data.name},
-                        {"visits", sys_data.visits}
-                    };
-                }
-                payload["systems"] = systems_obj;
-            }
-            else if (type == "session")
-            {
-                if (!req.has_param("session_id"))
-                {
-                    res.set_content(make_error("session_id parameter required for type=session").dump(), application_json);
-                    res.status = 400;
-                    return;
-                }
-                const auto sessionId = req.get_param_value("session_id");
-                auto maybeSession = tracker->getSessionData(sessionId);
-                if (!maybeSession.has_value())
-                {
-                    res.set_content(make_error("Session not found").dump(), application_json);
-                    res.status = 404;
-                    return;
-                }
-                
-                auto& data = *maybeSession;
-                payload["version"] = data.version;
-                payload["session_id"] = data.session_id;
-                payload["start_time_ms"] = data.start_time_ms;
-                payload["end_time_ms"] = data.end_time_ms;
-                payload["active"] = data.active;
-                
-                nlohmann::json systems_obj = nlohmann::json::object();
-                for (const auto& [system_id, sys_data] : data.systems)
+                if (type == "all")
                 {
-                    systems_obj[system_id] = {
-                        {"name", sys_data.name},
-                        {"visits", sys_data.visits}
-                    };
-                }
-                payload["systems"] = systems_obj;
-            }
-            else if (type == "active-session")
-            {
-                auto maybeSession = tracker->getActiveSessionData();
-                if (!maybeSession.has_value())
-                {
-                    res.set_content(make_error("No active session").dump(), application_json);
-                    res.status = 404;
-                    return;
+                    auto data = tracker->getAllTimeData();
+                    payload["version"] = data.version;
+                    payload["tracking_enabled"] = data.tracking_enabled;
+                    payload["last_updated_ms"] = data.last_updated_ms;
+
+                    nlohmann::json systems_obj = nlohmann::json::object();
+                    for (const auto& [system_id, sys_data] : data.systems)
+                    {
+                        systems_obj[system_id] = {
+                            {"name", sys_data.name},
+                            {"visits", sys_data.visits}
+                        };
+                    }
+                    payload["systems"] = systems_obj;
                 }
-                
-                auto& data = *maybeSession;
-                payload["version"] = data.version;
-                payload["session_id"] = data.session_id;
-                payload["start_time_ms"] = data.start_time_ms;
-                payload["end_time_ms"] = data.end_time_ms;
-                payload["active"] = data.active;
-                
-                nlohmann::json systems_obj = nlohmann::json::object();
-                for (const auto& [system_id, sys_data] : data.systems)
+                else
                 {
-                    systems_obj[system_id] = {
-                        {"name", sys_data.name},
-                        {"visits", sys_data.visits}
-                    };
+                    auto maybeSession = type == "session" ? tracker->getSessionData(sessionId) : tracker->getActiveSessionData();
+                    if (!maybeSession.has_value())
+                    {
+                        rendered.status = 404;
+                        rendered.body = make_error(type == "session" ? "Session not found" : "No active session").dump();
+                        return rendered;
+                    }
+
+                    auto& data = *maybeSession;
+                    payload["version"] = data.version;
+                    payload["session_id"] = data.session_id;
+                    payload["start_time_ms"] = data.start_time_ms;
+                    payload["end_time_ms"] = data.end_time_ms;
+                    payload["active"] = data.active;
+
+                    nlohmann::json systems_obj = nlohmann::json::object();
+                    for (const auto& [system_id, sys_data] : data.systems)
+                    {
+                        systems_obj[system_id] = {
+                            {"name", sys_data.name},
+                            {"visits", sys_data.visits}
+                        };
+                    }
+                    payload["systems"] = systems_obj;
                 }
-                payload["systems"] = systems_obj;
-            }
-            else
-            {
-                res.set_content(make_error("Invalid type parameter (must be 'all', 'session', or 'active-session')").dump(), application_json);
-                res.status = 400;
-                return;
-            }
 
-            res.set_content(payload.dump(), application_json);
-            res.status = 200;
+                rendered.body = payload.dump();
+                return rendered;
+            });
         }
         catch (const std::exception& ex)
         {
@@ -1846,11 +2593,13 @@ void HelperServer::configureRoutes()
                 latestOverlayStateJson_["heartbeat_ms"] = now_ms();
                 const auto serialized = latestOverlayStateJson_.dump();
                 latestOverlayState_ = serialized;
+                latestOverlayStateStale_ = false;
+                noteOverlayStateChangeLocked();
 
                 const std::uint32_t version = latestOverlayStateJson_.value("version", overlay::schema_version);
                 const std::uint64_t generatedAt = latestOverlayStateJson_.value("generated_at_ms", 0ULL);
 
-                sharedMemoryWriter_.write(serialized, version, generatedAt);
+                publishSharedState(latestOverlayStateJson_, serialized, version, generatedAt);
                 
                 if (websocketHub_)
                 {
@@ -1907,6 +2656,7 @@ void HelperServer::recordOverlayEvents(std::vector<overlay::OverlayEvent> events
 
         droppedSnapshot = droppedEvents_;
     }
+    eventsChanged_.notify_all();
 
     if (!events.empty())
     {
@@ -1954,6 +2704,7 @@ void HelperServer::updateStarCatalogSummary(StarCatalogSummary summary)
 {
     std::lock_guard<std::mutex> guard(catalogMutex_);
     starCatalogSummary_ = std::move(summary);
+    ++starCatalogRevision_;
 }
 
 HelperServer::StarCatalogSummary HelperServer::getStarCatalogSummary() const
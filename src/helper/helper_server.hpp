@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <filesystem>
 #include <functional>
@@ -10,6 +11,7 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
 #include <httplib.h>
 #include <nlohmann/json.hpp>
@@ -18,6 +20,7 @@
 #include "shared_memory_channel.hpp"
 #include "event_channel.hpp"
 #include "helper_websocket.hpp"
+#include "route_planner.hpp"
 
 // Forward declaration
 namespace helper { class SessionTracker; }
@@ -91,10 +94,32 @@ public:
     void setFollowModeUpdateHandler(FollowModeUpdateHandler handler);
     bool updateFollowModeFlag(bool enabled);
 
+    using RouteComputeHandler = std::function<helper::routing::RouteResult(const helper::routing::RouteRequest&)>;
+    void setRouteComputeHandler(RouteComputeHandler handler);
+    // Called when a log-watcher update puts the player off the active route; returns the replacement route.
+    using RouteRepairHandler = std::function<std::optional<std::vector<overlay::RouteNode>>(const std::vector<overlay::RouteNode>&, const std::string&)>;
+    void setRouteRepairHandler(RouteRepairHandler handler);
+
     // Log path configuration
     using LogPathReloadHandler = std::function<void()>;
     void setLogPathReloadHandler(LogPathReloadHandler handler);
 
+    // Historical log backfill. The start handler returns std::nullopt while a run is in progress.
+    using LogBackfillHandler = std::function<std::optional<nlohmann::json>()>;
+    void setLogBackfillStatusHandler(LogBackfillHandler handler);
+    void setLogBackfillStartHandler(LogBackfillHandler handler);
+
+    // Answers /telemetry/history without a range: {"history": ..., "archive": ...} with the in-memory session
+    // history and the hourly totals of the telemetry store, either of which may be absent. The revision must change
+    // whenever that payload would, so the rendered response is reused until it does.
+    using TelemetryHistoryHandler = std::function<std::optional<nlohmann::json>()>;
+    using RevisionProvider = std::function<std::uint64_t()>;
+    void setTelemetryHistoryHandler(TelemetryHistoryHandler handler, RevisionProvider revision);
+
+    // Answers /telemetry/history?from=&to=&resolution= (UTC ms) from the on-disk telemetry store.
+    using TelemetryRangeHandler = std::function<std::optional<nlohmann::json>(std::uint64_t fromMs, std::uint64_t toMs, std::uint64_t resolutionMs)>;
+    void setTelemetryRangeHandler(TelemetryRangeHandler handler);
+
     // Direct update methods for instant state sync (similar to follow mode)
     bool updateTrackingFlag(bool enabled);
     bool updateSessionState(bool hasActiveSession, std::optional<std::string> sessionId);
@@ -108,11 +133,33 @@ public:
     // Broadcast JSON message to all connected WebSocket clients
     void broadcastWebSocketMessage(const nlohmann::json& message);
 
+    // Shared memory normally carries the binary state encoding; JSON is kept for debugging and older overlays.
+    void setSharedStateJson(bool enabled) { sharedStateJson_.store(enabled); }
+
 private:
     void configureRoutes();
     bool authorize(const httplib::Request& req, httplib::Response& res) const;
     long long uptimeMilliseconds() const;
     std::optional<nlohmann::json> latestOverlayStateJson() const;
+    std::string latestOverlayStateTextLocked();
+    bool acquireStream();
+    void releaseStream();
+    bool waitForStreamsStopping(std::chrono::milliseconds timeout);
+    void wakeStreams();
+    void noteOverlayStateChangeLocked();
+
+    // A rendered 200 response and its strong ETag, reused until the revision it was rendered at moves on.
+    struct CachedResponse
+    {
+        std::uint64_t revision{0};
+        int status{200};
+        std::string body;
+        std::string etag;
+    };
+    using ResponseRenderer = std::function<CachedResponse()>;
+    void respondCached(const httplib::Request& req, httplib::Response& res, const std::string& key, std::uint64_t revision, const ResponseRenderer& render);
+    bool publishSharedState(const overlay::OverlayState& state, const std::string& serialized);
+    bool publishSharedState(const nlohmann::json& stateJson, const std::string& serialized, std::uint32_t version, std::uint64_t generatedAt);
 
     std::string host_;
     int port_;
@@ -125,12 +172,17 @@ private:
 
     mutable std::mutex overlayStateMutex_;
     std::string latestOverlayState_;
+    bool latestOverlayStateStale_{false};   // heartbeat_ms in the JSON is newer than the cached text
+    std::uint64_t overlayStateGeneration_{0};   // bumped by every state change except a heartbeat tick
+    std::uint64_t overlayStateRevision_{0};     // bumped by those and heartbeat ticks: the served text changed
+    std::condition_variable overlayStateChanged_;
     nlohmann::json latestOverlayStateJson_;
     std::uint64_t lastOverlayGeneratedAtMs_{0};
     std::chrono::system_clock::time_point lastOverlayAcceptedAt_{};
     std::string authToken_;
     bool requireAuth_{false};
     overlay::SharedMemoryWriter sharedMemoryWriter_;
+    std::atomic_bool sharedStateJson_{false};
 
     struct EventRecord
     {
@@ -142,8 +194,17 @@ private:
     std::deque<EventRecord> recentEvents_;
     std::uint64_t nextEventId_{1};
     std::uint32_t droppedEvents_{0};
+    std::condition_variable eventsChanged_;
     static constexpr std::size_t maxEventBuffer_ = 128;
 
+    // Server-sent event streams and long polls each hold an httplib worker thread until they return, so
+    // only a few may be open at once; stop() wakes them all so the worker pool can be joined.
+    std::atomic_int openStreams_{0};
+    std::atomic_bool streamsStopping_{false};
+    std::mutex streamsMutex_;
+    std::condition_variable streamsStopped_;
+    static constexpr int maxOpenStreams_ = 4;
+
     std::unique_ptr<helper::ws::HelperWebSocketHub> websocketHub_;
     int websocketPort_{0};
 
@@ -151,8 +212,34 @@ private:
     std::thread heartbeatThread_;
     std::chrono::milliseconds heartbeatInterval_{std::chrono::milliseconds{2000}};
 
+    // Off-route repairs run on their own thread so a slow search never holds up the log watcher. Only the
+    // latest request is kept; a newer jump replaces one that has not started yet.
+    struct RouteRepairJob
+    {
+        std::vector<overlay::RouteNode> route;
+        nlohmann::json routeJson;   // the published route the repair replaces
+        std::string currentSystemId;
+        std::string currentSystemName;
+    };
+
+    void startRouteRepair();
+    void stopRouteRepair();
+    void scheduleRouteRepair(RouteRepairJob job);
+    void applyRouteRepair(const RouteRepairJob& job, std::vector<overlay::RouteNode> repaired);
+
+    std::mutex routeRepairMutex_;
+    std::condition_variable routeRepairRequested_;
+    std::optional<RouteRepairJob> pendingRouteRepair_;
+    bool routeRepairRunning_{false};
+    std::thread routeRepairThread_;
+
     mutable std::mutex catalogMutex_;
     StarCatalogSummary starCatalogSummary_{};
+    std::uint64_t starCatalogRevision_{0};
+
+    std::mutex responseCacheMutex_;
+    std::unordered_map<std::string, std::shared_ptr<const CachedResponse>> responseCache_;
+    static constexpr std::size_t maxCachedResponses_ = 32;
 
     TelemetrySummaryHandler telemetrySummaryHandler_{};
     TelemetryResetHandler telemetryResetHandler_{};
@@ -161,6 +248,13 @@ private:
     FollowModeUpdateHandler followModeUpdateHandler_{};
     SessionTrackerProvider sessionTrackerProvider_{};
     LogPathReloadHandler logPathReloadHandler_{};
+    LogBackfillHandler logBackfillStatusHandler_{};
+    LogBackfillHandler logBackfillStartHandler_{};
+    TelemetryHistoryHandler telemetryHistoryHandler_{};
+    RevisionProvider telemetryHistoryRevision_{};
+    TelemetryRangeHandler telemetryRangeHandler_{};
+    RouteComputeHandler routeComputeHandler_{};
+    RouteRepairHandler routeRepairHandler_{};
 
     mutable std::mutex pscanMutex_;
     std::optional<overlay::PscanData> latestPscanData_{};
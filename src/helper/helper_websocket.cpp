@@ -1,15 +1,18 @@
 #include "helper_websocket.hpp"
 
-#include <bcrypt.h>
-#include <windows.h>
+#include "overlay_schema.hpp"
+#include "overlay_state_binary.hpp"
 
 #include <spdlog/spdlog.h>
-#include <httplib.h>
+#include <zlib.h>
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
 #include <cctype>
+#include <cstring>
+#include <deque>
 #include <sstream>
 #include <string_view>
 #include <unordered_map>
@@ -19,61 +22,210 @@
 namespace
 {
     constexpr const char* websocket_guid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    constexpr std::size_t max_handshake_bytes = 16384;
+    constexpr std::size_t max_inbound_payload = 64 * 1024;   // browsers only send control frames
+    constexpr std::size_t frame_error = static_cast<std::size_t>(-1);
+    constexpr std::size_t max_gathered_frames = 16;           // frames handed to one gathered write
+    constexpr auto ping_interval = std::chrono::seconds(15);
 
-    std::string sha1_base64(const std::string& value)
+    std::array<std::uint8_t, 20> sha1(std::string_view data)
     {
-        BCRYPT_ALG_HANDLE algorithm = nullptr;
-        BCRYPT_HASH_HANDLE hash = nullptr;
-        DWORD objectLength = 0;
-        DWORD hashLength = 0;
-        DWORD cbData = 0;
+        std::array<std::uint32_t, 5> h{0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u};
 
-        NTSTATUS status = BCryptOpenAlgorithmProvider(&algorithm, BCRYPT_SHA1_ALGORITHM, nullptr, 0);
-        if (!BCRYPT_SUCCESS(status))
+        std::string message(data);
+        const auto bitLength = static_cast<std::uint64_t>(data.size()) * 8;
+        message.push_back(static_cast<char>(0x80));
+        while (message.size() % 64 != 56)
         {
-            return {};
+            message.push_back('\0');
+        }
+        for (int i = 7; i >= 0; --i)
+        {
+            message.push_back(static_cast<char>((bitLength >> (i * 8)) & 0xFF));
         }
 
-        status = BCryptGetProperty(algorithm, BCRYPT_OBJECT_LENGTH, reinterpret_cast<PUCHAR>(&objectLength), sizeof(DWORD), &cbData, 0);
-        if (!BCRYPT_SUCCESS(status))
+        for (std::size_t chunk = 0; chunk < message.size(); chunk += 64)
         {
-            BCryptCloseAlgorithmProvider(algorithm, 0);
-            return {};
+            std::array<std::uint32_t, 80> w{};
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                const auto* bytes = reinterpret_cast<const unsigned char*>(message.data() + chunk + i * 4);
+                w[i] = static_cast<std::uint32_t>(bytes[0]) << 24 | static_cast<std::uint32_t>(bytes[1]) << 16 |
+                    static_cast<std::uint32_t>(bytes[2]) << 8 | static_cast<std::uint32_t>(bytes[3]);
+            }
+            for (std::size_t i = 16; i < 80; ++i)
+            {
+                w[i] = std::rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+            }
+
+            auto a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (std::size_t i = 0; i < 80; ++i)
+            {
+                std::uint32_t f = 0;
+                std::uint32_t k = 0;
+                if (i < 20)
+                {
+                    f = (b & c) | (~b & d);
+                    k = 0x5A827999u;
+                }
+                else if (i < 40)
+                {
+                    f = b ^ c ^ d;
+                    k = 0x6ED9EBA1u;
+                }
+                else if (i < 60)
+                {
+                    f = (b & c) | (b & d) | (c & d);
+                    k = 0x8F1BBCDCu;
+                }
+                else
+                {
+                    f = b ^ c ^ d;
+                    k = 0xCA62C1D6u;
+                }
+                const auto temp = std::rotl(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = std::rotl(b, 30);
+                b = a;
+                a = temp;
+            }
+            h[0] += a;
+            h[1] += b;
+            h[2] += c;
+            h[3] += d;
+            h[4] += e;
         }
 
-        status = BCryptGetProperty(algorithm, BCRYPT_HASH_LENGTH, reinterpret_cast<PUCHAR>(&hashLength), sizeof(DWORD), &cbData, 0);
-        if (!BCRYPT_SUCCESS(status))
+        std::array<std::uint8_t, 20> digest{};
+        for (std::size_t i = 0; i < 20; ++i)
         {
-            BCryptCloseAlgorithmProvider(algorithm, 0);
-            return {};
+            digest[i] = static_cast<std::uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
         }
+        return digest;
+    }
 
-        std::vector<UCHAR> hashObject(objectLength);
-        std::vector<UCHAR> hashBuffer(hashLength);
+    std::string base64_encode(const std::uint8_t* data, std::size_t length)
+    {
+        static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string result;
+        result.reserve((length + 2) / 3 * 4);
+        for (std::size_t i = 0; i < length; i += 3)
+        {
+            const std::uint32_t chunk = static_cast<std::uint32_t>(data[i]) << 16 |
+                (i + 1 < length ? static_cast<std::uint32_t>(data[i + 1]) << 8 : 0) |
+                (i + 2 < length ? static_cast<std::uint32_t>(data[i + 2]) : 0);
+            result.push_back(alphabet[(chunk >> 18) & 0x3F]);
+            result.push_back(alphabet[(chunk >> 12) & 0x3F]);
+            result.push_back(i + 1 < length ? alphabet[(chunk >> 6) & 0x3F] : '=');
+            result.push_back(i + 2 < length ? alphabet[chunk & 0x3F] : '=');
+        }
+        return result;
+    }
+
+    // Sec-WebSocket-Accept for a client key (RFC 6455 section 4.2.2).
+    std::string websocket_accept_key(const std::string& key)
+    {
+        const auto digest = sha1(key + websocket_guid);
+        return base64_encode(digest.data(), digest.size());
+    }
+
+    struct InboundFrame
+    {
+        unsigned char opcode{0};
+        std::string payload;
+    };
 
-        status = BCryptCreateHash(algorithm, &hash, hashObject.data(), objectLength, nullptr, 0, 0);
-        if (!BCRYPT_SUCCESS(status))
+    // Decodes the frame at the start of `data`. Returns the bytes it spans, 0 while it is incomplete, or
+    // frame_error for fragmented or oversized frames.
+    std::size_t parse_frame(std::string_view data, InboundFrame& frame)
+    {
+        if (data.size() < 2)
         {
-            BCryptCloseAlgorithmProvider(algorithm, 0);
-            return {};
+            return 0;
         }
 
-    status = BCryptHashData(hash, reinterpret_cast<PUCHAR>(const_cast<char*>(value.data())), static_cast<ULONG>(value.size()), 0);
-        if (BCRYPT_SUCCESS(status))
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+        const bool fin = (bytes[0] & 0x80) != 0;
+        const bool masked = (bytes[1] & 0x80) != 0;
+        std::uint64_t payloadLength = bytes[1] & 0x7F;
+        std::size_t offset = 2;
+
+        if (payloadLength == 126)
         {
-            status = BCryptFinishHash(hash, hashBuffer.data(), hashLength, 0);
+            if (data.size() < 4)
+            {
+                return 0;
+            }
+            payloadLength = static_cast<std::uint64_t>(bytes[2]) << 8 | static_cast<std::uint64_t>(bytes[3]);
+            offset = 4;
+        }
+        else if (payloadLength == 127)
+        {
+            if (data.size() < 10)
+            {
+                return 0;
+            }
+            payloadLength = 0;
+            for (std::size_t i = 2; i < 10; ++i)
+            {
+                payloadLength = (payloadLength << 8) | bytes[i];
+            }
+            offset = 10;
         }
 
-        BCryptDestroyHash(hash);
-        BCryptCloseAlgorithmProvider(algorithm, 0);
+        if (!fin || payloadLength > max_inbound_payload)
+        {
+            return frame_error;
+        }
 
-        if (!BCRYPT_SUCCESS(status))
+        std::array<unsigned char, 4> mask{};
+        if (masked)
         {
-            return {};
+            if (data.size() < offset + 4)
+            {
+                return 0;
+            }
+            std::copy_n(bytes + offset, 4, mask.begin());
+            offset += 4;
+        }
+
+        if (data.size() - offset < payloadLength)
+        {
+            return 0;
         }
 
-    const std::string hashString(reinterpret_cast<const char*>(hashBuffer.data()), hashBuffer.size());
-    return httplib::detail::base64_encode(hashString);
+        frame.opcode = bytes[0] & 0x0F;
+        frame.payload.assign(data.substr(offset, static_cast<std::size_t>(payloadLength)));
+        if (masked)
+        {
+            for (std::size_t i = 0; i < frame.payload.size(); ++i)
+            {
+                frame.payload[i] = static_cast<char>(frame.payload[i] ^ mask[i % 4]);
+            }
+        }
+        return offset + static_cast<std::size_t>(payloadLength);
+    }
+
+    // `envelope` serialized with "sequence" added, without copying the state it carries. nlohmann::json
+    // orders object keys, so the result matches dumping a copy with the key set.
+    std::string serialize_with_sequence(const nlohmann::json& envelope, std::uint64_t sequence)
+    {
+        if (!envelope.is_object() || envelope.contains("sequence") || (!envelope.empty() && envelope.begin().key() < "sequence"))
+        {
+            auto copy = envelope;
+            copy["sequence"] = sequence;
+            return copy.dump();
+        }
+
+        const auto rest = envelope.dump();
+        std::string result = "{\"sequence\":" + std::to_string(sequence);
+        if (rest.size() > 2)
+        {
+            result.push_back(',');
+        }
+        result.append(rest, 1, std::string::npos);
+        return result;
     }
 
     std::string to_lower(std::string value)
@@ -137,52 +289,243 @@ namespace
         }
         return value.substr(begin, end - begin + 1);
     }
+
+    // Raw DEFLATE for permessage-deflate (RFC 7692). With context takeover the window carries over from one
+    // message to the next, so a message repeating most of the previous one compresses to a few bytes.
+    class MessageDeflater
+    {
+    public:
+        MessageDeflater(int windowBits, bool contextTakeover)
+            : contextTakeover_(contextTakeover)
+        {
+            ok_ = deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        }
+
+        ~MessageDeflater()
+        {
+            if (ok_)
+            {
+                deflateEnd(&stream_);
+            }
+        }
+
+        MessageDeflater(const MessageDeflater&) = delete;
+        MessageDeflater& operator=(const MessageDeflater&) = delete;
+
+        bool compress(std::string_view input, std::string& output)
+        {
+            if (!ok_ || (!contextTakeover_ && deflateReset(&stream_) != Z_OK))
+            {
+                return false;
+            }
+
+            output.clear();
+            stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+            stream_.avail_in = static_cast<uInt>(input.size());
+            std::size_t produced = 0;
+            do
+            {
+                output.resize(std::max<std::size_t>(output.size() * 2, input.size() / 4 + 64));
+                stream_.next_out = reinterpret_cast<Bytef*>(output.data() + produced);
+                stream_.avail_out = static_cast<uInt>(output.size() - produced);
+                const auto result = deflate(&stream_, Z_SYNC_FLUSH);
+                if (result != Z_OK && result != Z_BUF_ERROR)
+                {
+                    return false;
+                }
+                produced = output.size() - stream_.avail_out;
+            } while (stream_.avail_out == 0);
+            output.resize(produced);
+
+            // A sync flush ends in the empty stored block 00 00 FF FF, which the receiver appends back.
+            if (output.size() >= 4 && std::memcmp(output.data() + output.size() - 4, "\x00\x00\xff\xff", 4) == 0)
+            {
+                output.resize(output.size() - 4);
+            }
+            return true;
+        }
+
+    private:
+        z_stream stream_{};
+        bool ok_{false};
+        bool contextTakeover_;
+    };
+
+    struct DeflateParameters
+    {
+        int serverWindowBits{15};
+        bool serverWindowBitsRequested{false};
+        bool serverNoContextTakeover{false};
+    };
+
+    // Picks the first permessage-deflate offer in a Sec-WebSocket-Extensions header this hub can honour. Client
+    // messages are never inflated (browsers only send control frames, which are not compressed), so the
+    // client_* parameters need no support.
+    std::optional<DeflateParameters> negotiate_permessage_deflate(const std::string& header)
+    {
+        std::size_t offerStart = 0;
+        while (offerStart <= header.size())
+        {
+            auto offerEnd = header.find(',', offerStart);
+            if (offerEnd == std::string::npos)
+            {
+                offerEnd = header.size();
+            }
+            const auto offer = header.substr(offerStart, offerEnd - offerStart);
+            offerStart = offerEnd + 1;
+
+            DeflateParameters parameters;
+            bool acceptable = true;
+            std::size_t paramStart = 0;
+            for (bool first = true; acceptable && paramStart <= offer.size(); first = false)
+            {
+                auto paramEnd = offer.find(';', paramStart);
+                if (paramEnd == std::string::npos)
+                {
+                    paramEnd = offer.size();
+                }
+                const auto param = make_trimmed(offer.substr(paramStart, paramEnd - paramStart));
+                paramStart = paramEnd + 1;
+
+                const auto eq = param.find('=');
+                const auto name = to_lower(make_trimmed(param.substr(0, eq)));
+                auto value = eq == std::string::npos ? std::string{} : make_trimmed(param.substr(eq + 1));
+                if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+                {
+                    value = value.substr(1, value.size() - 2);
+                }
+
+                if (first)
+                {
+                    acceptable = name == "permessage-deflate";
+                }
+                else if (name == "server_no_context_takeover")
+                {
+                    parameters.serverNoContextTakeover = true;
+                }
+                else if (name == "server_max_window_bits")
+                {
+                    // zlib has no raw 8-bit window.
+                    const auto bits = std::atoi(value.c_str());
+                    acceptable = bits >= 9 && bits <= 15;
+                    parameters.serverWindowBits = bits;
+                    parameters.serverWindowBitsRequested = true;
+                }
+                else
+                {
+                    acceptable = name == "client_no_context_takeover" || name == "client_max_window_bits";
+                }
+            }
+
+            if (acceptable)
+            {
+                return parameters;
+            }
+        }
+        return std::nullopt;
+    }
 }
 
 namespace helper::ws
 {
-    struct HelperWebSocketHub::Client
+    enum class HelperWebSocketHub::FrameKind : std::uint8_t
     {
-        explicit Client(asio::ip::tcp::socket socket)
-            : socket(std::move(socket))
+        Control,        // handshake response, hello and close; each sent at most once, never dropped
+        Pong,           // at most one queued per client; a newer ping's pong replaces it (RFC 6455 5.5.3)
+        Message,        // pings, events and telemetry; the oldest goes first when the queue is full
+        OverlayState,   // at most one queued per client; a newer state replaces it
+    };
+
+    // An unfragmented, unmasked server frame. The payload is the serialized message itself, written after the
+    // header in the same gathered write, so framing never copies it. Immutable once built.
+    struct HelperWebSocketHub::WireFrame
+    {
+        // Raw bytes sent as they are: the HTTP handshake response.
+        explicit WireFrame(std::string raw)
+            : payload(std::move(raw))
         {
         }
 
-        ~Client()
+        WireFrame(unsigned char opcode, std::string text, bool compressed = false)
+            : payload(std::move(text))
         {
-            // Signal thread to exit
-            running.store(false);
-            
-            // Close socket to unblock any pending reads
-            asio::error_code ec;
-            socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
-            socket.close(ec);
-            
-            // Wait for thread to exit (with timeout)
-            if (readerThread.joinable())
+            header[0] = static_cast<unsigned char>(0x80 | (compressed ? 0x40 : 0) | opcode);
+            const auto len = payload.size();
+            if (len <= 125)
+            {
+                header[1] = static_cast<unsigned char>(len);
+                headerSize = 2;
+            }
+            else if (len <= 65535)
+            {
+                header[1] = 126;
+                header[2] = static_cast<unsigned char>((len >> 8) & 0xFF);
+                header[3] = static_cast<unsigned char>(len & 0xFF);
+                headerSize = 4;
+            }
+            else
             {
-                // Give thread a moment to exit gracefully
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                
-                // If still joinable, just detach to avoid blocking destructor
-                if (readerThread.joinable())
+                header[1] = 127;
+                const auto bigLen = static_cast<std::uint64_t>(len);
+                for (std::size_t i = 0; i < 8; ++i)
                 {
-                    readerThread.detach();
+                    header[2 + i] = static_cast<unsigned char>((bigLen >> ((7 - i) * 8)) & 0xFF);
                 }
+                headerSize = 10;
             }
         }
 
-        asio::ip::tcp::socket socket;
-        std::mutex writeMutex;
-        std::thread readerThread;
-        std::atomic_bool running{true};
+        unsigned char opcode() const { return header[0] & 0x0F; }
+
+        // Text and binary messages; control frames and the handshake response are never compressed.
+        bool compressible() const { return headerSize != 0 && (opcode() == 0x1 || opcode() == 0x2); }
+
+        std::array<unsigned char, 10> header{};
+        std::size_t headerSize{0};
+        std::string payload;
+    };
+
+    struct HelperWebSocketHub::Client
+    {
+        struct Outgoing
+        {
+            SharedFrame frame;
+            FrameKind kind;
+        };
+
+        explicit Client(asio::ip::tcp::socket socket)
+            : socket(std::move(socket))
+        {
+            asio::error_code ec;
+            const auto endpoint = this->socket.remote_endpoint(ec);
+            if (!ec)
+            {
+                remoteAddress = endpoint.address().to_string();
+            }
+        }
+
+        asio::ip::tcp::socket socket;   // bound to the client's strand; every member below runs on it
         std::string remoteAddress;
+        bool wantsPatches{false};
+        bool binaryState{false};
+        std::unique_ptr<MessageDeflater> deflater;   // set when permessage-deflate was negotiated
+        bool upgraded{false};           // guarded by clientsMutex_: broadcasts skip clients mid-handshake
+
+        std::array<char, 4096> readBuffer{};
+        std::string inbound;
+        std::deque<Outgoing> queue;     // the first `writing` frames are on the wire
+        std::size_t writing{0};
+        std::vector<WireFrame> compressed;  // this client's compressed copies of the frames being written
+        bool closeWhenFlushed{false};
+        bool closed{false};
     };
 
     HelperWebSocketHub::HelperWebSocketHub(Config config)
         : config_(std::move(config))
         , io_()
-        , acceptor_(io_)
+        , strand_(asio::make_strand(io_))
+        , acceptor_(strand_)
+        , pingTimer_(strand_)
     {
     }
 
@@ -227,7 +570,7 @@ namespace helper::ws
         if (ec)
         {
             spdlog::error("[ws] failed to bind {}:{} - {}", config_.host, config_.port, ec.message());
-            acceptor_.close();
+            acceptor_.close(ec);
             running_.store(false);
             return false;
         }
@@ -236,7 +579,7 @@ namespace helper::ws
         if (ec)
         {
             spdlog::error("[ws] listen failed: {}", ec.message());
-            acceptor_.close();
+            acceptor_.close(ec);
             running_.store(false);
             return false;
         }
@@ -244,26 +587,31 @@ namespace helper::ws
         // Update port if caller requested dynamic port 0
         config_.port = static_cast<int>(acceptor_.local_endpoint().port());
 
-        acceptThread_ = std::thread([this]() {
-            acceptLoop();
-        });
+        io_.restart();
+        work_.emplace(io_.get_executor());
+        startAccept();
+        startPingTimer();
 
-        pingThread_ = std::thread([this]() {
-            using namespace std::chrono_literals;
-            while (running_.load())
-            {
-                std::this_thread::sleep_for(15s);
-                if (!running_.load())
+        const auto threadCount = std::max<std::size_t>(1, config_.threads);
+        for (std::size_t i = 0; i < threadCount; ++i)
+        {
+            threads_.emplace_back([this]() {
+                for (;;)
                 {
-                    break;
+                    try
+                    {
+                        io_.run();
+                        return;
+                    }
+                    catch (const std::exception& ex)
+                    {
+                        spdlog::error("[ws] handler failed: {}", ex.what());
+                    }
                 }
+            });
+        }
 
-                nlohmann::json ping{{"type", "ping"}, {"now_ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()}};
-                broadcastJson(ping);
-            }
-        });
-
-        spdlog::info("Helper WebSocket hub listening on {}:{}", config_.host, config_.port);
+        spdlog::info("Helper WebSocket hub listening on {}:{} ({} threads)", config_.host, config_.port, threadCount);
         return true;
     }
 
@@ -274,221 +622,249 @@ namespace helper::ws
             return;
         }
 
-        asio::error_code ec;
-        acceptor_.cancel(ec);
-        acceptor_.close(ec);
+        asio::post(strand_, [this]() {
+            asio::error_code ec;
+            acceptor_.close(ec);
+            pingTimer_.cancel();
+        });
 
-        if (acceptThread_.joinable())
+        std::vector<std::shared_ptr<Client>> clients;
         {
-            acceptThread_.join();
+            std::lock_guard<std::mutex> guard(clientsMutex_);
+            clients = clients_;
         }
-
-        if (pingThread_.joinable())
+        for (const auto& client : clients)
         {
-            pingThread_.join();
+            asio::post(client->socket.get_executor(), [this, client]() {
+                closeClient(client);
+            });
         }
 
-        std::vector<std::shared_ptr<Client>> clients;
+        // With the sockets closed every pending operation completes, nothing re-arms and run() returns.
+        work_.reset();
+        for (auto& thread : threads_)
         {
-            std::lock_guard<std::mutex> guard(clientsMutex_);
-            for (auto& weak : clients_)
+            if (thread.joinable())
             {
-                if (auto locked = weak.lock())
-                {
-                    clients.push_back(std::move(locked));
-                }
+                thread.join();
             }
-            clients_.clear();
         }
+        threads_.clear();
 
-        for (auto& client : clients)
         {
-            client->running.store(false);
-            client->socket.close();
-            if (client->readerThread.joinable())
-            {
-                client->readerThread.join();
-            }
+            std::lock_guard<std::mutex> guard(clientsMutex_);
+            clients_.clear();
         }
 
         spdlog::info("Helper WebSocket hub stopped");
     }
 
+    HelperWebSocketHub::Stats HelperWebSocketHub::stats() const
+    {
+        Stats stats;
+        {
+            std::lock_guard<std::mutex> guard(clientsMutex_);
+            stats.clients = static_cast<std::size_t>(std::count_if(clients_.begin(), clients_.end(), [](const auto& client) {
+                return client->upgraded;
+            }));
+        }
+        stats.framesQueued = framesQueued_.load(std::memory_order_relaxed);
+        stats.framesCoalesced = framesCoalesced_.load(std::memory_order_relaxed);
+        stats.framesDropped = framesDropped_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
     void HelperWebSocketHub::broadcastJson(const nlohmann::json& message)
     {
-        const auto serialized = message.dump();
+        const auto frame = std::make_shared<const WireFrame>(0x1, message.dump());
 
         std::lock_guard<std::mutex> guard(clientsMutex_);
-        for (auto it = clients_.begin(); it != clients_.end();)
+        for (const auto& client : clients_)
         {
-            if (auto client = it->lock())
+            if (client->upgraded)
             {
-                try
-                {
-                    if (!sendText(client, serialized))
-                    {
-                        client->running.store(false);
-                        // Don't join here - let client cleanup happen naturally or in stop()
-                        // Joining from broadcast thread can cause deadlock
-                        it = clients_.erase(it);
-                        continue;
-                    }
-                }
-                catch (const std::exception& ex)
-                {
-                    spdlog::debug("[ws] broadcastJson exception for client {}: {}", client->remoteAddress, ex.what());
-                    client->running.store(false);
-                    // Don't join here - let client cleanup happen naturally or in stop()
-                    it = clients_.erase(it);
-                    continue;
-                }
-                ++it;
-            }
-            else
-            {
-                it = clients_.erase(it);
+                postFrame(client, frame, FrameKind::Message);
             }
         }
     }
 
     void HelperWebSocketHub::broadcastOverlayState(const nlohmann::json& state)
     {
-        const auto serialized = state.dump();
-
         std::lock_guard<std::mutex> guard(clientsMutex_);
-        for (auto it = clients_.begin(); it != clients_.end();)
+
+        // Patches are computed once per broadcast; the sequence only advances when the state changed, so a
+        // patch client's base always matches the last message it was sent.
+        SharedFrame patchFrame;
+        bool unchanged = false;
+        const auto stateIt = state.find("state");
+        if (stateIt != state.end())
         {
-            if (auto client = it->lock())
+            if (overlayStateSequence_ != 0)
             {
-                try
+                auto patch = overlay::diff_overlay_state_json(lastOverlayState_, *stateIt);
+                if (patch.empty())
                 {
-                    if (!sendText(client, serialized))
-                    {
-                        client->running.store(false);
-                        // Don't join here - let client cleanup happen naturally or in stop()
-                        it = clients_.erase(it);
-                        continue;
-                    }
+                    unchanged = true;
                 }
-                catch (const std::exception& ex)
+                else
                 {
-                    spdlog::debug("[ws] broadcastOverlayState exception for client {}: {}", client->remoteAddress, ex.what());
-                    client->running.store(false);
-                    // Don't join here - let client cleanup happen naturally or in stop()
-                    it = clients_.erase(it);
-                    continue;
+                    nlohmann::json message{
+                        {"type", "overlay_state_patch"},
+                        {"base_sequence", overlayStateSequence_},
+                        {"sequence", overlayStateSequence_ + 1},
+                        {"patch", std::move(patch)}
+                    };
+                    patchFrame = std::make_shared<const WireFrame>(0x1, message.dump());
                 }
-                ++it;
             }
-            else
+
+            if (!unchanged)
             {
-                it = clients_.erase(it);
+                ++overlayStateSequence_;
+                lastOverlayState_ = *stateIt;
             }
         }
-    }
 
-    void HelperWebSocketHub::broadcastEventBatch(nlohmann::json batch)
-    {
-        batch["type"] = "overlay_events";
-        const auto serialized = batch.dump();
+        const auto fullFrame = std::make_shared<const WireFrame>(0x1, serialize_with_sequence(state, overlayStateSequence_));
+        SharedFrame binaryFrame;
+        if (stateIt != state.end())
+        {
+            lastOverlayStateFrame_ = fullFrame;
+            const bool binaryClients = std::any_of(clients_.begin(), clients_.end(), [](const auto& client) {
+                return client->upgraded && client->binaryState;
+            });
+            binaryFrame = binaryClients ? makeBinaryStateFrame(*stateIt, overlayStateSequence_) : nullptr;
+            lastOverlayStateBinaryFrame_ = binaryFrame;
+        }
 
-        std::lock_guard<std::mutex> guard(clientsMutex_);
-        for (auto it = clients_.begin(); it != clients_.end();)
+        for (const auto& client : clients_)
         {
-            if (auto client = it->lock())
+            if (!client->upgraded || (client->wantsPatches && unchanged))
             {
-                try
-                {
-                    if (!sendText(client, serialized))
-                    {
-                        client->running.store(false);
-                        // Don't join here - let client cleanup happen naturally or in stop()
-                        it = clients_.erase(it);
-                        continue;
-                    }
-                }
-                catch (const std::exception& ex)
-                {
-                    spdlog::debug("[ws] broadcastEventBatch exception for client {}: {}", client->remoteAddress, ex.what());
-                    client->running.store(false);
-                    // Don't join here - let client cleanup happen naturally or in stop()
-                    it = clients_.erase(it);
-                    continue;
-                }
-                ++it;
+                continue;
+            }
+
+            if (client->binaryState && binaryFrame)
+            {
+                postFrame(client, binaryFrame, FrameKind::OverlayState);
+            }
+            else if (client->wantsPatches && patchFrame)
+            {
+                // Should the patch have to be coalesced, the full envelope replaces it.
+                postFrame(client, patchFrame, FrameKind::OverlayState, fullFrame);
             }
             else
             {
-                it = clients_.erase(it);
+                postFrame(client, fullFrame, FrameKind::OverlayState);
             }
         }
     }
 
-    void HelperWebSocketHub::acceptLoop()
+    void HelperWebSocketHub::broadcastEventBatch(nlohmann::json batch)
     {
-        while (running_.load())
-        {
-            asio::error_code ec;
-            asio::ip::tcp::socket socket(io_);
-            acceptor_.accept(socket, ec);
+        batch["type"] = "overlay_events";
+        broadcastJson(batch);
+    }
+
+    void HelperWebSocketHub::startAccept()
+    {
+        // Each connection gets its own strand, so its handlers never run concurrently.
+        acceptor_.async_accept(asio::make_strand(io_), [this](const asio::error_code& ec, asio::ip::tcp::socket socket) {
             if (ec)
             {
-                if (running_.load())
+                if (!running_.load() || ec == asio::error::operation_aborted)
                 {
-                    spdlog::warn("[ws] accept failed: {}", ec.message());
+                    return;
                 }
-                continue;
+                spdlog::warn("[ws] accept failed: {}", ec.message());
+                startAccept();
+                return;
             }
 
             auto client = std::make_shared<Client>(std::move(socket));
-            client->remoteAddress = client->socket.remote_endpoint().address().to_string();
-
-            std::string requestBuffer;
-            if (!performHandshake(*client, requestBuffer))
             {
-                client->socket.close();
-                continue;
+                // Checked under the lock stop() snapshots the clients with, so none is left open.
+                std::lock_guard<std::mutex> guard(clientsMutex_);
+                if (!running_.load())
+                {
+                    asio::error_code closeError;
+                    client->socket.close(closeError);
+                    return;
+                }
+                clients_.push_back(client);
             }
 
-            sendInitialPayload(client);
-
-            client->readerThread = std::thread([this, client]() {
-                readerLoop(client);
-            });
+            readHandshake(client);
+            startAccept();
+        });
+    }
 
+    void HelperWebSocketHub::startPingTimer()
+    {
+        pingTimer_.expires_after(ping_interval);
+        pingTimer_.async_wait([this](const asio::error_code& ec) {
+            if (ec || !running_.load())
             {
-                std::lock_guard<std::mutex> guard(clientsMutex_);
-                clients_.push_back(client);
+                return;
             }
-        }
+
+            nlohmann::json ping{{"type", "ping"}, {"now_ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()}};
+            broadcastJson(ping);
+            startPingTimer();
+        });
     }
 
-    bool HelperWebSocketHub::performHandshake(Client& client, std::string& buffer)
+    void HelperWebSocketHub::readHandshake(std::shared_ptr<Client> client)
     {
-        try
-        {
-            while (buffer.find("\r\n\r\n") == std::string::npos)
-            {
-                std::array<char, 512> temp{};
-                const auto bytes = client.socket.read_some(asio::buffer(temp));
-                if (bytes == 0)
+        asio::async_read_until(client->socket, asio::dynamic_buffer(client->inbound, max_handshake_bytes), "\r\n\r\n",
+            [this, client](const asio::error_code& ec, std::size_t length) {
+                if (ec)
                 {
-                    return false;
+                    closeClient(client);
+                    return;
                 }
-                buffer.append(temp.data(), bytes);
-                if (buffer.size() > 16384)
+
+                const auto request = client->inbound.substr(0, length);
+                client->inbound.erase(0, length);
+
+                std::string response;
+                const bool accepted = performHandshake(*client, request, response);
+                queueFrame(*client, std::make_shared<const WireFrame>(std::move(response)), FrameKind::Control);
+                if (!accepted)
                 {
-                    return false;
+                    client->closeWhenFlushed = true;
+                    writeNext(client);
+                    return;
+                }
+
+                // Fetched before taking clientsMutex_: the server broadcasts while holding its own state lock.
+                const auto latestState = config_.getLatestOverlayState ? config_.getLatestOverlayState() : std::nullopt;
+
+                {
+                    // Queuing the initial state under the lock broadcasts take keeps patch clients on an unbroken
+                    // sequence: every later broadcast lands behind it on this client's strand.
+                    std::lock_guard<std::mutex> guard(clientsMutex_);
+                    queueInitialPayload(*client, latestState);
+                    client->upgraded = true;
                 }
-            }
 
-            const auto headerEnd = buffer.find("\r\n\r\n");
-            std::string headerPart = buffer.substr(0, headerEnd);
+                writeNext(client);
+                readFrames(client);
+            });
+    }
+
+    bool HelperWebSocketHub::performHandshake(Client& client, const std::string& request, std::string& response)
+    {
+        try
+        {
+            const auto headerEnd = request.find("\r\n\r\n");
+            std::string headerPart = request.substr(0, headerEnd);
 
             std::istringstream stream(headerPart);
             std::string requestLine;
             if (!std::getline(stream, requestLine))
             {
+                response = make_http_error_response(400, "Malformed request");
                 return false;
             }
             if (!requestLine.empty() && requestLine.back() == '\r')
@@ -503,8 +879,7 @@ namespace helper::ws
             requestLineStream >> method >> target >> version;
             if (method != "GET")
             {
-                auto error = make_http_error_response(405, "Only GET supported for WebSocket handshake");
-                asio::write(client.socket, asio::buffer(error));
+                response = make_http_error_response(405, "Only GET supported for WebSocket handshake");
                 return false;
             }
 
@@ -519,8 +894,7 @@ namespace helper::ws
 
             if (path != "/overlay/stream")
             {
-                auto error = make_http_error_response(404, "Unknown WebSocket endpoint");
-                asio::write(client.socket, asio::buffer(error));
+                response = make_http_error_response(404, "Unknown WebSocket endpoint");
                 return false;
             }
 
@@ -554,12 +928,16 @@ namespace helper::ws
                 connectionIt == headers.end() || to_lower(connectionIt->second).find("upgrade") == std::string::npos ||
                 keyIt == headers.end())
             {
-                auto error = make_http_error_response(400, "Missing required WebSocket headers");
-                asio::write(client.socket, asio::buffer(error));
+                response = make_http_error_response(400, "Missing required WebSocket headers");
                 return false;
             }
 
             const auto params = parse_query_params(query);
+            const auto patchesIt = params.find("patches");
+            const auto formatIt = params.find("format");
+            client.binaryState = formatIt != params.end() && formatIt->second == "binary";
+            // Binary states are always whole; compression is what keeps them small.
+            client.wantsPatches = !client.binaryState && patchesIt != params.end() && patchesIt->second == "1";
 
             if (!config_.token.empty())
             {
@@ -580,169 +958,98 @@ namespace helper::ws
 
                 if (tokenCandidate != config_.token)
                 {
-                    auto error = make_http_error_response(401, "Unauthorized");
-                    asio::write(client.socket, asio::buffer(error));
+                    response = make_http_error_response(401, "Unauthorized");
                     return false;
                 }
             }
 
-            const auto acceptKey = sha1_base64(keyIt->second + websocket_guid);
-            if (acceptKey.empty())
+            std::ostringstream oss;
+            oss << "HTTP/1.1 101 Switching Protocols\r\n";
+            oss << "Upgrade: websocket\r\n";
+            oss << "Connection: Upgrade\r\n";
+            oss << "Sec-WebSocket-Accept: " << websocket_accept_key(keyIt->second) << "\r\n";
+            oss << "Sec-WebSocket-Version: 13\r\n";
+
+            const auto extensionsIt = headers.find("sec-websocket-extensions");
+            if (const auto deflate = extensionsIt != headers.end() ? negotiate_permessage_deflate(extensionsIt->second) : std::nullopt)
             {
-                auto error = make_http_error_response(500, "Unable to compute handshake");
-                asio::write(client.socket, asio::buffer(error));
-                return false;
+                client.deflater = std::make_unique<MessageDeflater>(deflate->serverWindowBits, !deflate->serverNoContextTakeover);
+                oss << "Sec-WebSocket-Extensions: permessage-deflate";
+                if (deflate->serverNoContextTakeover)
+                {
+                    oss << "; server_no_context_takeover";
+                }
+                if (deflate->serverWindowBitsRequested)
+                {
+                    oss << "; server_max_window_bits=" << deflate->serverWindowBits;
+                }
+                oss << "\r\n";
             }
-
-            std::ostringstream response;
-            response << "HTTP/1.1 101 Switching Protocols\r\n";
-            response << "Upgrade: websocket\r\n";
-            response << "Connection: Upgrade\r\n";
-            response << "Sec-WebSocket-Accept: " << acceptKey << "\r\n";
-            response << "Sec-WebSocket-Version: 13\r\n";
-            response << "Access-Control-Allow-Origin: *\r\n";
-            response << "\r\n";
-
-            const auto handshake = response.str();
-            asio::write(client.socket, asio::buffer(handshake));
+            oss << "Access-Control-Allow-Origin: *\r\n";
+            oss << "\r\n";
+            response = oss.str();
             return true;
         }
         catch (const std::exception& ex)
         {
             spdlog::warn("[ws] handshake exception: {}", ex.what());
+            response = make_http_error_response(500, "Unable to complete handshake");
             return false;
         }
     }
 
-    void HelperWebSocketHub::readerLoop(std::shared_ptr<Client> client)
+    void HelperWebSocketHub::readFrames(std::shared_ptr<Client> client)
     {
-        try
-        {
-            while (client->running.load())
+        client->socket.async_read_some(asio::buffer(client->readBuffer), [this, client](const asio::error_code& ec, std::size_t bytes) {
+            if (ec)
             {
-                std::array<unsigned char, 2> header{};
-                if (!readExact(client->socket, header.data(), header.size()))
+                if (ec != asio::error::eof && ec != asio::error::operation_aborted)
                 {
-                    break;
-                }
-
-                const bool fin = (header[0] & 0x80) != 0;
-                const unsigned char opcode = header[0] & 0x0F;
-                const bool masked = (header[1] & 0x80) != 0;
-                std::uint64_t payloadLength = header[1] & 0x7F;
-
-                if (!fin)
-                {
-                    spdlog::debug("[ws] fragmented frame from {} ignored", client->remoteAddress);
-                    return;
-                }
-
-                if (payloadLength == 126)
-                {
-                    std::array<unsigned char, 2> extended{};
-                    if (!readExact(client->socket, extended.data(), extended.size()))
-                    {
-                        break;
-                    }
-                    payloadLength = static_cast<std::uint64_t>(extended[0]) << 8 | static_cast<std::uint64_t>(extended[1]);
-                }
-                else if (payloadLength == 127)
-                {
-                    std::array<unsigned char, 8> extended{};
-                    if (!readExact(client->socket, extended.data(), extended.size()))
-                    {
-                        break;
-                    }
-                    payloadLength = 0;
-                    for (int i = 0; i < 8; ++i)
-                    {
-                        payloadLength = (payloadLength << 8) | extended[i];
-                    }
+                    spdlog::debug("[ws] client {} disconnected: {}", client->remoteAddress, ec.message());
                 }
+                closeClient(client);
+                return;
+            }
 
-                std::array<unsigned char, 4> mask{};
-                if (masked)
+            client->inbound.append(client->readBuffer.data(), bytes);
+            InboundFrame frame;
+            for (;;)
+            {
+                const auto consumed = parse_frame(client->inbound, frame);
+                if (consumed == 0)
                 {
-                    if (!readExact(client->socket, mask.data(), mask.size()))
-                    {
-                        break;
-                    }
+                    break;
                 }
-
-                std::string payload;
-                payload.resize(static_cast<std::size_t>(payloadLength));
-                if (payloadLength > 0)
+                if (consumed == frame_error)
                 {
-                    if (!readExact(client->socket, payload.data(), payload.size()))
-                    {
-                        break;
-                    }
-                    if (masked)
-                    {
-                        for (std::size_t i = 0; i < payload.size(); ++i)
-                        {
-                            payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
-                        }
-                    }
+                    spdlog::debug("[ws] fragmented or oversized frame from {}; closing", client->remoteAddress);
+                    closeClient(client);
+                    return;
                 }
+                client->inbound.erase(0, consumed);
 
-                if (opcode == 0x8)
+                if (frame.opcode == 0x8)
                 {
-                    // close
-                    break;
+                    // close -> echo it, then close once the queue has drained
+                    queueFrame(*client, std::make_shared<const WireFrame>(0x8, std::move(frame.payload)), FrameKind::Control);
+                    client->closeWhenFlushed = true;
+                    writeNext(client);
+                    return;
                 }
-                else if (opcode == 0x9)
+                if (frame.opcode == 0x9)
                 {
                     // ping -> respond with pong
-                    std::vector<unsigned char> frame;
-                    frame.reserve(payload.size() + 2 + 8);
-                    frame.push_back(0x8A);
-                    if (payload.size() <= 125)
-                    {
-                        frame.push_back(static_cast<unsigned char>(payload.size()));
-                    }
-                    else if (payload.size() <= 65535)
-                    {
-                        frame.push_back(126);
-                        frame.push_back(static_cast<unsigned char>((payload.size() >> 8) & 0xFF));
-                        frame.push_back(static_cast<unsigned char>(payload.size() & 0xFF));
-                    }
-                    else
-                    {
-                        frame.push_back(127);
-                        std::uint64_t len = payload.size();
-                        for (int i = 7; i >= 0; --i)
-                        {
-                            frame.push_back(static_cast<unsigned char>((len >> (i * 8)) & 0xFF));
-                        }
-                    }
-                    frame.insert(frame.end(), payload.begin(), payload.end());
-                    std::lock_guard<std::mutex> lock(client->writeMutex);
-                    asio::write(client->socket, asio::buffer(frame));
-                }
-                else if (opcode == 0xA)
-                {
-                    // pong -> ignore
-                    continue;
-                }
-                else
-                {
-                    // Text or binary payloads ignored for now
-                    continue;
+                    queueFrame(*client, std::make_shared<const WireFrame>(0xA, std::move(frame.payload)), FrameKind::Pong);
+                    writeNext(client);
                 }
+                // Pongs, text and binary payloads are ignored.
             }
-        }
-        catch (const std::exception& ex)
-        {
-            spdlog::debug("[ws] client {} disconnected with exception: {}", client->remoteAddress, ex.what());
-        }
 
-        client->running.store(false);
-        asio::error_code ec;
-        client->socket.close(ec);
+            readFrames(client);
+        });
     }
 
-    void HelperWebSocketHub::sendInitialPayload(const std::shared_ptr<Client>& client)
+    void HelperWebSocketHub::queueInitialPayload(Client& client, const std::optional<nlohmann::json>& latestState)
     {
         nlohmann::json hello{
             {"type", "hello"},
@@ -753,73 +1060,205 @@ namespace helper::ws
                 "follow_mode",
                 "telemetry_v1",
                 "mining_telemetry",
-                "telemetry_reset"
+                "telemetry_reset",
+                "overlay_state_patch",
+                "permessage_deflate",
+                "binary_state"
             })},
+            {"compression", client.deflater ? "permessage-deflate" : "none"},
+            {"state_format", client.binaryState ? "binary" : "json"},
             {"http_port", config_.httpPort},
             {"ws_port", config_.port}
         };
-        sendText(client, hello.dump());
+        queueFrame(client, std::make_shared<const WireFrame>(0x1, hello.dump()), FrameKind::Control);
 
-        if (config_.getLatestOverlayState)
+        if (client.binaryState)
         {
-            if (auto state = config_.getLatestOverlayState())
+            SharedFrame frame;
+            if (overlayStateSequence_ != 0)
             {
-                nlohmann::json envelope{{"type", "overlay_state"}, {"state", *state}};
-                sendText(client, envelope.dump());
+                if (!lastOverlayStateBinaryFrame_)
+                {
+                    lastOverlayStateBinaryFrame_ = makeBinaryStateFrame(lastOverlayState_, overlayStateSequence_);
+                }
+                frame = lastOverlayStateBinaryFrame_;
             }
+            else if (latestState)
+            {
+                frame = makeBinaryStateFrame(*latestState, 0);
+            }
+            if (frame)
+            {
+                queueFrame(client, frame, FrameKind::OverlayState);
+                return;
+            }
+        }
+
+        // Once something has been broadcast, start from that so the next patch applies cleanly. Its frame is
+        // shared with every client it was broadcast to.
+        if (overlayStateSequence_ != 0 && lastOverlayStateFrame_)
+        {
+            queueFrame(client, lastOverlayStateFrame_, FrameKind::OverlayState);
+        }
+        else if (latestState)
+        {
+            nlohmann::json envelope{{"type", "overlay_state"}, {"state", *latestState}, {"sequence", 0}};
+            queueFrame(client, std::make_shared<const WireFrame>(0x1, envelope.dump()), FrameKind::OverlayState);
         }
     }
 
-    bool HelperWebSocketHub::sendText(const std::shared_ptr<Client>& client, const std::string& text)
+    HelperWebSocketHub::SharedFrame HelperWebSocketHub::makeBinaryStateFrame(const nlohmann::json& state, std::uint64_t sequence) const
     {
-        if (!client->running.load())
+        std::string encoded;
+        try
         {
-            return false;
+            encoded = overlay::encode_overlay_state_binary(overlay::parse_overlay_state(state));
+        }
+        catch (const std::exception& ex)
+        {
+            // Binary clients get the JSON envelope for a state the schema rejects.
+            spdlog::debug("[ws] overlay state has no binary encoding: {}", ex.what());
+            return nullptr;
         }
 
-        std::vector<unsigned char> frame;
-        frame.reserve(text.size() + 10);
-        frame.push_back(0x81);
+        std::string payload(12, '\0');
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            payload[i] = static_cast<char>((binary_state_frame_magic >> (i * 8)) & 0xFF);
+        }
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            payload[4 + i] = static_cast<char>((sequence >> (i * 8)) & 0xFF);
+        }
+        payload += encoded;
+        return std::make_shared<const WireFrame>(0x2, std::move(payload));
+    }
 
-        const auto len = text.size();
-        if (len <= 125)
+    void HelperWebSocketHub::postFrame(const std::shared_ptr<Client>& client, const SharedFrame& frame, FrameKind kind, const SharedFrame& fullState)
+    {
+        // Only the reference count changes per client; the frame itself is shared.
+        asio::post(client->socket.get_executor(), [this, client, frame, kind, fullState]() {
+            queueFrame(*client, frame, kind, fullState);
+            writeNext(client);
+        });
+    }
+
+    void HelperWebSocketHub::queueFrame(Client& client, SharedFrame frame, FrameKind kind, const SharedFrame& fullState)
+    {
+        if (client.closed)
         {
-            frame.push_back(static_cast<unsigned char>(len));
+            return;
         }
-        else if (len <= 65535)
+
+        // Only the frames behind the ones being written can still be replaced or dropped.
+        const auto firstQueued = client.queue.begin() + static_cast<std::ptrdiff_t>(client.writing);
+
+        if (kind == FrameKind::OverlayState || kind == FrameKind::Pong)
         {
-            frame.push_back(126);
-            frame.push_back(static_cast<unsigned char>((len >> 8) & 0xFF));
-            frame.push_back(static_cast<unsigned char>(len & 0xFF));
+            const auto pending = std::find_if(firstQueued, client.queue.end(), [kind](const Client::Outgoing& queued) {
+                return queued.kind == kind;
+            });
+            if (pending != client.queue.end())
+            {
+                // The client never received the queued state, so a patch against it would not apply. A pong
+                // only needs to answer the latest ping.
+                pending->frame = fullState ? fullState : std::move(frame);
+                framesCoalesced_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
         }
-        else
+
+        if (kind != FrameKind::Control && kind != FrameKind::Pong && static_cast<std::size_t>(client.queue.end() - firstQueued) >= config_.sendQueueLimit)
         {
-            frame.push_back(127);
-            std::uint64_t bigLen = static_cast<std::uint64_t>(len);
-            for (int i = 7; i >= 0; --i)
+            const auto oldest = std::find_if(firstQueued, client.queue.end(), [](const Client::Outgoing& queued) {
+                return queued.kind == FrameKind::Message;
+            });
+            if (oldest != client.queue.end())
             {
-                frame.push_back(static_cast<unsigned char>((bigLen >> (i * 8)) & 0xFF));
+                client.queue.erase(oldest);
+                framesDropped_.fetch_add(1, std::memory_order_relaxed);
             }
         }
 
-        frame.insert(frame.end(), text.begin(), text.end());
+        client.queue.push_back(Client::Outgoing{std::move(frame), kind});
+        framesQueued_.fetch_add(1, std::memory_order_relaxed);
+    }
 
-        std::lock_guard<std::mutex> lock(client->writeMutex);
-        asio::error_code ec;
-        asio::write(client->socket, asio::buffer(frame), ec);
-        if (ec)
+    void HelperWebSocketHub::writeNext(std::shared_ptr<Client> client)
+    {
+        if (client->writing != 0 || client->closed)
         {
-            spdlog::debug("[ws] failed to send to {}: {}", client->remoteAddress, ec.message());
-            return false;
+            return;
         }
-        return true;
+        if (client->queue.empty())
+        {
+            if (client->closeWhenFlushed)
+            {
+                closeClient(client);
+            }
+            return;
+        }
+
+        // Everything queued (up to a cap) goes out in one gathered write: each frame's header and its shared
+        // payload are written in place, never copied into a per-client buffer. Compression happens here, in
+        // send order, so the deflate context only ever sees what the client receives.
+        const auto count = std::min(client->queue.size(), max_gathered_frames);
+        std::vector<asio::const_buffer> buffers;
+        buffers.reserve(count * 2);
+        client->compressed.clear();
+        client->compressed.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto* frame = client->queue[i].frame.get();
+            if (client->deflater && frame->compressible())
+            {
+                std::string payload;
+                if (!client->deflater->compress(frame->payload, payload))
+                {
+                    spdlog::debug("[ws] compression failed for {}; closing", client->remoteAddress);
+                    closeClient(client);
+                    return;
+                }
+                frame = &client->compressed.emplace_back(frame->opcode(), std::move(payload), true);
+            }
+            buffers.emplace_back(frame->header.data(), frame->headerSize);
+            buffers.emplace_back(frame->payload.data(), frame->payload.size());
+        }
+        client->writing = count;
+
+        asio::async_write(client->socket, buffers, [this, client](const asio::error_code& ec, std::size_t) {
+            const auto written = client->writing;
+            client->writing = 0;
+            if (ec)
+            {
+                if (ec != asio::error::operation_aborted)
+                {
+                    spdlog::debug("[ws] failed to send to {}: {}", client->remoteAddress, ec.message());
+                }
+                closeClient(client);
+                return;
+            }
+
+            client->queue.erase(client->queue.begin(), client->queue.begin() + static_cast<std::ptrdiff_t>(written));
+            writeNext(client);
+        });
     }
 
-    bool HelperWebSocketHub::readExact(asio::ip::tcp::socket& socket, void* buffer, std::size_t length)
+    void HelperWebSocketHub::closeClient(const std::shared_ptr<Client>& client)
     {
+        if (client->closed)
+        {
+            return;
+        }
+        client->closed = true;
+
         asio::error_code ec;
-        asio::read(socket, asio::buffer(buffer, length), asio::transfer_exactly(length), ec);
-        return !ec;
-    }
+        client->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+        client->socket.close(ec);
+        // A write in flight still references its frames until its handler runs.
+        client->queue.erase(client->queue.begin() + static_cast<std::ptrdiff_t>(client->writing), client->queue.end());
 
+        std::lock_guard<std::mutex> guard(clientsMutex_);
+        clients_.erase(std::remove(clients_.begin(), clients_.end(), client), clients_.end());
+    }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -19,6 +21,19 @@ namespace helper::ws
         nlohmann::json payload;
     };
 
+    // Clients connecting with ?format=binary receive overlay_state as binary frames laid out (little-endian) as
+    //
+    //   u32 magic 'EFWS' | u64 sequence | overlay::encode_overlay_state_binary() bytes
+    //
+    // Every other message stays a JSON text frame.
+    constexpr std::uint32_t binary_state_frame_magic = 0x53574645; // 'EFWS'
+
+    // WebSocket push channel for the browser. Every socket operation is asynchronous on one io_context run
+    // by a small fixed pool of threads; each client's I/O is serialized on its own strand. Broadcasts only
+    // queue frames, so a slow or stalled browser tab never blocks the caller or the other clients. A broadcast
+    // is serialized and framed once; every client's queue shares that immutable frame. Clients that negotiate
+    // permessage-deflate get each frame compressed as it is written, with the context carried between
+    // messages, so a state that differs little from the previous one costs a few dozen bytes.
     class HelperWebSocketHub
     {
     public:
@@ -29,6 +44,18 @@ namespace helper::ws
             int httpPort{0};
             std::string token;
             std::function<std::optional<nlohmann::json>()> getLatestOverlayState;
+            std::size_t threads{2};
+            // Frames a client may have waiting behind the one being written. A newer overlay_state replaces
+            // a queued one (coalesce-latest); past the limit the oldest queued message is dropped.
+            std::size_t sendQueueLimit{64};
+        };
+
+        struct Stats
+        {
+            std::size_t clients{0};
+            std::uint64_t framesQueued{0};
+            std::uint64_t framesCoalesced{0};    // queued overlay_state or pong frames replaced by a newer one
+            std::uint64_t framesDropped{0};      // oldest messages dropped from a full queue
         };
 
         explicit HelperWebSocketHub(Config config);
@@ -40,30 +67,51 @@ namespace helper::ws
         bool start();
         void stop();
 
-    int port() const noexcept { return config_.port; }
+        int port() const noexcept { return config_.port; }
+        Stats stats() const;
 
-    void broadcastJson(const nlohmann::json& message);
+        void broadcastJson(const nlohmann::json& message);
+        // Sends `state` (an overlay_state envelope) to every client. Clients that connected with
+        // ?patches=1 get an overlay_state_patch merge patch against the previous broadcast instead.
         void broadcastOverlayState(const nlohmann::json& state);
         void broadcastEventBatch(nlohmann::json batch);
 
     private:
         struct Client;
+        struct WireFrame;
+        enum class FrameKind : std::uint8_t;
+        using SharedFrame = std::shared_ptr<const WireFrame>;
 
-        void acceptLoop();
-        bool performHandshake(Client& client, std::string& requestBuffer);
-        void readerLoop(std::shared_ptr<Client> client);
-        void sendInitialPayload(const std::shared_ptr<Client>& client);
-    bool sendText(const std::shared_ptr<Client>& client, const std::string& text);
-        static bool readExact(asio::ip::tcp::socket& socket, void* buffer, std::size_t length);
+        void startAccept();
+        void startPingTimer();
+        void readHandshake(std::shared_ptr<Client> client);
+        bool performHandshake(Client& client, const std::string& request, std::string& response);
+        void readFrames(std::shared_ptr<Client> client);
+        void queueInitialPayload(Client& client, const std::optional<nlohmann::json>& latestState);
+        SharedFrame makeBinaryStateFrame(const nlohmann::json& state, std::uint64_t sequence) const;
+        void postFrame(const std::shared_ptr<Client>& client, const SharedFrame& frame, FrameKind kind, const SharedFrame& fullState = nullptr);
+        void queueFrame(Client& client, SharedFrame frame, FrameKind kind, const SharedFrame& fullState = nullptr);
+        void writeNext(std::shared_ptr<Client> client);
+        void closeClient(const std::shared_ptr<Client>& client);
 
         Config config_;
         asio::io_context io_;
+        asio::strand<asio::io_context::executor_type> strand_;  // the acceptor and ping timer
+        std::optional<asio::executor_work_guard<asio::io_context::executor_type>> work_;
         asio::ip::tcp::acceptor acceptor_;
-        std::thread acceptThread_;
-        std::thread pingThread_;
+        asio::steady_timer pingTimer_;
+        std::vector<std::thread> threads_;
         std::atomic_bool running_{false};
 
-        std::mutex clientsMutex_;
-        std::vector<std::weak_ptr<Client>> clients_;
+        mutable std::mutex clientsMutex_;
+        std::vector<std::shared_ptr<Client>> clients_;
+        nlohmann::json lastOverlayState_;            // last broadcast state, the base for the next patch
+        SharedFrame lastOverlayStateFrame_;          // that state's envelope, as sent to clients joining later
+        SharedFrame lastOverlayStateBinaryFrame_;    // and its binary frame, once a binary client wanted one
+        std::uint64_t overlayStateSequence_{0};      // guarded by clientsMutex_ like the four above
+
+        std::atomic<std::uint64_t> framesQueued_{0};
+        std::atomic<std::uint64_t> framesCoalesced_{0};
+        std::atomic<std::uint64_t> framesDropped_{0};
     };
 }
@@ -0,0 +1,361 @@
+#include "log_backfill.hpp"
+
+#include "log_parsers.hpp"
+#include "log_tail_reader.hpp"
+#include "system_resolver.hpp"
+#include "telemetry_store.hpp"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+namespace helper::logs
+{
+    namespace
+    {
+        constexpr int index_version = 1;
+
+        std::string filename_utf8(const std::filesystem::path& path)
+        {
+            const auto text = path.filename().u8string();
+            return std::string(text.begin(), text.end());
+        }
+
+        std::uint64_t timestamp_ms(const std::chrono::system_clock::time_point& timestamp)
+        {
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
+            return ms > 0 ? static_cast<std::uint64_t>(ms) : 0;
+        }
+    }
+
+    struct LogBackfill::Job
+    {
+        std::filesystem::path path;
+        std::string key;
+        bool chat{false};
+        std::uint64_t startOffset{0};
+        std::uint64_t size{0};
+        BackfillCheckpoint checkpoint;   // starts as the previous checkpoint, updated by parseFile
+        bool parsed{false};
+    };
+
+    LogBackfill::LogBackfill(Config config, const SystemResolver& resolver)
+        : config_(std::move(config))
+        , resolver_(resolver)
+    {
+        loadIndex();
+    }
+
+    BackfillResult LogBackfill::run(const std::atomic_bool* cancel)
+    {
+        const auto started = std::chrono::steady_clock::now();
+        BackfillResult result;
+        const bool adopted = adoptFollowedFiles();
+        auto jobs = collectJobs(result.filesScanned);
+
+        // Largest first, so one huge log does not start last and leave the other workers idle.
+        std::sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) {
+            return a.size - a.startOffset > b.size - b.startOffset;
+        });
+
+        const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        const auto threadCount = static_cast<std::size_t>(std::min<std::size_t>(config_.threads != 0 ? config_.threads : hardware, std::max<std::size_t>(jobs.size(), 1)));
+        std::vector<BackfillResult> partials(threadCount);
+        std::atomic<std::size_t> next{0};
+        const auto work = [&](BackfillResult& partial) {
+            while (!(cancel && cancel->load()))
+            {
+                const auto index = next.fetch_add(1);
+                if (index >= jobs.size())
+                {
+                    break;
+                }
+                parseFile(jobs[index], partial);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount - 1);
+        for (std::size_t i = 1; i < threadCount; ++i)
+        {
+            workers.emplace_back(work, std::ref(partials[i]));
+        }
+        work(partials[0]);
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        for (const auto& partial : partials)
+        {
+            result.filesParsed += partial.filesParsed;
+            result.bytesParsed += partial.bytesParsed;
+            for (const auto& [id, visit] : partial.visits)
+            {
+                auto& merged = result.visits[id];
+                merged.name = visit.name;
+                merged.visits += visit.visits;
+            }
+        }
+        for (const auto& job : jobs)
+        {
+            if (job.parsed)
+            {
+                checkpoints_[job.key] = job.checkpoint;
+            }
+        }
+
+        result.cancelled = cancel && cancel->load();
+        result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        if (result.filesParsed > 0 || adopted)
+        {
+            saveIndex();
+        }
+        return result;
+    }
+
+    bool LogBackfill::adoptFollowedFiles()
+    {
+        // What the log watcher already read was counted live. Moving the checkpoint past it, with a size
+        // that never matches, makes the next scan of a rotated log parse only what the watcher missed.
+        bool changed = false;
+        for (const auto& file : config_.followedFiles)
+        {
+            if (file.path.empty())
+            {
+                continue;
+            }
+            const auto key = telemetry::source_key(file.path);
+            const auto previous = checkpoints_.find(key);
+            if (file.consumedOffset <= (previous != checkpoints_.end() ? previous->second.offset : 0))
+            {
+                continue;
+            }
+            auto& checkpoint = checkpoints_[key];
+            checkpoint.offset = file.consumedOffset;
+            checkpoint.size = 0;
+            checkpoint.writeTime = 0;
+            changed = true;
+        }
+        return changed;
+    }
+
+    std::vector<LogBackfill::Job> LogBackfill::collectJobs(std::size_t& found) const
+    {
+        std::vector<std::string> excluded;
+        for (const auto& file : config_.followedFiles)
+        {
+            if (file.live && !file.path.empty())
+            {
+                excluded.push_back(telemetry::source_key(file.path));
+            }
+        }
+
+        std::vector<Job> jobs;
+        const auto scan = [&](const std::optional<std::filesystem::path>& directory, bool chat) {
+            if (!directory || directory->empty())
+            {
+                return;
+            }
+
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator(*directory, ec))
+            {
+                if (!entry.is_regular_file(ec))
+                {
+                    continue;
+                }
+
+                const auto filename = filename_utf8(entry.path());
+                if (chat ? !is_local_chat_log_filename(filename) : !is_combat_log_filename(filename))
+                {
+                    continue;
+                }
+
+                Job job;
+                job.path = entry.path();
+                job.key = telemetry::source_key(job.path);
+                job.chat = chat;
+                if (std::find(excluded.begin(), excluded.end(), job.key) != excluded.end())
+                {
+                    continue;
+                }
+                ++found;
+
+                job.size = entry.file_size(ec);
+                if (ec)
+                {
+                    continue;
+                }
+                const auto writeTime = entry.last_write_time(ec);
+                if (ec)
+                {
+                    continue;
+                }
+
+                const auto writeTicks = static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+                if (const auto previous = checkpoints_.find(job.key); previous != checkpoints_.end())
+                {
+                    if (previous->second.writeTime == writeTicks && previous->second.size == job.size)
+                    {
+                        continue;
+                    }
+                    job.checkpoint = previous->second;
+                    // A log that shrank was replaced; its old lines stay counted.
+                    job.startOffset = job.size >= previous->second.offset ? previous->second.offset : 0;
+                }
+                job.checkpoint.size = job.size;
+                job.checkpoint.writeTime = writeTicks;
+                jobs.push_back(std::move(job));
+            }
+        };
+
+        scan(config_.chatDirectory, true);
+        scan(config_.combatDirectory, false);
+        return jobs;
+    }
+
+    void LogBackfill::parseFile(Job& job, BackfillResult& result) const
+    {
+        LogTailReader reader;
+        reader.reset(job.path, job.startOffset);
+
+        CombatDamageEvent combatEvent;
+        MiningYieldEvent miningEvent;
+        auto& checkpoint = job.checkpoint;
+        const bool opened = reader.readLines([&](std::string_view line) {
+            if (job.chat)
+            {
+                const auto parsed = parse_local_chat_line(line);
+                if (!parsed)
+                {
+                    return;
+                }
+                ++checkpoint.systemEntries;
+                // Unmapped names would only pollute the visited list; the live watcher logs them.
+                if (const auto id = resolver_.resolve(parsed->systemName))
+                {
+                    auto& visit = result.visits[*id];
+                    if (visit.name.empty())
+                    {
+                        visit.name = parsed->systemName;
+                    }
+                    ++visit.visits;
+                }
+                return;
+            }
+
+            const auto classified = classify_game_log_line(line);
+            if (parse_combat_damage_line(classified, combatEvent))
+            {
+                ++checkpoint.combatEvents;
+                if (config_.telemetryStore)
+                {
+                    config_.telemetryStore->append(job.key, telemetry::TelemetryRecord::combat(timestamp_ms(combatEvent.timestamp), combatEvent.playerDealt, combatEvent.amount, static_cast<std::uint8_t>(combatEvent.quality)));
+                }
+            }
+            else if (parse_mining_yield_line(classified, miningEvent))
+            {
+                ++checkpoint.miningEvents;
+                if (config_.telemetryStore)
+                {
+                    config_.telemetryStore->append(job.key, telemetry::TelemetryRecord::mining(timestamp_ms(miningEvent.timestamp), miningEvent.volumeM3, config_.telemetryStore->resourceId(miningEvent.resource.view())));
+                }
+            }
+        });
+        if (!opened)
+        {
+            spdlog::warn("Log backfill unable to open {}", job.key);
+            return;
+        }
+
+        checkpoint.offset = reader.consumedOffset();
+        result.bytesParsed += checkpoint.offset - std::min(job.startOffset, checkpoint.offset);
+        ++result.filesParsed;
+        job.parsed = true;
+    }
+
+    bool LogBackfill::loadIndex()
+    {
+        std::ifstream file(config_.indexPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        try
+        {
+            const auto json = nlohmann::json::parse(file);
+            if (json.value("version", 0) != index_version)
+            {
+                spdlog::warn("Ignoring log backfill index with unknown version: {}", config_.indexPath.string());
+                return false;
+            }
+
+            // Compact rows: [offset, size, writeTime, systemEntries, combatEvents, miningEvents]. Indexes
+            // written before the telemetry store took over may still carry hourly "telemetry" rows; they are
+            // ignored and dropped on the next save.
+            for (const auto& [key, row] : json.at("files").items())
+            {
+                BackfillCheckpoint checkpoint;
+                checkpoint.offset = row.at(0).get<std::uint64_t>();
+                checkpoint.size = row.at(1).get<std::uint64_t>();
+                checkpoint.writeTime = row.at(2).get<std::int64_t>();
+                checkpoint.systemEntries = row.at(3).get<std::uint64_t>();
+                checkpoint.combatEvents = row.at(4).get<std::uint64_t>();
+                checkpoint.miningEvents = row.at(5).get<std::uint64_t>();
+                checkpoints_[key] = checkpoint;
+            }
+            return true;
+        }
+        catch (const std::exception& ex)
+        {
+            spdlog::warn("Failed to read log backfill index {}: {}", config_.indexPath.string(), ex.what());
+            checkpoints_.clear();
+            return false;
+        }
+    }
+
+    bool LogBackfill::saveIndex() const
+    {
+        nlohmann::json files = nlohmann::json::object();
+        for (const auto& [key, checkpoint] : checkpoints_)
+        {
+            files[key] = {checkpoint.offset, checkpoint.size, checkpoint.writeTime, checkpoint.systemEntries, checkpoint.combatEvents, checkpoint.miningEvents};
+        }
+        const nlohmann::json json{
+            {"version", index_version},
+            {"files", std::move(files)}
+        };
+
+        // Written aside and renamed over, so an interrupted save keeps the previous index.
+        auto temporary = config_.indexPath;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                spdlog::error("Failed to write log backfill index {}", temporary.string());
+                return false;
+            }
+            file << json.dump();
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temporary, config_.indexPath, ec);
+        if (ec)
+        {
+            spdlog::error("Failed to replace log backfill index {}: {}", config_.indexPath.string(), ec.message());
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "log_tail_reader.hpp"
+#include "session_tracker.hpp"
+
+namespace helper::telemetry
+{
+    class TelemetryStore;
+}
+
+namespace helper::logs
+{
+    class SystemResolver;
+
+    // How much of one historical log has been folded into the backfilled totals.
+    struct BackfillCheckpoint
+    {
+        std::uint64_t offset{0};          // file offset just past the last complete line parsed
+        std::uint64_t size{0};            // file size and last write time (file clock ticks) when parsed;
+        std::int64_t writeTime{0};        // NTFS may defer the time while the game holds the log open
+        std::uint64_t systemEntries{0};   // Local chat "channel changed" lines
+        std::uint64_t combatEvents{0};
+        std::uint64_t miningEvents{0};
+    };
+
+    // What one run found in the bytes it had not parsed before. Merging it into the all-time totals counts
+    // each log line once however often the backfill runs.
+    struct BackfillResult
+    {
+        std::size_t filesScanned{0};      // log files found, including unchanged ones
+        std::size_t filesParsed{0};
+        std::uint64_t bytesParsed{0};
+        double elapsedMs{0.0};
+        bool cancelled{false};
+        std::unordered_map<std::string, SystemVisitData> visits;        // by system id
+    };
+
+    // Parses the historical Local chat and combat logs in parallel with the live parsers and keeps a
+    // checkpoint per file, so a later run only reads what was appended or created since. Combat and mining
+    // events go to the telemetry store, which answers every query over them.
+    class LogBackfill
+    {
+    public:
+        struct Config
+        {
+            std::optional<std::filesystem::path> chatDirectory;
+            std::optional<std::filesystem::path> combatDirectory;
+            std::vector<FollowedLogFile> followedFiles;          // read by the log watcher; live ones are skipped
+            std::filesystem::path indexPath;
+            unsigned threads{0};                                 // 0 = one per hardware thread
+            telemetry::TelemetryStore* telemetryStore{nullptr};  // optional; receives every parsed event
+        };
+
+        LogBackfill(Config config, const SystemResolver& resolver);
+
+        LogBackfill(const LogBackfill&) = delete;
+        LogBackfill& operator=(const LogBackfill&) = delete;
+
+        // Parses every new or grown log and saves the index. `cancel` is polled between files.
+        BackfillResult run(const std::atomic_bool* cancel = nullptr);
+
+        const std::map<std::string, BackfillCheckpoint>& checkpoints() const { return checkpoints_; }
+
+    private:
+        struct Job;
+
+        bool loadIndex();
+        bool saveIndex() const;
+        bool adoptFollowedFiles();
+        std::vector<Job> collectJobs(std::size_t& found) const;
+        void parseFile(Job& job, BackfillResult& result) const;
+
+        Config config_;
+        const SystemResolver& resolver_;
+        std::map<std::string, BackfillCheckpoint> checkpoints_;           // by UTF-8 path
+    };
+}
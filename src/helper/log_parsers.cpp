@@ -4,204 +4,424 @@
 #include <array>
 #include <cctype>
 #include <charconv>
-#include <ctime>
-#include <iomanip>
-#include <regex>
-#include <sstream>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace helper::logs
 {
     namespace
     {
-        std::string trim_copy(std::string_view input)
+        // Markup-free copies of longer lines than this go to the heap; game log lines are far shorter.
+        constexpr std::size_t inline_text_capacity = 1024;
+
+        constexpr char ascii_lower(char ch)
+        {
+            return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+        }
+
+        bool is_space(char ch)
+        {
+            return std::isspace(static_cast<unsigned char>(ch)) != 0;
+        }
+
+        bool is_digit(char ch)
+        {
+            return ch >= '0' && ch <= '9';
+        }
+
+        bool is_number_char(char ch)
         {
-            auto begin = input.begin();
-            auto end = input.end();
-            while (begin != end && std::isspace(static_cast<unsigned char>(*begin)))
+            return is_digit(ch) || ch == '.' || ch == ',';
+        }
+
+        bool is_all_digits(std::string_view value)
+        {
+            return !value.empty() && std::all_of(value.begin(), value.end(), is_digit);
+        }
+
+        std::string_view trim_view(std::string_view value)
+        {
+            while (!value.empty() && is_space(value.front()))
             {
-                ++begin;
+                value.remove_prefix(1);
             }
-            if (begin == end)
+            while (!value.empty() && is_space(value.back()))
             {
-                return std::string{};
+                value.remove_suffix(1);
             }
-            do
-            {
-                --end;
-            } while (end != begin && std::isspace(static_cast<unsigned char>(*end)));
-            return std::string(begin, end + 1);
+            return value;
         }
 
-        std::string to_lower_copy(std::string_view input)
+        bool equals_ignore_case(std::string_view text, std::string_view lowerNeedle)
         {
-            std::string output;
-            output.reserve(input.size());
-            for (const auto ch : input)
-            {
-                output.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
-            }
-            return output;
+            return text.size() == lowerNeedle.size() && std::equal(text.begin(), text.end(), lowerNeedle.begin(), [](char a, char b) {
+                return ascii_lower(a) == b;
+            });
         }
 
-        bool is_all_digits(std::string_view value)
+        // Case-insensitive find of an all-lowercase needle, without building a lowercase copy of the text.
+        std::size_t find_ignore_case(std::string_view text, std::string_view lowerNeedle, std::size_t from = 0)
         {
-            if (value.empty())
+            if (from > text.size() || lowerNeedle.size() > text.size() - from)
             {
-                return false;
+                return std::string_view::npos;
             }
-            return std::all_of(value.begin(), value.end(), [](unsigned char ch) {
-                return std::isdigit(ch) != 0;
-            });
+
+            // Needles that start with a space or punctuation can skip ahead with a plain (memchr) search.
+            const auto first = lowerNeedle.front();
+            const bool firstIsLetter = first >= 'a' && first <= 'z';
+            const auto last = text.size() - lowerNeedle.size();
+            for (auto position = from; position <= last; ++position)
+            {
+                if (!firstIsLetter)
+                {
+                    position = text.find(first, position);
+                    if (position == std::string_view::npos || position > last)
+                    {
+                        return std::string_view::npos;
+                    }
+                }
+                else if (ascii_lower(text[position]) != first)
+                {
+                    continue;
+                }
+
+                if (equals_ignore_case(text.substr(position, lowerNeedle.size()), lowerNeedle))
+                {
+                    return position;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        bool contains_ignore_case(std::string_view text, std::string_view lowerNeedle)
+        {
+            return find_ignore_case(text, lowerNeedle) != std::string_view::npos;
         }
 
-        std::optional<std::chrono::system_clock::time_point> parse_timestamp(std::string_view line)
+        // The text with <...> tags removed. Lines without markup are used as they are; the rest are copied
+        // into inline storage.
+        class MarkupFreeText
         {
-            const auto open = line.find('[');
-            const auto close = line.find(']');
-            if (open == std::string_view::npos || close == std::string_view::npos || close <= open + 1)
+        public:
+            explicit MarkupFreeText(std::string_view markup)
             {
-                return std::nullopt;
+                if (markup.find_first_of("<>") == std::string_view::npos)
+                {
+                    text_ = markup;
+                    return;
+                }
+
+                char* out = inline_.data();
+                if (markup.size() > inline_.size())
+                {
+                    overflow_.resize(markup.size());
+                    out = overflow_.data();
+                }
+
+                const char* begin = out;
+                bool inTag = false;
+                for (const char ch : markup)
+                {
+                    if (ch == '<' || ch == '>')
+                    {
+                        inTag = ch == '<';
+                        continue;
+                    }
+                    if (!inTag)
+                    {
+                        *out++ = ch;
+                    }
+                }
+                text_ = std::string_view(begin, static_cast<std::size_t>(out - begin));
             }
 
-            auto raw = trim_copy(line.substr(open + 1, close - open - 1));
-            if (raw.size() < 19)
+            MarkupFreeText(const MarkupFreeText&) = delete;
+            MarkupFreeText& operator=(const MarkupFreeText&) = delete;
+
+            std::string_view view() const { return text_; }
+
+        private:
+            std::array<char, inline_text_capacity> inline_;
+            std::string overflow_;
+            std::string_view text_;
+        };
+
+        // Digits with optional thousands separators and a decimal point, e.g. "1,234.5".
+        double parse_number(std::string_view token)
+        {
+            std::array<char, 64> digits{};
+            std::size_t length = 0;
+            for (const auto ch : token)
             {
-                return std::nullopt;
+                if (ch != ',' && length < digits.size())
+                {
+                    digits[length++] = ch;
+                }
             }
 
-            std::tm tm{};
-            std::istringstream iss(raw.substr(0, 19));
-            iss >> std::get_time(&tm, "%Y.%m.%d %H:%M:%S");
-            if (iss.fail())
+            double value = 0.0;
+            const auto result = std::from_chars(digits.data(), digits.data() + length, value);
+            return result.ec == std::errc{} ? value : 0.0;
+        }
+
+        std::optional<double> number_ending_at(std::string_view text, std::size_t anchor)
+        {
+            std::size_t end = std::min(anchor, text.size());
+            while (end > 0 && is_space(text[end - 1]))
+            {
+                --end;
+            }
+            std::size_t start = end;
+            while (start > 0 && is_number_char(text[start - 1]))
+            {
+                --start;
+            }
+            if (start == end)
             {
                 return std::nullopt;
             }
+            return parse_number(text.substr(start, end - start));
+        }
 
-#if defined(_WIN32)
-            const auto epoch = _mkgmtime(&tm);
-#elif defined(__unix__) || defined(__APPLE__)
-            const auto epoch = timegm(&tm);
-#else
-            const auto epoch = std::mktime(&tm);
-#endif
-            if (epoch == -1)
+        std::optional<double> number_starting_at(std::string_view text, std::size_t anchor)
+        {
+            std::size_t start = anchor;
+            while (start < text.size() && is_space(text[start]))
+            {
+                ++start;
+            }
+            std::size_t end = start;
+            while (end < text.size() && is_number_char(text[end]))
+            {
+                ++end;
+            }
+            if (start == end)
             {
                 return std::nullopt;
             }
-
-            return std::chrono::system_clock::from_time_t(epoch);
+            return parse_number(text.substr(start, end - start));
         }
 
-        double parse_number(std::string_view token)
+        // Reads an unsigned field followed by `separator`, advancing `text` past both.
+        bool read_field(std::string_view& text, int& value, char separator)
         {
-            std::string sanitized;
-            sanitized.reserve(token.size());
-            for (const auto ch : token)
+            const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (result.ec != std::errc{} || value < 0)
+            {
+                return false;
+            }
+            text.remove_prefix(static_cast<std::size_t>(result.ptr - text.data()));
+            if (separator != '\0')
             {
-                if (ch != ',')
+                if (text.empty() || text.front() != separator)
                 {
-                    sanitized.push_back(ch);
+                    return false;
                 }
+                text.remove_prefix(1);
             }
+            return true;
+        }
+
+        std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day)
+        {
+            year -= month <= 2 ? 1 : 0;
+            const auto era = (year >= 0 ? year : year - 399) / 400;
+            const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+            const auto dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+            const auto dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+            return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+        }
 
-            try
+        // "YYYY.MM.DD HH:MM:SS" in UTC, as written between the brackets of every game log line.
+        std::optional<std::chrono::system_clock::time_point> parse_timestamp(std::string_view text)
+        {
+            text = trim_view(text);
+            int year = 0;
+            int month = 0;
+            int day = 0;
+            int hour = 0;
+            int minute = 0;
+            int second = 0;
+            if (text.size() < 19 || !read_field(text, year, '.') || !read_field(text, month, '.') || !read_field(text, day, ' ') ||
+                !read_field(text, hour, ':') || !read_field(text, minute, ':') || !read_field(text, second, '\0'))
             {
-                return std::stod(sanitized);
+                return std::nullopt;
             }
-            catch (...)
+            if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
             {
-                return 0.0;
+                return std::nullopt;
             }
+
+            const auto days = days_from_civil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+            const auto seconds = std::chrono::seconds{days * 86400 + hour * 3600 + minute * 60 + second};
+            return std::chrono::system_clock::time_point{std::chrono::duration_cast<std::chrono::system_clock::duration>(seconds)};
         }
 
-        std::string lowercase_copy(std::string_view input)
+        std::chrono::system_clock::time_point timestamp_or_now(const GameLogLine& line)
         {
-            std::string out;
-            out.reserve(input.size());
-            for (const auto ch : input)
+            return parse_timestamp(line.timestamp).value_or(std::chrono::system_clock::now());
+        }
+
+        std::string_view cleanup_name(std::string_view name)
+        {
+            name = trim_view(name);
+            const auto dash = name.find(" -");
+            if (dash != std::string_view::npos)
             {
-                out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+                name.remove_suffix(name.size() - dash);
             }
-            return out;
+            return trim_view(name);
         }
 
-        std::string_view trim_view(std::string_view value)
+        // "X misses you", "You miss X" and "Your <weapon> misses X". Returns the counterparty, or empty.
+        std::string_view miss_counterparty(std::string_view text, bool& playerDealt)
         {
-            while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front())) != 0)
+            constexpr std::string_view youMiss{"you miss "};
+            constexpr std::string_view misses{" misses "};
+            if (contains_ignore_case(text, "you miss") || contains_ignore_case(text, "your "))
             {
-                value.remove_prefix(1);
+                playerDealt = true;
+                const auto youMissPos = find_ignore_case(text, youMiss);
+                if (youMissPos != std::string_view::npos)
+                {
+                    return trim_view(text.substr(youMissPos + youMiss.size()));
+                }
+
+                const auto missesPos = find_ignore_case(text, misses, find_ignore_case(text, "your "));
+                return missesPos != std::string_view::npos ? trim_view(text.substr(missesPos + misses.size())) : std::string_view{};
             }
-            while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back())) != 0)
+
+            if (contains_ignore_case(text, " misses you") || contains_ignore_case(text, " miss you"))
             {
-                value.remove_suffix(1);
+                playerDealt = false;
+                return trim_view(text.substr(0, find_ignore_case(text, " miss")));
+            }
+            return {};
+        }
+
+        HitQuality hit_quality(std::string_view text)
+        {
+            if (contains_ignore_case(text, "miss"))
+            {
+                return HitQuality::Miss;
+            }
+            if (contains_ignore_case(text, "glanc"))   // "glances off" or "glancing"
+            {
+                return HitQuality::Glancing;
+            }
+            if (contains_ignore_case(text, "penetrat"))   // "penetrates" or "penetrating"
+            {
+                return HitQuality::Penetrating;
+            }
+            if (contains_ignore_case(text, "smash"))   // "smashes" or "smashing"
+            {
+                return HitQuality::Smashing;
+            }
+            return HitQuality::Standard;
+        }
+
+        std::string_view strip_utf8_bom(std::string_view value)
+        {
+            if (value.size() >= 3 && value.substr(0, 3) == "\xEF\xBB\xBF")
+            {
+                value.remove_prefix(3);
             }
             return value;
         }
 
-        std::string strip_markup(std::string_view value)
+        // Matches `word` followed by whitespace (at least one character if `requireSpace`) and advances past both.
+        bool consume_word(std::string_view& text, std::string_view lowerWord, bool requireSpace)
         {
-            std::string output;
-            output.reserve(value.size());
-            bool inTag = false;
-            for (const char ch : value)
+            if (text.size() < lowerWord.size() || !equals_ignore_case(text.substr(0, lowerWord.size()), lowerWord))
             {
-                if (ch == '<')
-                {
-                    inTag = true;
-                    continue;
-                }
-                if (ch == '>')
-                {
-                    inTag = false;
-                    continue;
-                }
-                if (!inTag)
-                {
-                    output.push_back(ch);
-                }
+                return false;
             }
-            return output;
+            text.remove_prefix(lowerWord.size());
+            const auto spaces = static_cast<std::size_t>(std::find_if_not(text.begin(), text.end(), is_space) - text.begin());
+            if (requireSpace && spaces == 0)
+            {
+                return false;
+            }
+            text.remove_prefix(spaces);
+            return true;
         }
     }
 
-    std::optional<LocalChatEvent> parse_local_chat_line(std::string_view line)
+    GameLogLine classify_game_log_line(std::string_view line)
     {
-        static const std::regex pattern{R"(Channel\s+changed\s+to\s+Local\s*:\s*(.+))", std::regex::icase};
-        std::smatch match;
-        std::string owned(line);
-        if (!std::regex_search(owned, match, pattern))
+        GameLogLine result;
+        std::string_view rest = line;
+        const auto open = line.find('[');
+        const auto close = line.find(']');
+        if (open != std::string_view::npos && close != std::string_view::npos && close > open)
         {
-            return std::nullopt;
+            result.timestamp = line.substr(open + 1, close - open - 1);
+            rest = line.substr(close + 1);
         }
 
-        if (match.size() < 2)
+        rest = trim_view(rest);
+        if (rest.empty() || rest.front() != '(')
         {
-            return std::nullopt;
+            return result;
         }
 
-        auto system = trim_copy(match[1].str());
-        if (system.empty())
+        const auto tagEnd = rest.find(')');
+        if (tagEnd == std::string_view::npos)
         {
-            return std::nullopt;
+            return result;
         }
 
-        if (!system.empty() && static_cast<unsigned char>(system.front()) == 0xEF && system.size() >= 3)
+        const auto tag = rest.substr(1, tagEnd - 1);
+        if (equals_ignore_case(tag, "combat"))
         {
-            const auto bom = std::array<unsigned char, 3>{0xEF, 0xBB, 0xBF};
-            if (std::equal(bom.begin(), bom.end(), reinterpret_cast<const unsigned char*>(system.data()), reinterpret_cast<const unsigned char*>(system.data()) + 3))
+            result.kind = GameLogLineKind::Combat;
+        }
+        else if (equals_ignore_case(tag, "notify"))
+        {
+            result.kind = GameLogLineKind::Notify;
+        }
+        else if (equals_ignore_case(tag, "mining"))
+        {
+            result.kind = GameLogLineKind::Mining;
+        }
+        result.body = rest.substr(tagEnd + 1);
+        return result;
+    }
+
+    std::optional<LocalChatEvent> parse_local_chat_line(std::string_view line)
+    {
+        // "Channel changed to Local : <system>", in any case and with any spacing.
+        for (auto position = find_ignore_case(line, "channel"); position != std::string_view::npos; position = find_ignore_case(line, "channel", position + 1))
+        {
+            auto rest = line.substr(position);
+            if (!consume_word(rest, "channel", true) || !consume_word(rest, "changed", true) || !consume_word(rest, "to", true) ||
+                !consume_word(rest, "local", false) || !consume_word(rest, ":", false))
+            {
+                continue;
+            }
+
+            const auto system = trim_view(strip_utf8_bom(trim_view(rest)));
+            if (system.empty())
             {
-                system.erase(0, 3);
-                system = trim_copy(system);
+                return std::nullopt;
             }
+            return LocalChatEvent{std::string(system)};
         }
+        return std::nullopt;
+    }
 
-        if (system.empty())
+    bool is_local_chat_log_filename(std::string_view filename)
+    {
+        const auto pos = filename.find_last_of("/\\");
+        if (pos != std::string_view::npos)
         {
-            return std::nullopt;
+            filename.remove_prefix(pos + 1);
         }
 
-        return LocalChatEvent{std::move(system)};
+        return filename.size() > 10 && equals_ignore_case(filename.substr(0, 6), "local_") &&
+               filename.substr(filename.size() - 4) == ".txt";
     }
 
     bool is_combat_log_filename(std::string_view filename)
@@ -222,8 +442,7 @@ namespace helper::logs
             return false;
         }
 
-        const auto lower = to_lower_copy(filename);
-        if (lower.size() < 4 || lower.substr(lower.size() - 4) != ".txt")
+        if (!equals_ignore_case(filename.substr(filename.size() - 4), ".txt"))
         {
             return false;
         }
@@ -290,392 +509,217 @@ namespace helper::logs
         return id;
     }
 
-    std::optional<CombatDamageEvent> parse_combat_damage_line(std::string_view line)
+    bool parse_combat_damage_line(const GameLogLine& line, CombatDamageEvent& event)
     {
-        constexpr std::string_view kCombatToken{"(combat)"};
-        if (line.find(kCombatToken) == std::string_view::npos)
-        {
-            return std::nullopt;
-        }
-
-        const auto timestamp = parse_timestamp(line).value_or(std::chrono::system_clock::now());
-
-        const auto strippedStorage = strip_markup(line);
-        std::string_view strippedView = strippedStorage;
-        auto lower = lowercase_copy(strippedView);
-
-        const auto combatPos = lower.find(kCombatToken);
-        if (combatPos != std::string::npos)
+        if (line.kind != GameLogLineKind::Combat)
         {
-            strippedView.remove_prefix(combatPos + kCombatToken.size());
-            lower = lowercase_copy(strippedView);
+            return false;
         }
 
-        strippedView = trim_view(strippedView);
-        lower = lowercase_copy(strippedView);
-
-        if (lower.empty())
+        const MarkupFreeText stripped(line.body);
+        const auto text = trim_view(stripped.view());
+        if (text.empty())
         {
-            return std::nullopt;
+            return false;
         }
 
-        // Handle miss events first (they don't have damage amounts)
-        if (lower.find("miss") != std::string::npos)
+        // Misses carry no damage amount.
+        if (contains_ignore_case(text, "miss"))
         {
-            bool playerDealtMiss = false;
-            std::string counterpartyMiss;
-            
-            // Check for "you miss" or "your ... misses"
-            if (lower.find("you miss") != std::string::npos || lower.find("your ") != std::string::npos)
-            {
-                playerDealtMiss = true;
-                const auto youMissPos = lower.find("you miss ");
-                if (youMissPos != std::string::npos)
-                {
-                    // Extract target after "you miss"
-                    const auto targetStart = youMissPos + std::string("you miss ").size();
-                    counterpartyMiss = std::string(trim_view(strippedView.substr(targetStart)));
-                }
-                else
-                {
-                    // Look for "your ... misses ..."
-                    const auto yourPos = lower.find("your ");
-                    const auto missesPos = lower.find(" misses ", yourPos);
-                    if (missesPos != std::string::npos)
-                    {
-                        const auto targetStart = missesPos + std::string(" misses ").size();
-                        counterpartyMiss = std::string(trim_view(strippedView.substr(targetStart)));
-                    }
-                }
-            }
-            // Check for "X misses you" or "X's ... misses you"
-            else if (lower.find(" misses you") != std::string::npos || lower.find(" miss you") != std::string::npos)
-            {
-                playerDealtMiss = false;
-                const auto missYouPos = lower.find(" miss");  // Find start of " misses you" or " miss you"
-                if (missYouPos != std::string::npos)
-                {
-                    counterpartyMiss = std::string(trim_view(strippedView.substr(0, missYouPos)));
-                }
-            }
-            
-            if (!counterpartyMiss.empty())
+            bool playerDealt = false;
+            const auto counterparty = miss_counterparty(text, playerDealt);
+            if (!counterparty.empty())
             {
-                CombatDamageEvent event;
-                event.playerDealt = playerDealtMiss;
-                event.amount = 0.0;  // Misses have no damage
-                event.counterparty = std::move(counterpartyMiss);
+                event.playerDealt = playerDealt;
+                event.amount = 0.0;
+                event.counterparty = InternedString(counterparty);
                 event.quality = HitQuality::Miss;
-                event.timestamp = timestamp;
-                return event;
+                event.timestamp = timestamp_or_now(line);
+                return true;
             }
         }
 
-        const auto cleanup_name = [](std::string_view name) {
-            name = trim_view(name);
-            const auto dash = name.find(" -");
-            if (dash != std::string::npos)
-            {
-                name.remove_suffix(name.size() - dash);
-            }
-            return std::string(trim_view(name));
-        };
-
-        const auto extract_amount_before = [&](std::size_t anchor) -> std::optional<double> {
-            if (anchor > strippedView.size())
-            {
-                anchor = strippedView.size();
-            }
-            std::size_t end = anchor;
-            while (end > 0 && std::isspace(static_cast<unsigned char>(strippedView[end - 1])) != 0)
-            {
-                --end;
-            }
-            std::size_t start = end;
-            while (start > 0)
-            {
-                const auto ch = strippedView[start - 1];
-                if (!(std::isdigit(static_cast<unsigned char>(ch)) != 0 || ch == '.' || ch == ','))
-                {
-                    break;
-                }
-                --start;
-            }
-            if (start == end)
-            {
-                return std::nullopt;
-            }
-            return parse_number(strippedView.substr(start, end - start));
-        };
+        // "<amount> to <target> - <weapon>" and "<amount> from <attacker> - <weapon>".
+        const auto toPos = find_ignore_case(text, " to ");
+        const auto fromPos = find_ignore_case(text, " from ");
+        bool playerDealt = false;
+        std::string_view counterparty;
+        std::optional<double> amount;
 
-        const auto extract_amount_after = [&](std::size_t anchor) -> std::optional<double> {
-            std::size_t start = anchor;
-            while (start < strippedView.size() && std::isspace(static_cast<unsigned char>(strippedView[start])) != 0)
+        const auto named_after = [&](std::size_t anchor, std::size_t keywordLength) {
+            const auto nameStart = anchor + keywordLength;
+            auto nameEnd = find_ignore_case(text, " -", nameStart);
+            if (nameEnd == std::string_view::npos)
             {
-                ++start;
+                nameEnd = text.size();
             }
-            std::size_t end = start;
-            while (end < strippedView.size())
-            {
-                const auto ch = strippedView[end];
-                if (!(std::isdigit(static_cast<unsigned char>(ch)) != 0 || ch == '.' || ch == ','))
-                {
-                    break;
-                }
-                ++end;
-            }
-            if (start == end)
-            {
-                return std::nullopt;
-            }
-            return parse_number(strippedView.substr(start, end - start));
+            counterparty = cleanup_name(text.substr(nameStart, nameEnd - nameStart));
+            amount = number_ending_at(text, anchor);
         };
 
-        const std::size_t toPos = lower.find(" to ");
-        const std::size_t fromPos = lower.find(" from ");
-        bool playerDealt = false;
-        std::string counterparty;
-        std::optional<double> amountOpt;
-
-        if (toPos != std::string::npos && (fromPos == std::string::npos || toPos < fromPos))
+        if (toPos != std::string_view::npos && (fromPos == std::string_view::npos || toPos < fromPos))
         {
             playerDealt = true;
-            std::size_t nameStart = toPos + 4;
-            std::size_t nameEnd = lower.find(" -", nameStart);
-            if (nameEnd == std::string::npos)
-            {
-                nameEnd = strippedView.size();
-            }
-            counterparty = cleanup_name(strippedView.substr(nameStart, nameEnd - nameStart));
-            amountOpt = extract_amount_before(toPos);
+            named_after(toPos, 4);
         }
-        else if (fromPos != std::string::npos)
+        else if (fromPos != std::string_view::npos)
         {
-            playerDealt = false;
-            std::size_t nameStart = fromPos + 6;
-            std::size_t nameEnd = lower.find(" -", nameStart);
-            if (nameEnd == std::string::npos)
-            {
-                nameEnd = strippedView.size();
-            }
-            counterparty = cleanup_name(strippedView.substr(nameStart, nameEnd - nameStart));
-            amountOpt = extract_amount_before(fromPos);
+            named_after(fromPos, 6);
         }
 
+        // "<attacker> hits you ...", "You hit <target> for ..." and "Your <weapon> hits <target> for ...".
         if (counterparty.empty())
         {
-            if (lower.find(" hits you") != std::string::npos || lower.find(" smashes you") != std::string::npos || lower.find(" strikes you") != std::string::npos)
+            std::size_t attackPos = std::string_view::npos;
+            for (const std::string_view pattern : {std::string_view(" hits you"), std::string_view(" smashes you"), std::string_view(" strikes you")})
             {
-                playerDealt = false;
-                const std::array<std::string_view, 3> patterns{" hits you", " smashes you", " strikes you"};
-                for (const auto& pattern : patterns)
+                attackPos = find_ignore_case(text, pattern);
+                if (attackPos != std::string_view::npos)
                 {
-                    const auto pos = lower.find(pattern);
-                    if (pos != std::string::npos)
-                    {
-                        counterparty = cleanup_name(strippedView.substr(0, pos));
-                        if (!amountOpt.has_value())
-                        {
-                            amountOpt = extract_amount_before(pos);
-                        }
-                        break;
-                    }
+                    break;
                 }
             }
-            else if (lower.find("you hit ") != std::string::npos || lower.find("your ") != std::string::npos)
+
+            const auto target_until_for = [&](std::size_t targetStart) {
+                const auto amountPos = find_ignore_case(text, " for", targetStart);
+                const auto targetEnd = amountPos == std::string_view::npos ? text.size() : amountPos;
+                counterparty = cleanup_name(text.substr(targetStart, targetEnd - targetStart));
+                if (!amount.has_value() && amountPos != std::string_view::npos)
+                {
+                    amount = number_starting_at(text, amountPos + 4);
+                }
+            };
+
+            if (attackPos != std::string_view::npos)
             {
-                playerDealt = true;
-                const auto youHitPos = lower.find("you hit ");
-                if (youHitPos != std::string::npos)
+                playerDealt = false;
+                counterparty = cleanup_name(text.substr(0, attackPos));
+                if (!amount.has_value())
                 {
-                    const auto targetStart = youHitPos + std::string("you hit ").size();
-                    auto amountPos = lower.find(" for", targetStart);
-                    auto targetEnd = amountPos;
-                    if (targetEnd == std::string::npos)
-                    {
-                        targetEnd = strippedView.size();
-                    }
-                    counterparty = cleanup_name(strippedView.substr(targetStart, targetEnd - targetStart));
-                    if (!amountOpt.has_value() && amountPos != std::string::npos)
-                    {
-                        amountOpt = extract_amount_after(amountPos + 4);
-                    }
+                    amount = number_ending_at(text, attackPos);
                 }
-                else
+            }
+            else if (const auto youHitPos = find_ignore_case(text, "you hit "); youHitPos != std::string_view::npos)
+            {
+                playerDealt = true;
+                target_until_for(youHitPos + 8);
+            }
+            else if (const auto yourPos = find_ignore_case(text, "your "); yourPos != std::string_view::npos)
+            {
+                playerDealt = true;
+                const auto hitsPos = find_ignore_case(text, " hits ", yourPos);
+                if (hitsPos != std::string_view::npos)
                 {
-                    const auto yourPos = lower.find("your ");
-                    if (yourPos != std::string::npos)
-                    {
-                        auto targetStart = lower.find(" hits ", yourPos);
-                        if (targetStart != std::string::npos)
-                        {
-                            targetStart += std::string(" hits ").size();
-                            auto amountPos = lower.find(" for", targetStart);
-                            auto targetEnd = amountPos;
-                            if (targetEnd == std::string::npos)
-                            {
-                                targetEnd = strippedView.size();
-                            }
-                            counterparty = cleanup_name(strippedView.substr(targetStart, targetEnd - targetStart));
-                            if (!amountOpt.has_value() && amountPos != std::string::npos)
-                            {
-                                amountOpt = extract_amount_after(amountPos + 4);
-                            }
-                        }
-                    }
+                    target_until_for(hitsPos + 6);
                 }
             }
         }
 
         if (counterparty.empty())
         {
-            return std::nullopt;
+            return false;
         }
 
-        if (!amountOpt.has_value())
+        if (!amount.has_value())
         {
-            const auto forPos = lower.find(" for ");
-            if (forPos != std::string::npos)
+            const auto forPos = find_ignore_case(text, " for ");
+            if (forPos != std::string_view::npos)
             {
-                amountOpt = extract_amount_after(forPos + 4);
+                amount = number_starting_at(text, forPos + 4);
             }
         }
-
-        if (!amountOpt.has_value())
+        if (!amount.has_value())
         {
-            amountOpt = extract_amount_before(strippedView.size());
+            amount = number_ending_at(text, text.size());
         }
 
-        const auto amount = amountOpt.value_or(0.0);
-        
-        // Detect hit quality from keywords in the log line
-        HitQuality quality = HitQuality::Standard;
-        if (lower.find("miss") != std::string::npos)
+        // Misses carry no damage figure; anything else needs a positive amount.
+        const auto quality = hit_quality(text);
+        const auto value = amount.value_or(0.0);
+        if (quality != HitQuality::Miss && !(value > 0.0))
         {
-            quality = HitQuality::Miss;
-        }
-        else if (lower.find("glanc") != std::string::npos)  // "glances off" or "glancing"
-        {
-            quality = HitQuality::Glancing;
-        }
-        else if (lower.find("penetrat") != std::string::npos)  // "penetrates" or "penetrating"
-        {
-            quality = HitQuality::Penetrating;
-        }
-        else if (lower.find("smash") != std::string::npos)  // "smashes" or "smashing"
-        {
-            quality = HitQuality::Smashing;
-        }
-        
-        // For misses, amount might be 0
-        if (quality == HitQuality::Miss || amount > 0.0)
-        {
-            CombatDamageEvent event;
-            event.playerDealt = playerDealt;
-            event.amount = amount;
-            event.counterparty = std::move(counterparty);
-            event.quality = quality;
-            event.timestamp = timestamp;
-            return event;
+            return false;
         }
-        
-        return std::nullopt;
+
+        event.playerDealt = playerDealt;
+        event.amount = value;
+        event.counterparty = InternedString(counterparty);
+        event.quality = quality;
+        event.timestamp = timestamp_or_now(line);
+        return true;
     }
 
-    std::optional<MiningYieldEvent> parse_mining_yield_line(std::string_view line)
+    bool parse_mining_yield_line(const GameLogLine& line, MiningYieldEvent& event)
     {
-        if (line.find("(notify)") == std::string_view::npos && line.find("(mining)") == std::string_view::npos)
-        {
-            return std::nullopt;
-        }
-
-        const auto strippedStorage = strip_markup(line);
-        std::string_view strippedView = strippedStorage;
-        auto lower = lowercase_copy(strippedView);
-
-        constexpr std::string_view kMiningToken{"(mining)"};
-        const auto miningPos = lower.find(kMiningToken);
-        if (miningPos != std::string::npos)
+        if (line.kind != GameLogLineKind::Notify && line.kind != GameLogLineKind::Mining)
         {
-            strippedView.remove_prefix(miningPos + kMiningToken.size());
-            lower = lowercase_copy(strippedView);
+            return false;
         }
 
-        strippedView = trim_view(strippedView);
-        lower = lowercase_copy(strippedView);
-
-        if (lower.find(" mined ") == std::string::npos && lower.find(" mining ") == std::string::npos)
+        // "You have mined 1,200 units of Veldspar worth 345.0 m3."
+        const MarkupFreeText stripped(line.body);
+        const auto text = trim_view(stripped.view());
+        if (!contains_ignore_case(text, " mined ") && !contains_ignore_case(text, " mining "))
         {
-            return std::nullopt;
+            return false;
         }
 
-        const auto timestamp = parse_timestamp(line).value_or(std::chrono::system_clock::now());
-
-        std::size_t numberEnd = std::string::npos;
-        const std::size_t m3Pos = lower.find(" m3");
-        const std::size_t unitsPos = lower.find(" units");
-
-        if (m3Pos != std::string::npos)
+        auto numberEnd = find_ignore_case(text, " m3");
+        if (numberEnd == std::string_view::npos)
         {
-            numberEnd = m3Pos;
+            numberEnd = find_ignore_case(text, " units");
         }
-        else if (unitsPos != std::string::npos)
+        if (numberEnd == std::string_view::npos)
         {
-            numberEnd = unitsPos;
-        }
-        else
-        {
-            return std::nullopt;
+            return false;
         }
 
-        while (numberEnd > 0 && std::isspace(static_cast<unsigned char>(strippedView[numberEnd - 1])) != 0)
+        const auto volume = number_ending_at(text, numberEnd);
+        if (!volume.has_value() || !(*volume > 0.0))
         {
-            --numberEnd;
+            return false;
         }
 
-        std::size_t numberStart = numberEnd;
-        while (numberStart > 0)
+        std::string_view resource;
+        const auto ofPos = find_ignore_case(text, " of ");
+        if (ofPos != std::string_view::npos)
         {
-            const auto ch = strippedView[numberStart - 1];
-            if (!(std::isdigit(static_cast<unsigned char>(ch)) != 0 || ch == '.' || ch == ','))
+            const auto nameStart = ofPos + 4;
+            auto nameEnd = find_ignore_case(text, " worth", nameStart);
+            if (nameEnd == std::string_view::npos)
             {
-                break;
+                nameEnd = text.find('.', nameStart);
+            }
+            if (nameEnd == std::string_view::npos)
+            {
+                nameEnd = text.size();
             }
-            --numberStart;
+            resource = trim_view(text.substr(nameStart, nameEnd - nameStart));
         }
 
-        if (numberStart == numberEnd)
-        {
-            return std::nullopt;
-        }
+        event.volumeM3 = *volume;
+        event.resource = InternedString(resource);
+        event.timestamp = timestamp_or_now(line);
+        return true;
+    }
 
-        const auto volume = parse_number(strippedView.substr(numberStart, numberEnd - numberStart));
-        if (volume <= 0.0)
+    std::optional<CombatDamageEvent> parse_combat_damage_line(std::string_view line)
+    {
+        CombatDamageEvent event;
+        if (!parse_combat_damage_line(classify_game_log_line(line), event))
         {
             return std::nullopt;
         }
+        return event;
+    }
 
-        std::string resource;
-        const auto ofPos = lower.find(" of ");
-        if (ofPos != std::string::npos)
+    std::optional<MiningYieldEvent> parse_mining_yield_line(std::string_view line)
+    {
+        MiningYieldEvent event;
+        if (!parse_mining_yield_line(classify_game_log_line(line), event))
         {
-            auto nameStart = ofPos + 4;
-            auto nameEnd = lower.find(" worth", nameStart);
-            if (nameEnd == std::string::npos)
-            {
-                nameEnd = lower.find('.', nameStart);
-            }
-            if (nameEnd == std::string::npos)
-            {
-                nameEnd = lower.size();
-            }
-            resource = std::string(trim_view(strippedView.substr(nameStart, nameEnd - nameStart)));
+            return std::nullopt;
         }
-
-        MiningYieldEvent event;
-        event.volumeM3 = volume;
-        event.resource = std::move(resource);
-        event.timestamp = timestamp;
         return event;
     }
 }
@@ -5,6 +5,8 @@
 #include <string>
 #include <string_view>
 
+#include "string_interner.hpp"
+
 namespace helper::logs
 {
     struct LocalChatEvent
@@ -25,7 +27,7 @@ namespace helper::logs
     {
         bool playerDealt{false};
         double amount{0.0};
-        std::string counterparty;
+        InternedString counterparty;
         HitQuality quality{HitQuality::Standard};
         std::chrono::system_clock::time_point timestamp{};
     };
@@ -33,12 +35,33 @@ namespace helper::logs
     struct MiningYieldEvent
     {
         double volumeM3{0.0};
-        std::string resource;
+        InternedString resource;
         std::chrono::system_clock::time_point timestamp{};
     };
 
+    enum class GameLogLineKind
+    {
+        Other,
+        Combat,
+        Notify,
+        Mining
+    };
+
+    // A game log line split at its "[ timestamp ] (tag)" prefix. Views point into the original line.
+    struct GameLogLine
+    {
+        GameLogLineKind kind{GameLogLineKind::Other};
+        std::string_view timestamp;
+        std::string_view body;
+    };
+
+    GameLogLine classify_game_log_line(std::string_view line);
+
     std::optional<LocalChatEvent> parse_local_chat_line(std::string_view line);
 
+    // Local_<date>_<time>_<character>.txt, the chat channel that reports system changes.
+    bool is_local_chat_log_filename(std::string_view filename);
+
     bool is_combat_log_filename(std::string_view filename);
 
     std::optional<std::string> combat_log_character_id(std::string_view filename);
@@ -46,4 +69,10 @@ namespace helper::logs
     std::optional<CombatDamageEvent> parse_combat_damage_line(std::string_view line);
 
     std::optional<MiningYieldEvent> parse_mining_yield_line(std::string_view line);
+
+    // Allocation-free forms for the log watcher: they only look at lines of the matching kind and fill
+    // `event` in place, so a reused event keeps its string capacity. Return false if the line is not an event.
+    bool parse_combat_damage_line(const GameLogLine& line, CombatDamageEvent& event);
+
+    bool parse_mining_yield_line(const GameLogLine& line, MiningYieldEvent& event);
 }
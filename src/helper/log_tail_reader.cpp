@@ -0,0 +1,382 @@
+#include "log_tail_reader.hpp"
+
+#include "text_simd.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+
+namespace helper::logs
+{
+    namespace
+    {
+        constexpr std::size_t read_chunk_size = 64 * 1024;
+
+        bool starts_with_bytes(const char* data, std::size_t size, std::initializer_list<unsigned char> prefix)
+        {
+            return size >= prefix.size() && std::equal(prefix.begin(), prefix.end(), data, [](unsigned char expected, char actual) {
+                return static_cast<unsigned char>(actual) == expected;
+            });
+        }
+
+        char* put_utf8(char* out, std::uint32_t codePoint)
+        {
+            if (codePoint < 0x80)
+            {
+                *out++ = static_cast<char>(codePoint);
+            }
+            else if (codePoint < 0x800)
+            {
+                *out++ = static_cast<char>(0xC0 | (codePoint >> 6));
+                *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else if (codePoint < 0x10000)
+            {
+                *out++ = static_cast<char>(0xE0 | (codePoint >> 12));
+                *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else
+            {
+                *out++ = static_cast<char>(0xF0 | (codePoint >> 18));
+                *out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            return out;
+        }
+    }
+
+    LogTailReader::~LogTailReader()
+    {
+        close();
+    }
+
+    void LogTailReader::reset(const std::filesystem::path& path, std::uint64_t startOffset)
+    {
+        close();
+        path_ = path;
+        rewind();
+        offset_ = startOffset;
+    }
+
+    std::uint64_t LogTailReader::consumedOffset() const
+    {
+        // The unfinished line is held decoded, so count what it occupied in the file.
+        std::uint64_t pending = text_.size();
+        if (encoding_ == TextEncoding::Utf16LE)
+        {
+            pending = 0;
+            for (const char ch : text_)
+            {
+                const auto byte = static_cast<unsigned char>(ch);
+                if ((byte & 0xC0) != 0x80)
+                {
+                    pending += byte >= 0xF0 ? 4 : 2;
+                }
+            }
+            pending += (oddByte_ ? 1 : 0) + (highSurrogate_ != 0 ? 2 : 0);
+        }
+        return offset_ - std::min(pending, offset_);
+    }
+
+    bool LogTailReader::hasGrown() const
+    {
+        if (path_.empty())
+        {
+            return false;
+        }
+        if (!isOpen())
+        {
+            return true;
+        }
+
+        const auto size = fileSize();
+        return !size || *size != offset_;
+    }
+
+    bool LogTailReader::readLines(const LineCallback& onLine)
+    {
+        if (path_.empty())
+        {
+            return true;
+        }
+        if (!isOpen() && !open())
+        {
+            return false;
+        }
+
+        const auto size = fileSize();
+        if (!size)
+        {
+            return true;
+        }
+        if (*size < offset_)
+        {
+            rewind();
+        }
+
+        if (chunk_.empty())
+        {
+            chunk_.resize(read_chunk_size);
+        }
+        if (!bomChecked_ && offset_ > 0)
+        {
+            // Resuming mid-file: the encoding still comes from the first bytes.
+            detectEncoding(chunk_.data(), readAt(0, chunk_.data(), 3));
+        }
+
+        while (offset_ < *size)
+        {
+            const auto wanted = static_cast<std::size_t>(std::min<std::uint64_t>(*size - offset_, chunk_.size()));
+            const auto read = readAt(offset_, chunk_.data(), wanted);
+            if (read == 0)
+            {
+                break;
+            }
+
+            offset_ += read;
+            decode(chunk_.data(), read);
+            emitLines(onLine);
+        }
+        return true;
+    }
+
+    void LogTailReader::rewind()
+    {
+        offset_ = 0;
+        encoding_ = TextEncoding::Unknown;
+        bomChecked_ = false;
+        skipLineFeed_ = false;
+        oddByte_.reset();
+        highSurrogate_ = 0;
+        text_.clear();
+        scanned_ = 0;
+    }
+
+    std::size_t LogTailReader::detectEncoding(const char* data, std::size_t size)
+    {
+        // The first bytes of the file decide the encoding: chat logs start with a UTF-16LE BOM.
+        encoding_ = starts_with_bytes(data, size, {0xFF, 0xFE}) ? TextEncoding::Utf16LE : TextEncoding::Utf8;
+        bomChecked_ = true;
+        return encoding_ == TextEncoding::Utf16LE ? 2 : (starts_with_bytes(data, size, {0xEF, 0xBB, 0xBF}) ? 3 : 0);
+    }
+
+    void LogTailReader::decode(const char* data, std::size_t size)
+    {
+        if (!bomChecked_ && size > 0)
+        {
+            const auto bom = detectEncoding(data, size);
+            data += bom;
+            size -= bom;
+        }
+
+        if (encoding_ == TextEncoding::Utf16LE)
+        {
+            appendUtf16(data, size);
+        }
+        else
+        {
+            text_.append(data, size);
+        }
+    }
+
+    void LogTailReader::appendUtf16(const char* data, std::size_t size)
+    {
+        // Up to three bytes per unit, plus a replacement character for a dangling high surrogate.
+        const auto start = text_.size();
+        text_.resize(start + (size / 2 + 2) * 3);
+        char* out = text_.data() + start;
+
+        const auto put_unit = [&](std::uint16_t unit) {
+            if (highSurrogate_ != 0)
+            {
+                const auto high = std::exchange(highSurrogate_, std::uint16_t{0});
+                if (unit >= 0xDC00 && unit <= 0xDFFF)
+                {
+                    out = put_utf8(out, 0x10000 + ((static_cast<std::uint32_t>(high) - 0xD800) << 10) + (unit - 0xDC00));
+                    return;
+                }
+                out = put_utf8(out, 0xFFFD);
+            }
+
+            if (unit >= 0xD800 && unit <= 0xDBFF)
+            {
+                highSurrogate_ = unit;
+            }
+            else
+            {
+                out = put_utf8(out, unit >= 0xDC00 && unit <= 0xDFFF ? 0xFFFD : unit);
+            }
+        };
+
+        std::size_t index = 0;
+        if (oddByte_ && size > 0)
+        {
+            put_unit(static_cast<std::uint16_t>(static_cast<unsigned char>(*oddByte_) | (static_cast<unsigned char>(data[0]) << 8)));
+            oddByte_.reset();
+            index = 1;
+        }
+
+        while (index + 1 < size)
+        {
+            if (highSurrogate_ == 0)
+            {
+                // Chat text is nearly all ASCII: copy runs of it with the vector kernel and only decode the
+                // unit that ends each run here.
+                const auto ascii = ascii_utf16le_to_utf8(data + index, (size - index) / 2, out);
+                out += ascii;
+                index += 2 * ascii;
+                if (index + 1 >= size)
+                {
+                    break;
+                }
+            }
+            put_unit(static_cast<std::uint16_t>(static_cast<unsigned char>(data[index]) | (static_cast<unsigned char>(data[index + 1]) << 8)));
+            index += 2;
+        }
+
+        if (index < size)
+        {
+            oddByte_ = data[index];
+        }
+
+        text_.resize(static_cast<std::size_t>(out - text_.data()));
+    }
+
+    void LogTailReader::emitLines(const LineCallback& onLine)
+    {
+        std::size_t position = 0;
+        if (skipLineFeed_ && !text_.empty())
+        {
+            // The "\r\n" straddled two reads.
+            position = text_.front() == '\n' ? 1 : 0;
+            skipLineFeed_ = false;
+        }
+
+        const std::string_view text(text_);
+        std::size_t scan = std::max(position, scanned_);
+        while (true)
+        {
+            const auto newline = scan + find_line_break(text.data() + scan, text.size() - scan);
+            if (newline == text.size())
+            {
+                break;
+            }
+
+            onLine(text.substr(position, newline - position));
+
+            std::size_t next = newline + 1;
+            if (text[newline] == '\r')
+            {
+                if (next == text.size())
+                {
+                    skipLineFeed_ = true;
+                }
+                else if (text[next] == '\n')
+                {
+                    ++next;
+                }
+            }
+            position = scan = next;
+        }
+
+        // Keep only the unfinished line; erasing the prefix moves it down without reallocating.
+        text_.erase(0, position);
+        scanned_ = text_.size();
+    }
+
+#if defined(_WIN32)
+    bool LogTailReader::isOpen() const
+    {
+        return handle_ != nullptr;
+    }
+
+    bool LogTailReader::open()
+    {
+        const HANDLE handle = ::CreateFileW(path_.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        handle_ = handle;
+        return true;
+    }
+
+    void LogTailReader::close()
+    {
+        if (handle_)
+        {
+            ::CloseHandle(handle_);
+            handle_ = nullptr;
+        }
+    }
+
+    std::optional<std::uint64_t> LogTailReader::fileSize() const
+    {
+        LARGE_INTEGER size{};
+        if (!::GetFileSizeEx(handle_, &size))
+        {
+            return std::nullopt;
+        }
+        return static_cast<std::uint64_t>(size.QuadPart);
+    }
+
+    std::size_t LogTailReader::readAt(std::uint64_t offset, char* destination, std::size_t size) const
+    {
+        OVERLAPPED position{};
+        position.Offset = static_cast<DWORD>(offset);
+        position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD read = 0;
+        if (!::ReadFile(handle_, destination, static_cast<DWORD>(size), &read, &position))
+        {
+            return 0;
+        }
+        return read;
+    }
+#else
+    bool LogTailReader::isOpen() const
+    {
+        return descriptor_ >= 0;
+    }
+
+    bool LogTailReader::open()
+    {
+        descriptor_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+        return descriptor_ >= 0;
+    }
+
+    void LogTailReader::close()
+    {
+        if (descriptor_ >= 0)
+        {
+            ::close(descriptor_);
+            descriptor_ = -1;
+        }
+    }
+
+    std::optional<std::uint64_t> LogTailReader::fileSize() const
+    {
+        struct stat info{};
+        if (::fstat(descriptor_, &info) != 0)
+        {
+            return std::nullopt;
+        }
+        return static_cast<std::uint64_t>(info.st_size);
+    }
+
+    std::size_t LogTailReader::readAt(std::uint64_t offset, char* destination, std::size_t size) const
+    {
+        const auto read = ::pread(descriptor_, destination, size, static_cast<off_t>(offset));
+        return read > 0 ? static_cast<std::size_t>(read) : 0;
+    }
+#endif
+}
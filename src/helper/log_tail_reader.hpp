@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace helper::logs
+{
+    // How far a live reader got through one log: the file it follows now, or one it switched away from.
+    struct FollowedLogFile
+    {
+        std::filesystem::path path;
+        std::uint64_t consumedOffset{0};
+        bool live{false};
+    };
+
+    // Follows one log file as the game appends to it. The handle stays open between reads, and the raw bytes
+    // and decoded text go through buffers that are reused, so once they have grown to the longest line a
+    // steady stream of lines costs no allocations. Chat logs are UTF-16LE, game logs UTF-8; both come out
+    // as UTF-8.
+    class LogTailReader
+    {
+    public:
+        using LineCallback = std::function<void(std::string_view line)>;
+
+        LogTailReader() = default;
+        ~LogTailReader();
+
+        LogTailReader(const LogTailReader&) = delete;
+        LogTailReader& operator=(const LogTailReader&) = delete;
+
+        // Follows `path` from its beginning, or from `startOffset`, which must be the start of a line (see
+        // consumedOffset). An empty path closes the reader.
+        void reset(const std::filesystem::path& path, std::uint64_t startOffset = 0);
+
+        const std::filesystem::path& path() const { return path_; }
+        std::uint64_t offset() const { return offset_; }
+
+        // File offset just past the last line passed to readLines, i.e. where an unfinished line starts.
+        std::uint64_t consumedOffset() const;
+
+        // True if the file size no longer matches what has been consumed, or if the file is not open yet.
+        bool hasGrown() const;
+
+        // Reads everything appended since the last call and passes each complete line to `onLine`, without
+        // its terminator. The view points into the reader's buffer and is only valid during the call. A
+        // file that shrank is read again from the start. Returns false if the file could not be opened.
+        bool readLines(const LineCallback& onLine);
+
+    private:
+        enum class TextEncoding
+        {
+            Unknown,
+            Utf8,
+            Utf16LE
+        };
+
+        bool isOpen() const;
+        bool open();
+        void close();
+        void rewind();
+        std::optional<std::uint64_t> fileSize() const;
+        std::size_t readAt(std::uint64_t offset, char* destination, std::size_t size) const;
+        std::size_t detectEncoding(const char* data, std::size_t size);
+        void decode(const char* data, std::size_t size);
+        void appendUtf16(const char* data, std::size_t size);
+        void emitLines(const LineCallback& onLine);
+
+        std::filesystem::path path_;
+        std::uint64_t offset_{0};
+        TextEncoding encoding_{TextEncoding::Unknown};
+        bool bomChecked_{false};
+        bool skipLineFeed_{false};           // the last line ended in '\r' at the end of the buffer
+        std::optional<char> oddByte_;        // first half of a UTF-16 unit split across reads
+        std::uint16_t highSurrogate_{0};     // first half of a surrogate pair split across reads
+        std::vector<char> chunk_;
+        std::string text_;                   // decoded text; holds the unfinished last line between reads
+        std::size_t scanned_{0};             // prefix of text_ already searched for a terminator
+#ifdef _WIN32
+        void* handle_ = nullptr;
+#else
+        int descriptor_ = -1;
+#endif
+    };
+}
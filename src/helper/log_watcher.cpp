@@ -1,6 +1,9 @@
 #include "log_watcher.hpp"
 
+#include "file_change_notifier.hpp"
 #include "log_parsers.hpp"
+#include "telemetry_store.hpp"
+#include "telemetry_window.hpp"
 
 #include <windows.h>
 #include <shlobj.h>
@@ -13,13 +16,15 @@
 #include <ctime>
 #include <cwchar>
 #include <cwctype>
-#include <deque>
 #include <map>
 #include <iomanip>
+#include <iterator>
 #include <cctype>
 #include <cmath>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace helper::logs
@@ -80,11 +85,6 @@ namespace helper::logs
             return true;
         }
 
-        std::wstring to_wstring(const std::filesystem::path& path)
-        {
-            return path.native();
-        }
-
         std::string format_time_utc(const std::chrono::system_clock::time_point& tp)
         {
             const auto seconds = std::chrono::system_clock::to_time_t(tp);
@@ -95,14 +95,16 @@ namespace helper::logs
             return oss.str();
         }
 
-        std::string sanitize(std::string value)
+        // Copies into the existing string so a steady stream of combat lines reuses its capacity.
+        void assign_sanitized(std::string& target, std::string_view value)
         {
-            value.erase(std::remove(value.begin(), value.end(), '\r'), value.end());
-            value.erase(std::remove(value.begin(), value.end(), '\n'), value.end());
-            return value;
+            target.clear();
+            std::copy_if(value.begin(), value.end(), std::back_inserter(target), [](char ch) {
+                return ch != '\r' && ch != '\n';
+            });
         }
 
-        std::string make_bucket_id(const std::string& label)
+        std::string make_bucket_id(std::string_view label)
         {
             std::string id;
             id.reserve(label.size());
@@ -141,6 +143,7 @@ namespace helper::logs
     , miningTelemetryAggregator_(std::make_unique<MiningTelemetryAggregator>())
     , telemetryHistoryAggregator_(std::make_unique<TelemetryHistoryAggregator>())
     , followModeSupplier_(std::move(followSupplier))
+    , notifier_(make_file_change_notifier())
     {
     }
 
@@ -149,8 +152,7 @@ namespace helper::logs
     public:
         void add(const CombatDamageEvent& event)
         {
-            prune(event.timestamp);
-            recent_.push_back(event);
+            recent_.add(event.timestamp, {event.playerDealt ? event.amount : 0.0, event.playerDealt ? 0.0 : event.amount});
             
             // Track session start on first event
             if (sessionStart_.time_since_epoch().count() == 0 && event.timestamp.time_since_epoch().count() != 0)
@@ -193,20 +195,12 @@ namespace helper::logs
             sample.timestampMs = to_ms(event.timestamp);
             sample.damageDealt = totalDamageDealt_;
             sample.damageTaken = totalDamageTaken_;
-            sparklineBuffer_.push_back(sample);
-            
-            // Prune old sparkline samples
-            const auto sparklineCutoff = event.timestamp - sparklineWindow_;
-            while (!sparklineBuffer_.empty() && 
-                   sparklineBuffer_.front().timestampMs < to_ms(sparklineCutoff))
-            {
-                sparklineBuffer_.pop_front();
-            }
+            sparkline_.record(sample);
         }
 
         std::optional<CombatTelemetrySnapshot> snapshot(const std::chrono::system_clock::time_point& now)
         {
-            prune(now);
+            recent_.advance(now);
 
             if (recent_.empty() && totalDamageDealt_ == 0.0 && totalDamageTaken_ == 0.0)
             {
@@ -216,7 +210,7 @@ namespace helper::logs
             CombatTelemetrySnapshot snapshot;
             snapshot.totalDamageDealt = totalDamageDealt_;
             snapshot.totalDamageTaken = totalDamageTaken_;
-            snapshot.recentWindowSeconds = static_cast<double>(window_.count());
+            snapshot.recentWindowSeconds = static_cast<double>(recent_.window().count());
             
             // Copy hit quality counters (dealt)
             snapshot.missDealt = missDealt_;
@@ -249,21 +243,8 @@ namespace helper::logs
                 snapshot.lastEventMs = to_ms(lastEvent_);
             }
 
-            double recentDealt = 0.0;
-            double recentTaken = 0.0;
-            for (const auto& ev : recent_)
-            {
-                if (ev.playerDealt)
-                {
-                    recentDealt += ev.amount;
-                }
-                else
-                {
-                    recentTaken += ev.amount;
-                }
-            }
-            snapshot.recentDamageDealt = recentDealt;
-            snapshot.recentDamageTaken = recentTaken;
+            snapshot.recentDamageDealt = recent_.totals()[0];
+            snapshot.recentDamageTaken = recent_.totals()[1];
 
             if (!snapshot.hasData() && snapshot.recentDamageDealt <= 0.0 && snapshot.recentDamageTaken <= 0.0)
             {
@@ -275,7 +256,7 @@ namespace helper::logs
 
         std::vector<CombatDamageSample> getSparklineBuffer() const
         {
-            return std::vector<CombatDamageSample>(sparklineBuffer_.begin(), sparklineBuffer_.end());
+            return sparkline_.samples();
         }
 
         void reset()
@@ -301,7 +282,7 @@ namespace helper::logs
             smashingTaken_ = 0;
             
             // Clear sparkline buffer
-            sparklineBuffer_.clear();
+            sparkline_.clear();
         }
 
         void restoreSession(const CombatTelemetrySnapshot& persisted)
@@ -338,19 +319,10 @@ namespace helper::logs
         }
 
     private:
-        void prune(const std::chrono::system_clock::time_point& now)
-        {
-            const auto cutoff = now - window_;
-            while (!recent_.empty() && recent_.front().timestamp < cutoff)
-            {
-                recent_.pop_front();
-            }
-        }
-
-        std::deque<CombatDamageEvent> recent_;
+        // Recent damage as {dealt, taken}, summed as events arrive and age out.
+        WindowedSums<2> recent_{std::chrono::seconds{30}};
         double totalDamageDealt_{0.0};
         double totalDamageTaken_{0.0};
-        std::chrono::seconds window_{30};
         std::chrono::system_clock::time_point lastEvent_{};
         std::chrono::system_clock::time_point sessionStart_{};
         
@@ -368,9 +340,8 @@ namespace helper::logs
         std::uint64_t penetratingTaken_{0};
         std::uint64_t smashingTaken_{0};
         
-        // Sparkline buffer (high-granularity samples, 120s retention)
-        std::deque<CombatDamageSample> sparklineBuffer_;
-        static constexpr std::chrono::seconds sparklineWindow_{120};
+        // Sparkline buffer (1s resolution, 120s retention)
+        SparklineRing<CombatDamageSample, 120> sparkline_;
     };
 
     class LogWatcher::MiningTelemetryAggregator
@@ -380,46 +351,30 @@ namespace helper::logs
 
         void add(const MiningYieldEvent& event)
         {
-            MiningYieldEvent normalized = event;
-            normalized.resource = normalizeResourceLabel(normalized.resource);
-            if (normalized.resource.empty())
-            {
-                normalized.resource = "Unknown resource";
-            }
-
-            prune(normalized.timestamp);
+            const auto resource = resourceIndex(event.resource);
 
             // Only set sessionStart_ if this is the FIRST event ever (not after restore)
             // After restore, sessionStart_ is already set to the original session start time
-            if (sessionStart_.time_since_epoch().count() == 0 && normalized.timestamp.time_since_epoch().count() != 0)
+            if (sessionStart_.time_since_epoch().count() == 0 && event.timestamp.time_since_epoch().count() != 0)
             {
-                sessionStart_ = normalized.timestamp;
+                sessionStart_ = event.timestamp;
             }
 
-            recent_.push_back(std::move(normalized));
-            const auto& stored = recent_.back();
-            totalVolume_ += stored.volumeM3;
-            lastEvent_ = stored.timestamp;
-            sessionBuckets_[stored.resource] += stored.volumeM3;
+            recent_.add(event.timestamp, {event.volumeM3}, resource);
+            totalVolume_ += event.volumeM3;
+            lastEvent_ = event.timestamp;
+            resources_[resource].sessionTotalM3 += event.volumeM3;
             
             // Add sparkline sample (cumulative volume at this timestamp)
             MiningRateSample sample;
-            sample.timestampMs = to_ms(stored.timestamp);
+            sample.timestampMs = to_ms(event.timestamp);
             sample.volumeM3 = totalVolume_;
-            sparklineBuffer_.push_back(sample);
-            
-            // Prune old sparkline samples
-            const auto sparklineCutoff = stored.timestamp - sparklineWindow_;
-            while (!sparklineBuffer_.empty() && 
-                   sparklineBuffer_.front().timestampMs < to_ms(sparklineCutoff))
-            {
-                sparklineBuffer_.pop_front();
-            }
+            sparkline_.record(sample);
         }
 
         std::optional<MiningTelemetrySnapshot> snapshot(const std::chrono::system_clock::time_point& now)
         {
-            prune(now);
+            recent_.advance(now);
 
             if (recent_.empty() && totalVolume_ == 0.0)
             {
@@ -428,7 +383,7 @@ namespace helper::logs
 
             MiningTelemetrySnapshot snapshot;
             snapshot.totalVolumeM3 = totalVolume_;
-            snapshot.recentWindowSeconds = static_cast<double>(window_.count());
+            snapshot.recentWindowSeconds = static_cast<double>(recent_.window().count());
             if (lastEvent_.time_since_epoch().count() != 0)
             {
                 snapshot.lastEventMs = to_ms(lastEvent_);
@@ -439,60 +394,28 @@ namespace helper::logs
                 const auto elapsed = now - sessionStart_;
                 snapshot.sessionDurationSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(elapsed).count();
             }
+            snapshot.recentVolumeM3 = recent_.totals()[0];
 
-            double recentVolume = 0.0;
-            std::map<std::string, double> recentBuckets;
-            for (const auto& ev : recent_)
+            // One bucket per resource seen this session; the window keeps their recent sums current.
+            snapshot.buckets = resources_;
+            for (std::size_t i = 0; i < snapshot.buckets.size(); ++i)
             {
-                recentVolume += ev.volumeM3;
-                recentBuckets[ev.resource] += ev.volumeM3;
+                snapshot.buckets[i].recentVolumeM3 = recent_.forKey(static_cast<std::uint32_t>(i))[0];
             }
-            snapshot.recentVolumeM3 = recentVolume;
-
-            if (!sessionBuckets_.empty() || !recentBuckets.empty())
-            {
-                snapshot.buckets.reserve(sessionBuckets_.size() + recentBuckets.size());
-
-                for (const auto& kv : sessionBuckets_)
+            std::sort(snapshot.buckets.begin(), snapshot.buckets.end(), [](const MiningBucketSnapshot& a, const MiningBucketSnapshot& b) {
+                constexpr double epsilon = 1e-6;
+                const double diffSession = a.sessionTotalM3 - b.sessionTotalM3;
+                if (std::abs(diffSession) > epsilon)
                 {
-                    MiningBucketSnapshot bucket;
-                    bucket.resource = kv.first;
-                    bucket.sessionTotalM3 = kv.second;
-                    if (auto it = recentBuckets.find(kv.first); it != recentBuckets.end())
-                    {
-                        bucket.recentVolumeM3 = it->second;
-                    }
-                    snapshot.buckets.push_back(std::move(bucket));
+                    return diffSession > 0.0;
                 }
-
-                for (const auto& kv : recentBuckets)
+                const double diffRecent = a.recentVolumeM3 - b.recentVolumeM3;
+                if (std::abs(diffRecent) > epsilon)
                 {
-                    if (sessionBuckets_.find(kv.first) != sessionBuckets_.end())
-                    {
-                        continue;
-                    }
-                    MiningBucketSnapshot bucket;
-                    bucket.resource = kv.first;
-                    bucket.sessionTotalM3 = 0.0;
-                    bucket.recentVolumeM3 = kv.second;
-                    snapshot.buckets.push_back(std::move(bucket));
+                    return diffRecent > 0.0;
                 }
-
-                std::sort(snapshot.buckets.begin(), snapshot.buckets.end(), [](const MiningBucketSnapshot& a, const MiningBucketSnapshot& b) {
-                    constexpr double epsilon = 1e-6;
-                    const double diffSession = a.sessionTotalM3 - b.sessionTotalM3;
-                    if (std::abs(diffSession) > epsilon)
-                    {
-                        return diffSession > 0.0;
-                    }
-                    const double diffRecent = a.recentVolumeM3 - b.recentVolumeM3;
-                    if (std::abs(diffRecent) > epsilon)
-                    {
-                        return diffRecent > 0.0;
-                    }
-                    return a.resource < b.resource;
-                });
-            }
+                return a.resource.view() < b.resource.view();
+            });
 
             if (!snapshot.hasData() && snapshot.recentVolumeM3 <= 0.0)
             {
@@ -504,7 +427,7 @@ namespace helper::logs
 
         std::vector<MiningRateSample> getSparklineBuffer() const
         {
-            return std::vector<MiningRateSample>(sparklineBuffer_.begin(), sparklineBuffer_.end());
+            return sparkline_.samples();
         }
 
         void reset()
@@ -512,9 +435,10 @@ namespace helper::logs
             recent_.clear();
             totalVolume_ = 0.0;
             lastEvent_ = std::chrono::system_clock::time_point{};
-            sessionBuckets_.clear();
+            resources_.clear();
+            resourceIndices_.clear();
             sessionStart_ = std::chrono::system_clock::time_point{};
-            sparklineBuffer_.clear();
+            sparkline_.clear();
         }
 
         void restoreSession(const MiningTelemetrySnapshot& persisted)
@@ -533,54 +457,72 @@ namespace helper::logs
             }
             
             // Restore bucket totals
-            sessionBuckets_.clear();
+            recent_.clear();
+            resources_.clear();
+            resourceIndices_.clear();
             for (const auto& bucket : persisted.buckets)
             {
                 if (bucket.sessionTotalM3 > 0.0)
                 {
-                    sessionBuckets_[bucket.resource] = bucket.sessionTotalM3;
+                    resources_[resourceIndex(bucket.resource)].sessionTotalM3 = bucket.sessionTotalM3;
                 }
             }
             
             spdlog::info("Restored mining session: {:.1f} m³ total, {} ore types", 
-                         totalVolume_, sessionBuckets_.size());
+                         totalVolume_, resources_.size());
         }
 
     private:
-        static std::string normalizeResourceLabel(std::string label)
+        static std::string_view normalizeResourceLabel(std::string_view label)
         {
             const auto notSpace = [](unsigned char ch) {
                 return std::isspace(ch) == 0;
             };
-            auto begin = std::find_if(label.begin(), label.end(), notSpace);
-            auto end = std::find_if(label.rbegin(), label.rend(), notSpace).base();
+            const auto begin = std::find_if(label.begin(), label.end(), notSpace);
+            const auto end = std::find_if(label.rbegin(), label.rend(), notSpace).base();
             if (begin >= end)
             {
-                return {};
+                return "Unknown resource";
             }
-            std::string trimmed(begin, end);
-            return trimmed;
+            return label.substr(static_cast<std::size_t>(begin - label.begin()), static_cast<std::size_t>(end - begin));
         }
 
-        void prune(const std::chrono::system_clock::time_point& now)
+        // Dense index into resources_, which is also the resource's key in the recent window. Labels are
+        // normalized and slugified once, the first time their interned id is seen.
+        std::uint32_t resourceIndex(InternedString raw)
         {
-            const auto cutoff = now - window_;
-            while (!recent_.empty() && recent_.front().timestamp < cutoff)
+            if (const auto it = resourceIndices_.find(raw.id()); it != resourceIndices_.end())
+            {
+                return it->second;
+            }
+
+            const InternedString label(normalizeResourceLabel(raw.view()));
+            auto index = static_cast<std::uint32_t>(resources_.size());
+            if (const auto it = resourceIndices_.find(label.id()); it != resourceIndices_.end())
             {
-                recent_.pop_front();
+                index = it->second;
             }
+            else
+            {
+                MiningBucketSnapshot bucket;
+                bucket.resource = label;
+                bucket.bucketId = InternedString(make_bucket_id(label.view()));
+                resources_.push_back(bucket);
+                resourceIndices_.emplace(label.id(), index);
+            }
+            resourceIndices_.emplace(raw.id(), index);
+            return index;
         }
 
-        std::deque<MiningYieldEvent> recent_;
+        WindowedSums<1> recent_{kDefaultWindow};
         double totalVolume_{0.0};
-        std::chrono::seconds window_{kDefaultWindow};
         std::chrono::system_clock::time_point lastEvent_{};
-        std::map<std::string, double> sessionBuckets_;
+        std::vector<MiningBucketSnapshot> resources_;                     // session totals; recent filled at snapshot
+        std::unordered_map<std::uint32_t, std::uint32_t> resourceIndices_;   // interned label id -> index
         std::chrono::system_clock::time_point sessionStart_{};
         
-        // Sparkline buffer (high-granularity samples, 120s retention)
-        std::deque<MiningRateSample> sparklineBuffer_;
-        static constexpr std::chrono::seconds sparklineWindow_{120};
+        // Sparkline buffer (1s resolution, 120s retention)
+        SparklineRing<MiningRateSample, 120> sparkline_;
     };
 
     class LogWatcher::TelemetryHistoryAggregator
@@ -631,6 +573,7 @@ namespace helper::logs
             }
             resetMarkers_.push_back(marker);
             pruneMarkers(cutoffMs(marker));
+            ++revision_;
         }
 
         void resetAll()
@@ -638,6 +581,14 @@ namespace helper::logs
             slices_.clear();
             resetMarkers_.clear();
             saturated_ = false;
+            ++revision_;
+        }
+
+        // Changes whenever snapshot(now) would return something different from the previous call.
+        std::uint64_t revision(const std::chrono::system_clock::time_point& now)
+        {
+            prune(now);
+            return revision_;
         }
 
         TelemetryHistorySnapshot snapshot(const std::chrono::system_clock::time_point& now)
@@ -691,6 +642,7 @@ namespace helper::logs
             slice.damageDealt += dealt;
             slice.damageTaken += taken;
             slice.miningVolume += mining;
+            ++revision_;
 
             prune(std::chrono::system_clock::time_point{std::chrono::milliseconds{ms}});
         }
@@ -708,6 +660,7 @@ namespace helper::logs
                         break;
                     }
                     slices_.erase(it);
+                    ++revision_;
                 }
 
                 pruneMarkers(cutoff);
@@ -720,6 +673,7 @@ namespace helper::logs
                 {
                     slices_.erase(slices_.begin());
                 }
+                ++revision_;
             }
         }
 
@@ -757,6 +711,7 @@ namespace helper::logs
                     break;
                 }
                 it = resetMarkers_.erase(it);
+                ++revision_;
             }
         }
 
@@ -766,6 +721,7 @@ namespace helper::logs
         std::chrono::seconds historyDuration_{std::chrono::hours(24)};
         std::size_t capacity_{0};
         bool saturated_{false};
+        std::uint64_t revision_{0};
     };
 
     LogWatcher::~LogWatcher()
@@ -799,7 +755,7 @@ namespace helper::logs
             stopRequested_.store(true);
         }
 
-        cv_.notify_all();
+        wakeWorker();
         if (worker_.joinable())
         {
             worker_.join();
@@ -813,28 +769,88 @@ namespace helper::logs
         return status_;
     }
 
+    std::vector<FollowedLogFile> LogWatcher::followedFiles() const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto files = retiredFiles_;
+        for (const auto* tail : {&chatTail_, &combatTail_})
+        {
+            if (!tail->path().empty())
+            {
+                files.push_back(FollowedLogFile{tail->path(), tail->consumedOffset(), true});
+            }
+        }
+        return files;
+    }
+
     void LogWatcher::run()
     {
         spdlog::info("Log watcher thread starting");
 
+        // pollInterval is the directory rescan cadence. In between, the loop wakes on change notifications, or
+        // where those are unavailable polls every activePollInterval after new lines and backs off while idle.
         const auto pollInterval = std::max(std::chrono::milliseconds{250}, config_.pollInterval);
+        const auto activePollInterval = std::chrono::milliseconds{50};
+
+        std::vector<std::filesystem::path> watchedDirectories;
+        std::vector<FileChange> changes;
+        bool watching = false;
+        bool rescan = true;
+        auto lastRescan = std::chrono::steady_clock::time_point{};
+        auto idleWait = activePollInterval;
 
         while (!stopRequested_.load())
         {
             LogWatcherStatus snapshot;
             bool publish = false;
             bool forcePublish = false;
+            bool grew = false;
 
             {
                 std::unique_lock<std::mutex> lock(mutex_);
                 status_.running = true;
 
                 discoverDirectories();
-                forcePublish |= refreshChatFile();
-                refreshCombatFile();
 
-                publish |= processLocalChat();
-                publish |= processCombat();
+                std::vector<std::filesystem::path> directories;
+                for (const auto* directory : {&status_.chatDirectory, &status_.combatDirectory})
+                {
+                    if (!directory->empty())
+                    {
+                        directories.push_back(*directory);
+                    }
+                }
+                if (directories != watchedDirectories)
+                {
+                    watchedDirectories = directories;
+                    watching = notifier_ && !directories.empty() && notifier_->watch(directories);
+                    rescan = true;
+                    spdlog::info("Log watcher {} log directories", watching ? "watching" : "polling");
+                }
+
+                // A rescan also reads both tails unconditionally, so a stale size from the filesystem can only
+                // delay lines until the next one.
+                const auto now = std::chrono::steady_clock::now();
+                const bool fullPass = rescan || now - lastRescan >= pollInterval;
+                if (fullPass)
+                {
+                    forcePublish |= refreshChatFile();
+                    refreshCombatFile();
+                    lastRescan = now;
+                    rescan = false;
+                }
+
+                const bool chatGrew = chatTail_.hasGrown();
+                const bool combatGrew = combatTail_.hasGrown();
+                grew = chatGrew || combatGrew;
+                if (fullPass || chatGrew)
+                {
+                    publish |= processLocalChat();
+                }
+                if (fullPass || combatGrew)
+                {
+                    publish |= processCombat();
+                }
 
                 snapshot = status_;
                 
@@ -857,8 +873,26 @@ namespace helper::logs
 
             publishStateIfNeeded(snapshot, publish || forcePublish);
 
+            if (watching)
+            {
+                // New or renamed files, and notifications the platform dropped, need the directories rescanned;
+                // plain writes only need the size check above.
+                changes.clear();
+                notifier_->wait(pollInterval, changes);
+                rescan = std::any_of(changes.begin(), changes.end(), [](const FileChange& change) {
+                    return change.renamed || change.fileName.empty();
+                });
+                if (!notifier_->watching())
+                {
+                    spdlog::warn("Log directory notifications stopped; polling instead");
+                    watching = false;
+                }
+                continue;
+            }
+
+            idleWait = grew ? activePollInterval : std::min(idleWait * 2, pollInterval);
             std::unique_lock<std::mutex> waitLock(mutex_);
-            cv_.wait_for(waitLock, pollInterval, [this]() {
+            cv_.wait_for(waitLock, idleWait, [this]() {
                 return stopRequested_.load();
             });
         }
@@ -866,6 +900,15 @@ namespace helper::logs
         spdlog::info("Log watcher thread stopping");
     }
 
+    void LogWatcher::wakeWorker()
+    {
+        cv_.notify_all();
+        if (notifier_)
+        {
+            notifier_->wake();
+        }
+    }
+
     bool LogWatcher::discoverDirectories()
     {
         bool changed = false;
@@ -876,7 +919,7 @@ namespace helper::logs
             if (status_.chatDirectory != desired)
             {
                 status_.chatDirectory = desired;
-                chatTail_.reset({});
+                followTail(chatTail_, {});
                 changed = true;
             }
         }
@@ -885,7 +928,7 @@ namespace helper::logs
             if (auto resolved = resolveDefaultDirectory(L"Chatlogs"))
             {
                 status_.chatDirectory = *resolved;
-                chatTail_.reset({});
+                followTail(chatTail_, {});
                 changed = true;
             }
         }
@@ -896,7 +939,7 @@ namespace helper::logs
             if (status_.combatDirectory != desired)
             {
                 status_.combatDirectory = desired;
-                combatTail_.reset({});
+                followTail(combatTail_, {});
             }
         }
         else if (status_.combatDirectory.empty())
@@ -904,7 +947,7 @@ namespace helper::logs
             if (auto resolved = resolveDefaultDirectory(L"Gamelogs"))
             {
                 status_.combatDirectory = *resolved;
-                combatTail_.reset({});
+                followTail(combatTail_, {});
             }
         }
 
@@ -924,21 +967,21 @@ namespace helper::logs
     {
         if (status_.chatDirectory.empty())
         {
-            chatTail_.path.clear();
+            followTail(chatTail_, {});
             return false;
         }
 
         auto latest = latestChatLogPath(status_.chatDirectory);
         if (!latest.has_value())
         {
-            chatTail_.path.clear();
+            followTail(chatTail_, {});
             status_.chatFile.clear();
             return false;
         }
 
-        if (chatTail_.path != *latest)
+        if (chatTail_.path() != *latest)
         {
-            chatTail_.reset(*latest);
+            followTail(chatTail_, *latest);
             status_.chatFile = *latest;
             lastPublishedSystemId_.reset();
             status_.lastError.clear();
@@ -959,26 +1002,26 @@ namespace helper::logs
     {
         if (status_.combatDirectory.empty())
         {
-            combatTail_.path.clear();
+            followTail(combatTail_, {});
             return false;
         }
 
         auto latest = latestCombatLogPath(status_.combatDirectory);
         if (!latest.has_value())
         {
-            combatTail_.path.clear();
+            followTail(combatTail_, {});
             status_.combatFile.clear();
             status_.combat.reset();
             return false;
         }
 
-        if (combatTail_.path != *latest)
+        if (combatTail_.path() != *latest)
         {
             // Preserve mining session data when switching combat log files
             // Save both the snapshot and restore aggregator state to maintain session continuity
             auto preservedMining = status_.telemetry.mining;
             
-            combatTail_.reset(*latest);
+            followTail(combatTail_, *latest);
             status_.combatFile = *latest;
             status_.combat.emplace();
             combatTelemetryAggregator_->reset();
@@ -1015,21 +1058,34 @@ namespace helper::logs
         return false;
     }
 
+    void LogWatcher::followTail(LogTailReader& tail, const std::filesystem::path& path)
+    {
+        constexpr std::size_t maxRetiredFiles = 64;
+        if (!tail.path().empty() && tail.path() != path)
+        {
+            std::erase_if(retiredFiles_, [&](const FollowedLogFile& file) { return file.path == tail.path(); });
+            if (retiredFiles_.size() >= maxRetiredFiles)
+            {
+                retiredFiles_.erase(retiredFiles_.begin());
+            }
+            retiredFiles_.push_back(FollowedLogFile{tail.path(), tail.consumedOffset(), false});
+        }
+        tail.reset(path);
+    }
+
     bool LogWatcher::processLocalChat()
     {
-        if (chatTail_.path.empty())
+        if (chatTail_.path().empty())
         {
             return false;
         }
 
-        auto lines = readNewLines(chatTail_);
         bool updated = false;
-        for (const auto& line : lines)
-        {
+        const bool opened = chatTail_.readLines([&](std::string_view line) {
             auto parsed = parse_local_chat_line(line);
             if (!parsed.has_value())
             {
-                continue;
+                return;
             }
 
             LocationSample sample;
@@ -1050,6 +1106,10 @@ namespace helper::logs
 
             status_.location = std::move(sample);
             updated = true;
+        });
+        if (!opened)
+        {
+            status_.lastError = "Unable to open log file";
         }
 
         return updated;
@@ -1057,57 +1117,68 @@ namespace helper::logs
 
     bool LogWatcher::processCombat()
     {
-        if (combatTail_.path.empty())
+        if (combatTail_.path().empty())
         {
             return false;
         }
 
-        auto lines = readNewLines(combatTail_);
-        if (lines.empty())
-        {
-            return false;
-        }
-
-        if (!status_.combat.has_value())
-        {
-            status_.combat.emplace();
-            if (auto id = combat_log_character_id(combatTail_.path.filename().string()))
-            {
-                status_.combat->characterId = *id;
-            }
-        }
-
         bool updated = false;
         bool telemetryUpdated = false;
-        for (const auto& line : lines)
-        {
-            if (const auto combatEvent = parse_combat_damage_line(line))
+        CombatDamageEvent combatEvent;
+        MiningYieldEvent miningEvent;
+        auto* const store = config_.telemetryStore;
+        const auto source = store ? telemetry::source_key(combatTail_.path()) : std::string{};
+        const bool opened = combatTail_.readLines([&](std::string_view line) {
+            if (!status_.combat.has_value())
+            {
+                status_.combat.emplace();
+                if (auto id = combat_log_character_id(combatTail_.path().filename().string()))
+                {
+                    status_.combat->characterId = *id;
+                }
+            }
+
+            // Most lines are neither combat nor mining; the tag rules them out before any parsing.
+            const auto classified = classify_game_log_line(line);
+            if (parse_combat_damage_line(classified, combatEvent))
             {
-                combatTelemetryAggregator_->add(*combatEvent);
-                telemetryHistoryAggregator_->addCombat(*combatEvent);
+                combatTelemetryAggregator_->add(combatEvent);
+                telemetryHistoryAggregator_->addCombat(combatEvent);
+                if (store)
+                {
+                    store->append(source, telemetry::TelemetryRecord::combat(to_ms(combatEvent.timestamp), combatEvent.playerDealt, combatEvent.amount, static_cast<std::uint8_t>(combatEvent.quality)));
+                }
                 telemetryUpdated = true;
             }
-
-            if (const auto miningEvent = parse_mining_yield_line(line))
+            else if (parse_mining_yield_line(classified, miningEvent))
             {
-                miningTelemetryAggregator_->add(*miningEvent);
-                telemetryHistoryAggregator_->addMining(*miningEvent);
+                miningTelemetryAggregator_->add(miningEvent);
+                telemetryHistoryAggregator_->addMining(miningEvent);
+                if (store)
+                {
+                    store->append(source, telemetry::TelemetryRecord::mining(to_ms(miningEvent.timestamp), miningEvent.volumeM3, store->resourceId(miningEvent.resource.view())));
+                }
                 telemetryUpdated = true;
             }
 
-            if (line.find("(combat)") != std::string::npos)
+            if (classified.kind == GameLogLineKind::Combat)
             {
                 ++status_.combat->combatEventCount;
-                status_.combat->lastCombatLine = sanitize(line);
+                assign_sanitized(status_.combat->lastCombatLine, line);
                 status_.combat->lastEventAt = std::chrono::system_clock::now();
                 updated = true;
             }
-            else if (line.find("(notify)") != std::string::npos)
+            else if (classified.kind == GameLogLineKind::Notify)
             {
                 ++status_.combat->notifyEventCount;
                 status_.combat->lastEventAt = std::chrono::system_clock::now();
                 updated = true;
             }
+        });
+        if (!opened)
+        {
+            status_.lastError = "Unable to open log file";
+            return false;
         }
 
         if (telemetryUpdated)
@@ -1129,213 +1200,6 @@ namespace helper::logs
         return updated || telemetryUpdated;
     }
 
-    std::vector<std::string> LogWatcher::readNewLines(FileTailState& state)
-    {
-        std::vector<std::string> lines;
-        if (state.path.empty())
-        {
-            return lines;
-        }
-
-        const auto pathW = to_wstring(state.path);
-        HANDLE handle = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
-        if (handle == INVALID_HANDLE_VALUE)
-        {
-            status_.lastError = "Unable to open log file";
-            return lines;
-        }
-
-        LARGE_INTEGER size{};
-        if (!GetFileSizeEx(handle, &size))
-        {
-            CloseHandle(handle);
-            return lines;
-        }
-
-        std::uint64_t fileSize = static_cast<std::uint64_t>(size.QuadPart);
-        if (fileSize < state.offset)
-        {
-            state.offset = 0;
-            state.encoding = TextEncoding::Unknown;
-            state.consumedBom = false;
-            state.pendingLine.clear();
-            state.pendingBytes.clear();
-        }
-
-        if (fileSize == state.offset)
-        {
-            CloseHandle(handle);
-            return lines;
-        }
-
-        std::uint64_t remaining = fileSize - state.offset;
-        std::vector<char> buffer(static_cast<std::size_t>(remaining));
-
-        LARGE_INTEGER seek{};
-        seek.QuadPart = static_cast<LONGLONG>(state.offset);
-        if (!SetFilePointerEx(handle, seek, nullptr, FILE_BEGIN))
-        {
-            CloseHandle(handle);
-            return lines;
-        }
-
-        DWORD totalRead = 0;
-        while (remaining > 0)
-        {
-            const DWORD chunk = static_cast<DWORD>(std::min<std::uint64_t>(remaining, static_cast<std::uint64_t>(64 * 1024)));
-            DWORD read = 0;
-            if (!ReadFile(handle, buffer.data() + totalRead, chunk, &read, nullptr) || read == 0)
-            {
-                break;
-            }
-            totalRead += read;
-            remaining -= read;
-        }
-        CloseHandle(handle);
-
-        if (totalRead == 0)
-        {
-            return lines;
-        }
-
-        buffer.resize(totalRead);
-        state.offset += totalRead;
-
-        if (!state.pendingBytes.empty())
-        {
-            buffer.insert(buffer.begin(), state.pendingBytes.begin(), state.pendingBytes.end());
-            state.pendingBytes.clear();
-        }
-
-        const bool firstChunk = !state.consumedBom;
-        auto converted = convertToUtf8(state, buffer, firstChunk);
-        if (converted.empty())
-        {
-            return lines;
-        }
-
-        state.consumedBom = true;
-
-        if (converted.size() >= 3 && static_cast<unsigned char>(converted[0]) == 0xEF && static_cast<unsigned char>(converted[1]) == 0xBB && static_cast<unsigned char>(converted[2]) == 0xBF)
-        {
-            converted.erase(0, 3);
-        }
-
-        std::string combined;
-        combined.reserve(state.pendingLine.size() + converted.size());
-        combined.append(state.pendingLine);
-        combined.append(converted);
-        state.pendingLine.clear();
-
-        std::size_t position = 0;
-        while (position < combined.size())
-        {
-            const auto newline = combined.find_first_of("\r\n", position);
-            if (newline == std::string::npos)
-            {
-                break;
-            }
-
-            std::size_t next = newline + 1;
-            if (combined[newline] == '\r' && next < combined.size() && combined[next] == '\n')
-            {
-                ++next;
-            }
-
-            lines.emplace_back(combined.substr(position, newline - position));
-            position = next;
-        }
-
-        state.pendingLine = combined.substr(position);
-        return lines;
-    }
-
-    bool LogWatcher::ensureUtf16Even(FileTailState& state, std::vector<char>& buffer)
-    {
-        if (buffer.empty())
-        {
-            return false;
-        }
-
-        if (buffer.size() % 2 == 0)
-        {
-            return true;
-        }
-
-        state.pendingBytes.push_back(buffer.back());
-        buffer.pop_back();
-        return !buffer.empty();
-    }
-
-    std::string LogWatcher::convertToUtf8(FileTailState& state, std::vector<char>& buffer, bool isFirstChunk)
-    {
-        if (buffer.empty())
-        {
-            return {};
-        }
-
-        if (state.encoding == TextEncoding::Unknown)
-        {
-            if (buffer.size() >= 2 && static_cast<unsigned char>(buffer[0]) == 0xFF && static_cast<unsigned char>(buffer[1]) == 0xFE)
-            {
-                state.encoding = TextEncoding::Utf16LE;
-            }
-            else
-            {
-                state.encoding = TextEncoding::Utf8;
-            }
-        }
-
-        if (state.encoding == TextEncoding::Utf8)
-        {
-            std::size_t start = 0;
-            if (isFirstChunk && buffer.size() >= 3 && static_cast<unsigned char>(buffer[0]) == 0xEF && static_cast<unsigned char>(buffer[1]) == 0xBB && static_cast<unsigned char>(buffer[2]) == 0xBF)
-            {
-                start = 3;
-            }
-            return std::string(buffer.data() + start, buffer.data() + buffer.size());
-        }
-
-        if (state.encoding == TextEncoding::Utf16LE)
-        {
-            std::size_t offset = 0;
-            if (isFirstChunk && buffer.size() >= 2 && static_cast<unsigned char>(buffer[0]) == 0xFF && static_cast<unsigned char>(buffer[1]) == 0xFE)
-            {
-                offset = 2;
-            }
-
-            if (buffer.size() <= offset)
-            {
-                return {};
-            }
-
-            std::vector<char> slice(buffer.begin() + static_cast<std::ptrdiff_t>(offset), buffer.end());
-            if (!ensureUtf16Even(state, slice))
-            {
-                return {};
-            }
-
-            const wchar_t* wide = reinterpret_cast<const wchar_t*>(slice.data());
-            const int wcharCount = static_cast<int>(slice.size() / sizeof(wchar_t));
-            if (wcharCount <= 0)
-            {
-                return {};
-            }
-
-            const int required = WideCharToMultiByte(CP_UTF8, 0, wide, wcharCount, nullptr, 0, nullptr, nullptr);
-            if (required <= 0)
-            {
-                return {};
-            }
-
-            std::string utf8(static_cast<std::size_t>(required), '\0');
-            WideCharToMultiByte(CP_UTF8, 0, wide, wcharCount, utf8.data(), required, nullptr, nullptr);
-            return utf8;
-        }
-
-        return {};
-    }
-
     std::optional<std::filesystem::path> LogWatcher::resolveDefaultDirectory(const wchar_t* subFolder) const
     {
         PWSTR rawPath = nullptr;
@@ -1588,8 +1452,8 @@ namespace helper::logs
                         for (const auto& bucket : mining.buckets)
                         {
                             overlay::TelemetryBucket schemaBucket;
-                            schemaBucket.id = make_bucket_id(bucket.resource);
-                            schemaBucket.label = bucket.resource;
+                            schemaBucket.id = bucket.bucketId.str();
+                            schemaBucket.label = bucket.resource.str();
                             schemaBucket.session_total = bucket.sessionTotalM3;
                             schemaBucket.recent_total = bucket.recentVolumeM3;
                             payload.buckets.push_back(std::move(schemaBucket));
@@ -1661,11 +1525,11 @@ namespace helper::logs
         // Clear current directories to force re-discovery
         status_.chatDirectory.clear();
         status_.combatDirectory.clear();
-        chatTail_.reset({});
-        combatTail_.reset({});
+        followTail(chatTail_, {});
+        followTail(combatTail_, {});
         
         // Wake up the worker thread to re-discover directories
-        cv_.notify_one();
+        wakeWorker();
     }
 
     bool LogWatcher::followModeEnabled() const
@@ -1711,6 +1575,23 @@ namespace helper::logs
         return summary;
     }
 
+    std::uint64_t LogWatcher::telemetryHistoryRevision()
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return telemetryHistoryAggregator_->revision(std::chrono::system_clock::now());
+    }
+
+    std::optional<TelemetryHistorySnapshot> LogWatcher::telemetryHistorySnapshot()
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto historySnapshot = telemetryHistoryAggregator_->snapshot(std::chrono::system_clock::now());
+        if (!historySnapshot.hasData() && historySnapshot.resetMarkersMs.empty())
+        {
+            return std::nullopt;
+        }
+        return historySnapshot;
+    }
+
     TelemetrySummary LogWatcher::resetTelemetrySession()
     {
         std::lock_guard<std::mutex> guard(mutex_);
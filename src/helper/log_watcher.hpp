@@ -13,11 +13,20 @@
 #include <vector>
 #include <map>
 
+#include "log_tail_reader.hpp"
 #include "overlay_schema.hpp"
+#include "string_interner.hpp"
 #include "system_resolver.hpp"
 
+namespace helper::telemetry
+{
+    class TelemetryStore;
+}
+
 namespace helper::logs
 {
+    class FileChangeNotifier;
+
     struct LocationSample
     {
         std::string systemName;
@@ -67,7 +76,8 @@ namespace helper::logs
 
     struct MiningBucketSnapshot
     {
-        std::string resource;
+        InternedString resource;
+        InternedString bucketId;        // slug of resource, for overlay::TelemetryBucket::id
         double sessionTotalM3{0.0};
         double recentVolumeM3{0.0};
     };
@@ -153,6 +163,7 @@ namespace helper::logs
             std::optional<std::filesystem::path> chatDirectoryOverride;
             std::optional<std::filesystem::path> combatDirectoryOverride;
             std::chrono::milliseconds pollInterval{std::chrono::milliseconds{750}};
+            telemetry::TelemetryStore* telemetryStore{nullptr};  // optional; receives every combat and mining event
         };
 
         using PublishCallback = std::function<void(const overlay::OverlayState& state, std::size_t payloadBytes)>;
@@ -170,7 +181,14 @@ namespace helper::logs
 
         LogWatcherStatus status() const;
 
+        // The chat and combat logs followed now, and those left behind on rotation, with how much of each
+        // was read. The backfill starts after these offsets so no line is counted twice.
+        std::vector<FollowedLogFile> followedFiles() const;
+
     TelemetrySummary telemetrySnapshot();
+    // The history part of telemetrySnapshot() alone, and a revision that changes whenever it does.
+    std::optional<TelemetryHistorySnapshot> telemetryHistorySnapshot();
+    std::uint64_t telemetryHistoryRevision();
     TelemetrySummary resetTelemetrySession();
     void restoreMiningSession(const MiningTelemetrySnapshot& persisted);
     void forcePublish();
@@ -181,42 +199,14 @@ namespace helper::logs
         void reloadLogPaths();
 
     private:
-        enum class TextEncoding
-        {
-            Unknown,
-            Utf8,
-            Utf16LE
-        };
-
-        struct FileTailState
-        {
-            std::filesystem::path path;
-            std::uint64_t offset{0};
-            TextEncoding encoding{TextEncoding::Unknown};
-            bool consumedBom{false};
-            std::string pendingLine;
-            std::vector<char> pendingBytes;
-
-            void reset(const std::filesystem::path& newPath)
-            {
-                path = newPath;
-                offset = 0;
-                encoding = TextEncoding::Unknown;
-                consumedBom = false;
-                pendingLine.clear();
-                pendingBytes.clear();
-            }
-        };
-
         void run();
+        void wakeWorker();
         bool discoverDirectories();
         bool refreshChatFile();
         bool refreshCombatFile();
         bool processLocalChat();
         bool processCombat();
-        std::vector<std::string> readNewLines(FileTailState& state);
-        bool ensureUtf16Even(FileTailState& state, std::vector<char>& buffer);
-    std::string convertToUtf8(FileTailState& state, std::vector<char>& buffer, bool isFirstChunk);
+        void followTail(LogTailReader& tail, const std::filesystem::path& path);
         std::optional<std::filesystem::path> resolveDefaultDirectory(const wchar_t* subFolder) const;
         std::optional<std::filesystem::path> latestChatLogPath(const std::filesystem::path& directory) const;
         std::optional<std::filesystem::path> latestCombatLogPath(const std::filesystem::path& directory) const;
@@ -245,12 +235,14 @@ namespace helper::logs
         std::atomic_bool stopRequested_{false};
 
         LogWatcherStatus status_;
-        FileTailState chatTail_;
-        FileTailState combatTail_;
+        LogTailReader chatTail_;
+        LogTailReader combatTail_;
+        std::vector<FollowedLogFile> retiredFiles_;
         std::filesystem::file_time_type chatWriteTime_{};
         std::filesystem::file_time_type combatWriteTime_{};
         std::optional<std::string> lastPublishedSystemId_;
         std::chrono::system_clock::time_point lastPublishedAt_{};
         FollowModeSupplier followModeSupplier_{};
+        std::unique_ptr<FileChangeNotifier> notifier_;   // null where unsupported; run() then polls
     };
 }
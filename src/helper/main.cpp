@@ -137,6 +137,12 @@ namespace
         return value.empty() ? std::string{} : to_utf8(value);
     }
 
+    bool read_shared_state_json()
+    {
+        const auto value = read_env_var(L"EF_OVERLAY_SHARED_STATE_JSON");
+        return !value.empty() && value != L"0";
+    }
+
     std::wstring get_executable_path()
     {
         std::wstring buffer(MAX_PATH, L'\0');
@@ -452,6 +458,7 @@ int wmain(int argc, wchar_t* argv[])
     runtimeConfig.port = port;
     runtimeConfig.token = token;
     runtimeConfig.executableDirectory = std::filesystem::path(get_executable_path()).parent_path();
+    runtimeConfig.sharedStateJson = read_shared_state_json();
 
     HelperRuntime runtime(std::move(runtimeConfig));
     if (!runtime.start())
@@ -0,0 +1,346 @@
+#include "route_planner.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace helper::routing
+{
+    namespace
+    {
+        constexpr std::uint32_t kNoNode = std::numeric_limits<std::uint32_t>::max();
+        constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+        double distance_between(const overlay::Vec3f& lhs, const overlay::Vec3f& rhs)
+        {
+            const double dx = static_cast<double>(lhs.x) - rhs.x;
+            const double dy = static_cast<double>(lhs.y) - rhs.y;
+            const double dz = static_cast<double>(lhs.z) - rhs.z;
+            return std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+    }
+
+    RoutePlanner::RoutePlanner(overlay::StarCatalog catalog)
+        : catalog_(std::move(catalog))
+    {
+        const auto count = catalog_.size();
+        stamp_.assign(count, 0);
+        cost_.assign(count, kInfinity);
+        next_.assign(count, kNoNode);
+        closed_.assign(count, 0);
+    }
+
+    std::optional<std::uint32_t> RoutePlanner::resolveSystem(std::string_view idOrName) const
+    {
+        const auto* first = idOrName.data();
+        const auto* last = idOrName.data() + idOrName.size();
+        std::uint32_t systemId = 0;
+        const auto [ptr, ec] = std::from_chars(first, last, systemId);
+        if (ec == std::errc{} && ptr == last)
+        {
+            if (const auto* record = catalog_.find_by_system_id(systemId))
+            {
+                return static_cast<std::uint32_t>(record - catalog_.records.data());
+            }
+        }
+
+        if (const auto* record = catalog_.find_by_name(idOrName))
+        {
+            return static_cast<std::uint32_t>(record - catalog_.records.data());
+        }
+
+        return std::nullopt;
+    }
+
+    RouteResult RoutePlanner::plan(const RouteRequest& request)
+    {
+        const auto startedAt = std::chrono::steady_clock::now();
+        RouteResult result;
+
+        if (catalog_.empty())
+        {
+            result.failure = RouteFailure::CatalogUnavailable;
+            result.error = "Star catalog is empty";
+            return result;
+        }
+        if (!(request.maxJumpLy > 0.0) || !std::isfinite(request.maxJumpLy))
+        {
+            result.failure = RouteFailure::InvalidRequest;
+            result.error = "max_jump_ly must be a positive number";
+            return result;
+        }
+
+        const auto origin = resolveSystem(request.origin);
+        if (!origin)
+        {
+            result.failure = RouteFailure::UnknownSystem;
+            result.error = "Unknown origin system: " + request.origin;
+            return result;
+        }
+        const auto destination = resolveSystem(request.destination);
+        if (!destination)
+        {
+            result.failure = RouteFailure::UnknownSystem;
+            result.error = "Unknown destination system: " + request.destination;
+            return result;
+        }
+
+        result.reusedSearch = searchValid_
+            && goal_ == *destination
+            && maxJumpLy_ == request.maxJumpLy
+            && metric_ == request.metric;
+        if (!result.reusedSearch)
+        {
+            resetSearch(*destination, request.maxJumpLy, request.metric);
+        }
+
+        if (connected(*origin, *destination, request.maxJumpLy) && (isClosed(*origin) || search(*origin, result)))
+        {
+            buildRoute(*origin, result);
+            result.success = true;
+        }
+        else
+        {
+            result.failure = RouteFailure::Unreachable;
+            result.error = "No route within jump range";
+        }
+
+        result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startedAt).count();
+        return result;
+    }
+
+    void RoutePlanner::resetSearch(std::uint32_t goal, double maxJumpLy, RouteMetric metric)
+    {
+        if (++generation_ == 0)
+        {
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            generation_ = 1;
+        }
+
+        open_.clear();
+        searchValid_ = true;
+        goal_ = goal;
+        searchTarget_ = goal;
+        maxJumpLy_ = maxJumpLy;
+        metric_ = metric;
+
+        touch(goal);
+        cost_[goal] = 0.0;
+        open_.push_back(OpenEntry{0.0, 0.0, goal});
+    }
+
+    void RoutePlanner::touch(std::uint32_t node)
+    {
+        if (stamp_[node] == generation_)
+        {
+            return;
+        }
+        stamp_[node] = generation_;
+        cost_[node] = kInfinity;
+        next_[node] = kNoNode;
+        closed_[node] = 0;
+    }
+
+    bool RoutePlanner::isClosed(std::uint32_t node) const
+    {
+        return stamp_[node] == generation_ && closed_[node] != 0;
+    }
+
+    double RoutePlanner::heuristic(std::uint32_t node, std::uint32_t target) const
+    {
+        const double distance = distance_between(catalog_.records[node].position, catalog_.records[target].position);
+        if (metric_ == RouteMetric::Distance)
+        {
+            return distance;
+        }
+        // Every jump covers at most maxJumpLy_, so this never overestimates the remaining hop count.
+        return std::max(0.0, std::ceil(distance / maxJumpLy_ - 1e-9));
+    }
+
+    double RoutePlanner::edgeCost(double distanceLy) const
+    {
+        return metric_ == RouteMetric::Distance ? distanceLy : 1.0;
+    }
+
+    bool RoutePlanner::search(std::uint32_t target, RouteResult& result)
+    {
+        const auto& records = catalog_.records;
+        const auto& index = catalog_.spatial_index();
+        const auto radius = static_cast<float>(maxJumpLy_);
+        // Min-heap on f; prefer the deeper node (larger g) on ties so equal-cost frontiers resolve quickly.
+        const auto after = [](const OpenEntry& lhs, const OpenEntry& rhs) {
+            return lhs.f != rhs.f ? lhs.f > rhs.f : lhs.g < rhs.g;
+        };
+
+        // Closed nodes keep their exact cost-to-goal whatever heuristic closed them, and the open list still
+        // bounds the closed set, so switching origin only needs the open keys recomputed for the new target.
+        if (target != searchTarget_)
+        {
+            for (auto& entry : open_)
+            {
+                entry.f = entry.g + heuristic(entry.node, target);
+            }
+            std::make_heap(open_.begin(), open_.end(), after);
+            searchTarget_ = target;
+        }
+
+        while (!open_.empty())
+        {
+            std::pop_heap(open_.begin(), open_.end(), after);
+            const auto entry = open_.back();
+            open_.pop_back();
+
+            const auto node = entry.node;
+            if (closed_[node] != 0 || entry.g > cost_[node])
+            {
+                continue;
+            }
+            closed_[node] = 1;
+            ++result.expandedNodes;
+
+            if (node == target)
+            {
+                return true;
+            }
+
+            neighbours_.clear();
+            index.query_radius(records[node].position, radius, neighbours_);
+            for (const auto& neighbour : neighbours_)
+            {
+                const auto candidate = neighbour.record_index;
+                if (candidate == node)
+                {
+                    continue;
+                }
+
+                touch(candidate);
+                if (closed_[candidate] != 0)
+                {
+                    continue;
+                }
+
+                const double g = entry.g + edgeCost(std::sqrt(static_cast<double>(neighbour.distance_sq)));
+                if (g < cost_[candidate])
+                {
+                    cost_[candidate] = g;
+                    next_[candidate] = node;
+                    open_.push_back(OpenEntry{g + heuristic(candidate, target), g, candidate});
+                    std::push_heap(open_.begin(), open_.end(), after);
+                }
+            }
+        }
+
+        return false;
+    }
+
+    RouteResult RoutePlanner::repair(const std::vector<overlay::RouteNode>& route, std::string_view currentSystem)
+    {
+        RouteRequest request;
+        request.origin = std::string(currentSystem);
+        if (route.empty())
+        {
+            RouteResult result;
+            result.failure = RouteFailure::InvalidRequest;
+            result.error = "Route is empty";
+            return result;
+        }
+        request.destination = route.back().system_id;
+
+        const auto destination = resolveSystem(request.destination);
+        if (searchValid_ && destination && *destination == goal_)
+        {
+            request.maxJumpLy = maxJumpLy_;
+            request.metric = metric_;
+        }
+        else
+        {
+            for (const auto& hop : route)
+            {
+                if (!hop.via_gate && !hop.via_smart_gate)
+                {
+                    request.maxJumpLy = std::max(request.maxJumpLy, hop.distance_ly);
+                }
+            }
+            // Hop distances are rounded by the web app; leave a little slack so the longest hop stays in range.
+            request.maxJumpLy += 0.01;
+            request.metric = RouteMetric::Distance;
+        }
+
+        return plan(request);
+    }
+
+    bool RoutePlanner::connected(std::uint32_t from, std::uint32_t to, double maxJumpLy)
+    {
+        if (component_.empty() || componentJumpLy_ != maxJumpLy)
+        {
+            const auto& records = catalog_.records;
+            const auto& index = catalog_.spatial_index();
+            const auto radius = static_cast<float>(maxJumpLy);
+
+            component_.assign(records.size(), kNoNode);
+            std::vector<std::uint32_t> frontier;
+            std::uint32_t label = 0;
+            for (std::uint32_t seed = 0; seed < records.size(); ++seed)
+            {
+                if (component_[seed] != kNoNode)
+                {
+                    continue;
+                }
+
+                component_[seed] = label;
+                frontier.push_back(seed);
+                while (!frontier.empty())
+                {
+                    const auto node = frontier.back();
+                    frontier.pop_back();
+                    neighbours_.clear();
+                    index.query_radius(records[node].position, radius, neighbours_);
+                    for (const auto& neighbour : neighbours_)
+                    {
+                        if (component_[neighbour.record_index] == kNoNode)
+                        {
+                            component_[neighbour.record_index] = label;
+                            frontier.push_back(neighbour.record_index);
+                        }
+                    }
+                }
+                ++label;
+            }
+            componentJumpLy_ = maxJumpLy;
+        }
+
+        return component_[from] == component_[to];
+    }
+
+    void RoutePlanner::buildRoute(std::uint32_t origin, RouteResult& result) const
+    {
+        result.route.clear();
+        result.totalDistanceLy = 0.0;
+
+        std::uint32_t previous = kNoNode;
+        for (auto node = origin; node != kNoNode; node = next_[node])
+        {
+            const auto& record = catalog_.records[node];
+            overlay::RouteNode hop;
+            hop.system_id = std::to_string(record.system_id);
+            hop.display_name = std::string(catalog_.name_for(record));
+            if (previous != kNoNode)
+            {
+                hop.distance_ly = distance_between(catalog_.records[previous].position, record.position);
+                result.totalDistanceLy += hop.distance_ly;
+            }
+            result.route.push_back(std::move(hop));
+            previous = node;
+        }
+
+        // The origin is position 0 so the first jump reads as "hop 1/N", matching what the web app sends.
+        const auto hops = static_cast<int>(result.route.size()) - 1;
+        for (std::size_t i = 0; i < result.route.size(); ++i)
+        {
+            result.route[i].route_position = static_cast<int>(i);
+            result.route[i].total_route_hops = hops;
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "overlay_schema.hpp"
+#include "star_catalog.hpp"
+#include "star_spatial_index.hpp"
+
+namespace helper::routing
+{
+    enum class RouteMetric
+    {
+        Hops,
+        Distance
+    };
+
+    struct RouteRequest
+    {
+        std::string origin;         // System id or name
+        std::string destination;    // System id or name
+        double maxJumpLy{0.0};
+        RouteMetric metric{RouteMetric::Distance};
+    };
+
+    enum class RouteFailure
+    {
+        None,
+        InvalidRequest,
+        UnknownSystem,
+        Unreachable,
+        CatalogUnavailable
+    };
+
+    struct RouteResult
+    {
+        bool success{false};
+        RouteFailure failure{RouteFailure::None};
+        std::string error;
+        std::vector<overlay::RouteNode> route;
+        double totalDistanceLy{0.0};
+        std::uint32_t expandedNodes{0};
+        double elapsedMs{0.0};
+        bool reusedSearch{false};   // Resumed the previous search tree instead of starting over
+    };
+
+    // A* over the star catalog where two systems are connected when they lie within the jump range.
+    // Neighbours are expanded through the catalog's k-d tree, so nothing is precomputed per range.
+    // The search runs backwards from the destination, so its cost-to-goal values stay valid when the
+    // origin moves. As in D* Lite with static edge costs, a request that only changes the origin resumes
+    // the retained search (re-keying the open list for the new origin) instead of starting over.
+    // Not thread-safe; callers serialise access.
+    class RoutePlanner
+    {
+    public:
+        explicit RoutePlanner(overlay::StarCatalog catalog);
+
+        RoutePlanner(const RoutePlanner&) = delete;
+        RoutePlanner& operator=(const RoutePlanner&) = delete;
+
+        const overlay::StarCatalog& catalog() const noexcept { return catalog_; }
+
+        // Accepts a numeric system id or a system name (matched case- and whitespace-insensitively).
+        std::optional<std::uint32_t> resolveSystem(std::string_view idOrName) const;
+
+        RouteResult plan(const RouteRequest& request);
+
+        // Re-plans `route` from `currentSystem` to the same destination. Uses the jump range and metric of the
+        // retained search when it targets that destination, otherwise the longest non-gate hop of `route`.
+        RouteResult repair(const std::vector<overlay::RouteNode>& route, std::string_view currentSystem);
+
+    private:
+        struct OpenEntry
+        {
+            double f;
+            double g;
+            std::uint32_t node;
+        };
+
+        void resetSearch(std::uint32_t goal, double maxJumpLy, RouteMetric metric);
+        void touch(std::uint32_t node);
+        bool isClosed(std::uint32_t node) const;
+        double heuristic(std::uint32_t node, std::uint32_t target) const;
+        double edgeCost(double distanceLy) const;
+        bool search(std::uint32_t target, RouteResult& result);
+        void buildRoute(std::uint32_t origin, RouteResult& result) const;
+        bool connected(std::uint32_t from, std::uint32_t to, double maxJumpLy);
+
+        overlay::StarCatalog catalog_;
+
+        // Per-node search state, invalidated in O(1) by bumping generation_.
+        std::vector<std::uint32_t> stamp_;
+        std::vector<double> cost_;
+        std::vector<std::uint32_t> next_;
+        std::vector<std::uint8_t> closed_;
+        std::uint32_t generation_{0};
+
+        std::vector<OpenEntry> open_;
+        std::vector<overlay::StarNeighbor> neighbours_;
+
+        // Connected components for componentJumpLy_, so unreachable pairs are rejected without a search.
+        std::vector<std::uint32_t> component_;
+        double componentJumpLy_{0.0};
+
+        bool searchValid_{false};
+        std::uint32_t goal_{0};
+        std::uint32_t searchTarget_{0};
+        double maxJumpLy_{0.0};
+        RouteMetric metric_{RouteMetric::Distance};
+    };
+}
@@ -0,0 +1,60 @@
+#include "server_streams.hpp"
+
+#include <algorithm>
+
+namespace helper::streams
+{
+    std::string make_event(std::string_view event, std::uint64_t id, std::string_view data)
+    {
+        std::string message;
+        message.reserve(data.size() + event.size() + 40);
+        message.append("event: ").append(event);
+        message.append("\nid: ").append(std::to_string(id));
+        message.append("\ndata: ").append(data);
+        message.append("\n\n");
+        return message;
+    }
+
+    GenerationStream::Step GenerationStream::next(std::unique_lock<std::mutex>& lock, std::condition_variable& changed, std::chrono::milliseconds timeout,
+                                                  const std::uint64_t& generation, const std::atomic_bool& stopping, bool available)
+    {
+        if (stopping.load())
+        {
+            return Step::Stop;
+        }
+
+        if (!started_)
+        {
+            started_ = true;
+            sent_ = generation;
+            if (available)
+            {
+                return Step::Send;
+            }
+        }
+
+        const bool moved = changed.wait_for(lock, timeout, [&]() {
+            return stopping.load() || generation != sent_;
+        });
+        if (stopping.load())
+        {
+            return Step::Stop;
+        }
+        if (!moved)
+        {
+            return Step::Keepalive;
+        }
+
+        sent_ = generation;
+        return Step::Send;
+    }
+
+    bool wait_long_poll(std::unique_lock<std::mutex>& lock, std::condition_variable& changed, std::chrono::milliseconds timeout,
+                        const std::atomic_bool& stopping, const std::function<bool()>& ready)
+    {
+        changed.wait_for(lock, std::clamp(timeout, std::chrono::milliseconds{0}, long_poll_max), [&]() {
+            return stopping.load() || ready();
+        });
+        return ready();
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace helper::streams
+{
+    // Comment line written to an idle server-sent event stream so clients and proxies keep it open.
+    inline constexpr std::string_view keepalive = ": keepalive\n\n";
+    inline constexpr std::chrono::seconds keepalive_interval{15};
+    inline constexpr std::chrono::milliseconds long_poll_max{25000};
+
+    // One server-sent event. The payloads are single-line JSON dumps, so each fits in one data field.
+    std::string make_event(std::string_view event, std::uint64_t id, std::string_view data);
+
+    // Follows a change counter on behalf of one event stream. The counter is guarded by the mutex behind
+    // `lock`, and writers notify `changed` after moving it.
+    class GenerationStream
+    {
+    public:
+        enum class Step
+        {
+            Send,       // sent() is the generation to send
+            Keepalive,  // `timeout` passed without a change
+            Stop        // `stopping` was set
+        };
+
+        // The first step sends at once when `available`, so a client that connects before the first change still
+        // receives the current value. Later steps wait for `generation` to move past the one last sent; wake-ups
+        // that leave it unchanged, such as heartbeat ticks, are not sent.
+        Step next(std::unique_lock<std::mutex>& lock, std::condition_variable& changed, std::chrono::milliseconds timeout,
+                  const std::uint64_t& generation, const std::atomic_bool& stopping, bool available);
+
+        std::uint64_t sent() const noexcept { return sent_; }
+
+    private:
+        std::uint64_t sent_{0};
+        bool started_{false};
+    };
+
+    // Holds a long poll until `ready` holds, `stopping` is set or `timeout` (at most long_poll_max) passes.
+    // Called with `lock` held on the mutex guarding what `ready` reads. Returns whether `ready` holds.
+    bool wait_long_poll(std::unique_lock<std::mutex>& lock, std::condition_variable& changed, std::chrono::milliseconds timeout,
+                        const std::atomic_bool& stopping, const std::function<bool()>& ready);
+}
@@ -85,6 +85,33 @@ namespace helper
         saveAllTime();
     }
 
+    void SessionTracker::mergeAllTimeVisits(const std::unordered_map<std::string, SystemVisitData>& visits)
+    {
+        if (visits.empty())
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(allTimeMutex_);
+            if (!allTimeData_.tracking_enabled)
+            {
+                return;
+            }
+            for (const auto& [system_id, data] : visits)
+            {
+                auto& entry = allTimeData_.systems[system_id];
+                if (entry.name.empty())
+                {
+                    entry.name = data.name;
+                }
+                entry.visits += data.visits;
+            }
+            allTimeData_.last_updated_ms = nowMs();
+        }
+        saveAllTime();
+    }
+
     void SessionTracker::resetAllTimeTracking()
     {
         {
@@ -214,6 +241,7 @@ namespace helper
         }
         
         activeSession_.reset();
+        revision_.fetch_add(1);
     }
 
     void SessionTracker::resetActiveSession()
@@ -319,6 +347,8 @@ namespace helper
     bool SessionTracker::saveAllTime()
     {
         std::lock_guard<std::mutex> lock(allTimeMutex_);
+        // Every change is saved straight away, so saving is where the revision moves.
+        revision_.fetch_add(1);
         
         try
         {
@@ -362,6 +392,7 @@ namespace helper
         {
             return true;
         }
+        revision_.fetch_add(1);
 
         const auto session_path = getSessionFilePath(activeSession_->session_id);
         
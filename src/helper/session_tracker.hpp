@@ -1,11 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace helper
 {
@@ -46,6 +49,9 @@ namespace helper
         void setAllTimeTrackingEnabled(bool enabled);
         bool isAllTimeTrackingEnabled() const;
         void recordSystemVisitAllTime(const std::string& system_id, const std::string& system_name);
+        // Adds visits counted from historical logs by the log backfill. Dropped while all-time tracking is off,
+        // like live visits.
+        void mergeAllTimeVisits(const std::unordered_map<std::string, SystemVisitData>& visits);
         void resetAllTimeTracking();
         AllTimeVisitedSystems getAllTimeData() const;
 
@@ -60,6 +66,9 @@ namespace helper
         std::optional<SessionVisitedSystems> getActiveSessionData() const;
         std::vector<SessionVisitedSystems> listStoppedSessions() const;
 
+        // Changes whenever the all-time data, the active session or a saved session does.
+        std::uint64_t revision() const { return revision_.load(); }
+
         // Persistence
         bool saveAllTime();
         bool saveActiveSession();
@@ -75,6 +84,8 @@ namespace helper
         mutable std::recursive_mutex sessionMutex_;
         std::optional<SessionVisitedSystems> activeSession_;
 
+        std::atomic<std::uint64_t> revision_{0};
+
         std::filesystem::path getSessionFilePath(const std::string& session_id) const;
         std::string generateSessionId() const;
         std::uint64_t nowMs() const;
@@ -0,0 +1,57 @@
+#include "string_interner.hpp"
+
+#include <mutex>
+
+namespace helper
+{
+    StringInterner& StringInterner::global()
+    {
+        static StringInterner interner;
+        return interner;
+    }
+
+    StringInterner::StringInterner()
+    {
+        strings_.emplace_back();
+        ids_.emplace(strings_.back(), 0);
+    }
+
+    std::uint32_t StringInterner::intern(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return 0;
+        }
+
+        // Nearly every call finds a name already seen, under the shared lock.
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            if (const auto it = ids_.find(text); it != ids_.end())
+            {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (const auto it = ids_.find(text); it != ids_.end())
+        {
+            return it->second;
+        }
+        const auto id = static_cast<std::uint32_t>(strings_.size());
+        strings_.emplace_back(text);
+        ids_.emplace(strings_.back(), id);
+        return id;
+    }
+
+    std::string_view StringInterner::view(std::uint32_t id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return id < strings_.size() ? std::string_view(strings_[id]) : std::string_view();
+    }
+
+    std::size_t StringInterner::size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return strings_.size();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace helper
+{
+    // Process-wide table of the names that recur in telemetry (resources, counterparties, bucket ids).
+    // Each distinct string is stored once and never removed, so ids and views stay valid for the life of
+    // the process. Id 0 is the empty string.
+    class StringInterner
+    {
+    public:
+        static StringInterner& global();
+
+        std::uint32_t intern(std::string_view text);
+        std::string_view view(std::uint32_t id) const;
+        std::size_t size() const;
+
+    private:
+        StringInterner();
+
+        mutable std::shared_mutex mutex_;
+        std::deque<std::string> strings_;                          // by id; a deque never moves its elements
+        std::unordered_map<std::string_view, std::uint32_t> ids_;  // views into strings_
+    };
+
+    // A string held as its id in StringInterner::global(): copying, comparing for equality and hashing
+    // cost no more than an integer. The text is looked up only where it is serialized.
+    class InternedString
+    {
+    public:
+        InternedString() = default;
+        explicit InternedString(std::string_view text)
+            : id_(StringInterner::global().intern(text))
+        {
+        }
+
+        std::uint32_t id() const { return id_; }
+        bool empty() const { return id_ == 0; }
+        std::string_view view() const { return StringInterner::global().view(id_); }
+        std::string str() const { return std::string(view()); }
+
+        friend bool operator==(InternedString, InternedString) = default;
+        friend bool operator==(InternedString value, std::string_view text) { return value.view() == text; }
+
+    private:
+        std::uint32_t id_{0};
+    };
+}
@@ -0,0 +1,714 @@
+#include "telemetry_store.hpp"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace helper::telemetry
+{
+    namespace
+    {
+        constexpr std::uint32_t chunk_magic = 0x43544645; // 'EFTC'
+        constexpr std::uint16_t chunk_format_version = 1;
+        constexpr std::uint16_t column_count = 6;
+        constexpr std::size_t chunk_header_size = 4 + 2 + 2 + 4 + 4 + 8 + 8 + 8 + 8 + 8 + 4 + 4 + 4 * column_count + 4;
+        constexpr std::uint64_t day_ms = 24ull * 60 * 60 * 1000;
+        constexpr std::uint64_t chunk_span_ms = 60ull * 60 * 1000;
+        constexpr int metadata_version = 1;
+
+        template <typename T>
+        void put(std::string& out, T value)
+        {
+            char raw[sizeof(T)];
+            std::memcpy(raw, &value, sizeof(T));
+            out.append(raw, sizeof(T));
+        }
+
+        template <typename T>
+        T get(const char*& data)
+        {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            data += sizeof(T);
+            return value;
+        }
+
+        void put_varint(std::string& out, std::uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        bool get_varint(const char*& data, const char* end, std::uint64_t& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && data < end; shift += 7)
+            {
+                const auto byte = static_cast<unsigned char>(*data++);
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // XOR with the previous value, then only the bytes between the leading and trailing zero bytes:
+        // a control byte 0x80 | leading << 3 | trailing precedes them, and 0 means "same as before".
+        void put_xor(std::string& out, double value, std::uint64_t& previous)
+        {
+            const auto bits = std::bit_cast<std::uint64_t>(value);
+            const auto delta = bits ^ previous;
+            previous = bits;
+            if (delta == 0)
+            {
+                out.push_back('\0');
+                return;
+            }
+
+            const auto leading = std::countl_zero(delta) / 8;
+            const auto trailing = std::countr_zero(delta) / 8;
+            out.push_back(static_cast<char>(0x80 | (leading << 3) | trailing));
+            auto significant = delta >> (trailing * 8);
+            for (int i = 0; i < 8 - leading - trailing; ++i)
+            {
+                out.push_back(static_cast<char>(significant & 0xFF));
+                significant >>= 8;
+            }
+        }
+
+        bool get_xor(const char*& data, const char* end, double& value, std::uint64_t& previous)
+        {
+            if (data >= end)
+            {
+                return false;
+            }
+            const auto control = static_cast<unsigned char>(*data++);
+            if (control != 0)
+            {
+                const int leading = (control >> 3) & 0x7;
+                const int trailing = control & 0x7;
+                const int length = 8 - leading - trailing;
+                if (length <= 0 || end - data < length)
+                {
+                    return false;
+                }
+                std::uint64_t significant = 0;
+                for (int i = 0; i < length; ++i)
+                {
+                    significant |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (i * 8);
+                }
+                data += length;
+                previous ^= significant << (trailing * 8);
+            }
+            value = std::bit_cast<double>(previous);
+            return true;
+        }
+
+        std::uint64_t zigzag(std::int64_t value)
+        {
+            return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        std::int64_t unzigzag(std::uint64_t value)
+        {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        std::uint32_t checksum(std::string_view data)
+        {
+            std::uint32_t hash = 2166136261u;
+            for (const char ch : data)
+            {
+                hash = (hash ^ static_cast<unsigned char>(ch)) * 16777619u;
+            }
+            return hash;
+        }
+
+        std::optional<std::uint64_t> parse_partition_day(const std::filesystem::path& path)
+        {
+            const auto name = path.filename().string();
+            int year = 0;
+            unsigned month = 0;
+            unsigned day = 0;
+            if (path.extension() != ".eftc" || name.size() != 13 || std::sscanf(name.c_str(), "%4d%2u%2u", &year, &month, &day) != 3)
+            {
+                return std::nullopt;
+            }
+            const std::chrono::year_month_day date{std::chrono::year{year}, std::chrono::month{month}, std::chrono::day{day}};
+            if (!date.ok())
+            {
+                return std::nullopt;
+            }
+            return static_cast<std::uint64_t>(std::chrono::sys_days{date}.time_since_epoch().count());
+        }
+    }
+
+    std::string source_key(const std::filesystem::path& path)
+    {
+        const auto text = path.lexically_normal().generic_u8string();
+        return std::string(text.begin(), text.end());
+    }
+
+    struct TelemetryStore::ChunkHeader
+    {
+        std::uint32_t rows{0};
+        std::uint32_t payloadBytes{0};
+        std::uint64_t minTs{0};
+        std::uint64_t maxTs{0};
+        double dealt{0.0};
+        double taken{0.0};
+        double mining{0.0};
+        std::uint32_t combatRows{0};
+        std::uint32_t miningRows{0};
+        std::uint32_t columnBytes[column_count]{};
+        std::uint32_t checksum{0};
+
+        void encode(std::string& out) const
+        {
+            put(out, chunk_magic);
+            put(out, chunk_format_version);
+            put(out, column_count);
+            put(out, rows);
+            put(out, payloadBytes);
+            put(out, minTs);
+            put(out, maxTs);
+            put(out, dealt);
+            put(out, taken);
+            put(out, mining);
+            put(out, combatRows);
+            put(out, miningRows);
+            for (const auto bytes : columnBytes)
+            {
+                put(out, bytes);
+            }
+            put(out, checksum);
+        }
+
+        bool decode(const char* data)
+        {
+            if (get<std::uint32_t>(data) != chunk_magic || get<std::uint16_t>(data) != chunk_format_version || get<std::uint16_t>(data) != column_count)
+            {
+                return false;
+            }
+            rows = get<std::uint32_t>(data);
+            payloadBytes = get<std::uint32_t>(data);
+            minTs = get<std::uint64_t>(data);
+            maxTs = get<std::uint64_t>(data);
+            dealt = get<double>(data);
+            taken = get<double>(data);
+            mining = get<double>(data);
+            combatRows = get<std::uint32_t>(data);
+            miningRows = get<std::uint32_t>(data);
+            std::uint64_t columnTotal = 0;
+            for (auto& bytes : columnBytes)
+            {
+                bytes = get<std::uint32_t>(data);
+                columnTotal += bytes;
+            }
+            checksum = get<std::uint32_t>(data);
+            return columnTotal == payloadBytes && minTs <= maxTs;
+        }
+    };
+
+    TelemetryStore::TelemetryStore(Config config)
+        : config_(std::move(config))
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(config_.directory, ec);
+        if (ec)
+        {
+            spdlog::error("Failed to create telemetry store directory {}: {}", config_.directory.string(), ec.message());
+        }
+        config_.chunkRows = std::max<std::size_t>(config_.chunkRows, 1);
+        loadMetadata();
+    }
+
+    TelemetryStore::~TelemetryStore()
+    {
+        flush();
+    }
+
+    std::uint32_t TelemetryStore::resourceId(std::string_view name)
+    {
+        if (name.empty())
+        {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = resourceIds_.find(name); it != resourceIds_.end())
+        {
+            return it->second;
+        }
+        resources_.emplace_back(name);
+        const auto id = static_cast<std::uint32_t>(resources_.size());
+        resourceIds_.emplace(resources_.back(), id);
+        metadataDirty_ = true;
+        return id;
+    }
+
+    std::optional<std::string> TelemetryStore::resourceName(std::uint32_t id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (id == 0 || id > resources_.size())
+        {
+            return std::nullopt;
+        }
+        return resources_[id - 1];
+    }
+
+    bool TelemetryStore::append(std::string_view source, const TelemetryRecord& record)
+    {
+        if (record.timestampMs == 0)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sources_.find(source);
+        if (it == sources_.end())
+        {
+            it = sources_.emplace(std::string(source), SourceCursor{}).first;
+        }
+
+        // A source read again from the start replays rows already stored: everything before its newest
+        // timestamp, then as many rows at that timestamp as were stored.
+        auto& cursor = it->second;
+        if (record.timestampMs < cursor.timestampMs)
+        {
+            return false;
+        }
+        if (record.timestampMs == cursor.timestampMs)
+        {
+            if (cursor.replayed < cursor.rowsAtTimestamp)
+            {
+                ++cursor.replayed;
+                return false;
+            }
+            ++cursor.rowsAtTimestamp;
+        }
+        else
+        {
+            cursor.timestampMs = record.timestampMs;
+            cursor.rowsAtTimestamp = 1;
+        }
+        cursor.replayed = cursor.rowsAtTimestamp;
+        metadataDirty_ = true;
+
+        if (pending_.empty())
+        {
+            pendingSince_ = std::chrono::steady_clock::now();
+        }
+        pending_.push_back(record);
+        ++revision_;
+        if (pending_.size() >= config_.chunkRows || std::chrono::steady_clock::now() - pendingSince_ >= config_.flushInterval)
+        {
+            flushLocked();
+        }
+        return true;
+    }
+
+    void TelemetryStore::flush()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flushLocked();
+    }
+
+    void TelemetryStore::flushLocked()
+    {
+        if (!pending_.empty())
+        {
+            std::stable_sort(pending_.begin(), pending_.end(), [](const TelemetryRecord& a, const TelemetryRecord& b) {
+                return a.timestampMs < b.timestampMs;
+            });
+
+            // A chunk never spans more than one UTC hour, so any whole-hour resolution is answered from
+            // chunk headers alone. Backfilled rows can be days old and go to their own day's partition.
+            auto begin = pending_.begin();
+            while (begin != pending_.end())
+            {
+                const auto span = begin->timestampMs / chunk_span_ms;
+                const auto end = std::find_if(begin, pending_.end(), [&](const TelemetryRecord& row) {
+                    return row.timestampMs / chunk_span_ms != span;
+                });
+                std::vector<TelemetryRecord> rows(begin, end);
+                writeChunk(begin->timestampMs / day_ms, rows);
+                begin = end;
+            }
+            pending_.clear();
+        }
+
+        if (metadataDirty_)
+        {
+            saveMetadataLocked();
+            metadataDirty_ = false;
+        }
+    }
+
+    void TelemetryStore::writeChunk(std::uint64_t day, std::vector<TelemetryRecord>& rows)
+    {
+        const auto path = partitionPath(day);
+
+        // A chunk cut short by a crash would hide every chunk appended after it, so drop it first.
+        if (!verifiedPartitions_.contains(day))
+        {
+            std::uint64_t validLength = 0;
+            std::error_code ec;
+            const auto size = std::filesystem::file_size(path, ec);
+            if (!ec)
+            {
+                scanPartition(path, size, 0, 0, [&](const ChunkHeader& header) {
+                    validLength += chunk_header_size + header.payloadBytes;
+                    return true;
+                }, {});
+            }
+            if (!ec && size > validLength)
+            {
+                spdlog::warn("Telemetry store dropping {} damaged bytes from {}", size - validLength, path.string());
+                std::filesystem::resize_file(path, validLength, ec);
+            }
+            verifiedPartitions_[day] = validLength;
+        }
+
+        ChunkHeader header;
+        header.rows = static_cast<std::uint32_t>(rows.size());
+        header.minTs = rows.front().timestampMs;
+        header.maxTs = rows.back().timestampMs;
+
+        std::string columns[column_count];
+        std::uint64_t previousTs = 0;
+        std::uint64_t previousDealt = 0;
+        std::uint64_t previousTaken = 0;
+        std::uint64_t previousMining = 0;
+        std::uint32_t previousResource = 0;
+        for (const auto& row : rows)
+        {
+            put_varint(columns[0], row.timestampMs - previousTs);
+            previousTs = row.timestampMs;
+            put_xor(columns[1], row.dealt, previousDealt);
+            put_xor(columns[2], row.taken, previousTaken);
+            columns[3].push_back(static_cast<char>(row.quality));
+            put_xor(columns[4], row.miningM3, previousMining);
+            put_varint(columns[5], zigzag(static_cast<std::int64_t>(row.resourceId) - previousResource));
+            previousResource = row.resourceId;
+
+            header.dealt += row.dealt;
+            header.taken += row.taken;
+            header.mining += row.miningM3;
+            (row.quality == TelemetryRecord::no_quality ? header.miningRows : header.combatRows) += 1;
+        }
+
+        std::string payload;
+        for (std::size_t i = 0; i < column_count; ++i)
+        {
+            header.columnBytes[i] = static_cast<std::uint32_t>(columns[i].size());
+            payload += columns[i];
+        }
+        header.payloadBytes = static_cast<std::uint32_t>(payload.size());
+        header.checksum = checksum(payload);
+
+        std::string chunk;
+        chunk.reserve(chunk_header_size + payload.size());
+        header.encode(chunk);
+        chunk += payload;
+
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        file.flush();
+        if (!file)
+        {
+            spdlog::error("Failed to append {} telemetry rows to {}", rows.size(), path.string());
+            verifiedPartitions_.erase(day);
+            return;
+        }
+        verifiedPartitions_[day] += chunk.size();
+    }
+
+    void TelemetryStore::scan(std::uint64_t fromMs, std::uint64_t toMs, const std::function<void(const TelemetryRecord&)>& onRecord) const
+    {
+        std::vector<TelemetryRecord> pending;
+        std::vector<PartitionSnapshot> partitions;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            partitions = snapshotLocked(fromMs, toMs, pending);
+        }
+        for (const auto& partition : partitions)
+        {
+            scanPartition(partition.path, partition.length, fromMs, toMs, [](const ChunkHeader&) { return false; }, onRecord);
+        }
+        for (const auto& row : pending)
+        {
+            onRecord(row);
+        }
+    }
+
+    std::vector<TelemetryPoint> TelemetryStore::query(std::uint64_t fromMs, std::uint64_t toMs, std::uint64_t resolutionMs) const
+    {
+        resolutionMs = std::max<std::uint64_t>(resolutionMs, 1);
+        std::map<std::uint64_t, TelemetryPoint> buckets;
+        TelemetryPoint* current = nullptr;
+        const auto bucketFor = [&](std::uint64_t timestampMs) -> TelemetryPoint& {
+            // Rows arrive in time order within a chunk, so consecutive rows mostly share a bucket.
+            const auto start = timestampMs - timestampMs % resolutionMs;
+            if (!current || current->startMs != start)
+            {
+                current = &buckets[start];
+                current->startMs = start;
+            }
+            return *current;
+        };
+
+        std::vector<TelemetryRecord> pending;
+        std::vector<PartitionSnapshot> partitions;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            partitions = snapshotLocked(fromMs, toMs, pending);
+        }
+
+        const auto addRow = [&](const TelemetryRecord& row) {
+            auto& point = bucketFor(row.timestampMs);
+            point.dealt += row.dealt;
+            point.taken += row.taken;
+            point.miningM3 += row.miningM3;
+            (row.quality == TelemetryRecord::no_quality ? point.miningEvents : point.combatEvents) += 1;
+        };
+        const auto addHeader = [&](const ChunkHeader& header) {
+            // Whole chunk inside the range and inside one bucket: its sums are the answer.
+            if (header.minTs < fromMs || header.maxTs >= toMs || header.minTs / resolutionMs != header.maxTs / resolutionMs)
+            {
+                return false;
+            }
+            auto& point = bucketFor(header.minTs);
+            point.dealt += header.dealt;
+            point.taken += header.taken;
+            point.miningM3 += header.mining;
+            point.combatEvents += header.combatRows;
+            point.miningEvents += header.miningRows;
+            return true;
+        };
+
+        for (const auto& partition : partitions)
+        {
+            scanPartition(partition.path, partition.length, fromMs, toMs, addHeader, addRow);
+        }
+        for (const auto& row : pending)
+        {
+            addRow(row);
+        }
+
+        std::vector<TelemetryPoint> points;
+        points.reserve(buckets.size());
+        for (const auto& [start, point] : buckets)
+        {
+            points.push_back(point);
+        }
+        return points;
+    }
+
+    std::vector<TelemetryStore::PartitionSnapshot> TelemetryStore::snapshotLocked(std::uint64_t fromMs, std::uint64_t toMs, std::vector<TelemetryRecord>& pending) const
+    {
+        std::vector<std::pair<std::uint64_t, PartitionSnapshot>> partitions;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(config_.directory, ec))
+        {
+            const auto day = parse_partition_day(entry.path());
+            if (!day || *day * day_ms >= toMs || (*day + 1) * day_ms <= fromMs)
+            {
+                continue;
+            }
+            // One not appended to yet this run may still lose a damaged tail, but a scan stops at the damage.
+            std::error_code sizeError;
+            const auto verified = verifiedPartitions_.find(*day);
+            const auto length = verified != verifiedPartitions_.end() ? verified->second : entry.file_size(sizeError);
+            if (!sizeError)
+            {
+                partitions.emplace_back(*day, PartitionSnapshot{entry.path(), length});
+            }
+        }
+        std::sort(partitions.begin(), partitions.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+
+        std::copy_if(pending_.begin(), pending_.end(), std::back_inserter(pending), [&](const TelemetryRecord& row) {
+            return row.timestampMs >= fromMs && row.timestampMs < toMs;
+        });
+
+        std::vector<PartitionSnapshot> snapshots;
+        snapshots.reserve(partitions.size());
+        for (auto& [day, partition] : partitions)
+        {
+            snapshots.push_back(std::move(partition));
+        }
+        return snapshots;
+    }
+
+    void TelemetryStore::scanPartition(const std::filesystem::path& path, std::uint64_t length, std::uint64_t fromMs, std::uint64_t toMs,
+                                       const std::function<bool(const ChunkHeader&)>& useHeader,
+                                       const std::function<void(const TelemetryRecord&)>& onRecord) const
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            return;
+        }
+
+        std::uint64_t offset = 0;
+        char rawHeader[chunk_header_size];
+        std::string payload;
+        std::vector<std::uint64_t> timestamps;
+        while (offset + chunk_header_size <= length)
+        {
+            ChunkHeader header;
+            if (!file.read(rawHeader, chunk_header_size) || !header.decode(rawHeader) || offset + chunk_header_size + header.payloadBytes > length)
+            {
+                return;
+            }
+            offset += chunk_header_size + header.payloadBytes;
+
+            // onRecord is empty when only validating: every chunk's payload is checked then.
+            const bool validating = !onRecord;
+            const bool overlaps = header.minTs < toMs && header.maxTs >= fromMs;
+            if (!validating && (!overlaps || useHeader(header)))
+            {
+                file.seekg(static_cast<std::streamoff>(offset));
+                continue;
+            }
+
+            payload.resize(header.payloadBytes);
+            if (!file.read(payload.data(), static_cast<std::streamsize>(payload.size())) || checksum(payload) != header.checksum)
+            {
+                return;
+            }
+            if (validating)
+            {
+                useHeader(header);
+                continue;
+            }
+
+            const char* columns[column_count];
+            const char* columnEnds[column_count];
+            const char* cursor = payload.data();
+            for (std::size_t i = 0; i < column_count; ++i)
+            {
+                columns[i] = cursor;
+                cursor += header.columnBytes[i];
+                columnEnds[i] = cursor;
+            }
+            if (static_cast<std::size_t>(columnEnds[3] - columns[3]) != header.rows)
+            {
+                return;
+            }
+
+            TelemetryRecord row;
+            std::uint64_t delta = 0;
+            std::uint64_t previousDealt = 0;
+            std::uint64_t previousTaken = 0;
+            std::uint64_t previousMining = 0;
+            std::uint64_t resourceDelta = 0;
+            row.timestampMs = 0;
+            row.resourceId = 0;
+            for (std::uint32_t i = 0; i < header.rows; ++i)
+            {
+                if (!get_varint(columns[0], columnEnds[0], delta) || !get_xor(columns[1], columnEnds[1], row.dealt, previousDealt) ||
+                    !get_xor(columns[2], columnEnds[2], row.taken, previousTaken) || !get_xor(columns[4], columnEnds[4], row.miningM3, previousMining) ||
+                    !get_varint(columns[5], columnEnds[5], resourceDelta))
+                {
+                    spdlog::warn("Telemetry store chunk in {} is malformed", path.string());
+                    return;
+                }
+                row.timestampMs += delta;
+                row.quality = static_cast<std::uint8_t>(*columns[3]++);
+                row.resourceId = static_cast<std::uint32_t>(static_cast<std::int64_t>(row.resourceId) + unzigzag(resourceDelta));
+                if (row.timestampMs >= fromMs && row.timestampMs < toMs)
+                {
+                    onRecord(row);
+                }
+            }
+        }
+    }
+
+    std::filesystem::path TelemetryStore::partitionPath(std::uint64_t day) const
+    {
+        const std::chrono::year_month_day date{std::chrono::sys_days{std::chrono::days{static_cast<int>(day)}}};
+        char name[32];
+        std::snprintf(name, sizeof(name), "%04d%02u%02u.eftc", static_cast<int>(date.year()), static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+        return config_.directory / name;
+    }
+
+    void TelemetryStore::loadMetadata()
+    {
+        std::ifstream file(config_.directory / "store.json", std::ios::binary);
+        if (!file.is_open())
+        {
+            return;
+        }
+
+        try
+        {
+            const auto json = nlohmann::json::parse(file);
+            if (json.value("version", 0) != metadata_version)
+            {
+                spdlog::warn("Ignoring telemetry store metadata with unknown version");
+                return;
+            }
+            for (const auto& name : json.at("resources"))
+            {
+                resources_.push_back(name.get<std::string>());
+                resourceIds_.emplace(resources_.back(), static_cast<std::uint32_t>(resources_.size()));
+            }
+            for (const auto& [source, cursor] : json.at("sources").items())
+            {
+                sources_[source] = SourceCursor{cursor.at(0).get<std::uint64_t>(), cursor.at(1).get<std::uint32_t>()};
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            spdlog::warn("Failed to read telemetry store metadata: {}", ex.what());
+        }
+    }
+
+    void TelemetryStore::saveMetadataLocked() const
+    {
+        nlohmann::json sources = nlohmann::json::object();
+        for (const auto& [source, cursor] : sources_)
+        {
+            sources[source] = {cursor.timestampMs, cursor.rowsAtTimestamp};
+        }
+        const nlohmann::json json{
+            {"version", metadata_version},
+            {"resources", resources_},
+            {"sources", std::move(sources)}
+        };
+
+        const auto path = config_.directory / "store.json";
+        auto temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file << json.dump();
+            if (!file)
+            {
+                spdlog::error("Failed to write telemetry store metadata {}", temporary.string());
+                return;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temporary, path, ec);
+        if (ec)
+        {
+            spdlog::error("Failed to replace telemetry store metadata: {}", ec.message());
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace helper::telemetry
+{
+    // One combat or mining event. Combat rows set dealt or taken and a quality; mining rows set the volume
+    // and resource, and have quality no_quality.
+    struct TelemetryRecord
+    {
+        static constexpr std::uint8_t no_quality = 0xFF;
+
+        std::uint64_t timestampMs{0};
+        double dealt{0.0};
+        double taken{0.0};
+        std::uint8_t quality{no_quality};   // helper::logs::HitQuality for combat rows
+        double miningM3{0.0};
+        std::uint32_t resourceId{0};        // 0 = none; see TelemetryStore::resourceId
+
+        static TelemetryRecord combat(std::uint64_t timestampMs, bool playerDealt, double amount, std::uint8_t quality)
+        {
+            TelemetryRecord record;
+            record.timestampMs = timestampMs;
+            (playerDealt ? record.dealt : record.taken) = amount;
+            record.quality = quality;
+            return record;
+        }
+
+        static TelemetryRecord mining(std::uint64_t timestampMs, double volumeM3, std::uint32_t resourceId)
+        {
+            TelemetryRecord record;
+            record.timestampMs = timestampMs;
+            record.miningM3 = volumeM3;
+            record.resourceId = resourceId;
+            return record;
+        }
+    };
+
+    // Sums over one resolution bucket of a range query.
+    struct TelemetryPoint
+    {
+        std::uint64_t startMs{0};
+        double dealt{0.0};
+        double taken{0.0};
+        double miningM3{0.0};
+        std::uint32_t combatEvents{0};
+        std::uint32_t miningEvents{0};
+    };
+
+    // The append() source for a log file. The log watcher and the backfill must name a file alike for a
+    // replayed log to be recognised.
+    std::string source_key(const std::filesystem::path& path);
+
+    // Append-only columnar store for telemetry events, one partition file per UTC day under `directory`
+    // (YYYYMMDD.eftc). A partition is a sequence of chunks, little-endian:
+    //
+    //   u32 magic 'EFTC' | u16 format version | u16 column count | u32 rows | u32 payload bytes |
+    //   u64 min ts | u64 max ts | f64 sum dealt | f64 sum taken | f64 sum mining | u32 combat rows |
+    //   u32 mining rows | u32 column bytes[6] | u32 payload checksum | payload
+    //
+    // A chunk holds rows from a single UTC hour, sorted by time. Columns are stored one after another: timestamps as a varint
+    // base and varint deltas, dealt/taken/mining as byte-granular XOR against the previous value, quality
+    // as raw bytes and resource ids as zigzag varint deltas. Range scans read only chunk headers for
+    // chunks outside the range, and downsampling takes a chunk's sums from its header when the whole chunk
+    // falls in one bucket, so a multi-day query at whole-hour resolution decodes nothing.
+    //
+    // Appends are buffered and written as chunks when the buffer fills or flushInterval has passed since its
+    // first row. Events arrive per source (a log file); store.json keeps each source's newest timestamp and
+    // how many rows carried it, so a log that is read again from the start does not store its events twice.
+    // Queries take the partition lengths and buffered rows under the lock and read the files without it, so
+    // a long scan does not hold up appends; chunks written meanwhile lie past the lengths and are not seen.
+    class TelemetryStore
+    {
+    public:
+        struct Config
+        {
+            std::filesystem::path directory;
+            std::size_t chunkRows{4096};
+            std::chrono::seconds flushInterval{60};
+        };
+
+        explicit TelemetryStore(Config config);
+        ~TelemetryStore();
+
+        TelemetryStore(const TelemetryStore&) = delete;
+        TelemetryStore& operator=(const TelemetryStore&) = delete;
+
+        // Id for a resource name, stable across runs. Empty names map to 0.
+        std::uint32_t resourceId(std::string_view name);
+        std::optional<std::string> resourceName(std::uint32_t id) const;
+
+        // Adds an event read from `source`. Events must arrive in time order per source; ones at or before
+        // what the source already stored are dropped. Returns false for a dropped event.
+        bool append(std::string_view source, const TelemetryRecord& record);
+
+        // Writes buffered rows and the metadata.
+        void flush();
+
+        // Calls `onRecord` for every stored row with timestamp in [fromMs, toMs), partition by partition.
+        void scan(std::uint64_t fromMs, std::uint64_t toMs, const std::function<void(const TelemetryRecord&)>& onRecord) const;
+
+        // Sums rows with timestamp in [fromMs, toMs) into buckets of `resolutionMs` aligned to multiples of
+        // it. Only buckets with events are returned, in time order.
+        std::vector<TelemetryPoint> query(std::uint64_t fromMs, std::uint64_t toMs, std::uint64_t resolutionMs) const;
+
+        // Grows with every stored event, so cached query results can tell when they are stale.
+        std::uint64_t revision() const { return revision_.load(); }
+
+    private:
+        struct SourceCursor
+        {
+            std::uint64_t timestampMs{0};
+            std::uint32_t rowsAtTimestamp{0};
+            std::uint32_t replayed{0};          // rows at timestampMs seen this run; not persisted
+        };
+
+        struct ChunkHeader;
+
+        struct PartitionSnapshot
+        {
+            std::filesystem::path path;
+            std::uint64_t length{0};      // bytes to read; appends only ever go past it
+        };
+
+        void flushLocked();
+        void writeChunk(std::uint64_t day, std::vector<TelemetryRecord>& rows);
+        void loadMetadata();
+        void saveMetadataLocked() const;
+        std::filesystem::path partitionPath(std::uint64_t day) const;
+        std::vector<PartitionSnapshot> snapshotLocked(std::uint64_t fromMs, std::uint64_t toMs, std::vector<TelemetryRecord>& pending) const;
+        void scanPartition(const std::filesystem::path& path, std::uint64_t length, std::uint64_t fromMs, std::uint64_t toMs,
+                           const std::function<bool(const ChunkHeader&)>& useHeader,
+                           const std::function<void(const TelemetryRecord&)>& onRecord) const;
+
+        Config config_;
+        mutable std::mutex mutex_;
+        std::vector<TelemetryRecord> pending_;
+        std::chrono::steady_clock::time_point pendingSince_{};
+        std::vector<std::string> resources_;                       // id - 1 -> name
+        std::map<std::string, std::uint32_t, std::less<>> resourceIds_;
+        std::map<std::string, SourceCursor, std::less<>> sources_;
+        std::map<std::uint64_t, std::uint64_t> verifiedPartitions_; // day -> valid length, checked before appending
+        bool metadataDirty_{false};
+        std::atomic<std::uint64_t> revision_{0};
+    };
+}
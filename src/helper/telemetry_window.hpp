@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace helper::logs
+{
+    // Sums of `Columns` values over the events of the last `window`, in total and per key (small dense ids
+    // such as interned resource names). Each event is added once and subtracted once when it ages out, so
+    // reading a sum costs O(1) however many events the window holds.
+    template <std::size_t Columns>
+    class WindowedSums
+    {
+    public:
+        using Values = std::array<double, Columns>;
+        using TimePoint = std::chrono::system_clock::time_point;
+
+        explicit WindowedSums(std::chrono::seconds window)
+            : window_(window)
+        {
+        }
+
+        std::chrono::seconds window() const { return window_; }
+
+        void add(const TimePoint& timestamp, const Values& values, std::uint32_t key = 0)
+        {
+            advance(timestamp);
+            entries_.push_back(Entry{timestamp, values, key});
+            if (key >= byKey_.size())
+            {
+                byKey_.resize(static_cast<std::size_t>(key) + 1, Values{});
+            }
+            for (std::size_t i = 0; i < Columns; ++i)
+            {
+                totals_[i] += values[i];
+                byKey_[key][i] += values[i];
+            }
+        }
+
+        // Drops the events older than `now - window`.
+        void advance(const TimePoint& now)
+        {
+            const auto cutoff = now - window_;
+            while (!entries_.empty() && entries_.front().timestamp < cutoff)
+            {
+                const auto& entry = entries_.front();
+                for (std::size_t i = 0; i < Columns; ++i)
+                {
+                    totals_[i] -= entry.values[i];
+                    byKey_[entry.key][i] -= entry.values[i];
+                }
+                entries_.pop_front();
+            }
+
+            // Subtraction leaves rounding residue; an empty window is exactly zero.
+            if (entries_.empty())
+            {
+                totals_ = Values{};
+                std::fill(byKey_.begin(), byKey_.end(), Values{});
+            }
+        }
+
+        void clear()
+        {
+            entries_.clear();
+            totals_ = Values{};
+            byKey_.clear();
+        }
+
+        bool empty() const { return entries_.empty(); }
+        std::size_t size() const { return entries_.size(); }
+        const Values& totals() const { return totals_; }
+
+        Values forKey(std::uint32_t key) const
+        {
+            return key < byKey_.size() ? byKey_[key] : Values{};
+        }
+
+    private:
+        struct Entry
+        {
+            TimePoint timestamp;
+            Values values;
+            std::uint32_t key;
+        };
+
+        std::chrono::seconds window_;
+        std::deque<Entry> entries_;
+        Values totals_{};
+        std::vector<Values> byKey_;
+    };
+
+    // The latest sample of each second over the last `Seconds` seconds, in a fixed ring of one-second
+    // slots. Memory and read cost depend on the retention only, never on the event rate. `Sample` needs a
+    // `timestampMs` member.
+    template <typename Sample, std::size_t Seconds>
+    class SparklineRing
+    {
+    public:
+        void record(const Sample& sample)
+        {
+            const auto second = sample.timestampMs / 1000;
+            if (hasSamples_ && second + Seconds <= newestSecond_)
+            {
+                return;
+            }
+            if (!hasSamples_ || second > newestSecond_)
+            {
+                newestSecond_ = second;
+                hasSamples_ = true;
+            }
+
+            auto& slot = slots_[second % Seconds];
+            if (!slot.used || slot.second <= second)
+            {
+                slot = Slot{second, true, sample};
+            }
+        }
+
+        // Retained samples, oldest first.
+        std::vector<Sample> samples() const
+        {
+            std::vector<Sample> result;
+            if (!hasSamples_)
+            {
+                return result;
+            }
+            result.reserve(Seconds);
+            const auto first = newestSecond_ >= Seconds ? newestSecond_ - (Seconds - 1) : 0;
+            for (auto second = first; second <= newestSecond_; ++second)
+            {
+                const auto& slot = slots_[second % Seconds];
+                if (slot.used && slot.second == second)
+                {
+                    result.push_back(slot.sample);
+                }
+            }
+            return result;
+        }
+
+        void clear()
+        {
+            slots_.fill(Slot{});
+            hasSamples_ = false;
+            newestSecond_ = 0;
+        }
+
+    private:
+        struct Slot
+        {
+            std::uint64_t second{0};
+            bool used{false};
+            Sample sample{};
+        };
+
+        std::array<Slot, Seconds> slots_{};
+        std::uint64_t newestSecond_{0};
+        bool hasSamples_{false};
+    };
+}
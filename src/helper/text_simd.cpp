@@ -0,0 +1,215 @@
+#include "text_simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define EF_TEXT_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define EF_TARGET_AVX2
+#else
+#define EF_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace helper::logs
+{
+    namespace
+    {
+        std::size_t ascii_utf16le_to_utf8_scalar(const char* input, std::size_t units, char* output)
+        {
+            std::size_t index = 0;
+            for (; index < units; ++index)
+            {
+                const auto low = static_cast<unsigned char>(input[2 * index]);
+                const auto high = static_cast<unsigned char>(input[2 * index + 1]);
+                if (high != 0 || low >= 0x80)
+                {
+                    break;
+                }
+                output[index] = static_cast<char>(low);
+            }
+            return index;
+        }
+
+        std::size_t find_line_break_scalar(const char* data, std::size_t size)
+        {
+            for (std::size_t index = 0; index < size; ++index)
+            {
+                if (data[index] == '\n' || data[index] == '\r')
+                {
+                    return index;
+                }
+            }
+            return size;
+        }
+
+#if defined(EF_TEXT_SIMD_X86)
+        std::size_t ascii_utf16le_to_utf8_sse2(const char* input, std::size_t units, char* output)
+        {
+            // 16 units per step: both halves must be below 0x80 before they are packed to bytes.
+            const __m128i nonAscii = _mm_set1_epi16(static_cast<short>(0xFF80));
+            std::size_t index = 0;
+            for (; index + 16 <= units; index += 16)
+            {
+                const auto first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * index));
+                const auto second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * index + 16));
+                const auto high = _mm_and_si128(_mm_or_si128(first, second), nonAscii);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + index), _mm_packus_epi16(first, second));
+            }
+            return index + ascii_utf16le_to_utf8_scalar(input + 2 * index, units - index, output + index);
+        }
+
+        std::size_t find_line_break_sse2(const char* data, std::size_t size)
+        {
+            const auto lineFeed = _mm_set1_epi8('\n');
+            const auto carriageReturn = _mm_set1_epi8('\r');
+            std::size_t index = 0;
+            for (; index + 16 <= size; index += 16)
+            {
+                const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+                const auto hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, lineFeed), _mm_cmpeq_epi8(bytes, carriageReturn));
+                const auto mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+                if (mask != 0)
+                {
+                    return index + static_cast<std::size_t>(std::countr_zero(mask));
+                }
+            }
+            return index + find_line_break_scalar(data + index, size - index);
+        }
+
+        EF_TARGET_AVX2 std::size_t ascii_utf16le_to_utf8_avx2(const char* input, std::size_t units, char* output)
+        {
+            const __m256i nonAscii = _mm256_set1_epi16(static_cast<short>(0xFF80));
+            std::size_t index = 0;
+            for (; index + 32 <= units; index += 32)
+            {
+                const auto first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 2 * index));
+                const auto second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 2 * index + 32));
+                if (!_mm256_testz_si256(_mm256_or_si256(first, second), nonAscii))
+                {
+                    break;
+                }
+                // packus works per 128-bit lane; the permute restores first-then-second order.
+                const auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + index), packed);
+            }
+            // The tail goes to the SSE2 kernel, which is not VEX-encoded: clear the upper halves first or
+            // every short run pays an AVX-SSE transition.
+            _mm256_zeroupper();
+            return index + ascii_utf16le_to_utf8_sse2(input + 2 * index, units - index, output + index);
+        }
+
+        EF_TARGET_AVX2 std::size_t find_line_break_avx2(const char* data, std::size_t size)
+        {
+            const auto lineFeed = _mm256_set1_epi8('\n');
+            const auto carriageReturn = _mm256_set1_epi8('\r');
+            std::size_t index = 0;
+            for (; index + 32 <= size; index += 32)
+            {
+                const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+                const auto hits = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, lineFeed), _mm256_cmpeq_epi8(bytes, carriageReturn));
+                const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+                if (mask != 0)
+                {
+                    return index + static_cast<std::size_t>(std::countr_zero(mask));
+                }
+            }
+            _mm256_zeroupper();
+            return index + find_line_break_sse2(data + index, size - index);
+        }
+
+        bool cpu_has_avx2()
+        {
+#if defined(_MSC_VER)
+            int info[4]{};
+            __cpuid(info, 1);
+            const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        }
+#endif
+
+        TextSimdLevel detect_level()
+        {
+#if defined(EF_TEXT_SIMD_X86)
+            return cpu_has_avx2() ? TextSimdLevel::Avx2 : TextSimdLevel::Sse2;
+#else
+            return TextSimdLevel::Scalar;
+#endif
+        }
+
+        const TextSimdLevel g_supportedLevel = detect_level();
+        std::atomic<TextSimdLevel> g_level{g_supportedLevel};
+    }
+
+    TextSimdLevel supported_text_simd_level()
+    {
+        return g_supportedLevel;
+    }
+
+    TextSimdLevel text_simd_level()
+    {
+        return g_level.load(std::memory_order_relaxed);
+    }
+
+    void set_text_simd_level(TextSimdLevel level)
+    {
+        g_level.store(std::min(level, g_supportedLevel), std::memory_order_relaxed);
+    }
+
+    const char* text_simd_level_name(TextSimdLevel level)
+    {
+        switch (level)
+        {
+        case TextSimdLevel::Avx2:
+            return "avx2";
+        case TextSimdLevel::Sse2:
+            return "sse2";
+        default:
+            return "scalar";
+        }
+    }
+
+    std::size_t ascii_utf16le_to_utf8(const char* input, std::size_t units, char* output)
+    {
+        switch (text_simd_level())
+        {
+#if defined(EF_TEXT_SIMD_X86)
+        case TextSimdLevel::Avx2:
+            return ascii_utf16le_to_utf8_avx2(input, units, output);
+        case TextSimdLevel::Sse2:
+            return ascii_utf16le_to_utf8_sse2(input, units, output);
+#endif
+        default:
+            return ascii_utf16le_to_utf8_scalar(input, units, output);
+        }
+    }
+
+    std::size_t find_line_break(const char* data, std::size_t size)
+    {
+        switch (text_simd_level())
+        {
+#if defined(EF_TEXT_SIMD_X86)
+        case TextSimdLevel::Avx2:
+            return find_line_break_avx2(data, size);
+        case TextSimdLevel::Sse2:
+            return find_line_break_sse2(data, size);
+#endif
+        default:
+            return find_line_break_scalar(data, size);
+        }
+    }
+}
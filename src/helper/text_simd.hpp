@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+namespace helper::logs
+{
+    // Vector kernels for log ingestion. On x86-64 SSE2 is always available and AVX2 is used when the CPU
+    // has it; elsewhere the scalar versions run. The choice is made once at startup and can be lowered for
+    // tests and benchmarks.
+    enum class TextSimdLevel
+    {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    TextSimdLevel supported_text_simd_level();
+    TextSimdLevel text_simd_level();
+
+    // Uses `level`, or the best supported level below it. Not synchronised with running conversions.
+    void set_text_simd_level(TextSimdLevel level);
+
+    const char* text_simd_level_name(TextSimdLevel level);
+
+    // Converts the leading run of ASCII code units of `units` UTF-16LE units at `input`, one byte each, to
+    // `output` (which must hold `units` bytes). Returns how many units were converted; the caller handles
+    // the non-ASCII unit that stopped the run.
+    std::size_t ascii_utf16le_to_utf8(const char* input, std::size_t units, char* output);
+
+    // Offset of the first '\r' or '\n' in `data`, or `size` if there is none.
+    std::size_t find_line_break(const char* data, std::size_t size);
+}
@@ -667,7 +667,7 @@ std::wstring HelperTrayApplication::buildDiagnosticsText() const
                 out << L" ...";
                 break;
             }
-            out << L" " << utf8_to_wide(bucket.resource) << L"=" << format_double(bucket.sessionTotalM3);
+            out << L" " << utf8_to_wide(bucket.resource.str()) << L"=" << format_double(bucket.sessionTotalM3);
         }
     }
 
@@ -871,7 +871,7 @@ std::wstring HelperTrayApplication::formatTelemetryLine(const HelperRuntime::Sta
         if (!telemetry.mining->buckets.empty())
         {
             const auto& bucket = telemetry.mining->buckets.front();
-            segment += L" (" + utf8_to_wide(bucket.resource);
+            segment += L" (" + utf8_to_wide(bucket.resource.str());
             if (telemetry.mining->buckets.size() > 1)
             {
                 segment += L"+" + std::to_wstring(telemetry.mining->buckets.size() - 1);
@@ -73,6 +73,12 @@ namespace
         return value.empty() ? std::string{} : to_utf8(value);
     }
 
+    bool read_shared_state_json()
+    {
+        const auto value = read_env_var(L"EF_OVERLAY_SHARED_STATE_JSON");
+        return !value.empty() && value != L"0";
+    }
+
     std::wstring get_executable_path()
     {
         std::wstring buffer(MAX_PATH, L'\0');
@@ -110,6 +116,7 @@ int APIENTRY wWinMain(HINSTANCE instance, HINSTANCE, LPWSTR, int)
     config.port = read_port();
     config.token = read_token();
     config.executableDirectory = std::filesystem::path(get_executable_path()).parent_path();
+    config.sharedStateJson = read_shared_state_json();
 
     HelperRuntime runtime(std::move(config));
     HelperTrayApplication app(instance, runtime);
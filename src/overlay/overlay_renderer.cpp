@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <mutex>
 #include <sstream>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
@@ -44,6 +45,10 @@ namespace
     }
 
     constexpr std::uint64_t kStateStaleThresholdMs = 5000;
+    // Upper bound on how long the poll thread blocks waiting for a publish, so staleness checks keep running.
+    constexpr auto kStateWaitTimeout = std::chrono::milliseconds{200};
+    // Pause before retrying a publish that could not be read, so a persistently torn region does not spin.
+    constexpr auto kStateReadRetryDelay = std::chrono::milliseconds{10};
     constexpr std::uint64_t kMiningRateHistoryWindowMs = 120000;
     constexpr std::uint64_t kMiningRateSmoothingWindowMs = 10000;
 
@@ -427,6 +432,7 @@ void OverlayRenderer::pollLoop()
 {
     spdlog::info("Overlay state polling thread started");
 
+    std::uint64_t lastSequence = 0;
     while (running_.load())
     {
         if (!sharedReader_.ensure())
@@ -440,17 +446,35 @@ void OverlayRenderer::pollLoop()
             eventWriterReady_.store(eventWriter_.ensure());
         }
 
-        auto snapshot = sharedReader_.read();
+        // Wakes as soon as the helper publishes; an unchanged sequence means there is nothing to re-decode.
+        // The sequence only advances once a publish has been read, so a failed read is retried.
+        std::optional<overlay::SharedMemoryState> snapshot;
+        if (sharedReader_.wait_for_update(lastSequence, kStateWaitTimeout))
+        {
+            snapshot = sharedReader_.read_state();
+            if (snapshot)
+            {
+                lastSequence = snapshot->sequence;
+            }
+            else
+            {
+                std::this_thread::sleep_for(kStateReadRetryDelay);
+            }
+        }
+
         if (snapshot)
         {
-            const auto payload = snapshot->json_payload;
+            const auto& payload = snapshot->json_payload;
             const auto version = snapshot->version;
             const auto updatedAt = snapshot->updated_at_ms;
 
             try
             {
-                const auto json = nlohmann::json::parse(payload, nullptr, true, true);
-                overlay::OverlayState parsedState = overlay::parse_overlay_state(json);
+                if (!snapshot->state)
+                {
+                    throw std::runtime_error(snapshot->error);
+                }
+                overlay::OverlayState& parsedState = *snapshot->state;
 
                 {
                     std::lock_guard<std::mutex> lock(stateMutex_);
@@ -507,8 +531,14 @@ void OverlayRenderer::pollLoop()
 
         {
             const std::uint64_t currentTimeMs = now_ms();
+            const std::uint64_t sharedHeartbeatMs = sharedReader_.current_heartbeat_ms();
             std::lock_guard<std::mutex> lock(stateMutex_);
             const bool haveState = currentState_.has_value();
+            // Heartbeats between publishes only advance the header record, not the decoded state.
+            if (haveState && sharedHeartbeatMs > lastHeartbeatMs_)
+            {
+                lastHeartbeatMs_ = sharedHeartbeatMs;
+            }
             const std::uint64_t heartbeatCopy = lastHeartbeatMs_ == 0 ? lastUpdatedAtMs_ : lastHeartbeatMs_;
             const bool currentlyHidden = autoHidden_.load();
 
@@ -549,8 +579,6 @@ void OverlayRenderer::pollLoop()
                 }
             }
         }
-
-        std::this_thread::sleep_for(200ms);
     }
 
     spdlog::info("Overlay state polling thread exiting");
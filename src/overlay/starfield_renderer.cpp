@@ -409,18 +409,23 @@ std::filesystem::path StarfieldRenderer::resolveCatalogPath() const
         return {};
     }
 
-    const std::array<std::filesystem::path, 4> candidates{
-        base / L"star_catalog_v1.bin",
-        base / L".." / L"star_catalog_v1.bin",
-        base / L".." / L".." / L"data" / L"star_catalog_v1.bin",
-        base / L".." / L".." / L".." / L"data" / L"star_catalog_v1.bin"};
+    const std::array<std::filesystem::path, 4> directories{
+        base,
+        base / L"..",
+        base / L".." / L".." / L"data",
+        base / L".." / L".." / L".." / L"data"};
 
-    for (const auto& candidate : candidates)
+    // EFSTARS2 carries precomputed lookup indexes; fall back to the v1 catalog when it has not been converted.
+    for (const auto* fileName : {L"star_catalog_v2.bin", L"star_catalog_v1.bin"})
     {
-        std::error_code ec;
-        if (!candidate.empty() && std::filesystem::exists(candidate, ec) && !ec)
+        for (const auto& directory : directories)
         {
-            return std::filesystem::weakly_canonical(candidate, ec);
+            const auto candidate = directory / fileName;
+            std::error_code ec;
+            if (std::filesystem::exists(candidate, ec) && !ec)
+            {
+                return std::filesystem::weakly_canonical(candidate, ec);
+            }
         }
     }
 
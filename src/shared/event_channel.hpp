@@ -1,7 +1,11 @@
 #pragma once
 
+#include "ipc_backend.hpp"
+
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -9,9 +13,9 @@
 namespace overlay
 {
     constexpr int event_schema_version = 1;
-    constexpr const wchar_t* event_shared_memory_name = L"Local\\EFOverlayEventQueue";
-    constexpr std::size_t event_queue_slots = 64;
-    constexpr std::size_t event_payload_capacity = 512;
+    constexpr const wchar_t* event_shared_memory_name = L"Local\\EFOverlayEventRing";
+    constexpr std::size_t event_queue_slots = 256;               // power of two; see event_ring_protocol.hpp
+    constexpr std::size_t event_arena_capacity = 256 * 1024;     // shared by all pending payloads
 
     enum class OverlayEventType : std::uint16_t
     {
@@ -51,12 +55,15 @@ namespace overlay
         OverlayEventWriter& operator=(const OverlayEventWriter&) = delete;
 
         bool ensure();
+
+        // Thread-safe. Returns false if the queue is full or the payload is larger than a quarter of the
+        // arena; either way the event is counted as dropped.
         bool publish(const OverlayEvent& event);
 
     private:
-        void* mappingHandle_{nullptr};
-        void* view_{nullptr};
-        std::size_t capacity_{0};
+        std::mutex ensureMutex_;
+        SharedMapping mapping_;
+        std::atomic<void*> view_{nullptr};     // mapping_.data() once ready; checked without the mutex
     };
 
     class OverlayEventReader
@@ -73,9 +80,7 @@ namespace overlay
         EventDequeueResult drain();
 
     private:
-        void* mappingHandle_{nullptr};
-        void* view_{nullptr};
-        std::size_t capacity_{0};
+        SharedMapping mapping_;
         std::uint32_t lastDropped_{0};
     };
 
@@ -0,0 +1,306 @@
+#include "event_ring_protocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace overlay
+{
+    namespace
+    {
+        std::atomic_ref<std::uint64_t> atomic_u64(const std::uint64_t& value)
+        {
+            // The header lives in memory shared with another process; atomic_ref keeps the layout a plain struct.
+            return std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(value));
+        }
+
+        std::atomic_ref<std::uint32_t> atomic_u32(const std::uint32_t& value)
+        {
+            return std::atomic_ref<std::uint32_t>(const_cast<std::uint32_t&>(value));
+        }
+
+        EventRingSlot* ring_slots(void* region)
+        {
+            return reinterpret_cast<EventRingSlot*>(static_cast<std::byte*>(region) + sizeof(EventRingHeader));
+        }
+
+        std::byte* ring_arena(void* region, std::uint32_t slotCount)
+        {
+            return static_cast<std::byte*>(region) + sizeof(EventRingHeader) + slotCount * sizeof(EventRingSlot);
+        }
+
+        EventRingHeader* initialized_header(void* region, std::size_t regionSize)
+        {
+            if (regionSize < sizeof(EventRingHeader))
+            {
+                return nullptr;
+            }
+
+            auto* header = static_cast<EventRingHeader*>(region);
+            if (atomic_u32(header->magic).load(std::memory_order_acquire) != event_ring_magic ||
+                header->slot_count == 0 || (header->slot_count & (header->slot_count - 1)) != 0 ||
+                header->arena_capacity == 0 || header->arena_capacity % event_arena_alignment != 0 ||
+                event_ring_region_size(header->slot_count, header->arena_capacity) > regionSize)
+            {
+                return nullptr;
+            }
+            return header;
+        }
+
+        void copy_to_arena(std::byte* arena, std::size_t capacity, std::uint64_t offset, std::string_view payload)
+        {
+            if (payload.empty())
+            {
+                return;
+            }
+
+            const auto start = static_cast<std::size_t>(offset % capacity);
+            const auto first = std::min(payload.size(), capacity - start);
+            std::memcpy(arena + start, payload.data(), first);
+            std::memcpy(arena, payload.data() + first, payload.size() - first);
+        }
+
+        void copy_from_arena(const std::byte* arena, std::size_t capacity, std::uint64_t offset, std::string& payload)
+        {
+            if (payload.empty())
+            {
+                return;
+            }
+
+            const auto start = static_cast<std::size_t>(offset % capacity);
+            const auto first = std::min(payload.size(), capacity - start);
+            std::memcpy(payload.data(), arena + start, first);
+            std::memcpy(payload.data() + first, arena, payload.size() - first);
+        }
+
+        bool count_dropped(EventRingHeader* header)
+        {
+            atomic_u32(header->dropped_events).fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        EventArenaRecord* arena_record(std::byte* arena, std::size_t capacity, std::uint64_t position)
+        {
+            // Records are aligned to their own size and the capacity is a multiple of it, so none wraps.
+            return reinterpret_cast<EventArenaRecord*>(arena + position % capacity);
+        }
+
+        std::uint64_t arena_record_size(std::size_t payloadSize)
+        {
+            const auto padded = (payloadSize + event_arena_alignment - 1) / event_arena_alignment * event_arena_alignment;
+            return sizeof(EventArenaRecord) + padded;
+        }
+
+        // Moves the tail over every released record at the front of the arena. Any producer or consumer may
+        // run it; the CAS lets exactly one of them step over each record.
+        void advance_arena_tail(EventRingHeader* header, std::byte* arena)
+        {
+            auto tail = atomic_u64(header->arena_tail);
+            auto position = tail.load(std::memory_order_acquire);
+            while (position != atomic_u64(header->arena_head).load(std::memory_order_acquire))
+            {
+                auto* record = arena_record(arena, header->arena_capacity, position);
+                // A record whose position does not match is from an earlier lap: its producer has reserved
+                // the space but not yet stamped it.
+                if (atomic_u64(record->position).load(std::memory_order_acquire) != position ||
+                    atomic_u32(record->released).load(std::memory_order_acquire) == 0)
+                {
+                    return;
+                }
+
+                const auto size = atomic_u32(record->size).load(std::memory_order_relaxed);
+                if (!tail.compare_exchange_weak(position, position + size, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    continue;
+                }
+                position += size;
+            }
+        }
+
+        void release_arena_record(EventRingHeader* header, std::byte* arena, std::uint64_t position)
+        {
+            atomic_u32(arena_record(arena, header->arena_capacity, position)->released).store(1, std::memory_order_release);
+            advance_arena_tail(header, arena);
+        }
+
+        // Reserves a record for `payloadSize` bytes and stamps it. Fails when it would overrun space that a
+        // consumer has not released yet.
+        std::optional<std::uint64_t> reserve_arena_record(EventRingHeader* header, std::byte* arena, std::size_t payloadSize)
+        {
+            const auto size = arena_record_size(payloadSize);
+            auto head = atomic_u64(header->arena_head);
+            auto position = head.load(std::memory_order_relaxed);
+            bool retried = false;
+            while (true)
+            {
+                const auto tail = atomic_u64(header->arena_tail).load(std::memory_order_acquire);
+                if (position < tail)
+                {
+                    // Both cursors moved on since the head was read.
+                    position = head.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (position + size - tail > header->arena_capacity)
+                {
+                    if (retried)
+                    {
+                        return std::nullopt;
+                    }
+                    // Consumers advance the tail as they go, but one may have released a record behind
+                    // another that was still being read; try once to catch up before giving up.
+                    advance_arena_tail(header, arena);
+                    position = head.load(std::memory_order_relaxed);
+                    retried = true;
+                    continue;
+                }
+                if (head.compare_exchange_weak(position, position + size, std::memory_order_acq_rel, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            auto* record = arena_record(arena, header->arena_capacity, position);
+            atomic_u32(record->size).store(static_cast<std::uint32_t>(size), std::memory_order_relaxed);
+            atomic_u32(record->released).store(0, std::memory_order_relaxed);
+            atomic_u64(record->position).store(position, std::memory_order_release);
+            return position;
+        }
+    }
+
+    static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free, "Event ring cursors must be lock-free to work across processes");
+
+    void initialize_event_ring(void* region, std::size_t slotCount, std::size_t arenaCapacity)
+    {
+        auto* header = static_cast<EventRingHeader*>(region);
+        if (header->magic == event_ring_magic && header->slot_count == slotCount && header->arena_capacity == arenaCapacity)
+        {
+            return;
+        }
+
+        std::memset(header, 0, sizeof(EventRingHeader));
+        header->schema_version = static_cast<std::uint32_t>(event_schema_version);
+        header->slot_count = static_cast<std::uint32_t>(slotCount);
+        header->arena_capacity = static_cast<std::uint32_t>(arenaCapacity);
+
+        auto* slots = ring_slots(region);
+        for (std::size_t i = 0; i < slotCount; ++i)
+        {
+            std::memset(&slots[i], 0, sizeof(EventRingSlot));
+            slots[i].sequence = i;
+        }
+
+        atomic_u32(header->magic).store(event_ring_magic, std::memory_order_release);
+    }
+
+    bool push_event_ring(void* region, OverlayEventType type, std::uint64_t timestampMs, std::string_view payload)
+    {
+        auto* header = static_cast<EventRingHeader*>(region);
+        if (payload.size() > event_ring_max_payload(header->arena_capacity))
+        {
+            return count_dropped(header);
+        }
+
+        // Space comes first: a reservation can be handed back by releasing it, a claimed slot cannot.
+        auto* arena = ring_arena(region, header->slot_count);
+        const auto reserved = reserve_arena_record(header, arena, payload.size());
+        if (!reserved.has_value())
+        {
+            return count_dropped(header);
+        }
+        const auto offset = *reserved;
+
+        auto* slots = ring_slots(region);
+        const std::uint64_t mask = header->slot_count - 1;
+        auto enqueue = atomic_u64(header->enqueue_position);
+        auto position = enqueue.load(std::memory_order_relaxed);
+        EventRingSlot* slot = nullptr;
+        while (true)
+        {
+            slot = &slots[position & mask];
+            const auto sequence = atomic_u64(slot->sequence).load(std::memory_order_acquire);
+            const auto difference = static_cast<std::int64_t>(sequence - position);
+            if (difference == 0)
+            {
+                if (enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // The slot still holds the event from one lap ago: the ring is full.
+                release_arena_record(header, arena, offset);
+                return count_dropped(header);
+            }
+            else
+            {
+                position = enqueue.load(std::memory_order_relaxed);
+            }
+        }
+
+        copy_to_arena(arena, header->arena_capacity, offset + sizeof(EventArenaRecord), payload);
+
+        slot->timestamp_ms = timestampMs;
+        slot->payload_offset = offset;
+        slot->payload_size = static_cast<std::uint32_t>(payload.size());
+        slot->type = static_cast<std::uint16_t>(type);
+        slot->flags = 0;
+        atomic_u64(slot->sequence).store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<OverlayEvent> pop_event_ring(void* region, std::size_t regionSize)
+    {
+        auto* header = initialized_header(region, regionSize);
+        if (!header)
+        {
+            return std::nullopt;
+        }
+
+        auto* slots = ring_slots(region);
+        auto* arena = ring_arena(region, header->slot_count);
+        const std::uint64_t mask = header->slot_count - 1;
+        auto dequeue = atomic_u64(header->dequeue_position);
+        auto position = dequeue.load(std::memory_order_relaxed);
+        EventRingSlot* slot = nullptr;
+        while (true)
+        {
+            slot = &slots[position & mask];
+            const auto sequence = atomic_u64(slot->sequence).load(std::memory_order_acquire);
+            const auto difference = static_cast<std::int64_t>(sequence - (position + 1));
+            if (difference == 0)
+            {
+                if (dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // Empty, or the producer that claimed this position has not finished publishing yet.
+                return std::nullopt;
+            }
+            else
+            {
+                position = dequeue.load(std::memory_order_relaxed);
+            }
+        }
+
+        OverlayEvent event;
+        event.type = static_cast<OverlayEventType>(slot->type);
+        event.timestamp_ms = slot->timestamp_ms;
+        const auto offset = slot->payload_offset;
+        event.payload.resize(std::min<std::size_t>(slot->payload_size, event_ring_max_payload(header->arena_capacity)));
+        copy_from_arena(arena, header->arena_capacity, offset + sizeof(EventArenaRecord), event.payload);
+
+        release_arena_record(header, arena, offset);
+        atomic_u64(slot->sequence).store(position + header->slot_count, std::memory_order_release);
+        return event;
+    }
+
+    std::uint32_t event_ring_dropped(const void* region, std::size_t regionSize)
+    {
+        const auto* header = initialized_header(const_cast<void*>(region), regionSize);
+        return header ? atomic_u32(header->dropped_events).load(std::memory_order_relaxed) : 0;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "event_channel.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace overlay
+{
+    // Layout of the overlay event queue, independent of how the region is mapped:
+    //
+    //   EventRingHeader | slot_count EventRingSlot | payload arena (arena_capacity bytes)
+    //
+    // The slots form a bounded multi-producer/multi-consumer ring in the style of Dmitry Vyukov's queue.
+    // Every slot carries its own sequence: slot i starts at i, a producer that claims position p waits for
+    // sequence == p and publishes p + 1, and the consumer that takes it hands the slot back as
+    // p + slot_count. Producers and consumers each advance only their own cursor with a CAS, so neither side
+    // ever moves the other's index.
+    //
+    // Payloads live in the arena, a byte ring between a reservation cursor (arena_head) and a release cursor
+    // (arena_tail), both absolute. Each payload is one EventArenaRecord followed by its bytes, padded to 16;
+    // a slot stores the absolute position of its record. A producer reserves space only while
+    // head + size - tail fits the arena, and otherwise drops the event. A consumer marks the record released
+    // once it has copied the payload out, and moves the tail over every released record at the front. Space
+    // is therefore reused only after its reader is done with it, however long a producer stalls between
+    // reserving and writing.
+    constexpr std::uint32_t event_ring_magic = 0x52454645; // 'EFER'
+
+    struct EventRingHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t schema_version;
+        std::uint32_t slot_count;                  // power of two
+        std::uint32_t arena_capacity;
+        std::uint32_t dropped_events;              // rejected on a full ring or arena
+        std::uint32_t reserved;
+        alignas(64) std::uint64_t enqueue_position; // producers' cursor
+        alignas(64) std::uint64_t dequeue_position; // consumers' cursor
+        alignas(64) std::uint64_t arena_head;       // total arena bytes ever reserved
+        alignas(64) std::uint64_t arena_tail;       // total arena bytes released by consumers
+    };
+
+    struct EventArenaRecord
+    {
+        std::uint64_t position;                    // absolute arena position of this record, set on reservation
+        std::uint32_t size;                        // record size including this header and padding
+        std::uint32_t released;                    // 1 once the payload was copied out or the event dropped
+    };
+
+    constexpr std::size_t event_arena_alignment = sizeof(EventArenaRecord);   // arena_capacity is a multiple
+
+    struct EventRingSlot
+    {
+        alignas(8) std::uint64_t sequence;
+        std::uint64_t timestamp_ms;
+        std::uint64_t payload_offset;              // absolute position of the EventArenaRecord; modulo arena_capacity
+        std::uint32_t payload_size;
+        std::uint16_t type;
+        std::uint16_t flags;
+    };
+
+    constexpr std::size_t event_ring_region_size(std::size_t slotCount, std::size_t arenaCapacity)
+    {
+        return sizeof(EventRingHeader) + slotCount * sizeof(EventRingSlot) + arenaCapacity;
+    }
+
+    // Largest payload push_event_ring accepts; bigger ones would leave too little of the arena for the rest.
+    constexpr std::size_t event_ring_max_payload(std::size_t arenaCapacity)
+    {
+        return arenaCapacity / 4;
+    }
+
+    // Prepares a zeroed region. Idempotent for a region that is already initialised with the same layout.
+    void initialize_event_ring(void* region, std::size_t slotCount, std::size_t arenaCapacity);
+
+    // Safe to call from any number of threads and processes at once. Returns false, and counts the event as
+    // dropped, if the ring or the arena is full or the payload exceeds event_ring_max_payload.
+    bool push_event_ring(void* region, OverlayEventType type, std::uint64_t timestampMs, std::string_view payload);
+
+    // Takes the oldest published event. Returns nullopt when the ring is empty or the region is not
+    // initialised. Safe to call from several consumers.
+    std::optional<OverlayEvent> pop_event_ring(void* region, std::size_t regionSize);
+
+    // Events lost since the ring was created (0 if the region is not initialised).
+    std::uint32_t event_ring_dropped(const void* region, std::size_t regionSize);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace overlay
+{
+    // Platform layer under the shared state channel and the event queue: named shared memory and a named
+    // auto-reset notification. ipc_backend_win32.cpp wraps file mappings and events; ipc_backend_posix.cpp
+    // uses shm_open + mmap and a futex word, so the protocols can be benchmarked and fuzzed off Windows.
+    //
+    // Names use the Win32 form ("Local\\Name"). On POSIX the session prefix is dropped and the rest becomes
+    // "/Name". POSIX objects outlive their handles, so the side that created one unlinks it on close; mapped
+    // views stay valid, but unlike Win32 the name cannot be reopened while another process still holds it.
+    class SharedMapping
+    {
+    public:
+        SharedMapping() = default;
+        ~SharedMapping();
+
+        SharedMapping(const SharedMapping&) = delete;
+        SharedMapping& operator=(const SharedMapping&) = delete;
+        SharedMapping(SharedMapping&& other) noexcept;
+        SharedMapping& operator=(SharedMapping&& other) noexcept;
+
+        // Creates a zero-filled read-write mapping of `size` bytes, or maps the existing one of that name.
+        // With `exclusive`, an existing mapping is left alone and the call fails with already_existed() set.
+        bool create(const std::wstring& name, std::size_t size, bool exclusive = false);
+
+        // Maps an existing mapping. `size` 0 maps all of it; size() then reports what was mapped.
+        bool open(const std::wstring& name, bool writable, std::size_t size = 0);
+
+        void close();
+
+        void* data() const { return view_; }
+        std::size_t size() const { return size_; }
+        bool already_existed() const { return alreadyExisted_; }
+        explicit operator bool() const { return view_ != nullptr; }
+
+    private:
+        void* view_ = nullptr;
+        std::size_t size_ = 0;
+        bool alreadyExisted_ = false;
+#ifdef _WIN32
+        void* handle_ = nullptr;
+#else
+        std::string unlinkName_;   // set when this side created the object
+#endif
+    };
+
+    class SharedEvent
+    {
+    public:
+        SharedEvent() = default;
+        ~SharedEvent();
+
+        SharedEvent(const SharedEvent&) = delete;
+        SharedEvent& operator=(const SharedEvent&) = delete;
+
+        bool create(const std::wstring& name);
+        bool open(const std::wstring& name);
+        void close();
+
+        // Wakes one waiter, or the next one to wait if nobody is waiting yet.
+        void signal();
+
+        // Returns true if signalled within `timeout`, consuming the signal.
+        bool wait(std::chrono::milliseconds timeout);
+
+        explicit operator bool() const;
+
+    private:
+#ifdef _WIN32
+        void* handle_ = nullptr;
+#else
+        SharedMapping word_;
+#endif
+    };
+
+    // Error code of the last failed backend call (GetLastError or errno), for logging.
+    std::uint32_t ipc_last_error();
+}
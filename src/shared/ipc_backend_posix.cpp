@@ -0,0 +1,287 @@
+#include "ipc_backend.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace overlay
+{
+    namespace
+    {
+        std::string posix_name(const std::wstring& name)
+        {
+            std::wstring_view remaining(name);
+            for (const std::wstring_view prefix : {std::wstring_view(L"Local\\"), std::wstring_view(L"Global\\")})
+            {
+                if (remaining.substr(0, prefix.size()) == prefix)
+                {
+                    remaining.remove_prefix(prefix.size());
+                    break;
+                }
+            }
+
+            std::string result = "/";
+            for (const auto ch : remaining)
+            {
+                result.push_back(ch == L'\\' || ch == L'/' || ch < 0x20 || ch > 0x7E ? '_' : static_cast<char>(ch));
+            }
+            return result;
+        }
+
+        std::atomic_ref<std::uint32_t> event_word(const SharedMapping& mapping)
+        {
+            return std::atomic_ref<std::uint32_t>(*static_cast<std::uint32_t*>(mapping.data()));
+        }
+    }
+
+    SharedMapping::~SharedMapping()
+    {
+        close();
+    }
+
+    SharedMapping::SharedMapping(SharedMapping&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    SharedMapping& SharedMapping::operator=(SharedMapping&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            view_ = std::exchange(other.view_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            alreadyExisted_ = std::exchange(other.alreadyExisted_, false);
+            unlinkName_ = std::exchange(other.unlinkName_, {});
+        }
+        return *this;
+    }
+
+    bool SharedMapping::create(const std::wstring& name, std::size_t size, bool exclusive)
+    {
+        close();
+        alreadyExisted_ = false;
+
+        const auto path = posix_name(name);
+        bool created = true;
+        int descriptor = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (descriptor >= 0)
+        {
+            if (::ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+            {
+                const int error = errno;
+                ::close(descriptor);
+                ::shm_unlink(path.c_str());
+                errno = error;
+                return false;
+            }
+        }
+        else
+        {
+            if (errno != EEXIST)
+            {
+                return false;
+            }
+
+            alreadyExisted_ = true;
+            if (exclusive)
+            {
+                return false;
+            }
+
+            created = false;
+            descriptor = ::shm_open(path.c_str(), O_RDWR, 0600);
+            if (descriptor < 0)
+            {
+                return false;
+            }
+
+            // Mapping past the end of the object would fault on access instead of failing here.
+            struct stat info{};
+            if (::fstat(descriptor, &info) != 0 || static_cast<std::size_t>(info.st_size) < size)
+            {
+                ::close(descriptor);
+                errno = EINVAL;
+                return false;
+            }
+        }
+
+        void* view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        const int error = errno;
+        ::close(descriptor);
+        if (view == MAP_FAILED)
+        {
+            if (created)
+            {
+                ::shm_unlink(path.c_str());
+            }
+            errno = error;
+            return false;
+        }
+
+        view_ = view;
+        size_ = size;
+        if (created)
+        {
+            unlinkName_ = path;
+        }
+        return true;
+    }
+
+    bool SharedMapping::open(const std::wstring& name, bool writable, std::size_t size)
+    {
+        close();
+        alreadyExisted_ = false;
+
+        const auto path = posix_name(name);
+        const int descriptor = ::shm_open(path.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+        if (descriptor < 0)
+        {
+            return false;
+        }
+
+        struct stat info{};
+        if (::fstat(descriptor, &info) != 0)
+        {
+            const int error = errno;
+            ::close(descriptor);
+            errno = error;
+            return false;
+        }
+
+        const auto available = static_cast<std::size_t>(info.st_size);
+        if (size == 0)
+        {
+            size = available;
+        }
+        if (size == 0 || available < size)
+        {
+            // Not sized yet (the creator is between shm_open and ftruncate) or smaller than asked for.
+            ::close(descriptor);
+            errno = EINVAL;
+            return false;
+        }
+
+        void* view = ::mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, descriptor, 0);
+        const int error = errno;
+        ::close(descriptor);
+        if (view == MAP_FAILED)
+        {
+            errno = error;
+            return false;
+        }
+
+        view_ = view;
+        size_ = size;
+        return true;
+    }
+
+    void SharedMapping::close()
+    {
+        if (view_)
+        {
+            ::munmap(view_, size_);
+            view_ = nullptr;
+        }
+
+        if (!unlinkName_.empty())
+        {
+            ::shm_unlink(unlinkName_.c_str());
+            unlinkName_.clear();
+        }
+        size_ = 0;
+    }
+
+    SharedEvent::~SharedEvent()
+    {
+        close();
+    }
+
+    bool SharedEvent::create(const std::wstring& name)
+    {
+        // The event is a shared 32-bit word: 1 while signalled, waited on with a futex.
+        return word_.create(name, sizeof(std::uint32_t));
+    }
+
+    bool SharedEvent::open(const std::wstring& name)
+    {
+        return word_.open(name, true, sizeof(std::uint32_t));
+    }
+
+    void SharedEvent::close()
+    {
+        word_.close();
+    }
+
+    void SharedEvent::signal()
+    {
+        if (!word_)
+        {
+            return;
+        }
+
+        event_word(word_).store(1, std::memory_order_release);
+#if defined(__linux__)
+        ::syscall(SYS_futex, word_.data(), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+    }
+
+    bool SharedEvent::wait(std::chrono::milliseconds timeout)
+    {
+        if (!word_)
+        {
+            return false;
+        }
+
+        // Auto-reset: taking the signal clears it, so each signal releases at most one waiter.
+        auto word = event_word(word_);
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true)
+        {
+            if (word.exchange(0, std::memory_order_acq_rel) == 1)
+            {
+                return true;
+            }
+
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::steady_clock::duration::zero())
+            {
+                return false;
+            }
+
+#if defined(__linux__)
+            const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            timespec relative{};
+            relative.tv_sec = static_cast<time_t>(nanoseconds / 1000000000);
+            relative.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+            // Returns on a wake, a timeout, a signal, or at once if the word is no longer 0.
+            ::syscall(SYS_futex, word_.data(), FUTEX_WAIT, 0, &relative, nullptr, 0);
+#else
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(remaining, std::chrono::milliseconds{1}));
+#endif
+        }
+    }
+
+    SharedEvent::operator bool() const
+    {
+        return static_cast<bool>(word_);
+    }
+
+    std::uint32_t ipc_last_error()
+    {
+        return static_cast<std::uint32_t>(errno);
+    }
+}
@@ -0,0 +1,170 @@
+#include "ipc_backend.hpp"
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include <windows.h>
+
+#include <utility>
+
+namespace overlay
+{
+    SharedMapping::~SharedMapping()
+    {
+        close();
+    }
+
+    SharedMapping::SharedMapping(SharedMapping&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    SharedMapping& SharedMapping::operator=(SharedMapping&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            view_ = std::exchange(other.view_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            alreadyExisted_ = std::exchange(other.alreadyExisted_, false);
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    bool SharedMapping::create(const std::wstring& name, std::size_t size, bool exclusive)
+    {
+        close();
+        alreadyExisted_ = false;
+
+        const auto size64 = static_cast<std::uint64_t>(size);
+        handle_ = ::CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), name.c_str());
+        if (!handle_)
+        {
+            return false;
+        }
+
+        alreadyExisted_ = ::GetLastError() == ERROR_ALREADY_EXISTS;
+        if (alreadyExisted_ && exclusive)
+        {
+            close();
+            ::SetLastError(ERROR_ALREADY_EXISTS);
+            return false;
+        }
+
+        view_ = ::MapViewOfFile(handle_, FILE_MAP_WRITE | FILE_MAP_READ, 0, 0, size);
+        if (!view_)
+        {
+            const auto error = ::GetLastError();
+            close();
+            ::SetLastError(error);
+            return false;
+        }
+
+        size_ = size;
+        return true;
+    }
+
+    bool SharedMapping::open(const std::wstring& name, bool writable, std::size_t size)
+    {
+        close();
+        alreadyExisted_ = false;
+
+        const DWORD access = writable ? (FILE_MAP_READ | FILE_MAP_WRITE) : FILE_MAP_READ;
+        handle_ = ::OpenFileMappingW(access, FALSE, name.c_str());
+        if (!handle_)
+        {
+            return false;
+        }
+
+        view_ = ::MapViewOfFile(handle_, access, 0, 0, size);
+        if (!view_)
+        {
+            const auto error = ::GetLastError();
+            close();
+            ::SetLastError(error);
+            return false;
+        }
+
+        if (size == 0)
+        {
+            MEMORY_BASIC_INFORMATION info{};
+            size = ::VirtualQuery(view_, &info, sizeof(info)) != 0 ? info.RegionSize : 0;
+        }
+        size_ = size;
+        return true;
+    }
+
+    void SharedMapping::close()
+    {
+        if (view_)
+        {
+            ::UnmapViewOfFile(view_);
+            view_ = nullptr;
+        }
+
+        if (handle_)
+        {
+            ::CloseHandle(handle_);
+            handle_ = nullptr;
+        }
+        size_ = 0;
+    }
+
+    SharedEvent::~SharedEvent()
+    {
+        close();
+    }
+
+    bool SharedEvent::create(const std::wstring& name)
+    {
+        close();
+        handle_ = ::CreateEventW(nullptr, FALSE, FALSE, name.c_str());
+        return handle_ != nullptr;
+    }
+
+    bool SharedEvent::open(const std::wstring& name)
+    {
+        // Waiting only; the creator is the one that signals.
+        close();
+        handle_ = ::OpenEventW(SYNCHRONIZE, FALSE, name.c_str());
+        return handle_ != nullptr;
+    }
+
+    void SharedEvent::close()
+    {
+        if (handle_)
+        {
+            ::CloseHandle(handle_);
+            handle_ = nullptr;
+        }
+    }
+
+    void SharedEvent::signal()
+    {
+        if (handle_)
+        {
+            ::SetEvent(handle_);
+        }
+    }
+
+    bool SharedEvent::wait(std::chrono::milliseconds timeout)
+    {
+        return handle_ && ::WaitForSingleObject(handle_, static_cast<DWORD>(timeout.count())) == WAIT_OBJECT_0;
+    }
+
+    SharedEvent::operator bool() const
+    {
+        return handle_ != nullptr;
+    }
+
+    std::uint32_t ipc_last_error()
+    {
+        return static_cast<std::uint32_t>(::GetLastError());
+    }
+}
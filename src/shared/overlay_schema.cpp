@@ -809,4 +809,49 @@ namespace overlay
 
         return json;
     }
+
+    nlohmann::json diff_overlay_state_json(const nlohmann::json& from, const nlohmann::json& to)
+    {
+        if (!from.is_object() || !to.is_object())
+        {
+            return to;
+        }
+
+        nlohmann::json patch = nlohmann::json::object();
+        for (auto it = to.begin(); it != to.end(); ++it)
+        {
+            const auto previous = from.find(it.key());
+            if (previous == from.end())
+            {
+                if (!it->is_null())
+                {
+                    patch[it.key()] = *it;
+                }
+                continue;
+            }
+            if (*previous == *it)
+            {
+                continue;
+            }
+            if (previous->is_object() && it->is_object())
+            {
+                auto nested = diff_overlay_state_json(*previous, *it);
+                if (!nested.empty())
+                {
+                    patch[it.key()] = std::move(nested);
+                }
+                continue;
+            }
+            patch[it.key()] = *it;
+        }
+
+        for (auto it = from.begin(); it != from.end(); ++it)
+        {
+            if (!it->is_null() && !to.contains(it.key()))
+            {
+                patch[it.key()] = nullptr;
+            }
+        }
+        return patch;
+    }
 }
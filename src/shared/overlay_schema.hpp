@@ -181,4 +181,10 @@ namespace overlay
 
     [[nodiscard]] OverlayState parse_overlay_state(const nlohmann::json& json);
     [[nodiscard]] nlohmann::json serialize_overlay_state(const OverlayState& state);
+
+    // RFC 7386 merge patch turning serialized state `from` into `to`; applying it with json::merge_patch
+    // reproduces `to`. Objects are diffed recursively, arrays and scalars are replaced whole, and members
+    // that are missing or null in `to` become null (merge patch cannot tell the two apart). Empty when
+    // nothing changed.
+    [[nodiscard]] nlohmann::json diff_overlay_state_json(const nlohmann::json& from, const nlohmann::json& to);
 }
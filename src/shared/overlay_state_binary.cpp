@@ -0,0 +1,1053 @@
+#include "overlay_state_binary.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace overlay
+{
+    namespace
+    {
+        // Tags are part of the wire format: never renumber, only append.
+        enum class StateTag : std::uint16_t
+        {
+            Version = 1,
+            GeneratedAtMs = 2,
+            HeartbeatMs = 3,
+            Route = 4,
+            Notes = 5,
+            PlayerMarker = 6,
+            HighlightedSystem = 7,
+            CameraPose = 8,
+            HudHint = 9,
+            FollowModeEnabled = 10,
+            ActiveRouteNodeId = 11,
+            SourceOnline = 12,
+            Telemetry = 13,
+            VisitedSystemsTrackingEnabled = 14,
+            HasActiveSession = 15,
+            ActiveSessionId = 16,
+            Authenticated = 17,
+            TribeId = 18,
+            TribeName = 19,
+            PscanData = 20,
+            // Telemetry sections sit at the top level (Telemetry itself only marks presence) so that deltas
+            // can replace them, and individual history slices, independently.
+            TelemetryCombat = 21,
+            TelemetryMining = 22,
+            TelemetryHistory = 23,
+            TelemetryHistorySlice = 24
+        };
+
+        enum class RouteTag : std::uint16_t
+        {
+            SystemId = 1,
+            DisplayName = 2,
+            DistanceLy = 3,
+            ViaGate = 4,
+            ViaSmartGate = 5,
+            PlanetCount = 6,
+            NetworkNodes = 7,
+            RoutePosition = 8,
+            TotalRouteHops = 9
+        };
+
+        enum class MarkerTag : std::uint16_t
+        {
+            SystemId = 1,
+            DisplayName = 2,
+            IsDocked = 3
+        };
+
+        enum class HighlightTag : std::uint16_t
+        {
+            SystemId = 1,
+            DisplayName = 2,
+            Category = 3,
+            Note = 4
+        };
+
+        enum class CameraTag : std::uint16_t
+        {
+            Position = 1,
+            LookAt = 2,
+            Up = 3,
+            FovDegrees = 4
+        };
+
+        enum class HintTag : std::uint16_t
+        {
+            Id = 1,
+            Text = 2,
+            Dismissible = 3,
+            Active = 4
+        };
+
+        enum class CombatTag : std::uint16_t
+        {
+            TotalDamageDealt = 1,
+            TotalDamageTaken = 2,
+            RecentDamageDealt = 3,
+            RecentDamageTaken = 4,
+            RecentWindowSeconds = 5,
+            LastEventMs = 6,
+            SessionStartMs = 7,
+            SessionDurationSeconds = 8,
+            MissDealt = 9,
+            GlancingDealt = 10,
+            StandardDealt = 11,
+            PenetratingDealt = 12,
+            SmashingDealt = 13,
+            MissTaken = 14,
+            GlancingTaken = 15,
+            StandardTaken = 16,
+            PenetratingTaken = 17,
+            SmashingTaken = 18
+        };
+
+        enum class MiningTag : std::uint16_t
+        {
+            TotalVolumeM3 = 1,
+            RecentVolumeM3 = 2,
+            RecentWindowSeconds = 3,
+            LastEventMs = 4,
+            SessionStartMs = 5,
+            SessionDurationSeconds = 6,
+            Bucket = 7
+        };
+
+        enum class BucketTag : std::uint16_t
+        {
+            Id = 1,
+            Label = 2,
+            SessionTotal = 3,
+            RecentTotal = 4
+        };
+
+        enum class HistoryTag : std::uint16_t
+        {
+            SliceSeconds = 1,
+            Capacity = 2,
+            Saturated = 3,
+            ResetMarkerMs = 4
+        };
+
+        enum class SliceTag : std::uint16_t
+        {
+            StartMs = 1,
+            DurationSeconds = 2,
+            DamageDealt = 3,
+            DamageTaken = 4,
+            MiningVolumeM3 = 5
+        };
+
+        enum class PscanTag : std::uint16_t
+        {
+            SystemId = 1,
+            SystemName = 2,
+            ScannedAtMs = 3,
+            Node = 4
+        };
+
+        enum class PscanNodeTag : std::uint16_t
+        {
+            Id = 1,
+            Name = 2,
+            Type = 3,
+            OwnerName = 4,
+            DistanceM = 5
+        };
+
+        constexpr std::size_t field_header_size = sizeof(std::uint16_t) + sizeof(std::uint32_t);
+        constexpr std::size_t preamble_size = sizeof(std::uint32_t) + 2 * sizeof(std::uint16_t);
+        constexpr std::size_t delta_preamble_size = preamble_size + sizeof(std::uint64_t);
+        constexpr std::uint16_t replaced_tags_tag = 0;
+
+        class Encoder
+        {
+        public:
+            explicit Encoder(std::string& out)
+                : out_(out)
+            {
+            }
+
+            template <typename Tag>
+            void bytes(Tag tag, const void* data, std::size_t size)
+            {
+                header(static_cast<std::uint16_t>(tag), static_cast<std::uint32_t>(size));
+                out_.append(static_cast<const char*>(data), size);
+            }
+
+            template <typename Tag>
+            void string(Tag tag, std::string_view value)
+            {
+                bytes(tag, value.data(), value.size());
+            }
+
+            template <typename Tag, typename T>
+            void scalar(Tag tag, T value)
+            {
+                bytes(tag, &value, sizeof(value));
+            }
+
+            template <typename Tag>
+            void boolean(Tag tag, bool value)
+            {
+                scalar(tag, static_cast<std::uint8_t>(value ? 1 : 0));
+            }
+
+            template <typename Tag>
+            void vec3(Tag tag, const Vec3f& value)
+            {
+                const float packed[3] = {value.x, value.y, value.z};
+                bytes(tag, packed, sizeof(packed));
+            }
+
+            // Opens a nested field list; the length is patched in by end().
+            template <typename Tag>
+            std::size_t begin(Tag tag)
+            {
+                header(static_cast<std::uint16_t>(tag), 0);
+                return out_.size();
+            }
+
+            void end(std::size_t start)
+            {
+                const auto length = static_cast<std::uint32_t>(out_.size() - start);
+                std::memcpy(out_.data() + start - sizeof(length), &length, sizeof(length));
+            }
+
+        private:
+            void header(std::uint16_t tag, std::uint32_t length)
+            {
+                char raw[field_header_size];
+                std::memcpy(raw, &tag, sizeof(tag));
+                std::memcpy(raw + sizeof(tag), &length, sizeof(length));
+                out_.append(raw, sizeof(raw));
+            }
+
+            std::string& out_;
+        };
+
+        struct Field
+        {
+            std::uint16_t tag{0};
+            std::string_view data;
+
+            template <typename T>
+            T scalar() const
+            {
+                if (data.size() != sizeof(T))
+                {
+                    throw std::invalid_argument("Binary overlay field " + std::to_string(tag) + " has the wrong size");
+                }
+                T value;
+                std::memcpy(&value, data.data(), sizeof(T));
+                return value;
+            }
+
+            bool boolean() const { return scalar<std::uint8_t>() != 0; }
+            double f64() const { return scalar<double>(); }
+            std::uint64_t u64() const { return scalar<std::uint64_t>(); }
+            int i32() const { return scalar<std::int32_t>(); }
+            std::string string() const { return std::string(data); }
+
+            Vec3f vec3() const
+            {
+                if (data.size() != 3 * sizeof(float))
+                {
+                    throw std::invalid_argument("Binary overlay vector field has the wrong size");
+                }
+                float packed[3];
+                std::memcpy(packed, data.data(), sizeof(packed));
+                return Vec3f{packed[0], packed[1], packed[2]};
+            }
+        };
+
+        class FieldCursor
+        {
+        public:
+            explicit FieldCursor(std::string_view data)
+                : data_(data)
+            {
+            }
+
+            bool next(Field& field)
+            {
+                if (offset_ == data_.size())
+                {
+                    return false;
+                }
+                if (data_.size() - offset_ < field_header_size)
+                {
+                    throw std::invalid_argument("Binary overlay payload truncated in field header");
+                }
+
+                std::uint32_t length = 0;
+                std::memcpy(&field.tag, data_.data() + offset_, sizeof(field.tag));
+                std::memcpy(&length, data_.data() + offset_ + sizeof(field.tag), sizeof(length));
+                offset_ += field_header_size;
+                if (length > data_.size() - offset_)
+                {
+                    throw std::invalid_argument("Binary overlay field exceeds payload");
+                }
+
+                field.data = data_.substr(offset_, length);
+                offset_ += length;
+                return true;
+            }
+
+        private:
+            std::string_view data_;
+            std::size_t offset_{0};
+        };
+
+        template <typename Tag>
+        bool is(const Field& field, Tag tag)
+        {
+            return field.tag == static_cast<std::uint16_t>(tag);
+        }
+
+        void encode_route_node(Encoder& out, const RouteNode& node)
+        {
+            const auto mark = out.begin(StateTag::Route);
+            out.string(RouteTag::SystemId, node.system_id);
+            out.string(RouteTag::DisplayName, node.display_name);
+            out.scalar(RouteTag::DistanceLy, node.distance_ly);
+            out.boolean(RouteTag::ViaGate, node.via_gate);
+            out.boolean(RouteTag::ViaSmartGate, node.via_smart_gate);
+            out.scalar(RouteTag::PlanetCount, static_cast<std::int32_t>(node.planet_count));
+            out.scalar(RouteTag::NetworkNodes, static_cast<std::int32_t>(node.network_nodes));
+            out.scalar(RouteTag::RoutePosition, static_cast<std::int32_t>(node.route_position));
+            out.scalar(RouteTag::TotalRouteHops, static_cast<std::int32_t>(node.total_route_hops));
+            out.end(mark);
+        }
+
+        RouteNode decode_route_node(std::string_view data)
+        {
+            RouteNode node;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<RouteTag>(field.tag))
+                {
+                case RouteTag::SystemId: node.system_id = field.string(); break;
+                case RouteTag::DisplayName: node.display_name = field.string(); break;
+                case RouteTag::DistanceLy: node.distance_ly = field.f64(); break;
+                case RouteTag::ViaGate: node.via_gate = field.boolean(); break;
+                case RouteTag::ViaSmartGate: node.via_smart_gate = field.boolean(); break;
+                case RouteTag::PlanetCount: node.planet_count = field.i32(); break;
+                case RouteTag::NetworkNodes: node.network_nodes = field.i32(); break;
+                case RouteTag::RoutePosition: node.route_position = field.i32(); break;
+                case RouteTag::TotalRouteHops: node.total_route_hops = field.i32(); break;
+                default: break;
+                }
+            }
+            return node;
+        }
+
+        void encode_combat(Encoder& out, const CombatTelemetry& combat)
+        {
+            const auto mark = out.begin(StateTag::TelemetryCombat);
+            out.scalar(CombatTag::TotalDamageDealt, combat.total_damage_dealt);
+            out.scalar(CombatTag::TotalDamageTaken, combat.total_damage_taken);
+            out.scalar(CombatTag::RecentDamageDealt, combat.recent_damage_dealt);
+            out.scalar(CombatTag::RecentDamageTaken, combat.recent_damage_taken);
+            out.scalar(CombatTag::RecentWindowSeconds, combat.recent_window_seconds);
+            out.scalar(CombatTag::LastEventMs, combat.last_event_ms);
+            out.scalar(CombatTag::SessionStartMs, combat.session_start_ms);
+            out.scalar(CombatTag::SessionDurationSeconds, combat.session_duration_seconds);
+            out.scalar(CombatTag::MissDealt, combat.miss_dealt);
+            out.scalar(CombatTag::GlancingDealt, combat.glancing_dealt);
+            out.scalar(CombatTag::StandardDealt, combat.standard_dealt);
+            out.scalar(CombatTag::PenetratingDealt, combat.penetrating_dealt);
+            out.scalar(CombatTag::SmashingDealt, combat.smashing_dealt);
+            out.scalar(CombatTag::MissTaken, combat.miss_taken);
+            out.scalar(CombatTag::GlancingTaken, combat.glancing_taken);
+            out.scalar(CombatTag::StandardTaken, combat.standard_taken);
+            out.scalar(CombatTag::PenetratingTaken, combat.penetrating_taken);
+            out.scalar(CombatTag::SmashingTaken, combat.smashing_taken);
+            out.end(mark);
+        }
+
+        CombatTelemetry decode_combat(std::string_view data)
+        {
+            CombatTelemetry combat;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<CombatTag>(field.tag))
+                {
+                case CombatTag::TotalDamageDealt: combat.total_damage_dealt = field.f64(); break;
+                case CombatTag::TotalDamageTaken: combat.total_damage_taken = field.f64(); break;
+                case CombatTag::RecentDamageDealt: combat.recent_damage_dealt = field.f64(); break;
+                case CombatTag::RecentDamageTaken: combat.recent_damage_taken = field.f64(); break;
+                case CombatTag::RecentWindowSeconds: combat.recent_window_seconds = field.f64(); break;
+                case CombatTag::LastEventMs: combat.last_event_ms = field.u64(); break;
+                case CombatTag::SessionStartMs: combat.session_start_ms = field.u64(); break;
+                case CombatTag::SessionDurationSeconds: combat.session_duration_seconds = field.f64(); break;
+                case CombatTag::MissDealt: combat.miss_dealt = field.u64(); break;
+                case CombatTag::GlancingDealt: combat.glancing_dealt = field.u64(); break;
+                case CombatTag::StandardDealt: combat.standard_dealt = field.u64(); break;
+                case CombatTag::PenetratingDealt: combat.penetrating_dealt = field.u64(); break;
+                case CombatTag::SmashingDealt: combat.smashing_dealt = field.u64(); break;
+                case CombatTag::MissTaken: combat.miss_taken = field.u64(); break;
+                case CombatTag::GlancingTaken: combat.glancing_taken = field.u64(); break;
+                case CombatTag::StandardTaken: combat.standard_taken = field.u64(); break;
+                case CombatTag::PenetratingTaken: combat.penetrating_taken = field.u64(); break;
+                case CombatTag::SmashingTaken: combat.smashing_taken = field.u64(); break;
+                default: break;
+                }
+            }
+            return combat;
+        }
+
+        void encode_mining(Encoder& out, const MiningTelemetry& mining)
+        {
+            const auto mark = out.begin(StateTag::TelemetryMining);
+            out.scalar(MiningTag::TotalVolumeM3, mining.total_volume_m3);
+            out.scalar(MiningTag::RecentVolumeM3, mining.recent_volume_m3);
+            out.scalar(MiningTag::RecentWindowSeconds, mining.recent_window_seconds);
+            out.scalar(MiningTag::LastEventMs, mining.last_event_ms);
+            out.scalar(MiningTag::SessionStartMs, mining.session_start_ms);
+            out.scalar(MiningTag::SessionDurationSeconds, mining.session_duration_seconds);
+            for (const auto& bucket : mining.buckets)
+            {
+                const auto bucketMark = out.begin(MiningTag::Bucket);
+                out.string(BucketTag::Id, bucket.id);
+                out.string(BucketTag::Label, bucket.label);
+                out.scalar(BucketTag::SessionTotal, bucket.session_total);
+                out.scalar(BucketTag::RecentTotal, bucket.recent_total);
+                out.end(bucketMark);
+            }
+            out.end(mark);
+        }
+
+        TelemetryBucket decode_bucket(std::string_view data)
+        {
+            TelemetryBucket bucket;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<BucketTag>(field.tag))
+                {
+                case BucketTag::Id: bucket.id = field.string(); break;
+                case BucketTag::Label: bucket.label = field.string(); break;
+                case BucketTag::SessionTotal: bucket.session_total = field.f64(); break;
+                case BucketTag::RecentTotal: bucket.recent_total = field.f64(); break;
+                default: break;
+                }
+            }
+            return bucket;
+        }
+
+        MiningTelemetry decode_mining(std::string_view data)
+        {
+            MiningTelemetry mining;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<MiningTag>(field.tag))
+                {
+                case MiningTag::TotalVolumeM3: mining.total_volume_m3 = field.f64(); break;
+                case MiningTag::RecentVolumeM3: mining.recent_volume_m3 = field.f64(); break;
+                case MiningTag::RecentWindowSeconds: mining.recent_window_seconds = field.f64(); break;
+                case MiningTag::LastEventMs: mining.last_event_ms = field.u64(); break;
+                case MiningTag::SessionStartMs: mining.session_start_ms = field.u64(); break;
+                case MiningTag::SessionDurationSeconds: mining.session_duration_seconds = field.f64(); break;
+                case MiningTag::Bucket: mining.buckets.push_back(decode_bucket(field.data)); break;
+                default: break;
+                }
+            }
+            return mining;
+        }
+
+        void encode_history(Encoder& out, const TelemetryHistory& history)
+        {
+            const auto mark = out.begin(StateTag::TelemetryHistory);
+            out.scalar(HistoryTag::SliceSeconds, history.slice_seconds);
+            out.scalar(HistoryTag::Capacity, history.capacity);
+            out.boolean(HistoryTag::Saturated, history.saturated);
+            for (const auto marker : history.reset_markers_ms)
+            {
+                out.scalar(HistoryTag::ResetMarkerMs, marker);
+            }
+            out.end(mark);
+
+            for (const auto& slice : history.slices)
+            {
+                const auto sliceMark = out.begin(StateTag::TelemetryHistorySlice);
+                out.scalar(SliceTag::StartMs, slice.start_ms);
+                out.scalar(SliceTag::DurationSeconds, slice.duration_seconds);
+                out.scalar(SliceTag::DamageDealt, slice.damage_dealt);
+                out.scalar(SliceTag::DamageTaken, slice.damage_taken);
+                out.scalar(SliceTag::MiningVolumeM3, slice.mining_volume_m3);
+                out.end(sliceMark);
+            }
+        }
+
+        TelemetryHistorySlice decode_slice(std::string_view data)
+        {
+            TelemetryHistorySlice slice;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<SliceTag>(field.tag))
+                {
+                case SliceTag::StartMs: slice.start_ms = field.u64(); break;
+                case SliceTag::DurationSeconds: slice.duration_seconds = field.f64(); break;
+                case SliceTag::DamageDealt: slice.damage_dealt = field.f64(); break;
+                case SliceTag::DamageTaken: slice.damage_taken = field.f64(); break;
+                case SliceTag::MiningVolumeM3: slice.mining_volume_m3 = field.f64(); break;
+                default: break;
+                }
+            }
+            return slice;
+        }
+
+        // Slices arrive as separate top-level fields, possibly before this one, so only the scalars are set here.
+        void decode_history(TelemetryHistory& history, std::string_view data)
+        {
+            history.reset_markers_ms.clear();
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<HistoryTag>(field.tag))
+                {
+                case HistoryTag::SliceSeconds: history.slice_seconds = field.f64(); break;
+                case HistoryTag::Capacity: history.capacity = field.scalar<std::uint32_t>(); break;
+                case HistoryTag::Saturated: history.saturated = field.boolean(); break;
+                case HistoryTag::ResetMarkerMs: history.reset_markers_ms.push_back(field.u64()); break;
+                default: break;
+                }
+            }
+        }
+
+        void encode_telemetry(Encoder& out, const TelemetryMetrics& telemetry)
+        {
+            const auto mark = out.begin(StateTag::Telemetry);
+            out.end(mark);
+            if (telemetry.combat)
+            {
+                encode_combat(out, *telemetry.combat);
+            }
+            if (telemetry.mining)
+            {
+                encode_mining(out, *telemetry.mining);
+            }
+            if (telemetry.history)
+            {
+                encode_history(out, *telemetry.history);
+            }
+        }
+
+        TelemetryMetrics& ensure_telemetry(OverlayState& state)
+        {
+            if (!state.telemetry)
+            {
+                state.telemetry.emplace();
+            }
+            return *state.telemetry;
+        }
+
+        TelemetryHistory& ensure_history(OverlayState& state)
+        {
+            auto& telemetry = ensure_telemetry(state);
+            if (!telemetry.history)
+            {
+                telemetry.history.emplace();
+            }
+            return *telemetry.history;
+        }
+
+        void encode_pscan(Encoder& out, const PscanData& pscan)
+        {
+            const auto mark = out.begin(StateTag::PscanData);
+            out.string(PscanTag::SystemId, pscan.system_id);
+            out.string(PscanTag::SystemName, pscan.system_name);
+            out.scalar(PscanTag::ScannedAtMs, pscan.scanned_at_ms);
+            for (const auto& node : pscan.nodes)
+            {
+                const auto nodeMark = out.begin(PscanTag::Node);
+                out.string(PscanNodeTag::Id, node.id);
+                out.string(PscanNodeTag::Name, node.name);
+                out.string(PscanNodeTag::Type, node.type);
+                out.string(PscanNodeTag::OwnerName, node.owner_name);
+                out.scalar(PscanNodeTag::DistanceM, node.distance_m);
+                out.end(nodeMark);
+            }
+            out.end(mark);
+        }
+
+        PscanNode decode_pscan_node(std::string_view data)
+        {
+            PscanNode node;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<PscanNodeTag>(field.tag))
+                {
+                case PscanNodeTag::Id: node.id = field.string(); break;
+                case PscanNodeTag::Name: node.name = field.string(); break;
+                case PscanNodeTag::Type: node.type = field.string(); break;
+                case PscanNodeTag::OwnerName: node.owner_name = field.string(); break;
+                case PscanNodeTag::DistanceM: node.distance_m = field.f64(); break;
+                default: break;
+                }
+            }
+            return node;
+        }
+
+        PscanData decode_pscan(std::string_view data)
+        {
+            PscanData pscan;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<PscanTag>(field.tag))
+                {
+                case PscanTag::SystemId: pscan.system_id = field.string(); break;
+                case PscanTag::SystemName: pscan.system_name = field.string(); break;
+                case PscanTag::ScannedAtMs: pscan.scanned_at_ms = field.u64(); break;
+                case PscanTag::Node: pscan.nodes.push_back(decode_pscan_node(field.data)); break;
+                default: break;
+                }
+            }
+            return pscan;
+        }
+
+        PlayerMarker decode_marker(std::string_view data)
+        {
+            PlayerMarker marker;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<MarkerTag>(field.tag))
+                {
+                case MarkerTag::SystemId: marker.system_id = field.string(); break;
+                case MarkerTag::DisplayName: marker.display_name = field.string(); break;
+                case MarkerTag::IsDocked: marker.is_docked = field.boolean(); break;
+                default: break;
+                }
+            }
+            return marker;
+        }
+
+        HighlightedSystem decode_highlight(std::string_view data)
+        {
+            HighlightedSystem highlight;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<HighlightTag>(field.tag))
+                {
+                case HighlightTag::SystemId: highlight.system_id = field.string(); break;
+                case HighlightTag::DisplayName: highlight.display_name = field.string(); break;
+                case HighlightTag::Category: highlight.category = field.string(); break;
+                case HighlightTag::Note: highlight.note = field.string(); break;
+                default: break;
+                }
+            }
+            return highlight;
+        }
+
+        CameraPose decode_camera(std::string_view data)
+        {
+            CameraPose pose;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<CameraTag>(field.tag))
+                {
+                case CameraTag::Position: pose.position = field.vec3(); break;
+                case CameraTag::LookAt: pose.look_at = field.vec3(); break;
+                case CameraTag::Up: pose.up = field.vec3(); break;
+                case CameraTag::FovDegrees: pose.fov_degrees = field.scalar<float>(); break;
+                default: break;
+                }
+            }
+            return pose;
+        }
+
+        HudHint decode_hint(std::string_view data)
+        {
+            HudHint hint;
+            FieldCursor cursor(data);
+            Field field;
+            while (cursor.next(field))
+            {
+                switch (static_cast<HintTag>(field.tag))
+                {
+                case HintTag::Id: hint.id = field.string(); break;
+                case HintTag::Text: hint.text = field.string(); break;
+                case HintTag::Dismissible: hint.dismissible = field.boolean(); break;
+                case HintTag::Active: hint.active = field.boolean(); break;
+                default: break;
+                }
+            }
+            return hint;
+        }
+
+        void append_preamble(std::string& out, std::uint32_t magic)
+        {
+            char preamble[preamble_size] = {};
+            const std::uint16_t formatVersion = binary_state_format_version;
+            std::memcpy(preamble, &magic, sizeof(magic));
+            std::memcpy(preamble + sizeof(magic), &formatVersion, sizeof(formatVersion));
+            out.append(preamble, sizeof(preamble));
+        }
+
+        // Validates the preamble and returns the field list that follows it.
+        std::string_view field_list(std::string_view payload, std::uint32_t expectedMagic, std::size_t headerSize)
+        {
+            if (payload.size() < headerSize)
+            {
+                throw std::invalid_argument("Binary overlay payload too small");
+            }
+
+            std::uint32_t magic = 0;
+            std::uint16_t formatVersion = 0;
+            std::memcpy(&magic, payload.data(), sizeof(magic));
+            std::memcpy(&formatVersion, payload.data() + sizeof(magic), sizeof(formatVersion));
+            if (magic != expectedMagic)
+            {
+                throw std::invalid_argument("Binary overlay payload has an invalid magic");
+            }
+            if (formatVersion != binary_state_format_version)
+            {
+                throw std::invalid_argument("Unsupported binary overlay format version " + std::to_string(formatVersion));
+            }
+            return payload.substr(headerSize);
+        }
+
+        // Top-level fields grouped by tag, in encoding order within each tag.
+        using FieldGroups = std::vector<std::pair<std::uint16_t, std::vector<std::string_view>>>;
+
+        FieldGroups group_fields(std::string_view fields)
+        {
+            FieldGroups groups;
+            FieldCursor cursor(fields);
+            Field field;
+            const char* start = fields.data();
+            while (true)
+            {
+                const char* fieldStart = start;
+                if (!cursor.next(field))
+                {
+                    break;
+                }
+                // Keep the header with the bytes so groups can be copied verbatim.
+                const auto raw = std::string_view(fieldStart, static_cast<std::size_t>(field.data.data() + field.data.size() - fieldStart));
+                start = raw.data() + raw.size();
+
+                auto it = std::find_if(groups.begin(), groups.end(), [&](const auto& group) { return group.first == field.tag; });
+                if (it == groups.end())
+                {
+                    groups.emplace_back(field.tag, std::vector<std::string_view>{});
+                    it = std::prev(groups.end());
+                }
+                it->second.push_back(raw);
+            }
+            return groups;
+        }
+
+        const std::vector<std::string_view>* find_group(const FieldGroups& groups, std::uint16_t tag)
+        {
+            const auto it = std::find_if(groups.begin(), groups.end(), [&](const auto& group) { return group.first == tag; });
+            return it == groups.end() ? nullptr : &it->second;
+        }
+    }
+
+    std::string encode_overlay_state_binary(const OverlayState& state)
+    {
+        std::string out;
+        out.reserve(512 + state.route.size() * 96);
+
+        append_preamble(out, binary_state_magic);
+
+        Encoder encoder(out);
+        encoder.scalar(StateTag::Version, static_cast<std::int32_t>(state.version));
+        encoder.scalar(StateTag::GeneratedAtMs, state.generated_at_ms);
+        encoder.scalar(StateTag::HeartbeatMs, state.heartbeat_ms == 0 ? state.generated_at_ms : state.heartbeat_ms);
+
+        for (const auto& node : state.route)
+        {
+            encode_route_node(encoder, node);
+        }
+
+        if (state.notes)
+        {
+            encoder.string(StateTag::Notes, *state.notes);
+        }
+
+        if (state.player_marker)
+        {
+            const auto mark = encoder.begin(StateTag::PlayerMarker);
+            encoder.string(MarkerTag::SystemId, state.player_marker->system_id);
+            encoder.string(MarkerTag::DisplayName, state.player_marker->display_name);
+            encoder.boolean(MarkerTag::IsDocked, state.player_marker->is_docked);
+            encoder.end(mark);
+        }
+
+        for (const auto& highlight : state.highlighted_systems)
+        {
+            const auto mark = encoder.begin(StateTag::HighlightedSystem);
+            encoder.string(HighlightTag::SystemId, highlight.system_id);
+            encoder.string(HighlightTag::DisplayName, highlight.display_name);
+            encoder.string(HighlightTag::Category, highlight.category);
+            if (highlight.note)
+            {
+                encoder.string(HighlightTag::Note, *highlight.note);
+            }
+            encoder.end(mark);
+        }
+
+        if (state.camera_pose)
+        {
+            const auto mark = encoder.begin(StateTag::CameraPose);
+            encoder.vec3(CameraTag::Position, state.camera_pose->position);
+            encoder.vec3(CameraTag::LookAt, state.camera_pose->look_at);
+            encoder.vec3(CameraTag::Up, state.camera_pose->up);
+            encoder.scalar(CameraTag::FovDegrees, state.camera_pose->fov_degrees);
+            encoder.end(mark);
+        }
+
+        for (const auto& hint : state.hud_hints)
+        {
+            const auto mark = encoder.begin(StateTag::HudHint);
+            encoder.string(HintTag::Id, hint.id);
+            encoder.string(HintTag::Text, hint.text);
+            encoder.boolean(HintTag::Dismissible, hint.dismissible);
+            encoder.boolean(HintTag::Active, hint.active);
+            encoder.end(mark);
+        }
+
+        encoder.boolean(StateTag::FollowModeEnabled, state.follow_mode_enabled);
+        if (state.active_route_node_id)
+        {
+            encoder.string(StateTag::ActiveRouteNodeId, *state.active_route_node_id);
+        }
+        encoder.boolean(StateTag::SourceOnline, state.source_online);
+
+        if (state.telemetry)
+        {
+            encode_telemetry(encoder, *state.telemetry);
+        }
+
+        encoder.boolean(StateTag::VisitedSystemsTrackingEnabled, state.visited_systems_tracking_enabled);
+        encoder.boolean(StateTag::HasActiveSession, state.has_active_session);
+        if (state.active_session_id)
+        {
+            encoder.string(StateTag::ActiveSessionId, *state.active_session_id);
+        }
+
+        encoder.boolean(StateTag::Authenticated, state.authenticated);
+        if (state.tribe_id)
+        {
+            encoder.string(StateTag::TribeId, *state.tribe_id);
+        }
+        if (state.tribe_name)
+        {
+            encoder.string(StateTag::TribeName, *state.tribe_name);
+        }
+
+        if (state.pscan_data)
+        {
+            encode_pscan(encoder, *state.pscan_data);
+        }
+
+        return out;
+    }
+
+    OverlayState decode_overlay_state_binary(std::string_view payload)
+    {
+        OverlayState state;
+        bool sawHeartbeat = false;
+        FieldCursor cursor(field_list(payload, binary_state_magic, preamble_size));
+        Field field;
+        while (cursor.next(field))
+        {
+            switch (static_cast<StateTag>(field.tag))
+            {
+            case StateTag::Version: state.version = field.i32(); break;
+            case StateTag::GeneratedAtMs: state.generated_at_ms = field.u64(); break;
+            case StateTag::HeartbeatMs:
+                state.heartbeat_ms = field.u64();
+                sawHeartbeat = true;
+                break;
+            case StateTag::Route: state.route.push_back(decode_route_node(field.data)); break;
+            case StateTag::Notes: state.notes = field.string(); break;
+            case StateTag::PlayerMarker: state.player_marker = decode_marker(field.data); break;
+            case StateTag::HighlightedSystem: state.highlighted_systems.push_back(decode_highlight(field.data)); break;
+            case StateTag::CameraPose: state.camera_pose = decode_camera(field.data); break;
+            case StateTag::HudHint: state.hud_hints.push_back(decode_hint(field.data)); break;
+            case StateTag::FollowModeEnabled: state.follow_mode_enabled = field.boolean(); break;
+            case StateTag::ActiveRouteNodeId: state.active_route_node_id = field.string(); break;
+            case StateTag::SourceOnline: state.source_online = field.boolean(); break;
+            case StateTag::Telemetry: ensure_telemetry(state); break;
+            case StateTag::TelemetryCombat: ensure_telemetry(state).combat = decode_combat(field.data); break;
+            case StateTag::TelemetryMining: ensure_telemetry(state).mining = decode_mining(field.data); break;
+            case StateTag::TelemetryHistory: decode_history(ensure_history(state), field.data); break;
+            case StateTag::TelemetryHistorySlice: ensure_history(state).slices.push_back(decode_slice(field.data)); break;
+            case StateTag::VisitedSystemsTrackingEnabled: state.visited_systems_tracking_enabled = field.boolean(); break;
+            case StateTag::HasActiveSession: state.has_active_session = field.boolean(); break;
+            case StateTag::ActiveSessionId: state.active_session_id = field.string(); break;
+            case StateTag::Authenticated: state.authenticated = field.boolean(); break;
+            case StateTag::TribeId: state.tribe_id = field.string(); break;
+            case StateTag::TribeName: state.tribe_name = field.string(); break;
+            case StateTag::PscanData: state.pscan_data = decode_pscan(field.data); break;
+            default: break;
+            }
+        }
+
+        if (!sawHeartbeat)
+        {
+            state.heartbeat_ms = state.generated_at_ms;
+        }
+        return state;
+    }
+
+    std::optional<std::string> make_overlay_state_delta(std::string_view keyframe, std::string_view current, std::uint64_t baseSequence)
+    {
+        const auto before = group_fields(field_list(keyframe, binary_state_magic, preamble_size));
+        const auto after = group_fields(field_list(current, binary_state_magic, preamble_size));
+
+        // (tag, occurrences kept from the keyframe) for every group that differs.
+        std::vector<std::uint16_t> replaced;
+        std::vector<std::string_view> fields;
+        for (const auto& [tag, occurrences] : after)
+        {
+            const auto* previous = find_group(before, tag);
+            if (previous && *previous == occurrences)
+            {
+                continue;
+            }
+
+            std::size_t keep = 0;
+            if (previous)
+            {
+                const auto limit = std::min({previous->size(), occurrences.size(), std::size_t{0xFFFF}});
+                while (keep < limit && (*previous)[keep] == occurrences[keep])
+                {
+                    ++keep;
+                }
+            }
+            replaced.push_back(tag);
+            replaced.push_back(static_cast<std::uint16_t>(keep));
+            fields.insert(fields.end(), occurrences.begin() + static_cast<std::ptrdiff_t>(keep), occurrences.end());
+        }
+        for (const auto& [tag, occurrences] : before)
+        {
+            if (!find_group(after, tag))
+            {
+                replaced.push_back(tag);
+                replaced.push_back(0);
+            }
+        }
+        if (replaced.empty())
+        {
+            return std::nullopt;
+        }
+
+        std::string out;
+        append_preamble(out, binary_state_delta_magic);
+        out.append(reinterpret_cast<const char*>(&baseSequence), sizeof(baseSequence));
+
+        Encoder encoder(out);
+        encoder.bytes(replaced_tags_tag, replaced.data(), replaced.size() * sizeof(std::uint16_t));
+        for (const auto raw : fields)
+        {
+            out.append(raw);
+        }
+        return out;
+    }
+
+    bool is_overlay_state_delta(std::string_view payload) noexcept
+    {
+        std::uint32_t magic = 0;
+        if (payload.size() < delta_preamble_size)
+        {
+            return false;
+        }
+        std::memcpy(&magic, payload.data(), sizeof(magic));
+        return magic == binary_state_delta_magic;
+    }
+
+    std::uint64_t overlay_state_delta_base(std::string_view payload) noexcept
+    {
+        if (!is_overlay_state_delta(payload))
+        {
+            return 0;
+        }
+        std::uint64_t base = 0;
+        std::memcpy(&base, payload.data() + preamble_size, sizeof(base));
+        return base;
+    }
+
+    std::string apply_overlay_state_delta(std::string_view keyframe, std::string_view delta)
+    {
+        const auto keyframeFields = field_list(keyframe, binary_state_magic, preamble_size);
+        FieldCursor cursor(field_list(delta, binary_state_delta_magic, delta_preamble_size));
+
+        Field replacedField;
+        constexpr std::size_t entrySize = 2 * sizeof(std::uint16_t);
+        if (!cursor.next(replacedField) || replacedField.tag != replaced_tags_tag || replacedField.data.size() % entrySize != 0)
+        {
+            throw std::invalid_argument("Binary overlay delta is missing its replaced tag list");
+        }
+
+        // Per replaced tag: how many keyframe occurrences survive, counted down as they are copied.
+        std::vector<std::pair<std::uint16_t, std::uint16_t>> keep(replacedField.data.size() / entrySize);
+        for (std::size_t i = 0; i < keep.size(); ++i)
+        {
+            std::memcpy(&keep[i].first, replacedField.data.data() + i * entrySize, sizeof(std::uint16_t));
+            std::memcpy(&keep[i].second, replacedField.data.data() + i * entrySize + sizeof(std::uint16_t), sizeof(std::uint16_t));
+        }
+
+        std::string out;
+        out.reserve(keyframe.size() + delta.size());
+        append_preamble(out, binary_state_magic);
+
+        FieldCursor keyframeCursor(keyframeFields);
+        Field field;
+        const char* start = keyframeFields.data();
+        while (true)
+        {
+            const char* fieldStart = start;
+            if (!keyframeCursor.next(field))
+            {
+                break;
+            }
+            start = field.data.data() + field.data.size();
+
+            const auto entry = std::find_if(keep.begin(), keep.end(), [&](const auto& candidate) { return candidate.first == field.tag; });
+            if (entry == keep.end())
+            {
+                out.append(fieldStart, start);
+            }
+            else if (entry->second > 0)
+            {
+                --entry->second;
+                out.append(fieldStart, start);
+            }
+        }
+
+        // Everything after the tag list is already in field form. Occurrences of one tag stay in order because
+        // the kept prefix precedes the replacement tail.
+        const auto fieldsStart = replacedField.data.data() + replacedField.data.size();
+        out.append(fieldsStart, delta.data() + delta.size());
+        return out;
+    }
+}
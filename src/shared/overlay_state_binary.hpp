@@ -0,0 +1,59 @@
+#pragma once
+
+#include "overlay_schema.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace overlay
+{
+    // Compact binary encoding of OverlayState for the shared memory channel, replacing the JSON DOM round trip
+    // inside the game process. Layout (little-endian):
+    //
+    //   u32 magic 'EFSB' | u16 format version | u16 reserved | field*
+    //   field = u16 tag | u32 length | length bytes
+    //
+    // Each struct is a list of tagged fields; nested structs are fields whose bytes are another field list and
+    // repeated members repeat their tag. Scalars are fixed width, strings are raw UTF-8. Optional members are
+    // present only when set. Unknown tags are skipped, so fields can be added without a format bump.
+    constexpr std::uint32_t binary_state_magic = 0x42534645; // 'EFSB'
+    constexpr std::uint16_t binary_state_format_version = 1;
+
+    // OR-ed into the shared memory header's schema_version when the payload is binary rather than JSON.
+    constexpr std::uint32_t binary_state_encoding_flag = 0x80000000u;
+
+    [[nodiscard]] constexpr bool is_binary_state_encoding(std::uint32_t schemaVersion) noexcept
+    {
+        return (schemaVersion & binary_state_encoding_flag) != 0;
+    }
+
+    [[nodiscard]] std::string encode_overlay_state_binary(const OverlayState& state);
+
+    // Decodes straight from `payload` (e.g. a mapped shared memory slot); only the OverlayState's own strings
+    // are allocated. Throws std::invalid_argument on malformed input, and never reads outside `payload`.
+    [[nodiscard]] OverlayState decode_overlay_state_binary(std::string_view payload);
+
+    // Deltas carry only the top-level fields that differ from a keyframe (a full encoding published earlier):
+    //
+    //   u32 magic 'EFSD' | u16 format version | u16 reserved | u64 base sequence | replaced tags | field*
+    //
+    // `replaced tags` is a field with tag 0 holding (u16 tag, u16 kept) pairs: for each top-level tag that
+    // changed or was cleared, the first `kept` keyframe occurrences survive and the delta supplies the rest.
+    // A route that gained a hop or a history whose last slice grew therefore costs one field, not all of them.
+    // Deltas are cumulative, so a reader needs only the keyframe and the newest delta.
+    constexpr std::uint32_t binary_state_delta_magic = 0x44534645; // 'EFSD'
+
+    // Returns nullopt when `current` matches `keyframe` field for field. Both must be full encodings.
+    [[nodiscard]] std::optional<std::string> make_overlay_state_delta(std::string_view keyframe, std::string_view current, std::uint64_t baseSequence);
+
+    [[nodiscard]] bool is_overlay_state_delta(std::string_view payload) noexcept;
+
+    // Publish sequence of the keyframe a delta applies to; 0 if `payload` is not a delta.
+    [[nodiscard]] std::uint64_t overlay_state_delta_base(std::string_view payload) noexcept;
+
+    // Rebuilds the full encoding from a keyframe and a delta against it. Throws std::invalid_argument on
+    // malformed input.
+    [[nodiscard]] std::string apply_overlay_state_delta(std::string_view keyframe, std::string_view delta);
+}
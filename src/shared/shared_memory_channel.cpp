@@ -1,151 +1,290 @@
 #include "shared_memory_channel.hpp"
+#include "overlay_state_binary.hpp"
+#include "shared_memory_protocol.hpp"
 
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-
-#include <windows.h>
-
+#include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
 #include <array>
 #include <cstddef>
 #include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 
 namespace overlay
 {
+    static_assert(shared_state_slot_capacity_for(shared_memory_max_slot_capacity) == shared_memory_max_slot_capacity, "Maximum slot capacity must be reachable by doubling");
+
     namespace
     {
-        constexpr std::uint32_t header_magic = 0x45464F53; // 'EFOS'
-        struct SharedHeader
+        constexpr int max_region_name_attempts = 16;
+
+        std::wstring region_name(const std::wstring& mappingName, std::uint64_t generation)
+        {
+            return mappingName + L"." + std::to_wstring(generation);
+        }
+    }
+
+    SharedMemoryWriter::SharedMemoryWriter()
+        : SharedMemoryWriter(shared_memory_name, shared_memory_event_name)
+    {
+    }
+
+    SharedMemoryWriter::SharedMemoryWriter(std::wstring mappingName, std::wstring eventName)
+        : mappingName_(std::move(mappingName))
+        , eventName_(std::move(eventName))
+    {
+    }
+
+    SharedMemoryWriter::~SharedMemoryWriter() = default;
+
+    bool SharedMemoryWriter::ensure()
+    {
+        if (region_)
+        {
+            return true;
+        }
+
+        if (!control_ && !control_.create(mappingName_, sizeof(SharedStateControl)))
+        {
+            spdlog::error("Failed to create shared memory mapping (error {})", ipc_last_error());
+            return false;
+        }
+
+        // A restarted helper always starts a fresh generation; overlays still on the old one follow it.
+        auto generation = shared_state_generation(control_.data(), control_.size()) + 1;
+        if (!create_region(generation, shared_memory_initial_slot_capacity, region_))
         {
-            std::uint32_t magic;
-            std::uint32_t schema_version;
-            std::uint32_t payload_size;
-            std::uint32_t reserved;
-            std::uint64_t updated_at_ms;
-        };
+            return false;
+        }
 
-        bool validate_header(const SharedHeader& header)
+        slotCapacity_ = shared_memory_initial_slot_capacity;
+        generation_ = generation;
+        keyframe_.clear();
+        keyframeSequence_ = 0;
+        initialize_shared_state(region_.data(), slotCapacity_, generation_);
+        publish_shared_state_generation(control_.data(), generation_, region_.size());
+
+        // Readers block on this instead of polling; publishing still works without it.
+        if (!updateEvent_ && !updateEvent_.create(eventName_))
         {
-            return header.magic == header_magic && header.payload_size <= shared_memory_capacity - sizeof(SharedHeader);
+            spdlog::warn("Failed to create shared memory update event (error {})", ipc_last_error());
         }
+        return true;
+    }
 
-        void close_mapping(void*& mappingHandle, void*& view)
+    bool SharedMemoryWriter::create_region(std::uint64_t& generation, std::size_t slotCapacity, SharedMapping& region)
+    {
+        const auto size = shared_state_region_size(slotCapacity);
+        for (int attempt = 0; attempt < max_region_name_attempts; ++attempt, ++generation)
         {
-            if (view)
+            if (region.create(region_name(mappingName_, generation), size, true))
             {
-                ::UnmapViewOfFile(view);
-                view = nullptr;
+                return true;
             }
 
-            if (mappingHandle)
+            if (!region.already_existed())
             {
-                ::CloseHandle(mappingHandle);
-                mappingHandle = nullptr;
+                spdlog::error("Failed to create shared memory region {} (error {})", generation, ipc_last_error());
+                return false;
             }
+            // Left behind by a previous helper and still held open by a reader; its size is not ours.
         }
-    }
-
-    SharedMemoryWriter::SharedMemoryWriter() = default;
 
-    SharedMemoryWriter::~SharedMemoryWriter()
-    {
-        close_mapping(mappingHandle_, view_);
+        spdlog::error("Failed to create shared memory region: generations {} and below are all taken", generation);
+        return false;
     }
 
-    bool SharedMemoryWriter::ensure()
+    bool SharedMemoryWriter::reserve(std::size_t payloadSize)
     {
-        if (view_)
+        if (payloadSize <= slotCapacity_)
         {
             return true;
         }
 
-        mappingHandle_ = ::CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(shared_memory_capacity), shared_memory_name);
-        if (!mappingHandle_)
+        const auto slotCapacity = shared_state_slot_capacity_for(payloadSize);
+        if (slotCapacity == 0)
         {
-            spdlog::error("Failed to create shared memory mapping (error {})", ::GetLastError());
+            spdlog::warn("Shared payload too large ({} bytes > limit {})", payloadSize, shared_memory_max_slot_capacity);
             return false;
         }
 
-        view_ = ::MapViewOfFile(mappingHandle_, FILE_MAP_WRITE | FILE_MAP_READ, 0, 0, shared_memory_capacity);
-        if (!view_)
+        auto generation = generation_ + 1;
+        SharedMapping region;
+        if (!create_region(generation, slotCapacity, region))
         {
-            spdlog::error("Failed to map view of shared memory (error {})", ::GetLastError());
-            close_mapping(mappingHandle_, view_);
             return false;
         }
 
-        capacity_ = shared_memory_capacity;
+        grow_shared_state(region_.data(), region.data(), slotCapacity, generation);
+        publish_shared_state_generation(control_.data(), generation, region.size());
+
+        // Readers that have not remapped yet hold their own view of the old region, which stays valid.
+        region_ = std::move(region);
+        slotCapacity_ = slotCapacity;
+        generation_ = generation;
+        spdlog::info("Shared state grown to {} KiB per slot (generation {})", slotCapacity / 1024, generation);
         return true;
     }
 
     bool SharedMemoryWriter::write(const std::string& payload, std::uint32_t schemaVersion, std::uint64_t updatedAtMs)
     {
+        std::lock_guard<std::mutex> guard(writeMutex_);
+        if (!ensure())
+        {
+            return false;
+        }
+
+        if (!reserve(payload.size()) || !publish_shared_state(region_.data(), payload, schemaVersion, updatedAtMs))
+        {
+            return false;
+        }
+
+        updateEvent_.signal();
+        return true;
+    }
+
+    bool SharedMemoryWriter::write_binary(const std::string& encoded, std::uint32_t schemaVersion, std::uint64_t updatedAtMs)
+    {
+        std::lock_guard<std::mutex> guard(writeMutex_);
         if (!ensure())
         {
             return false;
         }
 
-        if (payload.size() > capacity_ - sizeof(SharedHeader))
+        std::optional<std::string> delta;
+        if (keyframeSequence_ != 0)
+        {
+            delta = make_overlay_state_delta(keyframe_, encoded, keyframeSequence_);
+        }
+
+        const bool keyframe = !delta || delta->size() * 2 > encoded.size();
+        const auto& payload = keyframe ? encoded : *delta;
+        if (!reserve(payload.size()) || !publish_shared_state(region_.data(), payload, schemaVersion | binary_state_encoding_flag, updatedAtMs, keyframe))
         {
-            spdlog::warn("Shared payload truncated ({} bytes > capacity {})", payload.size(), capacity_ - sizeof(SharedHeader));
             return false;
         }
 
-        auto* base = static_cast<std::byte*>(view_);
-        auto* headerPtr = reinterpret_cast<SharedHeader*>(base);
-        auto* data = reinterpret_cast<std::byte*>(headerPtr + 1);
+        if (keyframe)
+        {
+            keyframe_ = encoded;
+            keyframeSequence_ = shared_state_sequence(region_.data(), region_.size());
+        }
 
-        SharedHeader header{};
-        header.magic = header_magic;
-        header.schema_version = schemaVersion;
-        header.payload_size = static_cast<std::uint32_t>(payload.size());
-        header.reserved = 0;
-        header.updated_at_ms = updatedAtMs;
+        updateEvent_.signal();
+        return true;
+    }
 
-        std::memcpy(data, payload.data(), payload.size());
-        std::memcpy(headerPtr, &header, sizeof(SharedHeader));
+    bool SharedMemoryWriter::write_heartbeat(std::uint64_t heartbeatMs)
+    {
+        std::lock_guard<std::mutex> guard(writeMutex_);
+        if (!ensure())
+        {
+            return false;
+        }
 
+        publish_shared_heartbeat(region_.data(), heartbeatMs);
         return true;
     }
 
-    SharedMemoryReader::SharedMemoryReader() = default;
+    SharedMemoryReader::SharedMemoryReader()
+        : SharedMemoryReader(shared_memory_name, shared_memory_event_name)
+    {
+    }
 
-    SharedMemoryReader::~SharedMemoryReader()
+    SharedMemoryReader::SharedMemoryReader(std::wstring mappingName, std::wstring eventName)
+        : mappingName_(std::move(mappingName))
+        , eventName_(std::move(eventName))
     {
-        close_mapping(mappingHandle_, view_);
     }
 
+    SharedMemoryReader::~SharedMemoryReader() = default;
+
     bool SharedMemoryReader::ensure()
     {
-        if (view_)
+        if (!control_ && !control_.open(mappingName_, false, sizeof(SharedStateControl)))
         {
-            return true;
+            return false;
         }
 
-        mappingHandle_ = ::OpenFileMappingW(FILE_MAP_READ, FALSE, shared_memory_name);
-        if (!mappingHandle_)
+        return remap();
+    }
+
+    bool SharedMemoryReader::remap()
+    {
+        if (!control_)
         {
             return false;
         }
 
-        view_ = ::MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, shared_memory_capacity);
-        if (!view_)
+        const auto generation = shared_state_generation(control_.data(), control_.size());
+        if (generation == 0 || (generation == generation_ && region_))
         {
-            spdlog::warn("Failed to map view of shared memory for reading (error {})", ::GetLastError());
-            close_mapping(mappingHandle_, view_);
-            return false;
+            return static_cast<bool>(region_);
+        }
+
+        // On failure keep reading the current region: the writer may already have replaced the generation we
+        // were told about, and the next call picks up whichever is current then.
+        SharedMapping region;
+        if (!region.open(region_name(mappingName_, generation), false))
+        {
+            return static_cast<bool>(region_);
+        }
+
+        if (shared_state_region_generation(region.data(), region.size()) != generation)
+        {
+            return static_cast<bool>(region_);
         }
 
-        capacity_ = shared_memory_capacity;
+        region_ = std::move(region);
+        generation_ = generation;
+        keyframeSequence_ = 0;
         return true;
     }
 
+    std::uint64_t SharedMemoryReader::current_sequence()
+    {
+        return remap() ? shared_state_sequence(region_.data(), region_.size()) : 0;
+    }
+
+    std::uint64_t SharedMemoryReader::current_heartbeat_ms()
+    {
+        return remap() ? shared_state_heartbeat(region_.data(), region_.size()) : 0;
+    }
+
+    bool SharedMemoryReader::wait_for_update(std::uint64_t lastSequence, std::chrono::milliseconds timeout)
+    {
+        if (!ensure())
+        {
+            std::this_thread::sleep_for(timeout);
+            return false;
+        }
+
+        if (current_sequence() != lastSequence)
+        {
+            return true;
+        }
+
+        if (!updateEvent_)
+        {
+            updateEvent_.open(eventName_);
+        }
+
+        if (updateEvent_)
+        {
+            // Auto-reset: a publish that raced with the sequence check above leaves the event signalled.
+            updateEvent_.wait(timeout);
+        }
+        else
+        {
+            std::this_thread::sleep_for(timeout);
+        }
+
+        return current_sequence() != lastSequence;
+    }
+
     std::optional<SharedMemorySnapshot> SharedMemoryReader::read()
     {
         if (!ensure())
@@ -153,23 +292,92 @@ namespace overlay
             return std::nullopt;
         }
 
-        const auto* header = static_cast<const SharedHeader*>(view_);
-        if (!validate_header(*header))
+        auto snapshot = read_shared_state(region_.data(), region_.size());
+        if (!snapshot || snapshot->json_payload.empty())
         {
             return std::nullopt;
         }
 
-        if (header->payload_size == 0)
+        lastVersion_ = snapshot->version;
+        return snapshot;
+    }
+
+    std::optional<SharedMemoryState> SharedMemoryReader::read_state()
+    {
+        if (!ensure())
         {
             return std::nullopt;
         }
 
-        const auto* data = reinterpret_cast<const char*>(header + 1);
-        SharedMemorySnapshot snapshot;
-        snapshot.version = header->schema_version;
-        snapshot.updated_at_ms = header->updated_at_ms;
-        snapshot.json_payload.assign(data, header->payload_size);
-        lastVersion_ = header->schema_version;
-        return snapshot;
+        constexpr int maxAttempts = 4;
+        for (int attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            const auto view = begin_shared_state_read(region_.data(), region_.size());
+            if (!view || view->payload.empty())
+            {
+                return std::nullopt;
+            }
+
+            SharedMemoryState result;
+            result.sequence = view->sequence;
+            result.version = view->version & ~binary_state_encoding_flag;
+            result.updated_at_ms = view->updated_at_ms;
+
+            if (!is_binary_state_encoding(view->version))
+            {
+                result.json_payload.assign(view->payload);
+                if (!end_shared_state_read(region_.data(), *view))
+                {
+                    continue;
+                }
+
+                try
+                {
+                    result.state = parse_overlay_state(nlohmann::json::parse(result.json_payload, nullptr, true, true));
+                }
+                catch (const std::exception& ex)
+                {
+                    result.error = ex.what();
+                }
+                lastVersion_ = result.version;
+                return result;
+            }
+
+            try
+            {
+                if (is_overlay_state_delta(view->payload))
+                {
+                    const auto base = overlay_state_delta_base(view->payload);
+                    if (keyframeSequence_ != base)
+                    {
+                        const auto cached = read_shared_state_keyframe(region_.data(), region_.size(), keyframe_);
+                        keyframeSequence_ = cached.value_or(0);
+                        if (keyframeSequence_ != base)
+                        {
+                            // A newer keyframe replaced the base; the publish slot has moved on as well.
+                            continue;
+                        }
+                    }
+                    result.state = decode_overlay_state_binary(apply_overlay_state_delta(keyframe_, view->payload));
+                }
+                else
+                {
+                    result.state = decode_overlay_state_binary(view->payload);
+                }
+            }
+            catch (const std::invalid_argument& ex)
+            {
+                result.error = ex.what();
+            }
+
+            // A torn slot decodes as garbage (or fails to); only a slot that was stable throughout counts.
+            if (end_shared_state_read(region_.data(), *view))
+            {
+                lastVersion_ = result.version;
+                return result;
+            }
+        }
+
+        return std::nullopt;
     }
 }
@@ -1,26 +1,48 @@
 #pragma once
 
+#include "ipc_backend.hpp"
+#include "overlay_schema.hpp"
+
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
 #include <optional>
 #include <string>
 
 namespace overlay
 {
+    // Control block; the state itself lives in "<name>.<generation>" mappings that grow with the payload.
     constexpr const wchar_t* shared_memory_name = L"Local\\EFOverlaySharedState";
-    constexpr std::size_t shared_memory_capacity = 64 * 1024; // 64 KiB
+    constexpr const wchar_t* shared_memory_event_name = L"Local\\EFOverlaySharedStateUpdated"; // auto-reset, signalled per publish
+    constexpr std::size_t shared_memory_initial_slot_capacity = 64 * 1024;     // per publish slot until a payload outgrows it
+    constexpr std::size_t shared_memory_max_slot_capacity = 32 * 1024 * 1024;  // largest payload per publish
+    constexpr std::size_t shared_memory_header_size = 128;
 
     struct SharedMemorySnapshot
     {
+        std::uint64_t sequence = 0;     // publish counter; increases by one per write
         std::uint32_t version = 0;
         std::uint64_t updated_at_ms = 0;
         std::string json_payload;
     };
 
+    struct SharedMemoryState
+    {
+        std::uint64_t sequence = 0;
+        std::uint32_t version = 0;      // schema version with the encoding flag stripped
+        std::uint64_t updated_at_ms = 0;
+        std::optional<OverlayState> state; // unset if the payload failed to decode; see error
+        std::string error;
+        std::string json_payload;       // empty when the helper published the binary encoding
+    };
+
     class SharedMemoryWriter
     {
     public:
         SharedMemoryWriter();
+        // Alternate object names, e.g. for benchmarks that must not disturb a running helper.
+        SharedMemoryWriter(std::wstring mappingName, std::wstring eventName);
         ~SharedMemoryWriter();
 
         SharedMemoryWriter(const SharedMemoryWriter&) = delete;
@@ -29,16 +51,34 @@ namespace overlay
         bool ensure();
         bool write(const std::string& payload, std::uint32_t schemaVersion, std::uint64_t updatedAtMs);
 
+        // Publishes a binary-encoded state (see overlay_state_binary.hpp). Sent as a delta against the last
+        // keyframe while that stays under half the full size, otherwise as a new keyframe.
+        bool write_binary(const std::string& encoded, std::uint32_t schemaVersion, std::uint64_t updatedAtMs);
+
+        // Refreshes the heartbeat without republishing state; readers are not woken for it.
+        bool write_heartbeat(std::uint64_t heartbeatMs);
+
     private:
-        void* mappingHandle_ = nullptr;
-        void* view_ = nullptr;
-        std::size_t capacity_ = 0;
+        bool create_region(std::uint64_t& generation, std::size_t slotCapacity, SharedMapping& region);
+        bool reserve(std::size_t payloadSize);
+
+        std::wstring mappingName_;
+        std::wstring eventName_;
+        SharedMapping control_;
+        SharedMapping region_;
+        SharedEvent updateEvent_;
+        std::size_t slotCapacity_ = 0;
+        std::uint64_t generation_ = 0;
+        std::mutex writeMutex_;     // the helper publishes from request and heartbeat threads
+        std::string keyframe_;
+        std::uint64_t keyframeSequence_ = 0;
     };
 
     class SharedMemoryReader
     {
     public:
         SharedMemoryReader();
+        SharedMemoryReader(std::wstring mappingName, std::wstring eventName);
         ~SharedMemoryReader();
 
         SharedMemoryReader(const SharedMemoryReader&) = delete;
@@ -47,10 +87,33 @@ namespace overlay
         bool ensure();
         std::optional<SharedMemorySnapshot> read();
 
+        // Latest state, decoded. Binary payloads are decoded in place from the mapped slot and then checked
+        // against the slot sequence, so nothing is copied up front; JSON payloads are copied and parsed.
+        // A consistent payload that fails to decode is returned with `state` unset and `error` filled in.
+        std::optional<SharedMemoryState> read_state();
+
+        // Sequence of the latest publish; unchanged sequence means unchanged state.
+        std::uint64_t current_sequence();
+
+        // Latest helper heartbeat, which advances between publishes.
+        std::uint64_t current_heartbeat_ms();
+
+        // Blocks until a publish newer than `lastSequence` is available or `timeout` elapses. Returns true
+        // when newer state is available. Falls back to sleeping if the helper has not created the event.
+        bool wait_for_update(std::uint64_t lastSequence, std::chrono::milliseconds timeout);
+
     private:
-        void* mappingHandle_ = nullptr;
-        void* view_ = nullptr;
-        std::size_t capacity_ = 0;
+        // Follows the control block to the current generation; every read starts here.
+        bool remap();
+
+        std::wstring mappingName_;
+        std::wstring eventName_;
+        SharedMapping control_;
+        SharedMapping region_;
+        SharedEvent updateEvent_;
+        std::uint64_t generation_ = 0;
         std::uint32_t lastVersion_ = 0;
+        std::string keyframe_;              // cached keyframe slot, reused while deltas name it as their base
+        std::uint64_t keyframeSequence_ = 0;
     };
 }
@@ -0,0 +1,287 @@
+#include "shared_memory_protocol.hpp"
+
+#include <atomic>
+#include <cstring>
+
+namespace overlay
+{
+    namespace
+    {
+        constexpr int max_read_attempts = 4;
+
+        std::atomic_ref<std::uint64_t> atomic_u64(const std::uint64_t& value)
+        {
+            // The header lives in memory shared with another process; atomic_ref keeps the layout a plain struct.
+            return std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(value));
+        }
+
+        std::byte* slot_payload(void* region, std::uint32_t slotCapacity, std::uint64_t slotIndex)
+        {
+            return static_cast<std::byte*>(region) + sizeof(SharedStateHeader) + slotIndex * slotCapacity;
+        }
+
+        const std::byte* slot_payload(const void* region, std::uint32_t slotCapacity, std::uint64_t slotIndex)
+        {
+            return static_cast<const std::byte*>(region) + sizeof(SharedStateHeader) + slotIndex * slotCapacity;
+        }
+
+        constexpr std::uint64_t keyframe_slot_index = shared_state_slot_count;
+
+        const SharedStateHeader* initialized_header(const void* region, std::size_t regionSize)
+        {
+            if (regionSize < sizeof(SharedStateHeader))
+            {
+                return nullptr;
+            }
+
+            const auto* header = static_cast<const SharedStateHeader*>(region);
+            if (header->magic != shared_state_magic || shared_state_region_size(header->slot_capacity) > regionSize)
+            {
+                return nullptr;
+            }
+            return header;
+        }
+    }
+
+    static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free, "Shared state sequences must be lock-free to work across processes");
+
+    void initialize_shared_state(void* region, std::size_t slotCapacity, std::uint64_t generation)
+    {
+        auto* header = static_cast<SharedStateHeader*>(region);
+        if (header->magic == shared_state_magic && header->slot_capacity == slotCapacity && header->generation == generation)
+        {
+            return;
+        }
+
+        std::memset(header, 0, sizeof(SharedStateHeader));
+        header->slot_capacity = static_cast<std::uint32_t>(slotCapacity);
+        header->generation = generation;
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = shared_state_magic;
+    }
+
+    void grow_shared_state(const void* from, void* to, std::size_t slotCapacity, std::uint64_t generation)
+    {
+        const auto* source = static_cast<const SharedStateHeader*>(from);
+        auto* target = static_cast<SharedStateHeader*>(to);
+
+        // Sequences are copied as-is: the writer is between publishes, so every seqlock counter is even.
+        std::memcpy(target, source, sizeof(SharedStateHeader));
+        target->slot_capacity = static_cast<std::uint32_t>(slotCapacity);
+        target->generation = generation;
+
+        for (std::uint64_t slotIndex = 0; slotIndex < shared_state_slot_count; ++slotIndex)
+        {
+            std::memcpy(slot_payload(to, target->slot_capacity, slotIndex), slot_payload(from, source->slot_capacity, slotIndex), source->slots[slotIndex].payload_size);
+        }
+        std::memcpy(slot_payload(to, target->slot_capacity, keyframe_slot_index), slot_payload(from, source->slot_capacity, keyframe_slot_index), source->keyframe.payload_size);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void publish_shared_state_generation(void* control, std::uint64_t generation, std::uint64_t regionSize)
+    {
+        auto* block = static_cast<SharedStateControl*>(control);
+        block->magic = shared_state_control_magic;
+        atomic_u64(block->region_size).store(regionSize, std::memory_order_relaxed);
+        atomic_u64(block->generation).store(generation, std::memory_order_release);
+    }
+
+    std::uint64_t shared_state_generation(const void* control, std::size_t controlSize)
+    {
+        if (controlSize < sizeof(SharedStateControl))
+        {
+            return 0;
+        }
+
+        const auto* block = static_cast<const SharedStateControl*>(control);
+        if (block->magic != shared_state_control_magic)
+        {
+            return 0;
+        }
+        return atomic_u64(block->generation).load(std::memory_order_acquire);
+    }
+
+    std::uint64_t shared_state_region_generation(const void* region, std::size_t regionSize)
+    {
+        const auto* header = initialized_header(region, regionSize);
+        return header ? header->generation : 0;
+    }
+
+    bool publish_shared_state(void* region, std::string_view payload, std::uint32_t schemaVersion, std::uint64_t updatedAtMs, bool keyframe)
+    {
+        auto* header = static_cast<SharedStateHeader*>(region);
+        if (payload.size() > header->slot_capacity)
+        {
+            return false;
+        }
+
+        const auto next = atomic_u64(header->publish_sequence).load(std::memory_order_relaxed) + 1;
+        if (keyframe)
+        {
+            // Filled before the publish that names it, so every delta's base is resolvable once visible.
+            auto keyframeSequence = atomic_u64(header->keyframe.sequence);
+            const auto begin = keyframeSequence.load(std::memory_order_relaxed) + 1;
+            keyframeSequence.store(begin, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            std::memcpy(slot_payload(region, header->slot_capacity, keyframe_slot_index), payload.data(), payload.size());
+            header->keyframe.schema_version = schemaVersion;
+            header->keyframe.payload_size = static_cast<std::uint32_t>(payload.size());
+            header->keyframe.updated_at_ms = updatedAtMs;
+            atomic_u64(header->keyframe_sequence).store(next, std::memory_order_relaxed);
+
+            keyframeSequence.store(begin + 1, std::memory_order_release);
+        }
+
+        const auto slotIndex = next % shared_state_slot_count;
+        auto& slot = header->slots[slotIndex];
+        auto slotSequence = atomic_u64(slot.sequence);
+
+        // Mark the slot as being written before touching its contents. The counter names the publish, so a
+        // reader that loses a race with two further publishes cannot pair this payload with an older sequence.
+        const auto begin = 2 * next - 1;
+        slotSequence.store(begin, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(slot_payload(region, header->slot_capacity, slotIndex), payload.data(), payload.size());
+        slot.schema_version = schemaVersion;
+        slot.payload_size = static_cast<std::uint32_t>(payload.size());
+        slot.updated_at_ms = updatedAtMs;
+
+        slotSequence.store(begin + 1, std::memory_order_release);
+        atomic_u64(header->publish_sequence).store(next, std::memory_order_release);
+        return true;
+    }
+
+    void publish_shared_heartbeat(void* region, std::uint64_t heartbeatMs)
+    {
+        auto* header = static_cast<SharedStateHeader*>(region);
+        atomic_u64(header->heartbeat_ms).store(heartbeatMs, std::memory_order_release);
+    }
+
+    std::uint64_t shared_state_sequence(const void* region, std::size_t regionSize)
+    {
+        const auto* header = initialized_header(region, regionSize);
+        return header ? atomic_u64(header->publish_sequence).load(std::memory_order_acquire) : 0;
+    }
+
+    std::uint64_t shared_state_heartbeat(const void* region, std::size_t regionSize)
+    {
+        const auto* header = initialized_header(region, regionSize);
+        return header ? atomic_u64(header->heartbeat_ms).load(std::memory_order_acquire) : 0;
+    }
+
+    std::optional<std::uint64_t> read_shared_state_keyframe(const void* region, std::size_t regionSize, std::string& payload)
+    {
+        const auto* header = initialized_header(region, regionSize);
+        if (!header)
+        {
+            return std::nullopt;
+        }
+
+        for (int attempt = 0; attempt < max_read_attempts; ++attempt)
+        {
+            const auto before = atomic_u64(header->keyframe.sequence).load(std::memory_order_acquire);
+            if (before == 0)
+            {
+                return std::nullopt;
+            }
+            if ((before & 1u) != 0)
+            {
+                continue;
+            }
+
+            const auto sequence = atomic_u64(header->keyframe_sequence).load(std::memory_order_relaxed);
+            const auto size = header->keyframe.payload_size;
+            if (size > header->slot_capacity)
+            {
+                continue;
+            }
+            payload.assign(reinterpret_cast<const char*>(slot_payload(region, header->slot_capacity, keyframe_slot_index)), size);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (atomic_u64(header->keyframe.sequence).load(std::memory_order_relaxed) == before)
+            {
+                return sequence;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<SharedStateView> begin_shared_state_read(const void* region, std::size_t regionSize)
+    {
+        const auto* header = initialized_header(region, regionSize);
+        if (!header)
+        {
+            return std::nullopt;
+        }
+
+        for (int attempt = 0; attempt < max_read_attempts; ++attempt)
+        {
+            const auto published = atomic_u64(header->publish_sequence).load(std::memory_order_acquire);
+            if (published == 0)
+            {
+                return std::nullopt;
+            }
+
+            const auto slotIndex = published % shared_state_slot_count;
+            const auto& slot = header->slots[slotIndex];
+            const auto before = atomic_u64(slot.sequence).load(std::memory_order_acquire);
+            if (before != 2 * published)
+            {
+                // The writer has already lapped this slot; pick up the newer publish instead.
+                continue;
+            }
+
+            const auto size = slot.payload_size;
+            if (size > header->slot_capacity)
+            {
+                continue;
+            }
+
+            SharedStateView view;
+            view.sequence = published;
+            view.version = slot.schema_version;
+            view.updated_at_ms = slot.updated_at_ms;
+            view.payload = std::string_view(reinterpret_cast<const char*>(slot_payload(region, header->slot_capacity, slotIndex)), size);
+            view.slot_index = slotIndex;
+            view.slot_sequence = before;
+            return view;
+        }
+
+        return std::nullopt;
+    }
+
+    bool end_shared_state_read(const void* region, const SharedStateView& view)
+    {
+        const auto* header = static_cast<const SharedStateHeader*>(region);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return atomic_u64(header->slots[view.slot_index].sequence).load(std::memory_order_relaxed) == view.slot_sequence;
+    }
+
+    std::optional<SharedMemorySnapshot> read_shared_state(const void* region, std::size_t regionSize)
+    {
+        for (int attempt = 0; attempt < max_read_attempts; ++attempt)
+        {
+            const auto view = begin_shared_state_read(region, regionSize);
+            if (!view)
+            {
+                return std::nullopt;
+            }
+
+            SharedMemorySnapshot snapshot;
+            snapshot.sequence = view->sequence;
+            snapshot.version = view->version;
+            snapshot.updated_at_ms = view->updated_at_ms;
+            snapshot.json_payload.assign(view->payload);
+
+            if (end_shared_state_read(region, *view))
+            {
+                return snapshot;
+            }
+        }
+
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "shared_memory_channel.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace overlay
+{
+    // Layout of the shared state region, independent of how the region is mapped:
+    //
+    //   SharedStateHeader | slot 0 payload | slot 1 payload | keyframe payload   (slot capacity each)
+    //
+    // The single writer always fills the slot that is not currently published, then bumps
+    // publish_sequence to flip readers over to it. Each slot also carries its own seqlock counter
+    // (odd while being written), so a reader only retries when the writer lapped it twice during one
+    // copy; it never waits on a writer that is mid-write.
+    //
+    // Publishes may be deltas against a keyframe. A keyframe publish also copies its payload into the
+    // keyframe slot, where it stays until the next keyframe, so a reader that missed it can still resolve
+    // later deltas. Heartbeats only store heartbeat_ms and do not touch any slot.
+    //
+    // The region is one generation of a growable mapping. A small control block under the base name holds
+    // the current generation; each generation is its own mapping ("<name>.<generation>") sized for its slot
+    // capacity. When a payload outgrows the slots the writer creates the next generation with larger slots,
+    // copies the header and slot contents across, and only then advances the control block. Readers remap
+    // when they see a new generation; the old one stays intact (and mapped) until they do.
+    constexpr std::uint32_t shared_state_magic = 0x34464F45; // 'EFO4'
+    constexpr std::uint32_t shared_state_control_magic = 0x43464F45; // 'EFOC'
+    constexpr std::uint32_t shared_state_slot_count = 2;
+
+    struct SharedStateSlot
+    {
+        alignas(8) std::uint64_t sequence;   // seqlock counter: 2 * the publish it holds, odd while being written
+        std::uint64_t updated_at_ms;
+        std::uint32_t schema_version;
+        std::uint32_t payload_size;
+    };
+
+    struct SharedStateHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t slot_capacity;
+        alignas(8) std::uint64_t publish_sequence; // number of completed publishes; slot = sequence % 2
+        std::uint64_t heartbeat_ms;                // latest helper heartbeat, also between publishes
+        std::uint64_t keyframe_sequence;           // publish held in the keyframe slot; guarded by its seqlock
+        SharedStateSlot slots[shared_state_slot_count];
+        SharedStateSlot keyframe;
+        std::uint64_t generation;                  // generation this region belongs to
+        std::uint64_t reserved[2];
+    };
+
+    static_assert(sizeof(SharedStateHeader) == shared_memory_header_size, "SharedStateHeader layout is shared across processes");
+
+    struct SharedStateControl
+    {
+        std::uint32_t magic;
+        std::uint32_t reserved;
+        alignas(8) std::uint64_t generation;       // current region; 0 until the writer has created one
+        std::uint64_t region_size;                 // size of the current region, for diagnostics
+    };
+
+    constexpr std::size_t shared_state_region_size(std::size_t slotCapacity)
+    {
+        return sizeof(SharedStateHeader) + slotCapacity * (shared_state_slot_count + 1);
+    }
+
+    // Smallest slot capacity that holds `payloadSize`: the initial capacity doubled as often as needed.
+    // Returns 0 if that would exceed shared_memory_max_slot_capacity.
+    constexpr std::size_t shared_state_slot_capacity_for(std::size_t payloadSize)
+    {
+        std::size_t capacity = shared_memory_initial_slot_capacity;
+        while (capacity < payloadSize)
+        {
+            capacity *= 2;
+        }
+        return capacity <= shared_memory_max_slot_capacity ? capacity : 0;
+    }
+
+    // Prepares a zeroed region for publishing. Idempotent for a region that is already initialised with
+    // the same slot capacity and generation.
+    void initialize_shared_state(void* region, std::size_t slotCapacity, std::uint64_t generation = 0);
+
+    // Fills the zeroed region `to` with the header and slot contents of `from`, re-laid out for
+    // `slotCapacity`, so readers that remap carry on at the same publish sequence and keyframe. Must not run
+    // concurrently with a publish to `from`; `slotCapacity` must hold every payload currently in it.
+    void grow_shared_state(const void* from, void* to, std::size_t slotCapacity, std::uint64_t generation);
+
+    // Points readers at a new generation. `region` must be fully initialised first.
+    void publish_shared_state_generation(void* control, std::uint64_t generation, std::uint64_t regionSize);
+
+    // Current generation (0 if the control block is not initialised or no region was created yet).
+    std::uint64_t shared_state_generation(const void* control, std::size_t controlSize);
+
+    // Generation recorded in a region's own header (0 if the region is not initialised).
+    std::uint64_t shared_state_region_generation(const void* region, std::size_t regionSize);
+
+    // Publishes `payload` into the inactive slot, and into the keyframe slot as well when `keyframe` is set.
+    // Not safe to call concurrently with itself; the caller serialises writers. Returns false if the payload
+    // does not fit a slot.
+    bool publish_shared_state(void* region, std::string_view payload, std::uint32_t schemaVersion, std::uint64_t updatedAtMs, bool keyframe = false);
+
+    // Records a heartbeat without publishing state.
+    void publish_shared_heartbeat(void* region, std::uint64_t heartbeatMs);
+
+    // Latest heartbeat (0 if none or the region is not initialised).
+    std::uint64_t shared_state_heartbeat(const void* region, std::size_t regionSize);
+
+    // Copies the keyframe slot into `payload` and returns the publish sequence it belongs to. Returns nullopt
+    // if there is no keyframe or the writer kept replacing it (bounded retries).
+    std::optional<std::uint64_t> read_shared_state_keyframe(const void* region, std::size_t regionSize, std::string& payload);
+
+    // Sequence of the latest completed publish (0 if none or the region is not initialised). Cheap enough to
+    // poll: readers compare it with the sequence of their last snapshot to skip unchanged state.
+    std::uint64_t shared_state_sequence(const void* region, std::size_t regionSize);
+
+    // In-place view of the latest published slot. `payload` points into the mapped region and may be
+    // overwritten at any time; anything derived from it is only trustworthy once end_shared_state_read
+    // confirms the slot was left alone meanwhile.
+    struct SharedStateView
+    {
+        std::uint64_t sequence = 0;
+        std::uint32_t version = 0;
+        std::uint64_t updated_at_ms = 0;
+        std::string_view payload;
+        std::uint64_t slot_index = 0;
+        std::uint64_t slot_sequence = 0;
+    };
+
+    // Starts a zero-copy read of the latest publish. Returns nullopt if nothing has been published, the
+    // region is not initialised, or the writer kept overtaking the reader (bounded retries).
+    std::optional<SharedStateView> begin_shared_state_read(const void* region, std::size_t regionSize);
+
+    // True if the slot behind `view` was not rewritten since begin_shared_state_read.
+    bool end_shared_state_read(const void* region, const SharedStateView& view);
+
+    // Copies the latest complete snapshot out of `region` without taking locks. Returns nullopt if
+    // nothing has been published, the region is not initialised, or the writer kept overtaking the
+    // copy (bounded retries).
+    std::optional<SharedMemorySnapshot> read_shared_state(const void* region, std::size_t regionSize);
+}
@@ -1,8 +1,30 @@
 #include "star_catalog.hpp"
-
-#include <cctype>
+#include "star_spatial_index.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <bit>
 #include <cstring>
 #include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string_view>
 
@@ -11,8 +33,13 @@ namespace overlay
     namespace
     {
         constexpr std::string_view kMagic{"EFSTARS1"};
+        constexpr std::string_view kMagicV2{"EFSTARS2"};
         constexpr std::size_t kHeaderSize = 44;
+        constexpr std::size_t kHeaderSizeV2 = 64;
         constexpr std::size_t kPackedRecordSize = 36;
+        constexpr std::uint16_t kFormatVersionV2 = 2;
+        constexpr std::size_t kPerfectHashHeaderSize = 4 * sizeof(std::uint32_t);
+        constexpr std::uint64_t kGoldenRatio = 0x9E3779B97F4A7C15ULL;
 
         template <typename T>
         [[nodiscard]] T read_le(const std::uint8_t* data)
@@ -42,113 +69,594 @@ namespace overlay
             }
         }
 
-        std::string normalize_name(std::string_view name)
+        char ascii_lower(char ch)
+        {
+            return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+        }
+
+        // Yields the characters of a name as normalize_name used to produce them (trimmed, runs of
+        // whitespace collapsed to one space, ASCII lowercased) without materialising a string.
+        class NormalizedChars
         {
-            auto trim = [](std::string_view value) {
-                std::size_t start = 0;
-                while (start < value.size() && is_ascii_space(value[start]))
+        public:
+            explicit NormalizedChars(std::string_view text) : text_(text) {}
+
+            // Returns the next normalized character, or -1 at the end of the name.
+            int next()
+            {
+                bool sawSpace = false;
+                while (pos_ < text_.size() && is_ascii_space(text_[pos_]))
                 {
-                    ++start;
+                    ++pos_;
+                    sawSpace = true;
                 }
-                if (start == value.size())
+
+                if (pos_ == text_.size())
                 {
-                    return std::string_view{};
+                    return -1;
                 }
-                std::size_t end = value.size();
-                while (end > start && is_ascii_space(value[end - 1]))
+
+                if (sawSpace && emitted_)
                 {
-                    --end;
+                    return ' ';
                 }
-                return value.substr(start, end - start);
-            };
 
-            const auto trimmed = trim(name);
-            if (trimmed.empty())
+                emitted_ = true;
+                return static_cast<unsigned char>(ascii_lower(text_[pos_++]));
+            }
+
+        private:
+            std::string_view text_;
+            std::size_t pos_{0};
+            bool emitted_{false};
+        };
+
+        std::uint64_t mix64(std::uint64_t value)
+        {
+            value ^= value >> 30;
+            value *= 0xBF58476D1CE4E5B9ULL;
+            value ^= value >> 27;
+            value *= 0x94D049BB133111EBULL;
+            value ^= value >> 31;
+            return value;
+        }
+
+        std::uint64_t normalized_name_hash(std::string_view name, bool& empty)
+        {
+            std::uint64_t hash = 14695981039346656037ULL;
+            NormalizedChars chars{name};
+            empty = true;
+            for (int ch = chars.next(); ch >= 0; ch = chars.next())
             {
-                return {};
+                hash ^= static_cast<std::uint64_t>(ch);
+                hash *= 1099511628211ULL;
+                empty = false;
             }
+            return hash;
+        }
 
-            std::string output;
-            output.reserve(trimmed.size());
-            bool lastWasSpace = false;
+        bool normalized_names_equal(std::string_view lhs, std::string_view rhs)
+        {
+            NormalizedChars left{lhs};
+            NormalizedChars right{rhs};
+            while (true)
+            {
+                const int a = left.next();
+                const int b = right.next();
+                if (a != b)
+                {
+                    return false;
+                }
+                if (a < 0)
+                {
+                    return true;
+                }
+            }
+        }
+
+        // Read-only view of a file mapping; the catalog keeps it alive through a shared_ptr.
+        class MappedFile
+        {
+        public:
+            MappedFile() = default;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            ~MappedFile()
+            {
+#if defined(_WIN32)
+                if (view_)
+                {
+                    ::UnmapViewOfFile(view_);
+                }
+                if (mapping_)
+                {
+                    ::CloseHandle(mapping_);
+                }
+                if (file_ && file_ != INVALID_HANDLE_VALUE)
+                {
+                    ::CloseHandle(file_);
+                }
+#else
+                if (view_)
+                {
+                    ::munmap(view_, size_);
+                }
+                if (fd_ >= 0)
+                {
+                    ::close(fd_);
+                }
+#endif
+            }
 
-            for (char ch : trimmed)
+            // Returns false when the file exists but cannot be mapped (the caller falls back to reading it).
+            bool open(const std::filesystem::path& path)
             {
-                if (is_ascii_space(ch))
+#if defined(_WIN32)
+                file_ = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (file_ == INVALID_HANDLE_VALUE)
+                {
+                    throw std::runtime_error("Failed to open star catalog file: " + path.string());
+                }
+
+                LARGE_INTEGER fileSize{};
+                if (!::GetFileSizeEx(file_, &fileSize))
+                {
+                    throw std::runtime_error("Failed to determine star catalog file size: " + path.string());
+                }
+                size_ = static_cast<std::size_t>(fileSize.QuadPart);
+                if (size_ < kHeaderSize)
                 {
-                    if (!output.empty() && !lastWasSpace)
+                    throw std::runtime_error("Star catalog too small");
+                }
+
+                mapping_ = ::CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!mapping_)
+                {
+                    return false;
+                }
+
+                view_ = ::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+                return view_ != nullptr;
+#else
+                fd_ = ::open(path.c_str(), O_RDONLY);
+                if (fd_ < 0)
+                {
+                    throw std::runtime_error("Failed to open star catalog file: " + path.string());
+                }
+
+                struct stat info{};
+                if (::fstat(fd_, &info) != 0)
+                {
+                    throw std::runtime_error("Failed to determine star catalog file size: " + path.string());
+                }
+                size_ = static_cast<std::size_t>(info.st_size);
+                if (size_ < kHeaderSize)
+                {
+                    throw std::runtime_error("Star catalog too small");
+                }
+
+                void* view = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+                if (view == MAP_FAILED)
+                {
+                    return false;
+                }
+                view_ = view;
+                return true;
+#endif
+            }
+
+            [[nodiscard]] std::span<const std::uint8_t> bytes() const
+            {
+                return {static_cast<const std::uint8_t*>(view_), size_};
+            }
+
+        private:
+#if defined(_WIN32)
+            HANDLE file_{INVALID_HANDLE_VALUE};
+            HANDLE mapping_{nullptr};
+#else
+            int fd_{-1};
+#endif
+            void* view_{nullptr};
+            std::size_t size_{0};
+        };
+
+        // Hash-and-displace minimal perfect hash section of an EFSTARS2 catalog:
+        //   u32 key_count, u32 bucket_count, u32 seed, u32 reserved,
+        //   u32 displacements[bucket_count], u32 record_index[key_count]
+        // A key's 64-bit hash picks a bucket; the bucket's displacement then picks the one slot holding the
+        // record index, which the caller verifies against the key.
+        struct PerfectHashView
+        {
+            std::uint32_t key_count{0};
+            std::uint32_t bucket_count{0};
+            std::uint64_t seed{0};
+            const std::uint8_t* displacements{nullptr};
+            const std::uint8_t* slots{nullptr};
+
+            [[nodiscard]] bool present() const noexcept { return displacements != nullptr; }
+
+            [[nodiscard]] std::uint64_t key_hash(std::uint64_t base_hash) const noexcept
+            {
+                return mix64(base_hash ^ seed);
+            }
+
+            [[nodiscard]] std::optional<std::uint32_t> lookup(std::uint64_t hash) const noexcept
+            {
+                if (key_count == 0)
+                {
+                    return std::nullopt;
+                }
+
+                const auto bucket = (hash >> 32) % bucket_count;
+                const auto displacement = read_le<std::uint32_t>(displacements + bucket * sizeof(std::uint32_t));
+                const auto slot = mix64(hash ^ (displacement * kGoldenRatio)) % key_count;
+                return read_le<std::uint32_t>(slots + slot * sizeof(std::uint32_t));
+            }
+        };
+
+        PerfectHashView parse_perfect_hash(std::span<const std::uint8_t> section)
+        {
+            if (section.size() < kPerfectHashHeaderSize)
+            {
+                throw std::runtime_error("Star catalog index truncated");
+            }
+
+            PerfectHashView view;
+            view.key_count = read_le<std::uint32_t>(section.data() + 0);
+            view.bucket_count = read_le<std::uint32_t>(section.data() + 4);
+            view.seed = read_le<std::uint32_t>(section.data() + 8) * kGoldenRatio;
+
+            const auto expected = kPerfectHashHeaderSize
+                + (static_cast<std::size_t>(view.bucket_count) + view.key_count) * sizeof(std::uint32_t);
+            if (view.bucket_count == 0 || section.size() != expected)
+            {
+                throw std::runtime_error("Star catalog index malformed");
+            }
+
+            view.displacements = section.data() + kPerfectHashHeaderSize;
+            view.slots = view.displacements + static_cast<std::size_t>(view.bucket_count) * sizeof(std::uint32_t);
+            return view;
+        }
+
+        struct PerfectHashKey
+        {
+            std::uint64_t base_hash{0};
+            std::uint32_t record_index{0};
+        };
+
+        // Returns the serialized section, or nullopt when `seed` produced a bucket that could not be placed.
+        std::optional<std::vector<std::uint8_t>> try_build_perfect_hash(const std::vector<PerfectHashKey>& keys, std::uint32_t seed)
+        {
+            constexpr std::uint32_t kMaxDisplacement = 1u << 20;
+
+            const auto key_count = static_cast<std::uint32_t>(keys.size());
+            const auto bucket_count = std::max<std::uint32_t>(1, (key_count + 3) / 4);
+
+            PerfectHashView shape;
+            shape.key_count = key_count;
+            shape.bucket_count = bucket_count;
+            shape.seed = seed * kGoldenRatio;
+
+            std::vector<std::vector<std::pair<std::uint64_t, std::uint32_t>>> buckets(bucket_count);
+            for (const auto& key : keys)
+            {
+                const auto hash = shape.key_hash(key.base_hash);
+                buckets[(hash >> 32) % bucket_count].emplace_back(hash, key.record_index);
+            }
+
+            std::vector<std::uint32_t> order(bucket_count);
+            for (std::uint32_t i = 0; i < bucket_count; ++i)
+            {
+                order[i] = i;
+            }
+            std::stable_sort(order.begin(), order.end(), [&buckets](std::uint32_t lhs, std::uint32_t rhs) {
+                return buckets[lhs].size() > buckets[rhs].size();
+            });
+
+            std::vector<std::uint32_t> displacements(bucket_count, 0);
+            std::vector<std::uint32_t> slots(key_count, 0);
+            std::vector<bool> occupied(key_count, false);
+            std::vector<std::uint64_t> candidate;
+
+            for (const auto bucketIndex : order)
+            {
+                const auto& bucket = buckets[bucketIndex];
+                if (bucket.empty())
+                {
+                    break;
+                }
+
+                bool placed = false;
+                for (std::uint32_t displacement = 0; displacement < kMaxDisplacement && !placed; ++displacement)
+                {
+                    candidate.clear();
+                    placed = true;
+                    for (const auto& [hash, recordIndex] : bucket)
+                    {
+                        const auto slot = mix64(hash ^ (displacement * kGoldenRatio)) % key_count;
+                        if (occupied[slot] || std::find(candidate.begin(), candidate.end(), slot) != candidate.end())
+                        {
+                            placed = false;
+                            break;
+                        }
+                        candidate.push_back(slot);
+                    }
+
+                    if (placed)
                     {
-                        output.push_back(' ');
-                        lastWasSpace = true;
+                        displacements[bucketIndex] = displacement;
+                        for (std::size_t i = 0; i < bucket.size(); ++i)
+                        {
+                            occupied[candidate[i]] = true;
+                            slots[candidate[i]] = bucket[i].second;
+                        }
                     }
                 }
-                else
+
+                if (!placed)
+                {
+                    return std::nullopt;
+                }
+            }
+
+            std::vector<std::uint8_t> section;
+            section.reserve(kPerfectHashHeaderSize + (displacements.size() + slots.size()) * sizeof(std::uint32_t));
+            auto append_u32 = [&section](std::uint32_t value) {
+                const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+                section.insert(section.end(), bytes, bytes + sizeof(value));
+            };
+            append_u32(key_count);
+            append_u32(bucket_count);
+            append_u32(seed);
+            append_u32(0);
+            for (const auto value : displacements)
+            {
+                append_u32(value);
+            }
+            for (const auto value : slots)
+            {
+                append_u32(value);
+            }
+            return section;
+        }
+
+        std::vector<std::uint8_t> build_perfect_hash(const std::vector<PerfectHashKey>& keys)
+        {
+            std::vector<std::uint64_t> hashes;
+            hashes.reserve(keys.size());
+            for (const auto& key : keys)
+            {
+                hashes.push_back(key.base_hash);
+            }
+            std::sort(hashes.begin(), hashes.end());
+            if (std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end())
+            {
+                throw std::runtime_error("Star catalog index keys collide");
+            }
+
+            for (std::uint32_t seed = 1; seed < 64; ++seed)
+            {
+                if (auto section = try_build_perfect_hash(keys, seed))
                 {
-                    output.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
-                    lastWasSpace = false;
+                    return std::move(*section);
                 }
             }
 
-            if (!output.empty() && output.back() == ' ')
+            throw std::runtime_error("Failed to build star catalog perfect hash");
+        }
+
+        // Backing store for catalogs whose records cannot be viewed in place (foreign record size,
+        // misaligned source buffer or big-endian host).
+        struct DecodedStorage
+        {
+            std::shared_ptr<const void> source;
+            std::vector<StarCatalogRecord> records;
+        };
+
+        StarCatalogRecord decode_record(const std::uint8_t* record_ptr)
+        {
+            StarCatalogRecord record{};
+            record.system_id = read_le<std::uint32_t>(record_ptr + 0);
+            record.region_id = read_le<std::uint32_t>(record_ptr + 4);
+            record.constellation_id = read_le<std::uint32_t>(record_ptr + 8);
+            record.name_offset = read_le<std::uint32_t>(record_ptr + 12);
+            record.name_length = read_le<std::uint16_t>(record_ptr + 16);
+            record.spectral_id = *(record_ptr + 18);
+            record.flags = *(record_ptr + 19);
+            record.position.x = read_le<float>(record_ptr + 20);
+            record.position.y = read_le<float>(record_ptr + 24);
+            record.position.z = read_le<float>(record_ptr + 28);
+            record.security = read_le<float>(record_ptr + 32);
+            return record;
+        }
+    }
+
+    struct StarCatalog::LookupIndexes
+    {
+        struct NameSlot
+        {
+            std::uint64_t hash{0};
+            std::uint32_t index{0};
+        };
+
+        // Precomputed tables from an EFSTARS2 file; when present the runtime indexes below are never built.
+        PerfectHashView id_table;
+        PerfectHashView name_table;
+
+        std::once_flag ids_once;
+        bool ids_sorted{false};
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> by_system_id;
+
+        std::once_flag names_once;
+        std::vector<NameSlot> by_name;
+
+        std::once_flag spatial_once;
+        StarSpatialIndex spatial;
+    };
+
+    const StarCatalog::LookupIndexes& StarCatalog::id_index() const
+    {
+        auto& indexes = *indexes_;
+        std::call_once(indexes.ids_once, [this, &indexes]() {
+            // The shipped catalog is ordered by system id, in which case lookups bisect the records directly.
+            indexes.ids_sorted = std::adjacent_find(records.begin(), records.end(), [](const StarCatalogRecord& lhs, const StarCatalogRecord& rhs) {
+                return lhs.system_id >= rhs.system_id;
+            }) == records.end();
+            if (indexes.ids_sorted)
+            {
+                return;
+            }
+
+            indexes.by_system_id.reserve(records.size());
+            for (std::size_t i = 0; i < records.size(); ++i)
+            {
+                indexes.by_system_id.emplace_back(records[i].system_id, static_cast<std::uint32_t>(i));
+            }
+            std::sort(indexes.by_system_id.begin(), indexes.by_system_id.end());
+        });
+        return indexes;
+    }
+
+    const StarCatalog::LookupIndexes& StarCatalog::name_index() const
+    {
+        auto& indexes = *indexes_;
+        std::call_once(indexes.names_once, [this, &indexes]() {
+            indexes.by_name.reserve(records.size());
+            for (std::size_t i = 0; i < records.size(); ++i)
             {
-                output.pop_back();
+                bool empty = true;
+                const auto hash = normalized_name_hash(name_for(records[i]), empty);
+                if (!empty)
+                {
+                    indexes.by_name.push_back(LookupIndexes::NameSlot{hash, static_cast<std::uint32_t>(i)});
+                }
             }
+            std::sort(indexes.by_name.begin(), indexes.by_name.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : lhs.index < rhs.index;
+            });
+        });
+        return indexes;
+    }
 
-            return output;
+    const StarSpatialIndex& StarCatalog::spatial_index() const
+    {
+        static const StarSpatialIndex empty_index;
+        if (!indexes_)
+        {
+            return empty_index;
         }
+
+        auto& indexes = *indexes_;
+        std::call_once(indexes.spatial_once, [this, &indexes]() {
+            indexes.spatial = StarSpatialIndex{records};
+        });
+        return indexes.spatial;
     }
 
     const StarCatalogRecord* StarCatalog::find_by_system_id(std::uint32_t system_id) const
     {
-        const auto it = index_by_system_id_.find(system_id);
-        if (it == index_by_system_id_.end())
+        if (!indexes_)
         {
             return nullptr;
         }
 
-        const auto index = it->second;
-        if (index >= records.size())
+        if (indexes_->id_table.present())
+        {
+            const auto& table = indexes_->id_table;
+            const auto index = table.lookup(table.key_hash(system_id));
+            if (!index || *index >= records.size() || records[*index].system_id != system_id)
+            {
+                return nullptr;
+            }
+            return &records[*index];
+        }
+
+        const auto& indexes = id_index();
+        if (indexes.ids_sorted)
+        {
+            const auto it = std::lower_bound(records.begin(), records.end(), system_id, [](const StarCatalogRecord& record, std::uint32_t id) {
+                return record.system_id < id;
+            });
+            if (it == records.end() || it->system_id != system_id)
+            {
+                return nullptr;
+            }
+            return &*it;
+        }
+
+        // Duplicate ids resolve to the last record, as the former map-based index did.
+        const auto it = std::upper_bound(indexes.by_system_id.begin(), indexes.by_system_id.end(), system_id, [](std::uint32_t id, const auto& entry) {
+            return id < entry.first;
+        });
+        if (it == indexes.by_system_id.begin() || std::prev(it)->first != system_id)
         {
             return nullptr;
         }
 
-        return &records[index];
+        return &records[std::prev(it)->second];
     }
 
     const StarCatalogRecord* StarCatalog::find_by_name(std::string_view name) const
     {
-        const auto normalized = normalize_name(name);
-        if (normalized.empty())
+        if (!indexes_)
         {
             return nullptr;
         }
 
-        const auto it = index_by_name_.find(normalized);
-        if (it == index_by_name_.end())
+        bool empty = true;
+        const auto hash = normalized_name_hash(name, empty);
+        if (empty)
         {
             return nullptr;
         }
 
-        const auto index = it->second;
-        if (index >= records.size())
+        if (indexes_->name_table.present())
         {
-            return nullptr;
+            const auto& table = indexes_->name_table;
+            const auto index = table.lookup(table.key_hash(hash));
+            if (!index || *index >= records.size() || !normalized_names_equal(name_for(records[*index]), name))
+            {
+                return nullptr;
+            }
+            return &records[*index];
         }
 
-        return &records[index];
+        const auto& slots = name_index().by_name;
+        auto it = std::lower_bound(slots.begin(), slots.end(), hash, [](const auto& slot, std::uint64_t value) {
+            return slot.hash < value;
+        });
+
+        // Slots with equal hashes are ordered by record index so the first matching record wins.
+        for (; it != slots.end() && it->hash == hash; ++it)
+        {
+            const auto& record = records[it->index];
+            if (normalized_names_equal(name_for(record), name))
+            {
+                return &record;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool StarCatalog::has_precomputed_indexes() const noexcept
+    {
+        return indexes_ && indexes_->id_table.present() && indexes_->name_table.present();
     }
 
     std::string_view StarCatalog::name_for(const StarCatalogRecord& record) const
     {
-        if (record.name_offset + record.name_length > name_blob_.size())
+        if (static_cast<std::size_t>(record.name_offset) + record.name_length > name_blob_.size())
         {
             return std::string_view{};
         }
 
-        return std::string_view{name_blob_.data() + record.name_offset, record.name_length};
+        return name_blob_.substr(record.name_offset, record.name_length);
     }
 
-    StarCatalog load_star_catalog(std::span<const std::uint8_t> data)
+    StarCatalog StarCatalog::parse(std::shared_ptr<const void> storage, std::span<const std::uint8_t> data, bool mapped)
     {
         if (data.size() < kHeaderSize)
         {
@@ -160,7 +668,9 @@ namespace overlay
 
         const auto* magic_bytes = require_bytes(cursor, end, kMagic.size());
         cursor += kMagic.size();
-        if (std::string_view{reinterpret_cast<const char*>(magic_bytes), kMagic.size()} != kMagic)
+        const std::string_view magic{reinterpret_cast<const char*>(magic_bytes), kMagic.size()};
+        const bool is_v2 = magic == kMagicV2;
+        if (magic != kMagic && !is_v2)
         {
             throw std::runtime_error("Star catalog magic mismatch");
         }
@@ -182,6 +692,11 @@ namespace overlay
             throw std::runtime_error("Star catalog record size unsupported");
         }
 
+        if (is_v2 && version < kFormatVersionV2)
+        {
+            throw std::runtime_error("Star catalog version unsupported");
+        }
+
         StarCatalog catalog;
         catalog.version = version;
         catalog.record_size = record_size;
@@ -202,6 +717,35 @@ namespace overlay
         const auto strings_size = read_le<std::uint32_t>(strings_size_bytes);
         cursor += sizeof(std::uint32_t);
 
+        // EFSTARS2 extends the v1 header with its own size and the locations of the two index sections.
+        std::span<const std::uint8_t> id_section;
+        std::span<const std::uint8_t> name_section;
+        if (is_v2)
+        {
+            const auto* extension = require_bytes(cursor, end, kHeaderSizeV2 - kHeaderSize);
+            const auto header_size = read_le<std::uint32_t>(extension + 0);
+            const auto id_offset = read_le<std::uint32_t>(extension + 4);
+            const auto id_size = read_le<std::uint32_t>(extension + 8);
+            const auto name_offset = read_le<std::uint32_t>(extension + 12);
+            const auto name_size = read_le<std::uint32_t>(extension + 16);
+
+            if (header_size < kHeaderSizeV2 || header_size > data.size())
+            {
+                throw std::runtime_error("Star catalog header size invalid");
+            }
+            if (std::min(id_offset, name_offset) < header_size
+                || static_cast<std::size_t>(id_offset) + id_size > data.size()
+                || static_cast<std::size_t>(name_offset) + name_size > data.size())
+            {
+                throw std::runtime_error("Star catalog index truncated");
+            }
+
+            id_section = data.subspan(id_offset, id_size);
+            name_section = data.subspan(name_offset, name_size);
+            cursor = data.data() + header_size;
+            end = data.data() + std::min(id_offset, name_offset);
+        }
+
         const auto records_bytes = static_cast<std::size_t>(record_size) * static_cast<std::size_t>(star_count);
         const auto* records_ptr = require_bytes(cursor, end, records_bytes);
         cursor += records_bytes;
@@ -209,54 +753,153 @@ namespace overlay
         const auto* strings_ptr = require_bytes(cursor, end, strings_size);
         cursor += strings_size;
 
-        if (cursor != end)
+        // v2 pads the string blob so the index sections start on a four-byte boundary.
+        if (is_v2 ? static_cast<std::size_t>(end - cursor) >= sizeof(std::uint32_t) : cursor != end)
         {
             throw std::runtime_error("Star catalog contains trailing bytes");
         }
 
-        catalog.records.reserve(star_count);
-        catalog.name_blob_.assign(reinterpret_cast<const char*>(strings_ptr), strings_size);
-        catalog.index_by_system_id_.reserve(star_count);
-        catalog.index_by_name_.reserve(star_count);
-
         for (std::uint32_t i = 0; i < star_count; ++i)
         {
             const auto* record_ptr = records_ptr + static_cast<std::size_t>(i) * record_size;
-            StarCatalogRecord record{};
-            record.system_id = read_le<std::uint32_t>(record_ptr + 0);
-            record.region_id = read_le<std::uint32_t>(record_ptr + 4);
-            record.constellation_id = read_le<std::uint32_t>(record_ptr + 8);
-            record.name_offset = read_le<std::uint32_t>(record_ptr + 12);
-            record.name_length = read_le<std::uint16_t>(record_ptr + 16);
-            record.spectral_id = *(record_ptr + 18);
-            record.flags = *(record_ptr + 19);
-            record.position.x = read_le<float>(record_ptr + 20);
-            record.position.y = read_le<float>(record_ptr + 24);
-            record.position.z = read_le<float>(record_ptr + 28);
-            record.security = read_le<float>(record_ptr + 32);
-
-            if (record.name_offset + record.name_length > catalog.name_blob_.size())
+            const auto name_offset = read_le<std::uint32_t>(record_ptr + 12);
+            const auto name_length = read_le<std::uint16_t>(record_ptr + 16);
+            if (static_cast<std::size_t>(name_offset) + name_length > strings_size)
             {
                 throw std::runtime_error("Star catalog name out of range");
             }
+        }
 
-            const auto index = catalog.records.size();
-            catalog.index_by_system_id_[record.system_id] = index;
-            catalog.records.push_back(record);
+        const bool viewable = std::endian::native == std::endian::little
+            && record_size == sizeof(StarCatalogRecord)
+            && reinterpret_cast<std::uintptr_t>(records_ptr) % alignof(StarCatalogRecord) == 0;
 
-            const std::string_view name_view{catalog.name_blob_.data() + record.name_offset, record.name_length};
-            const std::string normalized = normalize_name(name_view);
-            if (!normalized.empty() && catalog.index_by_name_.find(normalized) == catalog.index_by_name_.end())
+        if (viewable)
+        {
+            catalog.records = {reinterpret_cast<const StarCatalogRecord*>(records_ptr), star_count};
+            catalog.storage_ = std::move(storage);
+        }
+        else
+        {
+            auto decoded = std::make_shared<DecodedStorage>();
+            decoded->source = std::move(storage);
+            decoded->records.reserve(star_count);
+            for (std::uint32_t i = 0; i < star_count; ++i)
             {
-                catalog.index_by_name_.emplace(normalized, index);
+                decoded->records.push_back(decode_record(records_ptr + static_cast<std::size_t>(i) * record_size));
             }
+            catalog.records = decoded->records;
+            catalog.storage_ = std::move(decoded);
         }
 
+        catalog.name_blob_ = std::string_view{reinterpret_cast<const char*>(strings_ptr), strings_size};
+        catalog.indexes_ = std::make_shared<LookupIndexes>();
+        if (is_v2)
+        {
+            catalog.indexes_->id_table = parse_perfect_hash(id_section);
+            catalog.indexes_->name_table = parse_perfect_hash(name_section);
+        }
+        catalog.mapped_ = mapped;
         return catalog;
     }
 
+    std::vector<std::uint8_t> serialize_star_catalog_v2(const StarCatalog& catalog)
+    {
+        // Key sets follow the runtime lookup semantics: the record a v1 lookup would return owns the key.
+        std::vector<PerfectHashKey> idKeys;
+        std::vector<PerfectHashKey> nameKeys;
+        idKeys.reserve(catalog.records.size());
+        nameKeys.reserve(catalog.records.size());
+        for (std::size_t i = 0; i < catalog.records.size(); ++i)
+        {
+            const auto& record = catalog.records[i];
+            if (catalog.find_by_system_id(record.system_id) == &record)
+            {
+                idKeys.push_back(PerfectHashKey{record.system_id, static_cast<std::uint32_t>(i)});
+            }
+
+            const auto name = catalog.name_for(record);
+            bool empty = true;
+            const auto nameHash = normalized_name_hash(name, empty);
+            if (!empty && catalog.find_by_name(name) == &record)
+            {
+                nameKeys.push_back(PerfectHashKey{nameHash, static_cast<std::uint32_t>(i)});
+            }
+        }
+
+        const auto idSection = build_perfect_hash(idKeys);
+        const auto nameSection = build_perfect_hash(nameKeys);
+
+        std::vector<std::uint8_t> buffer;
+        auto append_bytes = [&buffer](const void* data, std::size_t count) {
+            const auto* ptr = static_cast<const std::uint8_t*>(data);
+            buffer.insert(buffer.end(), ptr, ptr + count);
+        };
+        auto append_u16 = [&append_bytes](std::uint16_t value) { append_bytes(&value, sizeof(value)); };
+        auto append_u32 = [&append_bytes](std::uint32_t value) { append_bytes(&value, sizeof(value)); };
+        auto append_f32 = [&append_bytes](float value) { append_bytes(&value, sizeof(value)); };
+
+        const auto records_bytes = catalog.records.size() * kPackedRecordSize;
+        const auto strings_end = kHeaderSizeV2 + records_bytes + catalog.name_blob_.size();
+        const auto id_offset = (strings_end + 3) & ~static_cast<std::size_t>(3);
+        const auto name_offset = id_offset + idSection.size();
+        buffer.reserve(name_offset + nameSection.size());
+
+        append_bytes(kMagicV2.data(), kMagicV2.size());
+        append_u16(kFormatVersionV2);
+        append_u16(static_cast<std::uint16_t>(kPackedRecordSize));
+        append_u32(static_cast<std::uint32_t>(catalog.records.size()));
+        append_f32(catalog.bbox_min.x);
+        append_f32(catalog.bbox_min.y);
+        append_f32(catalog.bbox_min.z);
+        append_f32(catalog.bbox_max.x);
+        append_f32(catalog.bbox_max.y);
+        append_f32(catalog.bbox_max.z);
+        append_u32(static_cast<std::uint32_t>(catalog.name_blob_.size()));
+        append_u32(static_cast<std::uint32_t>(kHeaderSizeV2));
+        append_u32(static_cast<std::uint32_t>(id_offset));
+        append_u32(static_cast<std::uint32_t>(idSection.size()));
+        append_u32(static_cast<std::uint32_t>(name_offset));
+        append_u32(static_cast<std::uint32_t>(nameSection.size()));
+
+        for (const auto& record : catalog.records)
+        {
+            append_u32(record.system_id);
+            append_u32(record.region_id);
+            append_u32(record.constellation_id);
+            append_u32(record.name_offset);
+            append_u16(record.name_length);
+            append_bytes(&record.spectral_id, sizeof(record.spectral_id));
+            append_bytes(&record.flags, sizeof(record.flags));
+            append_f32(record.position.x);
+            append_f32(record.position.y);
+            append_f32(record.position.z);
+            append_f32(record.security);
+        }
+
+        append_bytes(catalog.name_blob_.data(), catalog.name_blob_.size());
+        buffer.resize(id_offset, 0);
+        append_bytes(idSection.data(), idSection.size());
+        append_bytes(nameSection.data(), nameSection.size());
+        return buffer;
+    }
+
+    StarCatalog load_star_catalog(std::span<const std::uint8_t> data)
+    {
+        auto buffer = std::make_shared<std::vector<std::uint8_t>>(data.begin(), data.end());
+        const std::span<const std::uint8_t> bytes{*buffer};
+        return StarCatalog::parse(std::move(buffer), bytes, false);
+    }
+
     StarCatalog load_star_catalog_from_file(const std::filesystem::path& path)
     {
+        auto mapped = std::make_shared<MappedFile>();
+        if (mapped->open(path))
+        {
+            const auto bytes = mapped->bytes();
+            return StarCatalog::parse(std::move(mapped), bytes, true);
+        }
+
         std::ifstream stream(path, std::ios::binary);
         if (!stream)
         {
@@ -271,12 +914,13 @@ namespace overlay
         }
         stream.seekg(0, std::ios::beg);
 
-        std::vector<std::uint8_t> buffer(static_cast<std::size_t>(size));
-        if (!stream.read(reinterpret_cast<char*>(buffer.data()), size))
+        auto buffer = std::make_shared<std::vector<std::uint8_t>>(static_cast<std::size_t>(size));
+        if (!stream.read(reinterpret_cast<char*>(buffer->data()), size))
         {
             throw std::runtime_error("Failed to read star catalog file: " + path.string());
         }
 
-        return load_star_catalog(buffer);
+        const std::span<const std::uint8_t> bytes{*buffer};
+        return StarCatalog::parse(std::move(buffer), bytes, false);
     }
 }
@@ -4,14 +4,17 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <span>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <vector>
 
 namespace overlay
 {
+    class StarSpatialIndex;
+
+    // Matches the packed 36-byte on-disk record so mapped catalogs can be viewed in place.
     struct StarCatalogRecord
     {
         std::uint32_t system_id{0};
@@ -25,6 +28,8 @@ namespace overlay
         float security{0.0f};
     };
 
+    static_assert(sizeof(StarCatalogRecord) == 36, "StarCatalogRecord must match the packed catalog record layout");
+
     class StarCatalog
     {
     public:
@@ -32,24 +37,44 @@ namespace overlay
         std::uint16_t record_size{0};
         Vec3f bbox_min{};
         Vec3f bbox_max{};
-        std::vector<StarCatalogRecord> records;
+        // Views either the mapped catalog file or an owned copy; valid for the lifetime of the catalog.
+        std::span<const StarCatalogRecord> records;
 
         [[nodiscard]] std::size_t size() const noexcept { return records.size(); }
         [[nodiscard]] bool empty() const noexcept { return records.empty(); }
+        [[nodiscard]] bool is_mapped() const noexcept { return mapped_; }
+        [[nodiscard]] bool has_precomputed_indexes() const noexcept;
 
         [[nodiscard]] const StarCatalogRecord* find_by_system_id(std::uint32_t system_id) const;
         [[nodiscard]] const StarCatalogRecord* find_by_name(std::string_view name) const;
         [[nodiscard]] std::string_view name_for(const StarCatalogRecord& record) const;
 
+        // k-d tree over record positions (see star_spatial_index.hpp), built on first use and shared by copies.
+        [[nodiscard]] const StarSpatialIndex& spatial_index() const;
+
     private:
+        struct LookupIndexes;
+
         friend StarCatalog load_star_catalog(std::span<const std::uint8_t> data);
         friend StarCatalog load_star_catalog_from_file(const std::filesystem::path& path);
+        friend std::vector<std::uint8_t> serialize_star_catalog_v2(const StarCatalog& catalog);
 
-        std::string name_blob_;
-        std::unordered_map<std::uint32_t, std::size_t> index_by_system_id_;
-        std::unordered_map<std::string, std::size_t> index_by_name_;
+        [[nodiscard]] static StarCatalog parse(std::shared_ptr<const void> storage, std::span<const std::uint8_t> data, bool mapped);
+        [[nodiscard]] const LookupIndexes& id_index() const;
+        [[nodiscard]] const LookupIndexes& name_index() const;
+
+        std::shared_ptr<const void> storage_;
+        std::shared_ptr<LookupIndexes> indexes_;
+        std::string_view name_blob_;
+        bool mapped_{false};
     };
 
+    // Parses an EFSTARS1 or EFSTARS2 image from a single copy of `data`; v2 lookup tables are used as stored.
     [[nodiscard]] StarCatalog load_star_catalog(std::span<const std::uint8_t> data);
+
+    // Maps the file read-only and views records and names in place. Lookup indexes are built on first use.
     [[nodiscard]] StarCatalog load_star_catalog_from_file(const std::filesystem::path& path);
+
+    // Encodes a loaded catalog (either format) as EFSTARS2, computing both perfect hash tables.
+    [[nodiscard]] std::vector<std::uint8_t> serialize_star_catalog_v2(const StarCatalog& catalog);
 }
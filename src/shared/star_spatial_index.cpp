@@ -0,0 +1,392 @@
+#include "star_spatial_index.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace overlay
+{
+    namespace
+    {
+        constexpr std::size_t kLeafSize = 8;
+        constexpr std::size_t kMaxDepth = 64;
+
+        float component(const Vec3f& value, std::uint8_t axis)
+        {
+            return axis == 0 ? value.x : (axis == 1 ? value.y : value.z);
+        }
+
+        float& component(Vec3f& value, std::uint8_t axis)
+        {
+            return axis == 0 ? value.x : (axis == 1 ? value.y : value.z);
+        }
+
+        float distance_sq(const Vec3f& lhs, const Vec3f& rhs)
+        {
+            const float dx = lhs.x - rhs.x;
+            const float dy = lhs.y - rhs.y;
+            const float dz = lhs.z - rhs.z;
+            return dx * dx + dy * dy + dz * dz;
+        }
+
+        bool inside_box(const Vec3f& point, const Vec3f& min, const Vec3f& max)
+        {
+            return point.x >= min.x && point.x <= max.x
+                && point.y >= min.y && point.y <= max.y
+                && point.z >= min.z && point.z <= max.z;
+        }
+
+        float plane_distance(const ClipPlane& plane, const Vec3f& point)
+        {
+            return plane.normal.x * point.x + plane.normal.y * point.y + plane.normal.z * point.z + plane.offset;
+        }
+
+        enum class Overlap
+        {
+            Outside,
+            Partial,
+            Inside
+        };
+
+        Overlap classify_box(std::span<const ClipPlane> planes, const Vec3f& min, const Vec3f& max)
+        {
+            bool fullyInside = true;
+            for (const auto& plane : planes)
+            {
+                const Vec3f positive{
+                    plane.normal.x >= 0.0f ? max.x : min.x,
+                    plane.normal.y >= 0.0f ? max.y : min.y,
+                    plane.normal.z >= 0.0f ? max.z : min.z};
+                if (plane_distance(plane, positive) < 0.0f)
+                {
+                    return Overlap::Outside;
+                }
+
+                const Vec3f negative{
+                    plane.normal.x >= 0.0f ? min.x : max.x,
+                    plane.normal.y >= 0.0f ? min.y : max.y,
+                    plane.normal.z >= 0.0f ? min.z : max.z};
+                if (plane_distance(plane, negative) < 0.0f)
+                {
+                    fullyInside = false;
+                }
+            }
+            return fullyInside ? Overlap::Inside : Overlap::Partial;
+        }
+
+        bool inside_planes(std::span<const ClipPlane> planes, const Vec3f& point)
+        {
+            return std::all_of(planes.begin(), planes.end(), [&point](const ClipPlane& plane) {
+                return plane_distance(plane, point) >= 0.0f;
+            });
+        }
+
+        struct Range
+        {
+            std::size_t lo{0};
+            std::size_t hi{0};
+        };
+
+        struct BoundedRange
+        {
+            std::size_t lo{0};
+            std::size_t hi{0};
+            Vec3f min{};
+            Vec3f max{};
+        };
+    }
+
+    StarSpatialIndex::StarSpatialIndex(std::span<const StarCatalogRecord> records)
+    {
+        if (records.empty())
+        {
+            return;
+        }
+
+        entries_.reserve(records.size());
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            entries_.push_back(Entry{records[i].position, static_cast<std::uint32_t>(i)});
+        }
+        split_axes_.assign(records.size(), 0);
+
+        bounds_min_ = bounds_max_ = entries_.front().position;
+        for (const auto& [position, recordIndex] : entries_)
+        {
+            bounds_min_ = Vec3f{std::min(bounds_min_.x, position.x), std::min(bounds_min_.y, position.y), std::min(bounds_min_.z, position.z)};
+            bounds_max_ = Vec3f{std::max(bounds_max_.x, position.x), std::max(bounds_max_.y, position.y), std::max(bounds_max_.z, position.z)};
+        }
+
+        build(0, entries_.size());
+    }
+
+    void StarSpatialIndex::build(std::size_t lo, std::size_t hi)
+    {
+        if (hi - lo <= kLeafSize)
+        {
+            return;
+        }
+
+        Vec3f min = entries_[lo].position;
+        Vec3f max = entries_[lo].position;
+        for (std::size_t i = lo + 1; i < hi; ++i)
+        {
+            const auto& p = entries_[i].position;
+            min = Vec3f{std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z)};
+            max = Vec3f{std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z)};
+        }
+
+        const float extentX = max.x - min.x;
+        const float extentY = max.y - min.y;
+        const float extentZ = max.z - min.z;
+        const std::uint8_t axis = (extentX >= extentY && extentX >= extentZ) ? 0 : (extentY >= extentZ ? 1 : 2);
+
+        const auto mid = lo + (hi - lo) / 2;
+        const auto begin = entries_.begin();
+        std::nth_element(begin + static_cast<std::ptrdiff_t>(lo), begin + static_cast<std::ptrdiff_t>(mid), begin + static_cast<std::ptrdiff_t>(hi), [axis](const Entry& lhs, const Entry& rhs) {
+            return component(lhs.position, axis) < component(rhs.position, axis);
+        });
+
+        split_axes_[mid] = axis;
+        build(lo, mid);
+        build(mid + 1, hi);
+    }
+
+    void StarSpatialIndex::query_radius(const Vec3f& center, float radius, std::vector<StarNeighbor>& out) const
+    {
+        if (entries_.empty() || !(radius >= 0.0f))
+        {
+            return;
+        }
+
+        const float radiusSq = radius * radius;
+        std::array<Range, kMaxDepth> stack{};
+        std::size_t depth = 0;
+        stack[depth++] = Range{0, entries_.size()};
+
+        while (depth > 0)
+        {
+            const auto range = stack[--depth];
+            if (range.hi - range.lo <= kLeafSize)
+            {
+                for (std::size_t i = range.lo; i < range.hi; ++i)
+                {
+                    const float d = distance_sq(center, entries_[i].position);
+                    if (d <= radiusSq)
+                    {
+                        out.push_back(StarNeighbor{entries_[i].record_index, d});
+                    }
+                }
+                continue;
+            }
+
+            const auto mid = range.lo + (range.hi - range.lo) / 2;
+            const float d = distance_sq(center, entries_[mid].position);
+            if (d <= radiusSq)
+            {
+                out.push_back(StarNeighbor{entries_[mid].record_index, d});
+            }
+
+            const float delta = component(center, split_axes_[mid]) - component(entries_[mid].position, split_axes_[mid]);
+            const Range left{range.lo, mid};
+            const Range right{mid + 1, range.hi};
+            if (delta <= radius)
+            {
+                stack[depth++] = left;
+            }
+            if (delta >= -radius)
+            {
+                stack[depth++] = right;
+            }
+        }
+    }
+
+    std::vector<StarNeighbor> StarSpatialIndex::nearest(const Vec3f& point, std::size_t k, float max_radius) const
+    {
+        std::vector<StarNeighbor> heap;
+        if (entries_.empty() || k == 0)
+        {
+            return heap;
+        }
+
+        heap.reserve(std::min(k, entries_.size()));
+        const auto farther = [](const StarNeighbor& lhs, const StarNeighbor& rhs) {
+            return lhs.distance_sq < rhs.distance_sq;
+        };
+        const float limitSq = max_radius * max_radius;
+        auto worst = [&]() {
+            return heap.size() < k ? limitSq : heap.front().distance_sq;
+        };
+        auto consider = [&](std::size_t i) {
+            const float d = distance_sq(point, entries_[i].position);
+            if (d > worst() || (d == worst() && heap.size() == k))
+            {
+                return;
+            }
+            if (heap.size() == k)
+            {
+                std::pop_heap(heap.begin(), heap.end(), farther);
+                heap.pop_back();
+            }
+            heap.push_back(StarNeighbor{entries_[i].record_index, d});
+            std::push_heap(heap.begin(), heap.end(), farther);
+        };
+
+        // Each frame carries a lower bound on the squared distance from `point` to anything in its range.
+        struct Frame
+        {
+            Range range;
+            float bound_sq{0.0f};
+        };
+        std::array<Frame, kMaxDepth> stack{};
+        std::size_t depth = 0;
+        stack[depth++] = Frame{Range{0, entries_.size()}, 0.0f};
+
+        while (depth > 0)
+        {
+            const auto frame = stack[--depth];
+            if (frame.bound_sq > worst())
+            {
+                continue;
+            }
+
+            const auto& range = frame.range;
+            if (range.hi - range.lo <= kLeafSize)
+            {
+                for (std::size_t i = range.lo; i < range.hi; ++i)
+                {
+                    consider(i);
+                }
+                continue;
+            }
+
+            const auto mid = range.lo + (range.hi - range.lo) / 2;
+            consider(mid);
+
+            const float delta = component(point, split_axes_[mid]) - component(entries_[mid].position, split_axes_[mid]);
+            const Range left{range.lo, mid};
+            const Range right{mid + 1, range.hi};
+            const Range& nearSide = delta <= 0.0f ? left : right;
+            const Range& farSide = delta <= 0.0f ? right : left;
+
+            // Push the far side first so the near side is explored first and tightens the bound.
+            stack[depth++] = Frame{farSide, std::max(frame.bound_sq, delta * delta)};
+            stack[depth++] = Frame{nearSide, frame.bound_sq};
+        }
+
+        std::sort_heap(heap.begin(), heap.end(), farther);
+        return heap;
+    }
+
+    std::optional<StarNeighbor> StarSpatialIndex::nearest(const Vec3f& point) const
+    {
+        const auto result = nearest(point, 1);
+        if (result.empty())
+        {
+            return std::nullopt;
+        }
+        return result.front();
+    }
+
+    void StarSpatialIndex::query_box(const Vec3f& min, const Vec3f& max, std::vector<std::uint32_t>& out) const
+    {
+        if (entries_.empty())
+        {
+            return;
+        }
+
+        std::array<Range, kMaxDepth> stack{};
+        std::size_t depth = 0;
+        stack[depth++] = Range{0, entries_.size()};
+
+        while (depth > 0)
+        {
+            const auto range = stack[--depth];
+            if (range.hi - range.lo <= kLeafSize)
+            {
+                for (std::size_t i = range.lo; i < range.hi; ++i)
+                {
+                    if (inside_box(entries_[i].position, min, max))
+                    {
+                        out.push_back(entries_[i].record_index);
+                    }
+                }
+                continue;
+            }
+
+            const auto mid = range.lo + (range.hi - range.lo) / 2;
+            if (inside_box(entries_[mid].position, min, max))
+            {
+                out.push_back(entries_[mid].record_index);
+            }
+
+            const auto axis = split_axes_[mid];
+            const float split = component(entries_[mid].position, axis);
+            if (component(min, axis) <= split)
+            {
+                stack[depth++] = Range{range.lo, mid};
+            }
+            if (component(max, axis) >= split)
+            {
+                stack[depth++] = Range{mid + 1, range.hi};
+            }
+        }
+    }
+
+    void StarSpatialIndex::query_frustum(std::span<const ClipPlane> planes, std::vector<std::uint32_t>& out) const
+    {
+        if (entries_.empty())
+        {
+            return;
+        }
+
+        std::array<BoundedRange, kMaxDepth> stack{};
+        std::size_t depth = 0;
+        stack[depth++] = BoundedRange{0, entries_.size(), bounds_min_, bounds_max_};
+
+        while (depth > 0)
+        {
+            const auto node = stack[--depth];
+            const auto overlap = classify_box(planes, node.min, node.max);
+            if (overlap == Overlap::Outside)
+            {
+                continue;
+            }
+
+            if (overlap == Overlap::Inside)
+            {
+                for (std::size_t i = node.lo; i < node.hi; ++i)
+                {
+                    out.push_back(entries_[i].record_index);
+                }
+                continue;
+            }
+
+            if (node.hi - node.lo <= kLeafSize)
+            {
+                for (std::size_t i = node.lo; i < node.hi; ++i)
+                {
+                    if (inside_planes(planes, entries_[i].position))
+                    {
+                        out.push_back(entries_[i].record_index);
+                    }
+                }
+                continue;
+            }
+
+            const auto mid = node.lo + (node.hi - node.lo) / 2;
+            if (inside_planes(planes, entries_[mid].position))
+            {
+                out.push_back(entries_[mid].record_index);
+            }
+
+            const auto axis = split_axes_[mid];
+            const float split = component(entries_[mid].position, axis);
+            BoundedRange left{node.lo, mid, node.min, node.max};
+            component(left.max, axis) = split;
+            BoundedRange right{mid + 1, node.hi, node.min, node.max};
+            component(right.min, axis) = split;
+            stack[depth++] = left;
+            stack[depth++] = right;
+        }
+    }
+}
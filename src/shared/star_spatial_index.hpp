@@ -0,0 +1,66 @@
+#pragma once
+
+#include "star_catalog.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace overlay
+{
+    struct StarNeighbor
+    {
+        std::uint32_t record_index{0};
+        float distance_sq{0.0f};
+    };
+
+    // Half-space used by frustum queries; a point is inside when dot(normal, p) + offset >= 0.
+    struct ClipPlane
+    {
+        Vec3f normal{};
+        float offset{0.0f};
+    };
+
+    // Implicit k-d tree over catalog positions (catalog units are light-years). Points are stored in tree order
+    // in one contiguous array, so there are no node allocations and traversal walks memory mostly forwards.
+    // Queries return indices into StarCatalog::records and never allocate beyond growing the caller's output.
+    class StarSpatialIndex
+    {
+    public:
+        StarSpatialIndex() = default;
+        explicit StarSpatialIndex(std::span<const StarCatalogRecord> records);
+
+        [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+        [[nodiscard]] bool empty() const noexcept { return entries_.empty(); }
+
+        // Appends every star within `radius` of `center` (unordered).
+        void query_radius(const Vec3f& center, float radius, std::vector<StarNeighbor>& out) const;
+
+        // Returns up to `k` stars nearest to `point`, closest first, optionally limited to `max_radius`.
+        [[nodiscard]] std::vector<StarNeighbor> nearest(const Vec3f& point, std::size_t k, float max_radius = std::numeric_limits<float>::infinity()) const;
+        [[nodiscard]] std::optional<StarNeighbor> nearest(const Vec3f& point) const;
+
+        // Appends every star inside the axis-aligned box [min, max].
+        void query_box(const Vec3f& min, const Vec3f& max, std::vector<std::uint32_t>& out) const;
+
+        // Appends every star inside the convex volume bounded by `planes` (e.g. the six view-frustum planes).
+        void query_frustum(std::span<const ClipPlane> planes, std::vector<std::uint32_t>& out) const;
+
+    private:
+        struct Entry
+        {
+            Vec3f position{};
+            std::uint32_t record_index{0};
+        };
+
+        void build(std::size_t lo, std::size_t hi);
+
+        std::vector<Entry> entries_;
+        std::vector<std::uint8_t> split_axes_;
+        Vec3f bounds_min_{};
+        Vec3f bounds_max_{};
+    };
+}
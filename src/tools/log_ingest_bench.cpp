@@ -0,0 +1,209 @@
+// Measures chat log ingestion (UTF-16LE to UTF-8 and line splitting) at each SIMD level the CPU supports:
+// the kernels on an in-memory buffer, then LogTailReader end to end on a file.
+//
+//   ef-log-ingest-bench [--megabytes N] [--iterations N] [chatlog.txt]
+//
+// Without a file it writes a synthetic UTF-16LE chat log with a sprinkling of non-ASCII names to the temp
+// directory. All levels must produce the same lines.
+
+#include "helper/log_tail_reader.hpp"
+#include "helper/text_simd.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using helper::logs::TextSimdLevel;
+
+    void append_utf16(std::string& out, std::u16string_view text)
+    {
+        for (const auto unit : text)
+        {
+            out.push_back(static_cast<char>(unit & 0xFF));
+            out.push_back(static_cast<char>(unit >> 8));
+        }
+    }
+
+    std::string synthetic_chat_log(std::size_t bytes)
+    {
+        const std::u16string speakers[] = {u"Keeper", u"Bench Pilot", u"Jörmungandr", u"Małgorzata", u"小明"};
+        const std::u16string messages[] = {
+            u"Channel changed to Local : E78-F12",
+            u"anyone selling feldspar near the gate? paying well",
+            u"o7 fly safe",
+            u"the smartgate in this system is offline again, route around it \U0001F680",
+            u"Pirate frigate on scan, 3 jumps out, heading for the station",
+        };
+
+        std::string log("\xFF\xFE");
+        for (std::size_t i = 0; log.size() < bytes; ++i)
+        {
+            const auto second = std::to_string(10 + i % 50);
+            append_utf16(log, u"[ 2025.10.13 18:30:");
+            append_utf16(log, std::u16string(second.begin(), second.end()));
+            append_utf16(log, u" ] ");
+            append_utf16(log, speakers[i % std::size(speakers)]);
+            append_utf16(log, u" > ");
+            append_utf16(log, messages[i % std::size(messages)]);
+            append_utf16(log, u"\r\n");
+        }
+        return log;
+    }
+
+    // Converts and splits in memory the way LogTailReader does, without the file or the non-ASCII decoding.
+    std::uint64_t kernel_pass(const std::string& log, std::string& text)
+    {
+        const auto units = (log.size() - 2) / 2;
+        text.resize(units);
+        std::size_t index = 0;
+        std::size_t written = 0;
+        while (index < units)
+        {
+            const auto ascii = helper::logs::ascii_utf16le_to_utf8(log.data() + 2 + 2 * index, units - index, text.data() + written);
+            written += ascii;
+            index += ascii;
+            if (index < units)
+            {
+                text[written++] = '?';
+                ++index;
+            }
+        }
+
+        std::uint64_t lines = 0;
+        for (std::size_t position = 0; position < written;)
+        {
+            position += helper::logs::find_line_break(text.data() + position, written - position);
+            position += position + 1 < written && text[position] == '\r' && text[position + 1] == '\n' ? 2 : 1;
+            ++lines;
+        }
+        return lines;
+    }
+
+    std::uint64_t reader_pass(const std::filesystem::path& path, std::uint64_t& checksum)
+    {
+        helper::logs::LogTailReader reader;
+        reader.reset(path);
+        std::uint64_t lines = 0;
+        reader.readLines([&](std::string_view line) {
+            ++lines;
+            checksum = checksum * 1099511628211ULL ^ std::hash<std::string_view>{}(line);
+        });
+        return lines;
+    }
+
+    double megabytes_per_second(std::size_t bytes, std::size_t iterations, Clock::duration elapsed)
+    {
+        return static_cast<double>(bytes * iterations) / (1024.0 * 1024.0) / std::chrono::duration<double>(elapsed).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t megabytes = 32;
+    std::size_t iterations = 5;
+    std::filesystem::path input;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--megabytes" && i + 1 < argc)
+        {
+            megabytes = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--iterations" && i + 1 < argc)
+        {
+            iterations = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            input = arg;
+        }
+    }
+    if (iterations == 0 || megabytes == 0)
+    {
+        std::cerr << "[error] Usage: ef-log-ingest-bench [--megabytes N] [--iterations N] [chatlog.txt]" << std::endl;
+        return 1;
+    }
+
+    std::string log;
+    std::filesystem::path path = input;
+    if (input.empty())
+    {
+        log = synthetic_chat_log(megabytes * 1024 * 1024);
+        path = std::filesystem::temp_directory_path() / "ef_log_ingest_bench.txt";
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(log.data(), static_cast<std::streamsize>(log.size()));
+    }
+    else
+    {
+        std::ifstream in(path, std::ios::binary);
+        log.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    if (log.size() < 2 || static_cast<unsigned char>(log[0]) != 0xFF || static_cast<unsigned char>(log[1]) != 0xFE)
+    {
+        std::cerr << "[error] " << path.string() << " is not a UTF-16LE chat log" << std::endl;
+        return 1;
+    }
+
+    std::cout << "[info] " << log.size() / (1024 * 1024) << " MiB x " << iterations << " iterations, best level "
+              << helper::logs::text_simd_level_name(helper::logs::supported_text_simd_level()) << std::endl;
+
+    bool consistent = true;
+    std::uint64_t expectedChecksum = 0;
+    std::string text;
+    for (const auto level : {TextSimdLevel::Scalar, TextSimdLevel::Sse2, TextSimdLevel::Avx2})
+    {
+        if (level > helper::logs::supported_text_simd_level())
+        {
+            break;
+        }
+        helper::logs::set_text_simd_level(level);
+
+        std::uint64_t kernelLines = 0;
+        auto start = Clock::now();
+        for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            kernelLines += kernel_pass(log, text);
+        }
+        const auto kernelElapsed = Clock::now() - start;
+
+        std::uint64_t readerLines = 0;
+        std::uint64_t checksum = 0;
+        start = Clock::now();
+        for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            checksum = 0;
+            readerLines += reader_pass(path, checksum);
+        }
+        const auto readerElapsed = Clock::now() - start;
+
+        if (level == TextSimdLevel::Scalar)
+        {
+            expectedChecksum = checksum;
+        }
+        else if (checksum != expectedChecksum)
+        {
+            std::cerr << "[warn] " << helper::logs::text_simd_level_name(level) << " produced different lines than scalar" << std::endl;
+            consistent = false;
+        }
+
+        std::cout << "[info] " << helper::logs::text_simd_level_name(level) << ": kernels " << megabytes_per_second(log.size(), iterations, kernelElapsed)
+                  << " MB/s (" << kernelLines / iterations << " lines), reader " << megabytes_per_second(log.size(), iterations, readerElapsed) << " MB/s ("
+                  << readerLines / iterations << " lines)" << std::endl;
+    }
+
+    if (input.empty())
+    {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Compares the single-pass game log parsers with the previous ones (log_parser_bench_legacy.cpp) on a log
+// corpus: time per line, heap allocations per line, and any line where the two disagree.
+//
+//   ef-log-parser-bench [--iterations N] [gamelog-or-chatlog.txt ...]
+//
+// Without files it runs on a synthetic corpus shaped like a combat and mining session. Recorded logs from
+// Documents\Frontier\logs\Gamelogs (or Chatlogs) give the numbers that matter.
+
+#include "log_parser_bench_legacy.hpp"
+
+#include "helper/log_parsers.hpp"
+#include "helper/log_tail_reader.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::atomic<std::uint64_t> g_allocations{0};
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size != 0 ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::string> synthetic_corpus(std::size_t lines)
+    {
+        const std::vector<std::string> names{"Feral Drone", "Pirate Frigate", "Rogue Harvester [RGH](Wend)", "Keeper Sentinel"};
+        const std::vector<std::string> weapons{"Light Laser", "250mm Railgun I", "Rapid Autocannon"};
+        const std::vector<std::string> qualities{"Hits", "Glances Off", "Penetrates", "Smashes"};
+        const std::vector<std::string> ores{"Feldspar Crystals", "Veldspar", "Hydrated Sulfide Matrix"};
+
+        std::vector<std::string> corpus{
+            "------------------------------------------------------------",
+            "  Gamelog",
+            "  Listener: Bench Pilot",
+            "  Session Started: 2025.10.13 18:00:00",
+            "------------------------------------------------------------",
+        };
+        for (std::size_t i = 0; corpus.size() < lines; ++i)
+        {
+            const auto minute = std::to_string(10 + i / 60 % 50);
+            const auto second = std::to_string(10 + i % 50);
+            const auto stamp = "[ 2025.10.13 18:" + minute + ":" + second + " ] ";
+            const auto& name = names[i % names.size()];
+            const auto& weapon = weapons[i % weapons.size()];
+            const auto amount = std::to_string(20 + i * 37 % 900);
+            switch (i % 10)
+            {
+            case 0:
+            case 1:
+            case 2:
+                corpus.push_back(stamp + "(combat) <color=0xff00ffff><b>" + amount + "</b> <color=0x77ffffff><font size=10>to</font> <b><color=0xffffffff>" +
+                                 name + "</b><font size=10><color=0x77ffffff> - " + weapon + " - " + qualities[i % qualities.size()]);
+                break;
+            case 3:
+            case 4:
+                corpus.push_back(stamp + "(combat) <color=0xffcc0000><b>" + amount + "</b> <color=0x77ffffff><font size=10>from</font> <b><color=0xffffffff>" +
+                                 name + "</b><font size=10><color=0x77ffffff> - " + qualities[(i + 1) % qualities.size()]);
+                break;
+            case 5:
+                corpus.push_back(stamp + "(combat) Your " + weapon + " misses " + name + " completely - " + weapon);
+                break;
+            case 6:
+                corpus.push_back(stamp + "(mining) You mined <color=0xff8dc169>" + amount + "</color> units of <color=0xffffffff><font size=12>" +
+                                 ores[i % ores.size()] + "</font></color> worth " + std::to_string(i % 90 + 1) + ".5 m3.");
+                break;
+            case 7:
+                corpus.push_back(stamp + "(notify) Your cargo hold is " + std::to_string(i % 100) + "% full.");
+                break;
+            case 8:
+                corpus.push_back(stamp + "(hint) Attempting to join a channel");
+                break;
+            default:
+                corpus.push_back(stamp + "Keeper > Channel changed to Local : E78-F" + std::to_string(i % 90 + 10));
+                break;
+            }
+        }
+        return corpus;
+    }
+
+    bool load_log(const std::string& path, std::vector<std::string>& corpus)
+    {
+        helper::logs::LogTailReader reader;
+        reader.reset(path);
+        return reader.readLines([&](std::string_view line) {
+            corpus.emplace_back(line);
+        });
+    }
+
+    bool same_event(const std::optional<helper::logs::CombatDamageEvent>& expected, bool parsed, const helper::logs::CombatDamageEvent& actual)
+    {
+        if (!expected)
+        {
+            return !parsed;
+        }
+        return parsed && expected->playerDealt == actual.playerDealt && expected->amount == actual.amount &&
+               expected->counterparty == actual.counterparty && expected->quality == actual.quality && expected->timestamp == actual.timestamp;
+    }
+
+    bool same_event(const std::optional<helper::logs::MiningYieldEvent>& expected, bool parsed, const helper::logs::MiningYieldEvent& actual)
+    {
+        if (!expected)
+        {
+            return !parsed;
+        }
+        return parsed && expected->volumeM3 == actual.volumeM3 && expected->resource == actual.resource && expected->timestamp == actual.timestamp;
+    }
+
+    struct PassResult
+    {
+        double nsPerLine{0.0};
+        double allocationsPerLine{0.0};
+        std::uint64_t events{0};
+    };
+
+    template <typename ParseLine>
+    PassResult run_pass(const std::vector<std::string>& corpus, std::size_t iterations, ParseLine&& parseLine)
+    {
+        PassResult result;
+        const auto allocationsBefore = g_allocations.load();
+        const auto start = Clock::now();
+        for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (const auto& line : corpus)
+            {
+                result.events += parseLine(std::string_view(line));
+            }
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        const auto lines = static_cast<double>(corpus.size() * iterations);
+        result.nsPerLine = elapsed / lines;
+        result.allocationsPerLine = static_cast<double>(g_allocations.load() - allocationsBefore) / lines;
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t iterations = 20;
+    std::vector<std::string> corpus;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc)
+        {
+            iterations = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (!load_log(arg, corpus))
+        {
+            std::cerr << "[error] Unable to read " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (iterations == 0)
+    {
+        std::cerr << "[error] Usage: ef-log-parser-bench [--iterations N] [log files...]" << std::endl;
+        return 1;
+    }
+    if (corpus.empty())
+    {
+        corpus = synthetic_corpus(20000);
+    }
+
+    // Both sides must produce the same events before their timings mean anything.
+    std::size_t mismatches = 0;
+    {
+        helper::logs::CombatDamageEvent combat;
+        helper::logs::MiningYieldEvent mining;
+        for (const auto& line : corpus)
+        {
+            const auto classified = helper::logs::classify_game_log_line(line);
+            const bool combatParsed = helper::logs::parse_combat_damage_line(classified, combat);
+            const bool miningParsed = helper::logs::parse_mining_yield_line(classified, mining);
+            const auto expectedChat = legacy::parse_local_chat_line(line);
+            const auto chat = helper::logs::parse_local_chat_line(line);
+            const bool chatMatches = expectedChat.has_value() == chat.has_value() && (!chat || expectedChat->systemName == chat->systemName);
+            if (!same_event(legacy::parse_combat_damage_line(line), combatParsed, combat) ||
+                !same_event(legacy::parse_mining_yield_line(line), miningParsed, mining) || !chatMatches)
+            {
+                if (++mismatches <= 5)
+                {
+                    std::cerr << "[warn] parsers disagree on: " << line << std::endl;
+                }
+            }
+        }
+    }
+
+    const auto legacyResult = run_pass(corpus, iterations, [](std::string_view line) {
+        return static_cast<std::uint64_t>(legacy::parse_combat_damage_line(line).has_value()) +
+               static_cast<std::uint64_t>(legacy::parse_mining_yield_line(line).has_value()) +
+               static_cast<std::uint64_t>(legacy::parse_local_chat_line(line).has_value());
+    });
+
+    helper::logs::CombatDamageEvent combat;
+    helper::logs::MiningYieldEvent mining;
+    const auto currentResult = run_pass(corpus, iterations, [&](std::string_view line) {
+        const auto classified = helper::logs::classify_game_log_line(line);
+        return static_cast<std::uint64_t>(helper::logs::parse_combat_damage_line(classified, combat)) +
+               static_cast<std::uint64_t>(helper::logs::parse_mining_yield_line(classified, mining)) +
+               static_cast<std::uint64_t>(helper::logs::parse_local_chat_line(line).has_value());
+    });
+
+    std::cout << "[info] " << corpus.size() << " lines x " << iterations << " iterations, " << mismatches << " disagreements" << std::endl;
+    std::cout << "[info] legacy:  " << legacyResult.nsPerLine << " ns/line, " << legacyResult.allocationsPerLine << " allocations/line" << std::endl;
+    std::cout << "[info] current: " << currentResult.nsPerLine << " ns/line, " << currentResult.allocationsPerLine << " allocations/line" << std::endl;
+    std::cout << "[info] speedup " << legacyResult.nsPerLine / currentResult.nsPerLine << "x" << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "helper/log_parsers.hpp"
+
+namespace legacy
+{
+    using helper::logs::CombatDamageEvent;
+    using helper::logs::HitQuality;
+    using helper::logs::LocalChatEvent;
+    using helper::logs::MiningYieldEvent;
+
+    std::optional<LocalChatEvent> parse_local_chat_line(std::string_view line);
+    std::optional<CombatDamageEvent> parse_combat_damage_line(std::string_view line);
+    std::optional<MiningYieldEvent> parse_mining_yield_line(std::string_view line);
+}
@@ -0,0 +1,166 @@
+// Measures publish-to-visible latency of the shared overlay state channel: the time from the helper calling
+// SharedMemoryWriter::write until the overlay's poll thread has woken and decoded the new state.
+// Uses private object names so it can run next to a live helper.
+//
+//   ef-shared-state-bench [publishes] [--poll] [--json]
+//
+// --poll emulates the previous fixed 200 ms sleep loop for comparison; --json publishes the JSON encoding
+// instead of the binary one.
+
+#include "overlay_schema.hpp"
+#include "overlay_state_binary.hpp"
+#include "shared_memory_channel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    overlay::OverlayState make_bench_state(std::size_t routeLength)
+    {
+        overlay::OverlayState state;
+        state.generated_at_ms = 1;
+        state.source_online = true;
+        for (std::size_t i = 0; i < routeLength; ++i)
+        {
+            overlay::RouteNode node;
+            node.system_id = std::to_string(30000000 + i);
+            node.display_name = "System " + std::to_string(i);
+            node.distance_ly = static_cast<double>(i) * 0.5;
+            node.route_position = static_cast<int>(i);
+            node.total_route_hops = static_cast<int>(routeLength) - 1;
+            state.route.push_back(std::move(node));
+        }
+        state.player_marker = overlay::PlayerMarker{"30000000", "System 0", false};
+        return state;
+    }
+
+    double percentile(std::vector<double>& samples, double fraction)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        const auto index = static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+        return samples[index];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t publishes = 500;
+    bool pollMode = false;
+    bool jsonMode = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--poll")
+        {
+            pollMode = true;
+        }
+        else if (arg == "--json")
+        {
+            jsonMode = true;
+        }
+        else
+        {
+            publishes = static_cast<std::size_t>(std::strtoull(arg.c_str(), nullptr, 10));
+        }
+    }
+    if (publishes == 0)
+    {
+        std::cerr << "[error] Usage: ef-shared-state-bench [publishes] [--poll] [--json]" << std::endl;
+        return 1;
+    }
+
+    const std::wstring mappingName = L"Local\\EFOverlaySharedStateBench";
+    const std::wstring eventName = L"Local\\EFOverlaySharedStateBenchUpdated";
+    overlay::SharedMemoryWriter writer(mappingName, eventName);
+    overlay::SharedMemoryReader reader(mappingName, eventName);
+    if (!writer.ensure() || !reader.ensure())
+    {
+        std::cerr << "[error] Failed to open benchmark shared memory" << std::endl;
+        return 1;
+    }
+
+    // publishedAt[n] is the time publish n started; sequences start at 1 for a fresh mapping.
+    const auto baseSequence = reader.current_sequence();
+    std::vector<std::atomic<std::int64_t>> publishedAt(publishes + 1);
+    std::vector<double> latenciesUs;
+    latenciesUs.reserve(publishes);
+    std::atomic_bool done{false};
+
+    std::thread consumer([&]() {
+        std::uint64_t lastSequence = baseSequence;
+        while (!done.load())
+        {
+            if (pollMode)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds{200});
+            }
+            else if (!reader.wait_for_update(lastSequence, std::chrono::milliseconds{200}))
+            {
+                continue;
+            }
+
+            const auto snapshot = reader.read_state();
+            if (!snapshot || snapshot->sequence == lastSequence)
+            {
+                continue;
+            }
+            lastSequence = snapshot->sequence;
+            const auto visibleAt = Clock::now().time_since_epoch().count();
+
+            const auto index = snapshot->sequence - baseSequence;
+            if (index < publishedAt.size() && snapshot->state && !snapshot->state->route.empty())
+            {
+                const auto elapsed = std::chrono::duration<double, std::micro>(Clock::duration{visibleAt - publishedAt[index].load()});
+                latenciesUs.push_back(elapsed.count());
+            }
+        }
+    });
+
+    auto state = make_bench_state(64);
+    for (std::size_t i = 1; i <= publishes; ++i)
+    {
+        state.generated_at_ms = i;
+        state.heartbeat_ms = i;
+        publishedAt[i].store(Clock::now().time_since_epoch().count());
+        if (jsonMode)
+        {
+            writer.write(overlay::serialize_overlay_state(state).dump(), static_cast<std::uint32_t>(state.version), state.generated_at_ms);
+        }
+        else
+        {
+            writer.write_binary(overlay::encode_overlay_state_binary(state), static_cast<std::uint32_t>(state.version), state.generated_at_ms);
+        }
+
+        // Irregular spacing so the poll loop phase does not line up with publishes.
+        std::this_thread::sleep_for(std::chrono::milliseconds{5 + static_cast<int>(i * 7 % 23)});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{300});
+    done.store(true);
+    consumer.join();
+
+    std::cout << "[info] " << (pollMode ? "poll (200 ms)" : "event wakeup") << ", " << (jsonMode ? "json" : "binary") << ": "
+              << latenciesUs.size() << " of " << publishes << " publishes observed" << std::endl;
+    if (latenciesUs.empty())
+    {
+        return 1;
+    }
+    std::cout << "[info] latency us p50=" << percentile(latenciesUs, 0.50)
+              << " p90=" << percentile(latenciesUs, 0.90)
+              << " p99=" << percentile(latenciesUs, 0.99)
+              << " max=" << *std::max_element(latenciesUs.begin(), latenciesUs.end())
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Offline converter: rewrites an EFSTARS1 star catalog as EFSTARS2 with precomputed perfect hash indexes.
+//
+//   ef-star-catalog-convert data/star_catalog_v1.bin data/star_catalog_v2.bin
+
+#include "star_catalog.hpp"
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    bool verify(const overlay::StarCatalog& source, const overlay::StarCatalog& converted)
+    {
+        if (source.size() != converted.size() || !converted.has_precomputed_indexes())
+        {
+            std::cerr << "[error] Converted catalog shape mismatch" << std::endl;
+            return false;
+        }
+
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            const auto& record = source.records[i];
+            const auto* expectedById = source.find_by_system_id(record.system_id);
+            const auto* actualById = converted.find_by_system_id(record.system_id);
+            if (!actualById || actualById - converted.records.data() != expectedById - source.records.data())
+            {
+                std::cerr << "[error] System id lookup mismatch for " << record.system_id << std::endl;
+                return false;
+            }
+
+            const auto name = source.name_for(record);
+            const auto* expectedByName = source.find_by_name(name);
+            const auto* actualByName = converted.find_by_name(name);
+            const auto expectedIndex = expectedByName ? expectedByName - source.records.data() : -1;
+            const auto actualIndex = actualByName ? actualByName - converted.records.data() : -1;
+            if (expectedIndex != actualIndex)
+            {
+                std::cerr << "[error] Name lookup mismatch for '" << name << "'" << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: ef-star-catalog-convert <input.bin> <output.bin>" << std::endl;
+        return 1;
+    }
+
+    const std::filesystem::path inputPath{argv[1]};
+    const std::filesystem::path outputPath{argv[2]};
+
+    try
+    {
+        const auto source = overlay::load_star_catalog_from_file(inputPath);
+        const auto bytes = overlay::serialize_star_catalog_v2(source);
+        const auto converted = overlay::load_star_catalog(bytes);
+        if (!verify(source, converted))
+        {
+            return 1;
+        }
+
+        std::ofstream stream(outputPath, std::ios::binary | std::ios::trunc);
+        if (!stream || !stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+        {
+            std::cerr << "[error] Failed to write " << outputPath.string() << std::endl;
+            return 1;
+        }
+
+        std::cout << "[info] Wrote " << outputPath.string() << " (stars=" << converted.size() << ", bytes=" << bytes.size() << ")" << std::endl;
+        return 0;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "[error] " << ex.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,150 @@
+// Measures TelemetryStore on a synthetic multi-day history: append throughput, bytes per row on disk, and
+// range queries at the resolutions the telemetry panel asks for.
+//
+//   ef-telemetry-store-bench [--days N] [--interval-ms N] [--iterations N]
+//
+// The store is written to a fresh directory under the temp directory and removed afterwards. Every query's
+// sums are checked against a full row scan of the same range.
+
+#include "helper/telemetry_store.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using helper::telemetry::TelemetryRecord;
+    using helper::telemetry::TelemetryStore;
+
+    constexpr std::uint64_t day_ms = 24ull * 60 * 60 * 1000;
+
+    double elapsed_ms(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::uintmax_t directory_bytes(const std::filesystem::path& directory)
+    {
+        std::uintmax_t bytes = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory))
+        {
+            bytes += entry.is_regular_file() ? entry.file_size() : 0;
+        }
+        return bytes;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::uint64_t days = 30;
+    std::uint64_t intervalMs = 2000;
+    std::size_t iterations = 5;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const auto value = std::strtoull(argv[i + 1], nullptr, 10);
+        if (arg == "--days")
+        {
+            days = value;
+        }
+        else if (arg == "--interval-ms")
+        {
+            intervalMs = value;
+        }
+        else if (arg == "--iterations")
+        {
+            iterations = static_cast<std::size_t>(value);
+        }
+    }
+    if (days == 0 || intervalMs == 0 || iterations == 0)
+    {
+        std::cerr << "[error] Usage: ef-telemetry-store-bench [--days N] [--interval-ms N] [--iterations N]" << std::endl;
+        return 1;
+    }
+
+    const auto directory = std::filesystem::temp_directory_path() / "ef_telemetry_store_bench";
+    std::filesystem::remove_all(directory);
+
+    const std::uint64_t firstMs = 1'760'000'000'000ull - 1'760'000'000'000ull % day_ms;
+    const std::uint64_t endMs = firstMs + days * day_ms;
+    std::uint64_t rows = 0;
+    {
+        TelemetryStore store({directory});
+        const std::uint32_t resources[] = {store.resourceId("Veldspar"), store.resourceId("Feldspar"), store.resourceId("Hemorphite")};
+
+        // Bursts of combat with mining in between, roughly what a long play session logs.
+        const auto start = Clock::now();
+        for (std::uint64_t timestamp = firstMs; timestamp < endMs; timestamp += intervalMs, ++rows)
+        {
+            const auto phase = (timestamp / (10 * 60 * 1000)) % 3;
+            if (phase == 2)
+            {
+                store.append("bench", TelemetryRecord::mining(timestamp, 12.5 * static_cast<double>(1 + rows % 4), resources[rows / 300 % 3]));
+            }
+            else
+            {
+                const auto damage = std::round(80.0 + 40.0 * std::sin(static_cast<double>(rows) * 0.1));
+                store.append("bench", TelemetryRecord::combat(timestamp, rows % 3 != 0, damage, static_cast<std::uint8_t>(rows % 5)));
+            }
+        }
+        store.flush();
+        const auto appendMs = elapsed_ms(start);
+        std::cout << "[info] " << rows << " rows over " << days << " days appended in " << appendMs << " ms ("
+                  << static_cast<double>(rows) / appendMs * 1000.0 << " rows/s), "
+                  << static_cast<double>(directory_bytes(directory)) / static_cast<double>(rows) << " bytes/row on disk (37 raw)" << std::endl;
+    }
+
+    TelemetryStore store({directory});
+    struct Query
+    {
+        const char* name;
+        std::uint64_t fromMs;
+        std::uint64_t resolutionMs;
+    };
+    const Query queries[] = {
+        {"last day @ 1 min", endMs - day_ms, 60 * 1000},
+        {"last week @ 15 min", endMs - std::min<std::uint64_t>(days, 7) * day_ms, 15 * 60 * 1000},
+        {"all days @ 1 h", firstMs, 60 * 60 * 1000},
+        {"all days @ 1 day", firstMs, day_ms},
+    };
+
+    bool consistent = true;
+    for (const auto& query : queries)
+    {
+        std::size_t points = 0;
+        double dealt = 0.0;
+        const auto start = Clock::now();
+        for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            const auto result = store.query(query.fromMs, endMs, query.resolutionMs);
+            points = result.size();
+            dealt = 0.0;
+            for (const auto& point : result)
+            {
+                dealt += point.dealt;
+            }
+        }
+        const auto queryMs = elapsed_ms(start) / static_cast<double>(iterations);
+
+        double scanned = 0.0;
+        const auto scanStart = Clock::now();
+        store.scan(query.fromMs, endMs, [&](const TelemetryRecord& row) { scanned += row.dealt; });
+        const auto scanMs = elapsed_ms(scanStart);
+
+        if (std::abs(scanned - dealt) > 1e-6 * std::max(1.0, scanned))
+        {
+            std::cerr << "[warn] " << query.name << ": query sums differ from the row scan" << std::endl;
+            consistent = false;
+        }
+        std::cout << "[info] " << query.name << ": " << points << " points in " << queryMs << " ms (full row scan " << scanMs << " ms)" << std::endl;
+    }
+
+    std::filesystem::remove_all(directory);
+    return consistent ? 0 : 2;
+}
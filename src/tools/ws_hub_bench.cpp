@@ -0,0 +1,450 @@
+// Drives HelperWebSocketHub with many local clients: connection setup, what a broadcast costs the publishing
+// thread, and how soon every reading client has the latest state while some clients stop reading entirely.
+//
+//   ef-ws-hub-bench [--clients N] [--stalled N] [--broadcasts N] [--interval-us N] [--state-kb N] [--threads N]
+//
+// The reading clients rotate through four modes: JSON, JSON with ?patches=1, JSON over permessage-deflate and
+// binary states over permessage-deflate. Each patch is checked against the last state the client was sent and
+// compressed messages are inflated with the context carried over, as a browser would. The stalled clients
+// complete the handshake and then never read.
+
+#include "helper/helper_websocket.hpp"
+#include "overlay_schema.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsed_ms(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::uint64_t number_after(std::string_view text, std::string_view key)
+    {
+        const auto pos = text.find(key);
+        if (pos == std::string_view::npos)
+        {
+            return 0;
+        }
+        return std::strtoull(text.data() + pos + key.size(), nullptr, 10);
+    }
+
+    enum class Mode
+    {
+        Json,
+        Patches,
+        Deflate,
+        DeflateBinary,
+    };
+
+    constexpr std::array<const char*, 4> mode_names{"json", "json+patches", "json+deflate", "binary+deflate"};
+
+    class BenchClient : public std::enable_shared_from_this<BenchClient>
+    {
+    public:
+        BenchClient(asio::io_context& io, Mode mode, bool reads)
+            : socket_(io)
+            , mode_(mode)
+            , reads_(reads)
+        {
+            if (mode_ == Mode::Deflate || mode_ == Mode::DeflateBinary)
+            {
+                inflating_ = inflateInit2(&inflater_, -15) == Z_OK;
+            }
+        }
+
+        ~BenchClient()
+        {
+            if (inflating_)
+            {
+                inflateEnd(&inflater_);
+            }
+        }
+
+        void start(const asio::ip::tcp::endpoint& endpoint)
+        {
+            socket_.async_connect(endpoint, [self = shared_from_this()](const asio::error_code& ec) {
+                if (ec)
+                {
+                    return;
+                }
+                const char* query = self->mode_ == Mode::Patches ? "?patches=1" : self->mode_ == Mode::DeflateBinary ? "?format=binary" : "";
+                const char* extensions = self->inflating_ ? "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n" : "";
+                self->request_ = std::string("GET /overlay/stream") + query +
+                    " HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n" + extensions +
+                    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+                asio::async_write(self->socket_, asio::buffer(self->request_), [self](const asio::error_code& writeError, std::size_t) {
+                    if (writeError)
+                    {
+                        return;
+                    }
+                    asio::async_read_until(self->socket_, asio::dynamic_buffer(self->inbound_), "\r\n\r\n",
+                        [self](const asio::error_code& readError, std::size_t length) {
+                            if (readError)
+                            {
+                                return;
+                            }
+                            self->inbound_.erase(0, length);
+                            if (self->reads_)
+                            {
+                                self->consume();
+                                self->read();
+                            }
+                        });
+                });
+            });
+        }
+
+        void close()
+        {
+            asio::error_code ec;
+            socket_.close(ec);
+        }
+
+        Mode mode() const { return mode_; }
+        std::uint64_t sequence() const { return sequence_.load(); }
+        std::uint64_t states() const { return states_.load(); }
+        std::uint64_t bytes() const { return bytes_.load(); }
+        bool consistent() const { return consistent_.load(); }
+
+    private:
+        void read()
+        {
+            socket_.async_read_some(asio::buffer(buffer_), [self = shared_from_this()](const asio::error_code& ec, std::size_t bytes) {
+                if (ec)
+                {
+                    return;
+                }
+                self->bytes_ += bytes;
+                self->inbound_.append(self->buffer_.data(), bytes);
+                self->consume();
+                self->read();
+            });
+        }
+
+        // Server frames are unmasked and unfragmented.
+        void consume()
+        {
+            for (;;)
+            {
+                if (inbound_.size() < 2)
+                {
+                    return;
+                }
+                const auto* header = reinterpret_cast<const unsigned char*>(inbound_.data());
+                std::uint64_t length = header[1] & 0x7F;
+                std::size_t offset = 2;
+                if (length >= 126)
+                {
+                    const std::size_t extended = length == 126 ? 2 : 8;
+                    if (inbound_.size() < 2 + extended)
+                    {
+                        return;
+                    }
+                    length = 0;
+                    for (std::size_t i = 0; i < extended; ++i)
+                    {
+                        length = (length << 8) | header[2 + i];
+                    }
+                    offset += extended;
+                }
+                if (inbound_.size() - offset < length)
+                {
+                    return;
+                }
+
+                const auto payload = std::string_view(inbound_).substr(offset, static_cast<std::size_t>(length));
+                const auto opcode = header[0] & 0x0F;
+                if ((header[0] & 0x40) != 0)
+                {
+                    onMessage(opcode, inflate(payload));
+                }
+                else
+                {
+                    onMessage(opcode, payload);
+                }
+                inbound_.erase(0, offset + static_cast<std::size_t>(length));
+            }
+        }
+
+        std::string_view inflate(std::string_view payload)
+        {
+            // permessage-deflate drops the 00 00 FF FF that ends each sync flush.
+            compressedInput_.assign(payload);
+            compressedInput_.append("\x00\x00\xff\xff", 4);
+            inflater_.next_in = reinterpret_cast<Bytef*>(compressedInput_.data());
+            inflater_.avail_in = static_cast<uInt>(compressedInput_.size());
+            inflated_.clear();
+            std::size_t produced = 0;
+            do
+            {
+                inflated_.resize(std::max<std::size_t>(inflated_.size() * 2, 64 * 1024));
+                inflater_.next_out = reinterpret_cast<Bytef*>(inflated_.data() + produced);
+                inflater_.avail_out = static_cast<uInt>(inflated_.size() - produced);
+                const auto result = ::inflate(&inflater_, Z_SYNC_FLUSH);
+                if (result != Z_OK && result != Z_BUF_ERROR)
+                {
+                    consistent_ = false;
+                    return {};
+                }
+                produced = inflated_.size() - inflater_.avail_out;
+            } while (inflater_.avail_out == 0);
+            return std::string_view(inflated_).substr(0, produced);
+        }
+
+        void onMessage(int opcode, std::string_view text)
+        {
+            if (opcode == 0x2)
+            {
+                if (text.size() < 12 || text.substr(0, 4) != "EFWS")
+                {
+                    consistent_ = false;
+                    return;
+                }
+                std::uint64_t sequence = 0;
+                for (std::size_t i = 0; i < 8; ++i)
+                {
+                    sequence |= static_cast<std::uint64_t>(static_cast<unsigned char>(text[4 + i])) << (i * 8);
+                }
+                if (sequence <= sequence_.load())
+                {
+                    consistent_ = false;
+                }
+                sequence_ = sequence;
+                ++states_;
+                return;
+            }
+
+            // nlohmann::json orders keys, so "sequence" precedes the state and follows a patch's base.
+            const bool patch = text.find("\"type\":\"overlay_state_patch\"") != std::string_view::npos;
+            if (!patch && text.find("\"type\":\"overlay_state\"") == std::string_view::npos)
+            {
+                return;
+            }
+            const auto sequence = number_after(text, "\"sequence\":");
+            if (patch && number_after(text, "\"base_sequence\":") != sequence_.load())
+            {
+                consistent_ = false;
+            }
+            if (sequence != 0 && sequence <= sequence_.load())
+            {
+                consistent_ = false;
+            }
+            sequence_ = sequence;
+            ++states_;
+        }
+
+        asio::ip::tcp::socket socket_;
+        Mode mode_;
+        bool reads_;
+        z_stream inflater_{};
+        bool inflating_{false};
+        std::string compressedInput_;
+        std::string inflated_;
+        std::string request_;
+        std::string inbound_;
+        std::array<char, 16 * 1024> buffer_{};
+        std::atomic<std::uint64_t> sequence_{0};
+        std::atomic<std::uint64_t> states_{0};
+        std::atomic<std::uint64_t> bytes_{0};
+        std::atomic_bool consistent_{true};
+    };
+
+    // A route long enough to make the serialized state about `kilobytes` KiB; successive states move the
+    // player one hop along it, as a live route does.
+    nlohmann::json make_state(std::uint64_t index, std::size_t kilobytes)
+    {
+        overlay::OverlayState state;
+        state.generated_at_ms = 1'760'000'000'000ull + index * 250;
+        state.heartbeat_ms = state.generated_at_ms;
+        const auto hops = std::max<std::size_t>(2, kilobytes * 1024 / 230);
+        for (std::size_t hop = 0; hop < hops; ++hop)
+        {
+            state.route.push_back(overlay::RouteNode{std::to_string(30'000'001 + hop * 7), "System " + std::to_string(hop * 7919 % 100'000),
+                static_cast<double>(hop % 13) * 1.37, hop % 3 == 0, hop % 11 == 0, static_cast<int>(hop % 9), static_cast<int>(hop % 4),
+                static_cast<int>(hop + 1), static_cast<int>(hops)});
+        }
+        const auto current = index % hops;
+        state.active_route_node_id = state.route[current].system_id;
+        state.player_marker = overlay::PlayerMarker{state.route[current].system_id, state.route[current].display_name, false};
+        state.follow_mode_enabled = true;
+        return {{"type", "overlay_state"}, {"state", overlay::serialize_overlay_state(state)}};
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t clients = 128;
+    std::size_t stalled = 8;
+    std::uint64_t broadcasts = 500;
+    std::uint64_t intervalUs = 2000;
+    std::size_t stateKb = 16;
+    std::size_t threads = 2;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const auto value = std::strtoull(argv[i + 1], nullptr, 10);
+        if (arg == "--clients")
+        {
+            clients = static_cast<std::size_t>(value);
+        }
+        else if (arg == "--stalled")
+        {
+            stalled = static_cast<std::size_t>(value);
+        }
+        else if (arg == "--broadcasts")
+        {
+            broadcasts = value;
+        }
+        else if (arg == "--interval-us")
+        {
+            intervalUs = value;
+        }
+        else if (arg == "--state-kb")
+        {
+            stateKb = static_cast<std::size_t>(value);
+        }
+        else if (arg == "--threads")
+        {
+            threads = static_cast<std::size_t>(value);
+        }
+    }
+    if (clients == 0 || broadcasts == 0 || threads == 0)
+    {
+        std::cerr << "[error] Usage: ef-ws-hub-bench [--clients N] [--stalled N] [--broadcasts N] [--interval-us N] [--state-kb N] [--threads N]" << std::endl;
+        return 1;
+    }
+
+    helper::ws::HelperWebSocketHub::Config config;
+    config.threads = threads;
+    helper::ws::HelperWebSocketHub hub(config);
+    if (!hub.start())
+    {
+        std::cerr << "[error] Unable to start the hub" << std::endl;
+        return 1;
+    }
+
+    asio::io_context io;
+    auto work = asio::make_work_guard(io);
+    std::thread clientThread([&io]() { io.run(); });
+
+    const asio::ip::tcp::endpoint endpoint(asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(hub.port()));
+    std::vector<std::shared_ptr<BenchClient>> readers;
+    std::vector<std::shared_ptr<BenchClient>> stalledClients;
+    const auto connectStart = Clock::now();
+    for (std::size_t i = 0; i < clients + stalled; ++i)
+    {
+        auto client = std::make_shared<BenchClient>(io, static_cast<Mode>(i % mode_names.size()), i < clients);
+        (i < clients ? readers : stalledClients).push_back(client);
+        asio::post(io, [client, endpoint]() { client->start(endpoint); });
+    }
+    const auto connectDeadline = Clock::now() + std::chrono::seconds{10};
+    while (hub.stats().clients < clients + stalled && Clock::now() < connectDeadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    std::cout << "[info] " << hub.stats().clients << " of " << clients + stalled << " clients upgraded in " << elapsed_ms(connectStart)
+              << " ms (" << stalled << " of them never read)" << std::endl;
+
+    std::vector<double> callUs;
+    callUs.reserve(static_cast<std::size_t>(broadcasts));
+    const auto broadcastStart = Clock::now();
+    for (std::uint64_t i = 0; i < broadcasts; ++i)
+    {
+        const auto state = make_state(i, stateKb);
+        const auto start = Clock::now();
+        hub.broadcastOverlayState(state);
+        callUs.push_back(elapsed_ms(start) * 1000.0);
+        if (intervalUs != 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(intervalUs));
+        }
+    }
+    const auto broadcastMs = elapsed_ms(broadcastStart);
+
+    // Every reading client should reach the final sequence however far behind the stalled ones are.
+    const auto drainStart = Clock::now();
+    const auto drainDeadline = drainStart + std::chrono::seconds{10};
+    const auto caughtUp = [&]() {
+        return std::all_of(readers.begin(), readers.end(), [&](const auto& client) { return client->sequence() == broadcasts; });
+    };
+    while (!caughtUp() && Clock::now() < drainDeadline)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds{200});
+    }
+    const auto drainMs = elapsed_ms(drainStart);
+    const bool allCaughtUp = caughtUp();
+
+    std::sort(callUs.begin(), callUs.end());
+    const auto percentile = [&](double p) {
+        return callUs[std::min(callUs.size() - 1, static_cast<std::size_t>(p * static_cast<double>(callUs.size())))];
+    };
+    std::uint64_t minStates = broadcasts;
+    std::uint64_t totalStates = 0;
+    std::uint64_t totalBytes = 0;
+    std::array<std::uint64_t, mode_names.size()> modeStates{};
+    std::array<std::uint64_t, mode_names.size()> modeBytes{};
+    bool consistent = true;
+    for (const auto& client : readers)
+    {
+        minStates = std::min(minStates, client->states());
+        totalStates += client->states();
+        totalBytes += client->bytes();
+        modeStates[static_cast<std::size_t>(client->mode())] += client->states();
+        modeBytes[static_cast<std::size_t>(client->mode())] += client->bytes();
+        consistent = consistent && client->consistent();
+    }
+
+    const auto stats = hub.stats();
+    std::cout << "[info] " << broadcasts << " broadcasts of a " << stateKb << " KiB state in " << broadcastMs << " ms; broadcastOverlayState p50 "
+              << percentile(0.5) << " us, p99 " << percentile(0.99) << " us, max " << callUs.back() << " us" << std::endl;
+    std::cout << "[info] reading clients " << (allCaughtUp ? "reached" : "did NOT reach") << " the final state " << drainMs << " ms after the last broadcast; "
+              << static_cast<double>(totalStates) / static_cast<double>(readers.size()) << " states per client on average (min " << minStates << "), "
+              << static_cast<double>(totalBytes) / (1024.0 * 1024.0) << " MiB received" << std::endl;
+    for (std::size_t mode = 0; mode < mode_names.size(); ++mode)
+    {
+        if (modeStates[mode] != 0)
+        {
+            std::cout << "[info] " << mode_names[mode] << ": " << static_cast<double>(modeBytes[mode]) / static_cast<double>(modeStates[mode])
+                      << " bytes on the wire per state" << std::endl;
+        }
+    }
+    std::cout << "[info] hub queued " << stats.framesQueued << " frames, coalesced " << stats.framesCoalesced << ", dropped " << stats.framesDropped << std::endl;
+    if (!consistent)
+    {
+        std::cerr << "[warn] a client received a patch that does not apply to its last state, or a message it could not decode" << std::endl;
+    }
+
+    const auto stopStart = Clock::now();
+    hub.stop();
+    std::cout << "[info] stop() with " << clients + stalled << " clients connected took " << elapsed_ms(stopStart) << " ms" << std::endl;
+
+    for (const auto& client : readers)
+    {
+        asio::post(io, [client]() { client->close(); });
+    }
+    for (const auto& client : stalledClients)
+    {
+        asio::post(io, [client]() { client->close(); });
+    }
+    work.reset();
+    clientThread.join();
+
+    return allCaughtUp && consistent ? 0 : 2;
+}
@@ -1,10 +1,26 @@
 #include "overlay_schema.hpp"
+#include "overlay_state_binary.hpp"
 #include "shared_memory_channel.hpp"
+#include "shared_memory_protocol.hpp"
 #include "event_channel.hpp"
+#include "event_ring_protocol.hpp"
+#include "helper/file_change_notifier.hpp"
+#include "helper/helper_websocket.hpp"
+#include "helper/log_backfill.hpp"
 #include "helper/log_parsers.hpp"
+#include "helper/log_tail_reader.hpp"
+#include "helper/route_planner.hpp"
+#include "helper/server_streams.hpp"
+#include "helper/session_tracker.hpp"
+#include "helper/string_interner.hpp"
 #include "helper/system_resolver.hpp"
+#include "helper/telemetry_store.hpp"
+#include "helper/telemetry_window.hpp"
+#include "helper/text_simd.hpp"
 #include "shared/star_catalog.hpp"
+#include "shared/star_spatial_index.hpp"
 
+#if defined(_WIN32)
 #ifndef NOMINMAX
 #define NOMINMAX
 #endif
@@ -14,17 +30,27 @@
 #endif
 
 #include <windows.h>
+#endif
 
 #include <chrono>
 #include <iostream>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
 
 #include <nlohmann/json.hpp>
+#include <zlib.h>
 
 namespace
 {
@@ -120,6 +146,91 @@ namespace
         state.telemetry = telemetry;
         return state;
     }
+
+    struct SampleStar
+    {
+        std::uint32_t system_id;
+        std::string name;
+        overlay::Vec3f position;
+        float security;
+    };
+
+    std::vector<std::uint8_t> make_catalog_bytes(const std::vector<SampleStar>& stars)
+    {
+        std::vector<std::uint32_t> nameOffsets;
+        std::string stringBlob;
+        nameOffsets.reserve(stars.size());
+        for (const auto& star : stars)
+        {
+            nameOffsets.push_back(static_cast<std::uint32_t>(stringBlob.size()));
+            stringBlob.append(star.name);
+        }
+
+        std::vector<std::uint8_t> buffer;
+        buffer.reserve(44 + stars.size() * 36 + stringBlob.size());
+
+        auto append_bytes = [&buffer](const void* data, std::size_t count) {
+            const auto* ptr = static_cast<const std::uint8_t*>(data);
+            buffer.insert(buffer.end(), ptr, ptr + count);
+        };
+
+        auto append_u16 = [&append_bytes](std::uint16_t value) {
+            append_bytes(&value, sizeof(value));
+        };
+
+        auto append_u32 = [&append_bytes](std::uint32_t value) {
+            append_bytes(&value, sizeof(value));
+        };
+
+        auto append_f32 = [&append_bytes](float value) {
+            append_bytes(&value, sizeof(value));
+        };
+
+        const char magic[8] = {'E','F','S','T','A','R','S','1'};
+        append_bytes(magic, sizeof(magic));
+        append_u16(1);  // version
+        append_u16(36); // record size
+        append_u32(static_cast<std::uint32_t>(stars.size()));
+
+        // bbox min/max
+        append_f32(0.0f);
+        append_f32(0.0f);
+        append_f32(-1.0f);
+        append_f32(10.0f);
+        append_f32(20.0f);
+        append_f32(30.0f);
+
+        append_u32(static_cast<std::uint32_t>(stringBlob.size()));
+
+        for (std::size_t i = 0; i < stars.size(); ++i)
+        {
+            append_u32(stars[i].system_id);
+            append_u32(static_cast<std::uint32_t>(7 + i));  // region id
+            append_u32(static_cast<std::uint32_t>(3 + i));  // constellation id
+            append_u32(nameOffsets[i]);
+            append_u16(static_cast<std::uint16_t>(stars[i].name.size()));
+            const std::uint8_t spectral = static_cast<std::uint8_t>(i + 1);
+            append_bytes(&spectral, sizeof(spectral));
+            const std::uint8_t flags = static_cast<std::uint8_t>(i);
+            append_bytes(&flags, sizeof(flags));
+            append_f32(stars[i].position.x);
+            append_f32(stars[i].position.y);
+            append_f32(stars[i].position.z);
+            append_f32(stars[i].security);
+        }
+
+        append_bytes(stringBlob.data(), stringBlob.size());
+
+        return buffer;
+    }
+
+    std::vector<std::uint8_t> make_sample_catalog_bytes()
+    {
+        return make_catalog_bytes({
+            SampleStar{42u, "Alpha", overlay::Vec3f{1.0f, 2.0f, 3.0f}, 0.7f},
+            SampleStar{43u, "Beta", overlay::Vec3f{4.0f, 5.0f, 6.0f}, 0.2f}
+        });
+    }
 }
 
 int main()
@@ -218,6 +329,140 @@ int main()
         }
     }, failures);
 
+    run_case("overlay binary state round-trip", [&](void) {
+        auto state = make_sample_state();
+        state.authenticated = true;
+        state.tribe_id = std::string{"98000001"};
+        state.tribe_name = std::string{"Frontier Cartographers"};
+        overlay::PscanData pscan;
+        pscan.system_id = "30000003";
+        pscan.system_name = "Mahnna";
+        pscan.scanned_at_ms = 123456900ULL;
+        pscan.nodes.push_back(overlay::PscanNode{"node-1", "Relay", "SSU", "Someone", 1250.5});
+        state.pscan_data = pscan;
+
+        const auto encoded = overlay::encode_overlay_state_binary(state);
+        const auto restored = overlay::decode_overlay_state_binary(encoded);
+        if (overlay::serialize_overlay_state(restored) != overlay::serialize_overlay_state(state))
+        {
+            throw std::runtime_error("binary encoding did not round-trip");
+        }
+        if (encoded.size() >= overlay::serialize_overlay_state(state).dump().size())
+        {
+            throw std::runtime_error("binary encoding should be smaller than JSON");
+        }
+
+        // Fields from a newer writer are skipped.
+        auto extended = encoded;
+        const std::uint16_t unknownTag = 0x7FFF;
+        const std::uint32_t unknownLength = 3;
+        extended.append(reinterpret_cast<const char*>(&unknownTag), sizeof(unknownTag));
+        extended.append(reinterpret_cast<const char*>(&unknownLength), sizeof(unknownLength));
+        extended.append("abc");
+        if (overlay::serialize_overlay_state(overlay::decode_overlay_state_binary(extended)) != overlay::serialize_overlay_state(state))
+        {
+            throw std::runtime_error("unknown binary field was not skipped");
+        }
+
+        auto expect_invalid = [](std::string_view payload, const char* what) {
+            try
+            {
+                (void)overlay::decode_overlay_state_binary(payload);
+            }
+            catch (const std::invalid_argument&)
+            {
+                return;
+            }
+            throw std::runtime_error(what);
+        };
+        expect_invalid(std::string_view(encoded).substr(0, encoded.size() - 1), "truncated payload should be rejected");
+        expect_invalid(std::string_view(encoded).substr(0, 4), "payload without a header should be rejected");
+        auto badMagic = encoded;
+        badMagic[0] = 'X';
+        expect_invalid(badMagic, "payload with a bad magic should be rejected");
+    }, failures);
+
+    run_case("overlay state deltas", [&](void) {
+        auto keyframeState = make_sample_state();
+        for (int i = 0; i < 40; ++i)
+        {
+            keyframeState.route.push_back(overlay::RouteNode{std::to_string(30001000 + i), "Waypoint " + std::to_string(i), 4.2, false});
+        }
+        auto current = keyframeState;
+        current.heartbeat_ms += 2000;
+        current.player_marker = overlay::PlayerMarker{"30000005", "Amdim", true};
+        current.notes.reset();
+        current.telemetry->combat->total_damage_dealt += 75.0;
+        current.telemetry->history->slices.front().damage_dealt += 75.0;
+        current.route.back().display_name = "Renamed tail";
+
+        const auto keyframe = overlay::encode_overlay_state_binary(keyframeState);
+        const auto encoded = overlay::encode_overlay_state_binary(current);
+        if (overlay::make_overlay_state_delta(keyframe, keyframe, 7).has_value())
+        {
+            throw std::runtime_error("identical states should not produce a delta");
+        }
+
+        const auto delta = overlay::make_overlay_state_delta(keyframe, encoded, 7);
+        if (!delta || !overlay::is_overlay_state_delta(*delta) || overlay::overlay_state_delta_base(*delta) != 7)
+        {
+            throw std::runtime_error("expected a delta against sequence 7");
+        }
+        if (delta->size() * 2 > encoded.size())
+        {
+            throw std::runtime_error("delta should be well under the full encoding");
+        }
+        const auto rebuilt = overlay::decode_overlay_state_binary(overlay::apply_overlay_state_delta(keyframe, *delta));
+        if (overlay::serialize_overlay_state(rebuilt) != overlay::serialize_overlay_state(current))
+        {
+            throw std::runtime_error("delta did not reproduce the current state");
+        }
+
+        // Region protocol: the keyframe survives later publishes, heartbeats leave the sequence alone.
+        constexpr std::size_t slotCapacity = 16 * 1024;
+        std::vector<std::uint64_t> storage(overlay::shared_state_region_size(slotCapacity) / sizeof(std::uint64_t) + 1, 0);
+        void* region = storage.data();
+        const auto regionSize = overlay::shared_state_region_size(slotCapacity);
+        overlay::initialize_shared_state(region, slotCapacity);
+        if (!overlay::publish_shared_state(region, keyframe, overlay::binary_state_encoding_flag, 1, true) ||
+            !overlay::publish_shared_state(region, *delta, overlay::binary_state_encoding_flag, 2) ||
+            !overlay::publish_shared_state(region, *delta, overlay::binary_state_encoding_flag, 3))
+        {
+            throw std::runtime_error("publishes should fit the slot");
+        }
+        overlay::publish_shared_heartbeat(region, 424242);
+
+        std::string keyframeCopy;
+        const auto keyframeSequence = overlay::read_shared_state_keyframe(region, regionSize, keyframeCopy);
+        if (!keyframeSequence || *keyframeSequence != 1 || keyframeCopy != keyframe)
+        {
+            throw std::runtime_error("keyframe slot should hold publish 1");
+        }
+        if (overlay::shared_state_sequence(region, regionSize) != 3 || overlay::shared_state_heartbeat(region, regionSize) != 424242)
+        {
+            throw std::runtime_error("heartbeat should not count as a publish");
+        }
+
+        // JSON merge patches for WebSocket clients.
+        const auto fromJson = overlay::serialize_overlay_state(keyframeState);
+        const auto toJson = overlay::serialize_overlay_state(current);
+        const auto patch = overlay::diff_overlay_state_json(fromJson, toJson);
+        if (patch.contains("hud_hints") || !patch.contains("player_marker") || !patch.at("notes").is_null())
+        {
+            throw std::runtime_error("merge patch should carry only changed members");
+        }
+        auto patched = fromJson;
+        patched.merge_patch(patch);
+        if (patched != toJson)
+        {
+            throw std::runtime_error("merge patch did not reproduce the current state");
+        }
+        if (!overlay::diff_overlay_state_json(toJson, toJson).empty())
+        {
+            throw std::runtime_error("identical states should produce an empty patch");
+        }
+    }, failures);
+
     run_case("local chat parser extracts system", []() {
         const auto sample = std::string{"[ 2025.09.30 15:07:01 ] Keeper > Channel changed to Local : E78-F01"};
         auto parsed = helper::logs::parse_local_chat_line(sample);
@@ -285,7 +530,17 @@ int main()
         }
         if (taken->counterparty != "Pirate Frigate")
         {
-            throw std::runtime_error(std::string{"Unexpected counterparty parsed for incoming damage: "} + taken->counterparty);
+            throw std::runtime_error(std::string{"Unexpected counterparty parsed for incoming damage: "} + taken->counterparty.str());
+        }
+
+        // Lines without a positive damage figure are rejected, as the legacy parser did.
+        if (helper::logs::parse_combat_damage_line(std::string{"[ 2025.10.13 18:22:00 ] (combat) Pirate Frigate - Light Laser smashes you"}).has_value())
+        {
+            throw std::runtime_error("A hit without a damage amount should be rejected");
+        }
+        if (helper::logs::parse_combat_damage_line(std::string{"[ 2025.10.13 18:22:01 ] (combat) You hit Pirate Frigate for -5 damage"}).has_value())
+        {
+            throw std::runtime_error("A negative damage amount should be rejected");
         }
     }, failures);
 
@@ -306,6 +561,49 @@ int main()
         }
     }, failures);
 
+    run_case("game log classification and in-place parsing", []() {
+        using helper::logs::GameLogLineKind;
+        const auto combatLine = std::string{"[ 2025.10.13 18:20:00 ] (combat) <color=0xff00ffff><b>52</b> <color=0x77ffffff><font size=10>to</font> "
+                                            "<b><color=0xffffffff>Feral Drone</b><font size=10><color=0x77ffffff> - Light Laser - Penetrates"};
+        const auto classified = helper::logs::classify_game_log_line(combatLine);
+        if (classified.kind != GameLogLineKind::Combat || helper::logs::classify_game_log_line("[ 2025.10.13 18:20:01 ] (hint) Mention (combat) later").kind != GameLogLineKind::Other)
+        {
+            throw std::runtime_error("Lines should be classified by the tag after the timestamp");
+        }
+
+        helper::logs::CombatDamageEvent event;
+        if (!helper::logs::parse_combat_damage_line(classified, event) || !event.playerDealt || event.amount != 52.0 ||
+            event.counterparty != "Feral Drone" || event.quality != helper::logs::HitQuality::Penetrating)
+        {
+            throw std::runtime_error("Expected markup-wrapped outgoing damage to parse");
+        }
+        if (std::chrono::duration_cast<std::chrono::seconds>(event.timestamp.time_since_epoch()).count() != 1760379600)
+        {
+            throw std::runtime_error("Game log timestamps should be read as UTC");
+        }
+
+        const auto miss = helper::logs::classify_game_log_line("[ 2025.10.13 18:20:02 ] (combat) Feral Drone misses you completely");
+        if (!helper::logs::parse_combat_damage_line(miss, event) || event.playerDealt || event.amount != 0.0 ||
+            event.counterparty != "Feral Drone" || event.quality != helper::logs::HitQuality::Miss)
+        {
+            throw std::runtime_error("Expected an incoming miss to reuse the event");
+        }
+
+        helper::logs::MiningYieldEvent yield;
+        const auto mined = helper::logs::classify_game_log_line("[ 2025.10.13 18:20:03 ] (mining) You mined <color=0xff8dc169>57</color> units of <color=0xffffffff>Feldspar Crystals</color>");
+        if (!helper::logs::parse_mining_yield_line(mined, yield) || yield.volumeM3 != 57.0 || yield.resource != "Feldspar Crystals" ||
+            helper::logs::parse_combat_damage_line(mined, event))
+        {
+            throw std::runtime_error("Expected a mining line to parse only as mining");
+        }
+
+        const auto chat = helper::logs::parse_local_chat_line("[ 2025.10.13 18:20:04 ] EVE System > channel  CHANGED to local:  \xEF\xBB\xBF" "A 2560 ");
+        if (!chat || chat->systemName != "A 2560" || helper::logs::parse_local_chat_line("[ 2025.10.13 18:20:05 ] Pilot > Channel changed to Local :  "))
+        {
+            throw std::runtime_error("Local channel changes should match in any case and spacing");
+        }
+    }, failures);
+
     run_case("system resolver finds canonical ids", []() {
         helper::logs::SystemResolver resolver;
         auto id = resolver.resolve("A 2560");
@@ -360,154 +658,1817 @@ int main()
         }
     }, failures);
 
-    run_case("overlay event queue", [&](void) {
-        overlay::OverlayEventWriter writer;
-        if (!writer.ensure())
+    run_case("ipc backend mappings and events", []() {
+        const std::wstring mappingName = L"Local\\EFOverlayIpcBackendTest";
+        overlay::SharedMapping created;
+        if (!created.create(mappingName, 4096) || created.already_existed() || created.size() != 4096)
         {
-            throw std::runtime_error("Failed to initialize event writer");
+            throw std::runtime_error("creating a fresh mapping failed");
         }
+        std::memcpy(created.data(), "ipc", 4);
 
-        overlay::OverlayEvent event;
-        event.type = overlay::OverlayEventType::WaypointAdvanced;
-        event.payload = R"({"test":"value"})";
-        event.timestamp_ms = 987654321ULL;
-        if (!writer.publish(event))
+        overlay::SharedMapping opened;
+        if (!opened.open(mappingName, false) || opened.size() < 4096 || std::memcmp(opened.data(), "ipc", 4) != 0)
         {
-            throw std::runtime_error("Failed to publish event");
+            throw std::runtime_error("opening the mapping should show the creator's bytes");
         }
-
-        overlay::OverlayEventReader reader;
-        auto drained = reader.drain();
-        if (drained.events.empty())
+        overlay::SharedMapping duplicate;
+        if (duplicate.create(mappingName, 4096, true) || !duplicate.already_existed())
         {
-            throw std::runtime_error("No events received from queue");
+            throw std::runtime_error("exclusive create should refuse an existing mapping");
         }
 
-        const auto& received = drained.events.front();
-        if (received.type != overlay::OverlayEventType::WaypointAdvanced)
+        const std::wstring eventName = L"Local\\EFOverlayIpcBackendTestEvent";
+        overlay::SharedEvent signaller;
+        overlay::SharedEvent waiter;
+        if (!signaller.create(eventName) || !waiter.open(eventName))
         {
-            throw std::runtime_error("Event type mismatch");
+            throw std::runtime_error("failed to create or open the event");
         }
-        if (received.payload != event.payload)
+        if (waiter.wait(std::chrono::milliseconds{0}))
         {
-            throw std::runtime_error("Event payload mismatch");
+            throw std::runtime_error("a fresh event should not be signalled");
         }
-    }, failures);
-
-    run_case("star catalog loader", []() {
-        const std::vector<std::string> names{"Alpha", "Beta"};
-        std::vector<std::uint32_t> nameOffsets;
-        std::string stringBlob;
-        nameOffsets.reserve(names.size());
-        for (const auto& name : names)
+        signaller.signal();
+        if (!waiter.wait(std::chrono::milliseconds{1000}) || waiter.wait(std::chrono::milliseconds{10}))
         {
-            nameOffsets.push_back(static_cast<std::uint32_t>(stringBlob.size()));
-            stringBlob.append(name);
+            throw std::runtime_error("the event should release one wait and then reset");
+        }
+        std::thread late([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            signaller.signal();
+        });
+        const bool woke = waiter.wait(std::chrono::milliseconds{5000});
+        late.join();
+        if (!woke)
+        {
+            throw std::runtime_error("a blocked wait should wake on signal");
         }
 
-        std::vector<std::uint8_t> buffer;
-        buffer.reserve(44 + names.size() * 36 + stringBlob.size());
+        // The state channel grows into a new generation and the reader follows it.
+        overlay::SharedMemoryWriter writer(L"Local\\EFOverlayIpcBackendTestState", L"Local\\EFOverlayIpcBackendTestStateUpdated");
+        overlay::SharedMemoryReader reader(L"Local\\EFOverlayIpcBackendTestState", L"Local\\EFOverlayIpcBackendTestStateUpdated");
+        const std::string large(3 * overlay::shared_memory_initial_slot_capacity, 'L');
+        if (!writer.write("small", 1, 1) || !reader.read() || !writer.write(large, 1, 2))
+        {
+            throw std::runtime_error("state channel publishes failed");
+        }
+        const auto grown = reader.read();
+        if (!grown || grown->sequence != 2 || grown->json_payload != large)
+        {
+            throw std::runtime_error("reader should remap to the grown region");
+        }
+    }, failures);
 
-        auto append_bytes = [&buffer](const void* data, std::size_t count) {
-            const auto* ptr = static_cast<const std::uint8_t*>(data);
-            buffer.insert(buffer.end(), ptr, ptr + count);
+    run_case("shared state seqlock stress", []() {
+        // Payload i has a length and fill character derived from i, so any torn copy is detectable.
+        constexpr std::uint64_t publishes = 200000;
+        constexpr std::size_t slotCapacity = 4096;
+        const auto payloadFor = [](std::uint64_t i) {
+            return std::string(1 + (i * 7919) % (slotCapacity - 1), static_cast<char>('a' + i % 26));
         };
 
-        auto append_u16 = [&append_bytes](std::uint16_t value) {
-            append_bytes(&value, sizeof(value));
-        };
+        std::vector<std::uint64_t> storage((overlay::shared_state_region_size(slotCapacity) + 7) / 8, 0);
+        void* region = storage.data();
+        overlay::initialize_shared_state(region, slotCapacity);
+        if (overlay::read_shared_state(region, storage.size() * 8).has_value())
+        {
+            throw std::runtime_error("Fresh region should not yield a snapshot");
+        }
 
-        auto append_u32 = [&append_bytes](std::uint32_t value) {
-            append_bytes(&value, sizeof(value));
+        std::atomic_bool done{false};
+        std::atomic<std::uint64_t> torn{0};
+        std::atomic<std::uint64_t> consistent{0};
+        const auto readLoop = [&]() {
+            std::uint64_t lastSequence = 0;
+            while (!done.load(std::memory_order_acquire))
+            {
+                const auto snapshot = overlay::read_shared_state(region, storage.size() * 8);
+                if (!snapshot)
+                {
+                    continue;
+                }
+                const auto expected = payloadFor(snapshot->updated_at_ms);
+                if (snapshot->sequence != snapshot->updated_at_ms || snapshot->json_payload != expected
+                    || snapshot->version != expected.size() || snapshot->sequence < lastSequence)
+                {
+                    torn.fetch_add(1);
+                }
+                else
+                {
+                    consistent.fetch_add(1);
+                }
+                lastSequence = snapshot->sequence;
+            }
         };
 
-        auto append_f32 = [&append_bytes](float value) {
-            append_bytes(&value, sizeof(value));
-        };
+        std::thread readerA(readLoop);
+        std::thread readerB(readLoop);
+        for (std::uint64_t i = 1; i <= publishes; ++i)
+        {
+            const auto payload = payloadFor(i);
+            if (!overlay::publish_shared_state(region, payload, static_cast<std::uint32_t>(payload.size()), i))
+            {
+                done.store(true);
+                readerA.join();
+                readerB.join();
+                throw std::runtime_error("Publish rejected a payload that fits the slot");
+            }
+        }
+        done.store(true, std::memory_order_release);
+        readerA.join();
+        readerB.join();
 
-        const char magic[8] = {'E','F','S','T','A','R','S','1'};
-        append_bytes(magic, sizeof(magic));
-        append_u16(1);  // version
-        append_u16(36); // record size
-        append_u32(static_cast<std::uint32_t>(names.size()));
+        if (torn.load() != 0)
+        {
+            throw std::runtime_error("Reader observed " + std::to_string(torn.load()) + " torn or out-of-order snapshots");
+        }
+        if (consistent.load() == 0)
+        {
+            throw std::runtime_error("Readers never observed a snapshot");
+        }
 
-        // bbox min/max
-        append_f32(0.0f);
-        append_f32(0.0f);
-        append_f32(-1.0f);
-        append_f32(10.0f);
-        append_f32(20.0f);
-        append_f32(30.0f);
+        const auto last = overlay::read_shared_state(region, storage.size() * 8);
+        if (!last || last->sequence != publishes || last->json_payload != payloadFor(publishes))
+        {
+            throw std::runtime_error("Final snapshot should be the last publish");
+        }
+        if (overlay::publish_shared_state(region, std::string(slotCapacity + 1, 'x'), 1, 1))
+        {
+            throw std::runtime_error("Oversized payload should be rejected");
+        }
+    }, failures);
 
-        append_u32(static_cast<std::uint32_t>(stringBlob.size()));
+    run_case("shared state region growth", []() {
+        // Capacity steps double from the initial slot size and stop at the maximum.
+        if (overlay::shared_state_slot_capacity_for(10) != overlay::shared_memory_initial_slot_capacity ||
+            overlay::shared_state_slot_capacity_for(overlay::shared_memory_initial_slot_capacity + 1) != 2 * overlay::shared_memory_initial_slot_capacity ||
+            overlay::shared_state_slot_capacity_for(5 * 1024 * 1024) != 8 * 1024 * 1024 ||
+            overlay::shared_state_slot_capacity_for(overlay::shared_memory_max_slot_capacity + 1) != 0)
+        {
+            throw std::runtime_error("unexpected slot capacity steps");
+        }
 
-        const std::array<std::uint32_t, 2> systemIds{42u, 43u};
-        const std::array<std::uint32_t, 2> regionIds{7u, 8u};
-        const std::array<std::uint32_t, 2> constellationIds{3u, 4u};
-        const std::array<std::array<float, 3>, 2> positions{{{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}}};
-        const std::array<float, 2> securities{0.7f, 0.2f};
+        constexpr std::size_t smallCapacity = 1024;
+        constexpr std::size_t largeCapacity = 4 * 1024 * 1024;
+        std::vector<std::uint64_t> small(overlay::shared_state_region_size(smallCapacity) / sizeof(std::uint64_t), 0);
+        std::vector<std::uint64_t> large(overlay::shared_state_region_size(largeCapacity) / sizeof(std::uint64_t), 0);
+        std::vector<std::uint64_t> control(sizeof(overlay::SharedStateControl) / sizeof(std::uint64_t), 0);
+        const auto smallSize = small.size() * sizeof(std::uint64_t);
+        const auto largeSize = large.size() * sizeof(std::uint64_t);
 
-        for (std::size_t i = 0; i < names.size(); ++i)
+        if (overlay::shared_state_generation(control.data(), sizeof(overlay::SharedStateControl)) != 0)
         {
-            append_u32(systemIds[i]);
-            append_u32(regionIds[i]);
-            append_u32(constellationIds[i]);
-            append_u32(nameOffsets[i]);
-            append_u16(static_cast<std::uint16_t>(names[i].size()));
-            const std::uint8_t spectral = static_cast<std::uint8_t>(i + 1);
-            append_bytes(&spectral, sizeof(spectral));
-            const std::uint8_t flags = static_cast<std::uint8_t>(i);
-            append_bytes(&flags, sizeof(flags));
-            append_f32(positions[i][0]);
-            append_f32(positions[i][1]);
-            append_f32(positions[i][2]);
-            append_f32(securities[i]);
+            throw std::runtime_error("an empty control block has no generation");
         }
+        overlay::initialize_shared_state(small.data(), smallCapacity, 1);
+        overlay::publish_shared_state_generation(control.data(), 1, smallSize);
+        const std::string keyframe(700, 'k');
+        if (!overlay::publish_shared_state(small.data(), keyframe, 7, 1, true) ||
+            !overlay::publish_shared_state(small.data(), "delta", 7, 2))
+        {
+            throw std::runtime_error("publishes should fit the small region");
+        }
+        overlay::publish_shared_heartbeat(small.data(), 99);
 
-        append_bytes(stringBlob.data(), stringBlob.size());
-
-        auto catalog = overlay::load_star_catalog(buffer);
-        if (catalog.version != 1)
+        const std::string big(3 * 1024 * 1024, 'b');
+        if (overlay::publish_shared_state(small.data(), big, 7, 3))
         {
-            throw std::runtime_error("Unexpected catalog version");
+            throw std::runtime_error("a multi-MB payload cannot fit the small region");
         }
-        if (catalog.record_size != 36)
+
+        overlay::grow_shared_state(small.data(), large.data(), largeCapacity, 2);
+        overlay::publish_shared_state_generation(control.data(), 2, largeSize);
+        if (overlay::shared_state_generation(control.data(), sizeof(overlay::SharedStateControl)) != 2 ||
+            overlay::shared_state_region_generation(large.data(), largeSize) != 2 ||
+            overlay::shared_state_region_generation(small.data(), smallSize) != 1)
         {
-            throw std::runtime_error("Unexpected record size");
+            throw std::runtime_error("generations should be advertised by the control block and each region");
         }
-        if (catalog.records.size() != names.size())
+
+        // A reader that remaps continues at the same sequence, keyframe and heartbeat.
+        const auto carried = overlay::read_shared_state(large.data(), largeSize);
+        std::string keyframeCopy;
+        const auto keyframeSequence = overlay::read_shared_state_keyframe(large.data(), largeSize, keyframeCopy);
+        if (!carried || carried->sequence != 2 || carried->json_payload != "delta" ||
+            !keyframeSequence || *keyframeSequence != 1 || keyframeCopy != keyframe ||
+            overlay::shared_state_heartbeat(large.data(), largeSize) != 99)
         {
-            throw std::runtime_error("Catalog record count mismatch");
+            throw std::runtime_error("growth should carry the published state across");
         }
 
-        const auto* alpha = catalog.find_by_system_id(42u);
-        if (!alpha)
+        if (!overlay::publish_shared_state(large.data(), big, 7, 3))
         {
-            throw std::runtime_error("Expected to find system 42");
+            throw std::runtime_error("the grown region should take a multi-MB payload");
+        }
+        const auto grown = overlay::read_shared_state(large.data(), largeSize);
+        if (!grown || grown->sequence != 3 || grown->json_payload != big)
+        {
+            throw std::runtime_error("multi-MB payload did not round-trip");
         }
 
-        auto alphaName = catalog.name_for(*alpha);
-        if (alphaName != "Alpha")
+        // The retired region is left as it was for readers that have not remapped yet.
+        const auto stale = overlay::read_shared_state(small.data(), smallSize);
+        if (!stale || stale->sequence != 2)
         {
-            throw std::runtime_error("System 42 name mismatch");
+            throw std::runtime_error("the previous generation should stay readable");
         }
+    }, failures);
 
-        if (std::abs(alpha->position.x - 1.0f) > 1e-6f || std::abs(alpha->position.y - 2.0f) > 1e-6f)
+    run_case("event ring laps and wraps", []() {
+        constexpr std::size_t slotCount = 16;
+        constexpr std::size_t arenaCapacity = 4096;
+        struct alignas(64) Line { std::byte bytes[64]; };
+        std::vector<Line> storage(overlay::event_ring_region_size(slotCount, arenaCapacity) / sizeof(Line) + 1);
+        void* region = storage.data();
+        const auto regionSize = storage.size() * sizeof(Line);
+        overlay::initialize_event_ring(region, slotCount, arenaCapacity);
+
+        // A 100-byte record and three 1000-byte ones leave too little of the arena for a fourth: unread
+        // payloads are never overwritten, so it is dropped.
+        const auto payloadFor = [](std::uint64_t i) { return std::string(i == 0 ? 100 : 1000, static_cast<char>('a' + i)); };
+        for (std::uint64_t i = 0; i < 4; ++i)
         {
-            throw std::runtime_error("System 42 position mismatch");
+            if (!overlay::push_event_ring(region, overlay::OverlayEventType::CustomJson, i, payloadFor(i)))
+            {
+                throw std::runtime_error("push into a ring with arena space should succeed");
+            }
+        }
+        if (overlay::push_event_ring(region, overlay::OverlayEventType::CustomJson, 4, payloadFor(4)) ||
+            overlay::event_ring_dropped(region, regionSize) != 1)
+        {
+            throw std::runtime_error("a payload that does not fit the unreleased arena should be dropped");
         }
 
-        if (catalog.find_by_system_id(999u) != nullptr)
+        // Reading the first two releases their space; payload 4 then straddles the end of the arena.
+        for (std::uint64_t i = 0; i < 2; ++i)
         {
-            throw std::runtime_error("Unexpected hit for unknown system");
+            const auto event = overlay::pop_event_ring(region, regionSize);
+            if (!event || event->timestamp_ms != i || event->payload != payloadFor(i))
+            {
+                throw std::runtime_error("expected payloads in order, intact");
+            }
+        }
+        if (!overlay::push_event_ring(region, overlay::OverlayEventType::CustomJson, 4, payloadFor(4)))
+        {
+            throw std::runtime_error("released arena space should be reused");
+        }
+        for (std::uint64_t i : {2, 3, 4})
+        {
+            const auto event = overlay::pop_event_ring(region, regionSize);
+            if (!event || event->timestamp_ms != i || event->payload != payloadFor(i))
+            {
+                throw std::runtime_error("expected wrapped payloads intact");
+            }
+        }
+        if (overlay::pop_event_ring(region, regionSize))
+        {
+            throw std::runtime_error("the ring should be empty");
         }
 
-        if (catalog.name_for(catalog.records.back()) != "Beta")
+        // A full ring rejects new events instead of moving the consumer's cursor.
+        for (std::uint64_t i = 0; i < slotCount; ++i)
         {
-            throw std::runtime_error("System 43 name mismatch");
+            overlay::push_event_ring(region, overlay::OverlayEventType::WaypointAdvanced, i, {});
+        }
+        if (overlay::push_event_ring(region, overlay::OverlayEventType::WaypointAdvanced, slotCount, {}) ||
+            overlay::push_event_ring(region, overlay::OverlayEventType::CustomJson, 0, std::string(overlay::event_ring_max_payload(arenaCapacity) + 1, 'x')))
+        {
+            throw std::runtime_error("full ring and oversized payload should be rejected");
+        }
+        const auto oldest = overlay::pop_event_ring(region, regionSize);
+        if (!oldest || oldest->timestamp_ms != 0 || overlay::event_ring_dropped(region, regionSize) != 3)
+        {
+            throw std::runtime_error("rejected events should leave the oldest in place");
         }
     }, failures);
 
+    run_case("event ring concurrent stress", []() {
+        // Producers and consumers interleave with random yields on a ring small enough to fill its slots and
+        // arena constantly. Producers retry rejected pushes, so every event is delivered intact exactly once,
+        // in per-producer order.
+        constexpr std::size_t slotCount = 16;
+        constexpr std::size_t arenaCapacity = 4096;
+        constexpr std::uint32_t producers = 4;
+        constexpr std::uint32_t consumers = 2;
+        constexpr std::uint32_t eventsPerProducer = 20000;
+        const auto payloadFor = [](std::uint32_t producer, std::uint32_t index) {
+            const auto size = (index * 2654435761u + producer * 97u) % 900u;
+            return std::string(size, static_cast<char>('a' + (producer * 7 + index) % 26));
+        };
+
+        struct alignas(64) Line { std::byte bytes[64]; };
+        std::vector<Line> storage(overlay::event_ring_region_size(slotCount, arenaCapacity) / sizeof(Line) + 1);
+        void* region = storage.data();
+        const auto regionSize = storage.size() * sizeof(Line);
+        overlay::initialize_event_ring(region, slotCount, arenaCapacity);
+
+        std::vector<std::atomic<std::uint8_t>> seen(producers * eventsPerProducer);
+        std::atomic<std::uint32_t> producersDone{0};
+        std::atomic<std::uint64_t> delivered{0};
+        std::atomic<std::uint64_t> rejected{0};
+        std::atomic_bool broken{false};
+        std::string brokenReason;
+        std::mutex brokenMutex;
+        const auto fail = [&](const std::string& reason) {
+            std::lock_guard<std::mutex> guard(brokenMutex);
+            if (!broken.exchange(true))
+            {
+                brokenReason = reason;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (std::uint32_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]() {
+                std::uint64_t rng = 0x9E3779B97F4A7C15ull * (p + 1);
+                for (std::uint32_t i = 0; i < eventsPerProducer; ++i)
+                {
+                    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+                    if (rng % 8 == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    const auto timestamp = (static_cast<std::uint64_t>(p) << 32) | i;
+                    while (!overlay::push_event_ring(region, static_cast<overlay::OverlayEventType>(p + 1), timestamp, payloadFor(p, i)))
+                    {
+                        // Full: each rejection is counted as a drop, so retries are tallied to account for them.
+                        rejected.fetch_add(1);
+                        std::this_thread::yield();
+                    }
+                }
+                producersDone.fetch_add(1);
+            });
+        }
+        for (std::uint32_t c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&, c]() {
+                std::uint64_t rng = 0xD1B54A32D192ED03ull * (c + 1);
+                std::vector<std::int64_t> lastIndex(producers, -1);
+                while (true)
+                {
+                    const bool finished = producersDone.load() == producers;
+                    auto event = overlay::pop_event_ring(region, regionSize);
+                    if (!event)
+                    {
+                        if (finished)
+                        {
+                            break;
+                        }
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+                    if (rng % 16 == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    const auto producer = static_cast<std::uint32_t>(event->timestamp_ms >> 32);
+                    const auto index = static_cast<std::uint32_t>(event->timestamp_ms);
+                    if (producer >= producers || index >= eventsPerProducer || static_cast<std::uint32_t>(event->type) != producer + 1)
+                    {
+                        fail("event header was corrupted");
+                        continue;
+                    }
+                    if (event->payload != payloadFor(producer, index))
+                    {
+                        fail("payload was torn or overwritten");
+                    }
+                    if (static_cast<std::int64_t>(index) <= lastIndex[producer])
+                    {
+                        fail("events from one producer arrived out of order");
+                    }
+                    lastIndex[producer] = index;
+                    if (seen[producer * eventsPerProducer + index].fetch_add(1) != 0)
+                    {
+                        fail("event was delivered twice");
+                    }
+                    delivered.fetch_add(1);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        if (broken.load())
+        {
+            throw std::runtime_error(brokenReason);
+        }
+        if (delivered.load() != producers * eventsPerProducer)
+        {
+            throw std::runtime_error("every event should be delivered");
+        }
+        if (overlay::event_ring_dropped(region, regionSize) != rejected.load())
+        {
+            throw std::runtime_error("only rejected pushes should be counted as dropped");
+        }
+    }, failures);
+
+    run_case("overlay event queue", [&](void) {
+        overlay::OverlayEventWriter writer;
+        if (!writer.ensure())
+        {
+            throw std::runtime_error("Failed to initialize event writer");
+        }
+
+        overlay::OverlayEvent event;
+        event.type = overlay::OverlayEventType::WaypointAdvanced;
+        event.payload = R"({"test":"value"})";
+        event.timestamp_ms = 987654321ULL;
+        if (!writer.publish(event))
+        {
+            throw std::runtime_error("Failed to publish event");
+        }
+
+        overlay::OverlayEventReader reader;
+        auto drained = reader.drain();
+        if (drained.events.empty())
+        {
+            throw std::runtime_error("No events received from queue");
+        }
+
+        const auto& received = drained.events.front();
+        if (received.type != overlay::OverlayEventType::WaypointAdvanced)
+        {
+            throw std::runtime_error("Event type mismatch");
+        }
+        if (received.payload != event.payload)
+        {
+            throw std::runtime_error("Event payload mismatch");
+        }
+    }, failures);
+
+    run_case("star catalog loader", []() {
+        const auto buffer = make_sample_catalog_bytes();
+        auto catalog = overlay::load_star_catalog(buffer);
+        if (catalog.version != 1)
+        {
+            throw std::runtime_error("Unexpected catalog version");
+        }
+        if (catalog.record_size != 36)
+        {
+            throw std::runtime_error("Unexpected record size");
+        }
+        if (catalog.records.size() != 2u)
+        {
+            throw std::runtime_error("Catalog record count mismatch");
+        }
+
+        const auto* alpha = catalog.find_by_system_id(42u);
+        if (!alpha)
+        {
+            throw std::runtime_error("Expected to find system 42");
+        }
+
+        auto alphaName = catalog.name_for(*alpha);
+        if (alphaName != "Alpha")
+        {
+            throw std::runtime_error("System 42 name mismatch");
+        }
+
+        if (std::abs(alpha->position.x - 1.0f) > 1e-6f || std::abs(alpha->position.y - 2.0f) > 1e-6f)
+        {
+            throw std::runtime_error("System 42 position mismatch");
+        }
+
+        if (catalog.find_by_system_id(999u) != nullptr)
+        {
+            throw std::runtime_error("Unexpected hit for unknown system");
+        }
+
+        if (catalog.name_for(catalog.records.back()) != "Beta")
+        {
+            throw std::runtime_error("System 43 name mismatch");
+        }
+    }, failures);
+
+    run_case("star catalog v2 perfect hash indexes", []() {
+        const auto source = overlay::load_star_catalog(make_sample_catalog_bytes());
+        if (source.has_precomputed_indexes())
+        {
+            throw std::runtime_error("v1 catalog should not report precomputed indexes");
+        }
+
+        const auto bytes = overlay::serialize_star_catalog_v2(source);
+        const auto catalog = overlay::load_star_catalog(bytes);
+        if (catalog.version != 2 || !catalog.has_precomputed_indexes())
+        {
+            throw std::runtime_error("Expected an EFSTARS2 catalog with precomputed indexes");
+        }
+        if (catalog.size() != source.size() || catalog.bbox_max.z != source.bbox_max.z)
+        {
+            throw std::runtime_error("v2 catalog header mismatch");
+        }
+
+        const auto* beta = catalog.find_by_system_id(43u);
+        if (!beta || catalog.name_for(*beta) != "Beta" || std::abs(beta->security - 0.2f) > 1e-6f)
+        {
+            throw std::runtime_error("v2 id lookup mismatch");
+        }
+
+        const auto* alpha = catalog.find_by_name("ALPHA");
+        if (!alpha || alpha->system_id != 42u)
+        {
+            throw std::runtime_error("v2 name lookup mismatch");
+        }
+
+        if (catalog.find_by_system_id(44u) != nullptr || catalog.find_by_name("Gamma") != nullptr)
+        {
+            throw std::runtime_error("v2 lookups should reject unknown keys");
+        }
+    }, failures);
+
+    run_case("star spatial index queries", []() {
+        const auto catalog = overlay::load_star_catalog(make_sample_catalog_bytes());
+        const auto& index = catalog.spatial_index();
+        if (index.size() != catalog.size())
+        {
+            throw std::runtime_error("Spatial index size mismatch");
+        }
+
+        const auto nearest = index.nearest(overlay::Vec3f{0.0f, 0.0f, 0.0f});
+        if (!nearest || catalog.records[nearest->record_index].system_id != 42u)
+        {
+            throw std::runtime_error("Expected system 42 to be nearest to the origin");
+        }
+
+        std::vector<overlay::StarNeighbor> within;
+        index.query_radius(overlay::Vec3f{4.0f, 5.0f, 6.0f}, 3.0f, within);
+        if (within.size() != 1 || catalog.records[within.front().record_index].system_id != 43u)
+        {
+            throw std::runtime_error("Radius query should only return system 43");
+        }
+
+        const auto ordered = index.nearest(overlay::Vec3f{4.0f, 5.0f, 6.0f}, 5);
+        if (ordered.size() != 2 || ordered.front().distance_sq != 0.0f || ordered.back().distance_sq < ordered.front().distance_sq)
+        {
+            throw std::runtime_error("k-nearest results should be sorted and capped at catalog size");
+        }
+
+        std::vector<std::uint32_t> boxed;
+        index.query_box(overlay::Vec3f{0.0f, 0.0f, 0.0f}, overlay::Vec3f{2.0f, 3.0f, 4.0f}, boxed);
+        if (boxed.size() != 1 || catalog.records[boxed.front()].system_id != 42u)
+        {
+            throw std::runtime_error("Box query should only return system 42");
+        }
+
+        // Half-space x >= 2.5 keeps only system 43.
+        const std::array<overlay::ClipPlane, 1> planes{overlay::ClipPlane{overlay::Vec3f{1.0f, 0.0f, 0.0f}, -2.5f}};
+        std::vector<std::uint32_t> visible;
+        index.query_frustum(planes, visible);
+        if (visible.size() != 1 || catalog.records[visible.front()].system_id != 43u)
+        {
+            throw std::runtime_error("Frustum query should only return system 43");
+        }
+    }, failures);
+
+    run_case("star spatial index matches brute force", []() {
+        // Enough seeded stars for a tree several levels deep, checked query by query against a linear scan.
+        std::mt19937 rng(20251013u);
+        std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+        std::vector<overlay::StarCatalogRecord> records(400);
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            records[i].system_id = static_cast<std::uint32_t>(30000000u + i);
+            records[i].position = overlay::Vec3f{coordinate(rng), coordinate(rng), coordinate(rng)};
+        }
+        // A duplicate position, so ties and zero distances cross leaf boundaries too.
+        records[399].position = records[7].position;
+
+        const overlay::StarSpatialIndex index(records);
+        if (index.size() != records.size())
+        {
+            throw std::runtime_error("Spatial index size mismatch");
+        }
+
+        const auto distanceSq = [](const overlay::Vec3f& lhs, const overlay::Vec3f& rhs) {
+            const float dx = lhs.x - rhs.x;
+            const float dy = lhs.y - rhs.y;
+            const float dz = lhs.z - rhs.z;
+            return dx * dx + dy * dy + dz * dz;
+        };
+
+        std::vector<float> expected;
+        std::vector<overlay::StarNeighbor> within;
+        for (int query = 0; query < 200; ++query)
+        {
+            // Mix catalog positions with points outside the populated cube.
+            const auto point = query % 4 == 0 ? records[static_cast<std::size_t>(query) % records.size()].position
+                                              : overlay::Vec3f{coordinate(rng) * 1.2f, coordinate(rng) * 1.2f, coordinate(rng) * 1.2f};
+
+            expected.clear();
+            for (const auto& record : records)
+            {
+                expected.push_back(distanceSq(point, record.position));
+            }
+            std::sort(expected.begin(), expected.end());
+
+            const auto nearest = index.nearest(point);
+            if (!nearest || nearest->distance_sq != expected.front() || distanceSq(point, records[nearest->record_index].position) != expected.front())
+            {
+                throw std::runtime_error("Nearest star differs from brute force at query " + std::to_string(query));
+            }
+
+            const auto ordered = index.nearest(point, 12);
+            if (ordered.size() != 12)
+            {
+                throw std::runtime_error("k-nearest should return k stars");
+            }
+            for (std::size_t i = 0; i < ordered.size(); ++i)
+            {
+                if (ordered[i].distance_sq != expected[i] || distanceSq(point, records[ordered[i].record_index].position) != expected[i])
+                {
+                    throw std::runtime_error("k-nearest differs from brute force at query " + std::to_string(query));
+                }
+            }
+
+            const float radius = 10.0f + static_cast<float>(query % 5) * 10.0f;
+            within.clear();
+            index.query_radius(point, radius, within);
+            std::vector<std::uint32_t> found;
+            for (const auto& neighbor : within)
+            {
+                if (neighbor.distance_sq != distanceSq(point, records[neighbor.record_index].position))
+                {
+                    throw std::runtime_error("Radius query reported a wrong distance");
+                }
+                found.push_back(neighbor.record_index);
+            }
+            std::vector<std::uint32_t> scanned;
+            for (std::uint32_t i = 0; i < records.size(); ++i)
+            {
+                if (distanceSq(point, records[i].position) <= radius * radius)
+                {
+                    scanned.push_back(i);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            if (found != scanned)
+            {
+                throw std::runtime_error("Radius query differs from brute force at query " + std::to_string(query) + ": " +
+                                         std::to_string(found.size()) + " vs " + std::to_string(scanned.size()));
+            }
+        }
+    }, failures);
+
+    run_case("star catalog mapped file", []() {
+        const auto buffer = make_sample_catalog_bytes();
+        const auto path = std::filesystem::temp_directory_path() / "ef_overlay_tests_catalog.bin";
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        }
+
+        {
+            auto catalog = overlay::load_star_catalog_from_file(path);
+            if (!catalog.is_mapped())
+            {
+                throw std::runtime_error("Expected catalog file to be mapped in place");
+            }
+            if (catalog.size() != 2)
+            {
+                throw std::runtime_error("Mapped catalog record count mismatch");
+            }
+
+            const auto* beta = catalog.find_by_name("  bETA ");
+            if (!beta || beta->system_id != 43u)
+            {
+                throw std::runtime_error("Name lookup should ignore case and surrounding whitespace");
+            }
+            if (catalog.find_by_name("Gamma") != nullptr)
+            {
+                throw std::runtime_error("Unexpected hit for unknown name");
+            }
+
+            const auto copy = catalog;
+            catalog = overlay::StarCatalog{};
+            const auto* alpha = copy.find_by_system_id(42u);
+            if (!alpha || copy.name_for(*alpha) != "Alpha")
+            {
+                throw std::runtime_error("Copied catalog should keep the mapping alive");
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }, failures);
+
+    run_case("route planner jump range search", []() {
+        // A chain 0 -> 1 -> 2 -> 3 spaced 4 ly apart, plus a shortcut star that
+        // links 0 and 3 with two 6.5 ly jumps, and an isolated star far away.
+        helper::routing::RoutePlanner planner(overlay::load_star_catalog(make_catalog_bytes({
+            SampleStar{100u, "Start", overlay::Vec3f{0.0f, 0.0f, 0.0f}, 0.5f},
+            SampleStar{101u, "Chain One", overlay::Vec3f{4.0f, 0.0f, 0.0f}, 0.5f},
+            SampleStar{102u, "Chain Two", overlay::Vec3f{8.0f, 0.0f, 0.0f}, 0.5f},
+            SampleStar{103u, "Goal", overlay::Vec3f{12.0f, 0.0f, 0.0f}, 0.5f},
+            SampleStar{104u, "Shortcut", overlay::Vec3f{6.0f, 2.5f, 0.0f}, 0.5f},
+            SampleStar{105u, "Island", overlay::Vec3f{100.0f, 0.0f, 0.0f}, 0.5f}
+        })));
+
+        helper::routing::RouteRequest request;
+        request.origin = "start";
+        request.destination = "103";
+        request.maxJumpLy = 7.0;
+        request.metric = helper::routing::RouteMetric::Distance;
+
+        auto shortest = planner.plan(request);
+        if (!shortest.success || shortest.route.size() != 4)
+        {
+            throw std::runtime_error("Distance route should follow the 4 ly chain");
+        }
+        if (shortest.route.front().system_id != "100" || shortest.route.back().display_name != "Goal")
+        {
+            throw std::runtime_error("Route should run from origin to destination");
+        }
+        if (std::fabs(shortest.totalDistanceLy - 12.0) > 1e-4 || shortest.route[1].distance_ly != 4.0 || shortest.route[1].total_route_hops != 3)
+        {
+            throw std::runtime_error("Unexpected route distances");
+        }
+
+        request.metric = helper::routing::RouteMetric::Hops;
+        const auto fewest = planner.plan(request);
+        if (!fewest.success || fewest.route.size() != 3 || fewest.route[1].system_id != "104")
+        {
+            throw std::runtime_error("Hop route should take the shortcut");
+        }
+
+        request.maxJumpLy = 3.0;
+        const auto tooShort = planner.plan(request);
+        if (tooShort.success || tooShort.failure != helper::routing::RouteFailure::Unreachable)
+        {
+            throw std::runtime_error("Route should fail when jumps exceed the range");
+        }
+
+        request.maxJumpLy = 7.0;
+        request.destination = "Island";
+        if (planner.plan(request).failure != helper::routing::RouteFailure::Unreachable)
+        {
+            throw std::runtime_error("Isolated star should be unreachable");
+        }
+
+        request.destination = "Nowhere";
+        if (planner.plan(request).failure != helper::routing::RouteFailure::UnknownSystem)
+        {
+            throw std::runtime_error("Unknown destination should be reported");
+        }
+    }, failures);
+
+    run_case("route planner repairs off-route jumps", []() {
+        std::vector<SampleStar> stars;
+        for (std::uint32_t i = 0; i < 20; ++i)
+        {
+            stars.push_back(SampleStar{200u + i, "Lane " + std::to_string(i), overlay::Vec3f{static_cast<float>(i) * 3.0f, 0.0f, 0.0f}, 0.5f});
+        }
+        stars.push_back(SampleStar{300u, "Detour", overlay::Vec3f{3.0f, 2.5f, 0.0f}, 0.5f});
+        helper::routing::RoutePlanner planner(overlay::load_star_catalog(make_catalog_bytes(stars)));
+
+        helper::routing::RouteRequest request;
+        request.origin = "200";
+        request.destination = "219";
+        request.maxJumpLy = 3.5;
+        const auto initial = planner.plan(request);
+        if (!initial.success || initial.route.size() != 20 || initial.reusedSearch)
+        {
+            throw std::runtime_error("Initial route should walk the lane");
+        }
+
+        // The search ran back from the destination, so a detour near the origin is already settled.
+        const auto repaired = planner.repair(initial.route, "300");
+        if (!repaired.success || !repaired.reusedSearch)
+        {
+            throw std::runtime_error("Repair should resume the previous search");
+        }
+        if (repaired.route.front().system_id != "300" || repaired.route.back().system_id != "219" || repaired.route[1].system_id != "201")
+        {
+            throw std::runtime_error("Repaired route should rejoin the lane");
+        }
+        if (repaired.expandedNodes >= initial.expandedNodes)
+        {
+            throw std::runtime_error("Repair should expand fewer nodes than the initial search");
+        }
+
+        // A route that the planner did not produce falls back to a fresh search using its longest hop.
+        helper::routing::RoutePlanner fresh(overlay::load_star_catalog(make_catalog_bytes(stars)));
+        const auto fallback = fresh.repair(initial.route, "Detour");
+        if (!fallback.success || fallback.reusedSearch || fallback.route.back().system_id != "219")
+        {
+            throw std::runtime_error("Repair of a foreign route should run a fresh search");
+        }
+    }, failures);
+
+    run_case("file change notifier", []() {
+        auto notifier = helper::logs::make_file_change_notifier();
+        if (!notifier)
+        {
+            return;
+        }
+
+        const auto directory = std::filesystem::temp_directory_path() / "ef_overlay_tests_notifier";
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+        std::filesystem::create_directories(directory);
+        if (!notifier->watch({directory}))
+        {
+            throw std::runtime_error("Expected the temp directory to be watchable");
+        }
+
+        std::vector<helper::logs::FileChange> changes;
+        const auto path = directory / "Local_20250101_000000.txt";
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        }
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::app);
+            out << "[ 2025.01.01 00:00:00 ] EVE System > Channel changed to Local : Alpha\n";
+        }
+
+        // Creation and the write may arrive together or in separate batches.
+        bool created = false;
+        bool written = false;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{2};
+        while ((!created || !written) && std::chrono::steady_clock::now() < deadline)
+        {
+            changes.clear();
+            notifier->wait(std::chrono::milliseconds{200}, changes);
+            for (const auto& change : changes)
+            {
+                if (change.fileName.empty())
+                {
+                    created = written = true;
+                }
+                else if (change.fileName == path.filename())
+                {
+                    (change.renamed ? created : written) = true;
+                }
+            }
+        }
+        if (!created || !written)
+        {
+            throw std::runtime_error("Expected creation and write notifications for the log file");
+        }
+
+        // wake() from another thread releases a wait that would otherwise run to its timeout.
+        const auto started = std::chrono::steady_clock::now();
+        std::thread waker([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            notifier->wake();
+        });
+        changes.clear();
+        const bool changed = notifier->wait(std::chrono::seconds{5}, changes);
+        waker.join();
+        if (changed || std::chrono::steady_clock::now() - started > std::chrono::seconds{2})
+        {
+            throw std::runtime_error("wake() should end the wait without reporting changes");
+        }
+
+        // Removing the watched directory ends the watch, so the log watcher falls back to polling.
+        std::filesystem::remove_all(directory, ec);
+        const auto removed = std::chrono::steady_clock::now() + std::chrono::seconds{2};
+        while (notifier->watching() && std::chrono::steady_clock::now() < removed)
+        {
+            changes.clear();
+            notifier->wait(std::chrono::milliseconds{200}, changes);
+        }
+        if (notifier->watching())
+        {
+            throw std::runtime_error("Expected the watch to end with its directory");
+        }
+
+        notifier.reset();
+        std::filesystem::remove_all(directory, ec);
+    }, failures);
+
+    run_case("websocket hub send queues", []() {
+        helper::ws::HelperWebSocketHub::Config config;
+        config.sendQueueLimit = 4;
+        helper::ws::HelperWebSocketHub hub(config);
+        if (!hub.start())
+        {
+            throw std::runtime_error("Expected the hub to listen on a dynamic port");
+        }
+
+        asio::io_context io;
+        const auto handshake = [&](asio::ip::tcp::socket& client, const std::string& target) {
+            client.connect({asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(hub.port())});
+            const auto upgrade = "GET " + target + " HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+            asio::write(client, asio::buffer(upgrade));
+            // Byte by byte: the first frames may arrive in the same segment as the response.
+            std::string reply;
+            while (reply.size() < 4 || reply.compare(reply.size() - 4, 4, "\r\n\r\n") != 0)
+            {
+                char c = 0;
+                asio::read(client, asio::buffer(&c, 1));
+                reply.push_back(c);
+            }
+            return reply;
+        };
+        const auto read_message = [](asio::ip::tcp::socket& socket) {
+            std::array<unsigned char, 2> header{};
+            asio::read(socket, asio::buffer(header));
+            std::uint64_t length = header[1] & 0x7F;
+            if (length >= 126)
+            {
+                std::array<unsigned char, 8> extended{};
+                const std::size_t bytes = length == 126 ? 2 : 8;
+                asio::read(socket, asio::buffer(extended.data(), bytes));
+                length = 0;
+                for (std::size_t i = 0; i < bytes; ++i)
+                {
+                    length = (length << 8) | extended[i];
+                }
+            }
+            std::string payload(static_cast<std::size_t>(length), '\0');
+            asio::read(socket, asio::buffer(payload));
+            return nlohmann::json::parse(payload);
+        };
+
+        // The sample handshake from RFC 6455.
+        asio::ip::tcp::socket socket(io);
+        const auto response = handshake(socket, "/overlay/stream?patches=1");
+        if (response.find("101 Switching Protocols") == std::string::npos || response.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") == std::string::npos)
+        {
+            throw std::runtime_error("Unexpected handshake response: " + response);
+        }
+
+        if (read_message(socket).value("type", "") != "hello")
+        {
+            throw std::runtime_error("Expected hello first");
+        }
+        hub.broadcastOverlayState({{"type", "overlay_state"}, {"state", {{"blob", "start"}}}});
+        auto message = read_message(socket);
+        if (message.value("type", "") != "overlay_state" || message.value("sequence", 0) != 1)
+        {
+            throw std::runtime_error("Expected the first state in full");
+        }
+
+        // The client stops reading while large states are broadcast. The broadcasts must not block, and once
+        // the socket buffers fill the queued states are coalesced.
+        constexpr std::uint64_t broadcasts = 64;
+        const auto started = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < broadcasts; ++i)
+        {
+            hub.broadcastOverlayState({{"type", "overlay_state"}, {"state", {{"blob", std::string(256 * 1024, static_cast<char>('a' + i % 26))}}}});
+            hub.broadcastJson({{"type", "ping"}, {"now_ms", i}});
+        }
+        if (std::chrono::steady_clock::now() - started > std::chrono::seconds{2})
+        {
+            throw std::runtime_error("Broadcasting to a stalled client should not block");
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while (hub.stats().framesCoalesced == 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        if (hub.stats().framesCoalesced == 0 || hub.stats().framesDropped == 0)
+        {
+            throw std::runtime_error("Expected queued states to coalesce and old pings to drop");
+        }
+
+        // Draining, every patch still applies to the last state received and the latest state arrives.
+        std::uint64_t sequence = 1;
+        std::size_t states = 0;
+        while (sequence < broadcasts + 1)
+        {
+            message = read_message(socket);
+            const auto type = message.value("type", "");
+            if (type == "overlay_state_patch" && message.value("base_sequence", std::uint64_t{0}) != sequence)
+            {
+                throw std::runtime_error("Patch base does not match the last state received");
+            }
+            if (type == "overlay_state" || type == "overlay_state_patch")
+            {
+                if (message.value("sequence", std::uint64_t{0}) <= sequence)
+                {
+                    throw std::runtime_error("State sequences must increase");
+                }
+                sequence = message.value("sequence", std::uint64_t{0});
+                ++states;
+            }
+        }
+        if (states >= broadcasts)
+        {
+            throw std::runtime_error("Expected fewer state frames than broadcasts");
+        }
+
+        // A client joining later starts from the last broadcast state, with its sequence.
+        asio::ip::tcp::socket late(io);
+        handshake(late, "/overlay/stream");
+        read_message(late);
+        message = read_message(late);
+        if (message.value("sequence", std::uint64_t{0}) != broadcasts + 1 || message["state"]["blob"].get<std::string>().size() != 256 * 1024)
+        {
+            throw std::runtime_error("Expected a late client to get the latest state");
+        }
+
+        // Stopping with clients still connected closes them and joins the pool promptly.
+        const auto stopping = std::chrono::steady_clock::now();
+        hub.stop();
+        if (std::chrono::steady_clock::now() - stopping > std::chrono::seconds{2} || hub.stats().clients != 0)
+        {
+            throw std::runtime_error("Expected stop() to close the clients and return promptly");
+        }
+    }, failures);
+
+    run_case("websocket hub coalesces pongs", []() {
+        helper::ws::HelperWebSocketHub::Config config;
+        config.sendQueueLimit = 4;
+        helper::ws::HelperWebSocketHub hub(config);
+        if (!hub.start())
+        {
+            throw std::runtime_error("Expected the hub to listen on a dynamic port");
+        }
+
+        asio::io_context io;
+        asio::ip::tcp::socket socket(io);
+        socket.connect({asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(hub.port())});
+        const std::string upgrade = "GET /overlay/stream HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+        asio::write(socket, asio::buffer(upgrade));
+        std::string reply;
+        while (reply.size() < 4 || reply.compare(reply.size() - 4, 4, "\r\n\r\n") != 0)
+        {
+            char c = 0;
+            asio::read(socket, asio::buffer(&c, 1));
+            reply.push_back(c);
+        }
+        const auto read_frame = [&socket](unsigned char& opcode) {
+            std::array<unsigned char, 2> header{};
+            asio::read(socket, asio::buffer(header));
+            opcode = header[0] & 0x0F;
+            std::uint64_t length = header[1] & 0x7F;
+            if (length >= 126)
+            {
+                std::array<unsigned char, 8> extended{};
+                const std::size_t bytes = length == 126 ? 2 : 8;
+                asio::read(socket, asio::buffer(extended.data(), bytes));
+                length = 0;
+                for (std::size_t i = 0; i < bytes; ++i)
+                {
+                    length = (length << 8) | extended[i];
+                }
+            }
+            std::string payload(static_cast<std::size_t>(length), '\0');
+            asio::read(socket, asio::buffer(payload));
+            return payload;
+        };
+
+        // Stall the client's socket with large states, then ping it far more often than the queue limit.
+        for (int i = 0; i < 64; ++i)
+        {
+            hub.broadcastOverlayState({{"type", "overlay_state"}, {"state", {{"blob", std::string(256 * 1024, static_cast<char>('a' + i % 26))}}}});
+        }
+        constexpr int pings = 200;
+        std::string frames;
+        for (int i = 0; i < pings; ++i)
+        {
+            const auto payload = "p" + std::to_string(i);
+            frames.push_back(static_cast<char>(0x89));
+            frames.push_back(static_cast<char>(0x80 | payload.size()));
+            frames.append(4, '\0');   // zero mask key
+            frames += payload;
+        }
+        asio::write(socket, asio::buffer(frames));
+
+        std::size_t pongs = 0;
+        std::string lastPong;
+        const auto last = "p" + std::to_string(pings - 1);
+        while (lastPong != last)
+        {
+            unsigned char opcode = 0;
+            auto payload = read_frame(opcode);
+            if (opcode == 0xA)
+            {
+                ++pongs;
+                lastPong = std::move(payload);
+            }
+        }
+        if (pongs >= static_cast<std::size_t>(pings))
+        {
+            throw std::runtime_error("Expected queued pongs to coalesce, got " + std::to_string(pongs));
+        }
+
+        hub.stop();
+    }, failures);
+
+    run_case("websocket hub compression and binary state", []() {
+        helper::ws::HelperWebSocketHub hub({});
+        if (!hub.start())
+        {
+            throw std::runtime_error("Expected the hub to listen on a dynamic port");
+        }
+
+        asio::io_context io;
+        asio::ip::tcp::socket socket(io);
+        socket.connect({asio::ip::make_address("127.0.0.1"), static_cast<unsigned short>(hub.port())});
+        const std::string request =
+            "GET /overlay/stream?format=binary HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+            "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n"
+            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+        asio::write(socket, asio::buffer(request));
+        std::string response;
+        while (response.size() < 4 || response.compare(response.size() - 4, 4, "\r\n\r\n") != 0)
+        {
+            char c = 0;
+            asio::read(socket, asio::buffer(&c, 1));
+            response.push_back(c);
+        }
+        if (response.find("Sec-WebSocket-Extensions: permessage-deflate\r\n") == std::string::npos)
+        {
+            throw std::runtime_error("Expected permessage-deflate to be accepted: " + response);
+        }
+
+        // Messages are inflated with one stream, the context carrying over as the hub's does.
+        z_stream inflater{};
+        inflateInit2(&inflater, -15);
+        struct Message
+        {
+            int opcode;
+            std::size_t wireBytes;
+            std::string payload;
+        };
+        const auto read_message = [&]() {
+            std::array<unsigned char, 2> header{};
+            asio::read(socket, asio::buffer(header));
+            std::uint64_t length = header[1] & 0x7F;
+            if (length >= 126)
+            {
+                std::array<unsigned char, 8> extended{};
+                const std::size_t bytes = length == 126 ? 2 : 8;
+                asio::read(socket, asio::buffer(extended.data(), bytes));
+                length = 0;
+                for (std::size_t i = 0; i < bytes; ++i)
+                {
+                    length = (length << 8) | extended[i];
+                }
+            }
+            std::string compressed(static_cast<std::size_t>(length), '\0');
+            asio::read(socket, asio::buffer(compressed));
+            if ((header[0] & 0x40) == 0)
+            {
+                throw std::runtime_error("Expected every data frame to be compressed");
+            }
+            compressed.append("\x00\x00\xff\xff", 4);
+            std::string payload(1 << 20, '\0');
+            inflater.next_in = reinterpret_cast<Bytef*>(compressed.data());
+            inflater.avail_in = static_cast<uInt>(compressed.size());
+            inflater.next_out = reinterpret_cast<Bytef*>(payload.data());
+            inflater.avail_out = static_cast<uInt>(payload.size());
+            if (inflate(&inflater, Z_SYNC_FLUSH) != Z_OK)
+            {
+                throw std::runtime_error("Compressed frame did not inflate");
+            }
+            payload.resize(payload.size() - inflater.avail_out);
+            return Message{header[0] & 0x0F, static_cast<std::size_t>(length), std::move(payload)};
+        };
+
+        const auto hello = nlohmann::json::parse(read_message().payload);
+        if (hello.value("compression", "") != "permessage-deflate" || hello.value("state_format", "") != "binary" ||
+            std::find(hello["features"].begin(), hello["features"].end(), "binary_state") == hello["features"].end())
+        {
+            throw std::runtime_error("Expected hello to advertise compression and binary state");
+        }
+
+        auto state = make_sample_state();
+        for (int hop = 0; hop < 40; ++hop)
+        {
+            state.route.push_back(RouteNode{std::to_string(30000100 + hop), "System " + std::to_string(hop), 2.5, hop % 2 == 0});
+        }
+        std::size_t lastWireBytes = 0;
+        for (std::uint64_t sequence = 1; sequence <= 2; ++sequence)
+        {
+            state.heartbeat_ms += 1000;
+            hub.broadcastOverlayState({{"type", "overlay_state"}, {"state", overlay::serialize_overlay_state(state)}});
+            const auto message = read_message();
+            std::uint64_t frameSequence = 0;
+            std::memcpy(&frameSequence, message.payload.data() + 4, sizeof(frameSequence));
+            if (message.opcode != 0x2 || message.payload.compare(0, 4, "EFWS") != 0 || frameSequence != sequence)
+            {
+                throw std::runtime_error("Expected a binary overlay_state frame");
+            }
+            const auto decoded = overlay::decode_overlay_state_binary(std::string_view(message.payload).substr(12));
+            if (decoded.route.size() != state.route.size() || decoded.heartbeat_ms != state.heartbeat_ms)
+            {
+                throw std::runtime_error("Binary state did not round-trip");
+            }
+            lastWireBytes = message.wireBytes;
+        }
+
+        // The second state repeats the first but for its heartbeat, so the deflate context reduces it to tens of bytes.
+        if (lastWireBytes > 128)
+        {
+            throw std::runtime_error("Expected a repeated state to compress to tens of bytes, got " + std::to_string(lastWireBytes));
+        }
+
+        inflateEnd(&inflater);
+        hub.stop();
+    }, failures);
+
+    run_case("server-sent event streams", []() {
+        using Step = helper::streams::GenerationStream::Step;
+        using Clock = std::chrono::steady_clock;
+        constexpr auto shortWait = std::chrono::milliseconds{60};
+        constexpr auto longWait = std::chrono::seconds{5};
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::uint64_t generation = 0;
+        std::uint64_t revision = 0;
+        std::atomic_bool stopping{false};
+        const auto later = [&](auto&& update) {
+            return std::thread([&, update]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds{20});
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    update();
+                }
+                changed.notify_all();
+            });
+        };
+
+        if (helper::streams::make_event("overlay_state", 7, "{}") != "event: overlay_state\nid: 7\ndata: {}\n\n")
+        {
+            throw std::runtime_error("Unexpected event framing");
+        }
+
+        // A state that exists before the first change is sent on connect, without waiting.
+        helper::streams::GenerationStream stream;
+        std::unique_lock<std::mutex> lock(mutex);
+        auto started = Clock::now();
+        if (stream.next(lock, changed, longWait, generation, stopping, true) != Step::Send || stream.sent() != 0 || Clock::now() - started > std::chrono::seconds{1})
+        {
+            throw std::runtime_error("Expected the current state on connect");
+        }
+
+        // Heartbeat ticks wake the stream but leave the generation alone, so only a keepalive follows.
+        lock.unlock();
+        auto writer = later([&]() { ++revision; });
+        lock.lock();
+        started = Clock::now();
+        if (stream.next(lock, changed, shortWait, generation, stopping, true) != Step::Keepalive || Clock::now() - started < shortWait)
+        {
+            throw std::runtime_error("A heartbeat tick should not produce an event");
+        }
+        lock.unlock();
+        writer.join();
+
+        writer = later([&]() { ++generation; });
+        lock.lock();
+        started = Clock::now();
+        if (stream.next(lock, changed, longWait, generation, stopping, true) != Step::Send || stream.sent() != 1 || Clock::now() - started > std::chrono::seconds{1})
+        {
+            throw std::runtime_error("Expected a change event as soon as the generation moved");
+        }
+        lock.unlock();
+        writer.join();
+
+        // Without a state on connect, the stream waits for the first change.
+        helper::streams::GenerationStream empty;
+        lock.lock();
+        if (empty.next(lock, changed, shortWait, generation, stopping, false) != Step::Keepalive)
+        {
+            throw std::runtime_error("Nothing should be sent before the first state");
+        }
+        lock.unlock();
+        writer = later([&]() { ++generation; });
+        lock.lock();
+        if (empty.next(lock, changed, longWait, generation, stopping, true) != Step::Send || empty.sent() != 2)
+        {
+            throw std::runtime_error("Expected the first state once it arrived");
+        }
+        lock.unlock();
+        writer.join();
+
+        // Long polls time out empty-handed, return early when their data arrives and give up on stop.
+        bool arrived = false;
+        lock.lock();
+        started = Clock::now();
+        if (helper::streams::wait_long_poll(lock, changed, shortWait, stopping, [&]() { return arrived; }) || Clock::now() - started < shortWait)
+        {
+            throw std::runtime_error("Expected the long poll to time out");
+        }
+        lock.unlock();
+        writer = later([&]() { arrived = true; });
+        lock.lock();
+        started = Clock::now();
+        if (!helper::streams::wait_long_poll(lock, changed, longWait, stopping, [&]() { return arrived; }) || Clock::now() - started > std::chrono::seconds{1})
+        {
+            throw std::runtime_error("Expected the long poll to return when its data arrived");
+        }
+        lock.unlock();
+        writer.join();
+
+        arrived = false;
+        writer = later([&]() { stopping.store(true); });
+        lock.lock();
+        started = Clock::now();
+        if (helper::streams::wait_long_poll(lock, changed, longWait, stopping, [&]() { return arrived; }) || Clock::now() - started > std::chrono::seconds{1})
+        {
+            throw std::runtime_error("Expected stopping to end the long poll");
+        }
+        if (stream.next(lock, changed, longWait, generation, stopping, true) != Step::Stop)
+        {
+            throw std::runtime_error("Expected stopping to end the stream");
+        }
+        lock.unlock();
+        writer.join();
+    }, failures);
+
+    run_case("log tail reader", []() {
+        const auto path = std::filesystem::temp_directory_path() / "ef_overlay_tests_tail.txt";
+        const auto append = [&](std::string_view bytes, bool truncate = false) {
+            std::ofstream out(path, std::ios::binary | (truncate ? std::ios::trunc : std::ios::app));
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        };
+        const auto utf16 = [](std::u16string_view text) {
+            std::string bytes;
+            for (const auto unit : text)
+            {
+                bytes.push_back(static_cast<char>(unit & 0xFF));
+                bytes.push_back(static_cast<char>(unit >> 8));
+            }
+            return bytes;
+        };
+
+        helper::logs::LogTailReader reader;
+        std::vector<std::string> lines;
+        const auto read = [&]() {
+            lines.clear();
+            if (!reader.readLines([&](std::string_view line) { lines.emplace_back(line); }))
+            {
+                throw std::runtime_error("Tail reader failed to open the log");
+            }
+        };
+
+        // Chat logs: UTF-16LE with a BOM, written in pieces that split a unit, a surrogate pair and a CRLF.
+        const auto chat = std::string("\xFF\xFE") + utf16(u"Channel changed to Local : Alpha\r\nName \U0001F680 here\r\n");
+        const auto split = chat.size() - utf16(u"\xDE80 here\r\n").size() - 1;
+        append(std::string_view(chat).substr(0, split), true);
+        reader.reset(path);
+        if (!reader.hasGrown())
+        {
+            throw std::runtime_error("A new tail should report unread data");
+        }
+        read();
+        if (lines.size() != 1 || lines[0] != "Channel changed to Local : Alpha")
+        {
+            throw std::runtime_error("Expected the first complete UTF-16 line without BOM or terminator");
+        }
+
+        // Completes the high surrogate, which must wait for its pair.
+        append(std::string_view(chat).substr(split, 1));
+        read();
+        if (!lines.empty() || reader.hasGrown())
+        {
+            throw std::runtime_error("An unfinished line should not be emitted");
+        }
+        append(std::string_view(chat).substr(split + 1, chat.size() - split - 3));
+        read();
+        if (lines.size() != 1 || lines[0] != "Name \xF0\x9F\x9A\x80 here")
+        {
+            throw std::runtime_error("Expected the surrogate pair decoded across reads: " + (lines.empty() ? std::string{} : lines[0]));
+        }
+        append(std::string_view(chat).substr(chat.size() - 2));
+        read();
+        if (!lines.empty())
+        {
+            throw std::runtime_error("The LF of a CRLF split across reads should not end another line");
+        }
+
+        append(utf16(u"\nNext\n"));
+        read();
+        if (lines.size() != 2 || !lines[0].empty() || lines[1] != "Next")
+        {
+            throw std::runtime_error("A bare LF after a completed CRLF should be an empty line");
+        }
+
+        // A file that shrinks is read again from the start; UTF-8 logs lose their BOM too.
+        append("\xEF\xBB\xBF[ 2025.01.01 00:00:00 ] (combat) hit\nrest", true);
+        read();
+        if (lines.size() != 1 || lines[0] != "[ 2025.01.01 00:00:00 ] (combat) hit" || reader.offset() != std::filesystem::file_size(path))
+        {
+            throw std::runtime_error("Expected a truncated log to be re-read as UTF-8");
+        }
+        append(" of line\r\n");
+        read();
+        if (lines.size() != 1 || lines[0] != "rest of line")
+        {
+            throw std::runtime_error("Expected the pending partial line to be completed");
+        }
+
+        reader.reset({});
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }, failures);
+
+    run_case("text simd kernels", []() {
+        // Every length around the vector widths, with the stopping unit or line break at every position.
+        std::string input;
+        std::string output;
+        // Levels the CPU lacks are clamped by set_text_simd_level, so they are skipped rather than re-run.
+        for (const auto level : {helper::logs::TextSimdLevel::Scalar, helper::logs::TextSimdLevel::Sse2, helper::logs::TextSimdLevel::Avx2})
+        {
+            if (level > helper::logs::supported_text_simd_level())
+            {
+                continue;
+            }
+            helper::logs::set_text_simd_level(level);
+            const std::string name = helper::logs::text_simd_level_name(level);
+            if (helper::logs::text_simd_level() != level)
+            {
+                throw std::runtime_error(name + ": supported level was not selected");
+            }
+            for (std::size_t units = 0; units <= 80; ++units)
+            {
+                for (std::size_t stop = 0; stop <= units; ++stop)
+                {
+                    input.clear();
+                    for (std::size_t i = 0; i < units; ++i)
+                    {
+                        // 0x00E9 fails on the low byte, 0x0141 on the high byte.
+                        const std::uint16_t unit = i == stop ? (stop % 2 == 0 ? 0x00E9 : 0x0141) : static_cast<std::uint16_t>('a' + i % 26);
+                        input.push_back(static_cast<char>(unit & 0xFF));
+                        input.push_back(static_cast<char>(unit >> 8));
+                    }
+                    output.assign(units, '\0');
+                    const auto converted = helper::logs::ascii_utf16le_to_utf8(input.data(), units, output.data());
+                    if (converted != stop)
+                    {
+                        throw std::runtime_error(name + ": ASCII run stopped at " + std::to_string(converted) + " instead of " + std::to_string(stop));
+                    }
+                    for (std::size_t i = 0; i < converted; ++i)
+                    {
+                        if (output[i] != static_cast<char>('a' + i % 26))
+                        {
+                            throw std::runtime_error(name + ": ASCII run copied the wrong bytes");
+                        }
+                    }
+
+                    std::string text(units, 'x');
+                    if (stop < units)
+                    {
+                        text[stop] = stop % 2 == 0 ? '\n' : '\r';
+                        text.back() = '\n';
+                    }
+                    if (helper::logs::find_line_break(text.data(), text.size()) != stop)
+                    {
+                        throw std::runtime_error(name + ": line break not found at " + std::to_string(stop));
+                    }
+                }
+            }
+        }
+        helper::logs::set_text_simd_level(helper::logs::supported_text_simd_level());
+    }, failures);
+
+    run_case("log backfill", []() {
+        const auto root = std::filesystem::temp_directory_path() / "ef_overlay_tests_backfill";
+        std::error_code ec;
+        std::filesystem::remove_all(root, ec);
+        std::filesystem::create_directories(root / "Chatlogs");
+        std::filesystem::create_directories(root / "Gamelogs");
+        const auto append = [](const std::filesystem::path& path, std::string_view bytes) {
+            std::ofstream out(path, std::ios::binary | std::ios::app);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        };
+        const auto utf16 = [](std::string_view text) {
+            std::string bytes;
+            for (const auto ch : text)
+            {
+                bytes.push_back(ch);
+                bytes.push_back('\0');
+            }
+            return bytes;
+        };
+        const auto jump = [](std::string_view system) {
+            return "[ 2025.10.13 18:00:01 ] EVE System > Channel changed to Local : " + std::string(system) + "\r\n";
+        };
+
+        const auto chat = root / "Chatlogs" / "Local_20251013_180000_2112000001.txt";
+        const auto live = root / "Chatlogs" / "Local_20251014_090000_2112000001.txt";
+        const auto combat = root / "Gamelogs" / "20251013_180000_2112000001.txt";
+        append(chat, "\xFF\xFE" + utf16(jump("A 2560") + jump("M 974") + "[ 2025.10.13 18:02:00 ] Pilot > o7\r\n" + jump("A 2560") + jump("Nowhere 9") +
+                                       "[ 2025.10.13 18:05:00 ] EVE System > Channel changed to Local : U 31"));
+        append(live, "\xFF\xFE" + utf16(jump("M 974")));
+        append(combat, "[ 2025.10.13 18:10:00 ] (combat) <color=0xff00ffff><b>100</b> <color=0x77ffffff><font size=10>to</font> <b><color=0xffffffff>Feral Drone</b><font size=10><color=0x77ffffff> - Light Laser - Hits\r\n"
+                       "[ 2025.10.13 18:20:00 ] (combat) <color=0xffcc0000><b>40</b> <color=0x77ffffff><font size=10>from</font> <b><color=0xffffffff>Pirate Frigate</b><font size=10><color=0x77ffffff> - Glances Off\r\n"
+                       "[ 2025.10.13 18:30:00 ] (notify) Your cargo hold is 50% full.\r\n"
+                       "[ 2025.10.13 19:05:00 ] (mining) You mined <color=0xff8dc169>250</color> units of <color=0xffffffff><font size=12>Veldspar</font></color> worth 12.5 m3.\r\n");
+
+        helper::logs::SystemResolver resolver;
+        helper::telemetry::TelemetryStore store({root / "telemetry"});
+        helper::logs::LogBackfill::Config config;
+        config.telemetryStore = &store;
+        config.chatDirectory = root / "Chatlogs";
+        config.combatDirectory = root / "Gamelogs";
+        config.followedFiles = {{live, 0, true}};
+        config.indexPath = root / "index.json";
+        config.threads = 2;
+
+        {
+            helper::logs::LogBackfill backfill(config, resolver);
+            const auto result = backfill.run();
+            if (result.filesScanned != 2 || result.filesParsed != 2 || result.visits.size() != 2 || result.visits.at("30000001").visits != 2 ||
+                result.visits.at("30000002").visits != 1)
+            {
+                throw std::runtime_error("Expected visits from the historical chat log only, without unmapped systems");
+            }
+            const auto hour = [](int h) {
+                return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    (std::chrono::sys_days{std::chrono::year{2025} / 10 / 13} + std::chrono::hours{h}).time_since_epoch()).count());
+            };
+            const auto points = store.query(hour(0), hour(24), 60 * 60 * 1000);
+            if (points.size() != 2 || points[0].startMs != hour(18) || points[0].dealt != 100.0 || points[0].taken != 40.0 || points[0].combatEvents != 2 ||
+                points[1].startMs != hour(19) || points[1].miningM3 != 12.5)
+            {
+                throw std::runtime_error("Expected the combat log's events in the telemetry store");
+            }
+            const auto& checkpoint = backfill.checkpoints().begin()->second;
+            if (backfill.checkpoints().size() != 2 || checkpoint.systemEntries != 4 || checkpoint.offset >= std::filesystem::file_size(chat))
+            {
+                throw std::runtime_error("Expected the chat checkpoint to stop before the unfinished line");
+            }
+        }
+
+        // A fresh instance resumes from the saved index: nothing to do, then only the completed line.
+        helper::logs::LogBackfill backfill(config, resolver);
+        if (backfill.run().filesParsed != 0)
+        {
+            throw std::runtime_error("Unchanged logs should not be parsed again");
+        }
+        append(chat, utf16("83\r\n"));
+        const auto result = backfill.run();
+        if (result.filesParsed != 1 || result.visits.size() != 1 || result.visits.count("30000003") != 1 || result.bytesParsed == 0 ||
+            backfill.checkpoints().begin()->second.systemEntries != 5)
+        {
+            throw std::runtime_error("Expected only the completed line of the grown log");
+        }
+
+        // The watcher read the live log to its end and then rotated away; only what came after is new.
+        const auto watched = std::filesystem::file_size(live);
+        append(live, utf16(jump("A 2560")));
+        config.followedFiles = {{live, watched, false}};
+        helper::logs::LogBackfill rotated(config, resolver);
+        const auto rotatedResult = rotated.run();
+        if (rotatedResult.filesParsed != 1 || rotatedResult.visits.size() != 1 || rotatedResult.visits.count("30000001") != 1 ||
+            rotatedResult.visits.at("30000001").visits != 1 || rotated.run().filesParsed != 0)
+        {
+            throw std::runtime_error("Expected a rotated log to be read only past the watcher's offset");
+        }
+
+        std::filesystem::remove_all(root, ec);
+    }, failures);
+
+    run_case("string interner", []() {
+        const helper::InternedString veldspar("Veldspar");
+        const auto view = veldspar.view();
+        if (helper::InternedString("Veldspar") != veldspar || veldspar == helper::InternedString("Feldspar") || veldspar != "Veldspar" ||
+            !helper::InternedString("").empty() || helper::InternedString().view() != "")
+        {
+            throw std::runtime_error("Expected one id per distinct string and 0 for the empty string");
+        }
+
+        // Threads interning the same names concurrently agree on the ids, and earlier views stay valid.
+        std::vector<std::vector<std::uint32_t>> ids(4);
+        std::vector<std::thread> threads;
+        for (auto& out : ids)
+        {
+            threads.emplace_back([&out]() {
+                for (int i = 0; i < 2000; ++i)
+                {
+                    out.push_back(helper::InternedString("interner test " + std::to_string(i)).id());
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        for (const auto& out : ids)
+        {
+            if (out != ids.front())
+            {
+                throw std::runtime_error("Expected concurrent interning to agree on ids");
+            }
+        }
+        if (view.data() != veldspar.view().data() || view != "Veldspar")
+        {
+            throw std::runtime_error("Expected interned views to stay valid as the table grows");
+        }
+    }, failures);
+
+    run_case("telemetry windows", []() {
+        using namespace std::chrono_literals;
+        const std::chrono::system_clock::time_point t0{std::chrono::milliseconds{1'760'000'000'000}};
+
+        helper::logs::WindowedSums<2> window{30s};
+        window.add(t0, {100.0, 0.0});
+        window.add(t0 + 10s, {0.0, 40.0}, 2);
+        window.add(t0 + 20s, {0.1, 0.0}, 2);
+        if (window.totals()[0] != 100.1 || window.totals()[1] != 40.0 || window.forKey(2)[1] != 40.0 || window.forKey(1)[0] != 0.0 || window.forKey(7)[0] != 0.0)
+        {
+            throw std::runtime_error("Expected running totals per column and per key");
+        }
+        window.advance(t0 + 35s);
+        if (window.size() != 2 || std::abs(window.totals()[0] - 0.1) > 1e-9 || window.forKey(0)[0] != 0.0)
+        {
+            throw std::runtime_error("Expected the first event to age out of the window");
+        }
+        window.advance(t0 + 60s);
+        if (!window.empty() || window.totals()[0] != 0.0 || window.forKey(2)[0] != 0.0)
+        {
+            throw std::runtime_error("Expected an empty window to sum to exactly zero");
+        }
+
+        struct Sample
+        {
+            std::uint64_t timestampMs{0};
+            double volumeM3{0.0};
+        };
+        helper::logs::SparklineRing<Sample, 4> ring;
+        const auto sample = [](std::uint64_t ms, double volume) {
+            return Sample{ms, volume};
+        };
+        ring.record(sample(10'000, 1.0));
+        ring.record(sample(10'900, 2.0));
+        ring.record(sample(12'100, 3.0));
+        auto samples = ring.samples();
+        if (samples.size() != 2 || samples[0].volumeM3 != 2.0 || samples[1].volumeM3 != 3.0)
+        {
+            throw std::runtime_error("Expected the latest sample of each second, oldest first");
+        }
+        ring.record(sample(14'000, 4.0));
+        ring.record(sample(10'500, 9.0));
+        samples = ring.samples();
+        if (samples.size() != 2 || samples[0].timestampMs != 12'100 || samples[1].volumeM3 != 4.0)
+        {
+            throw std::runtime_error("Expected samples past the retention to be dropped");
+        }
+        ring.clear();
+        if (!ring.samples().empty())
+        {
+            throw std::runtime_error("Expected a cleared ring to be empty");
+        }
+    }, failures);
+
+    run_case("telemetry store", []() {
+        using helper::telemetry::TelemetryRecord;
+        using helper::telemetry::TelemetryStore;
+        const auto root = std::filesystem::temp_directory_path() / "ef_overlay_tests_telemetry";
+        std::error_code ec;
+        std::filesystem::remove_all(root, ec);
+        const auto day0 = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::sys_days{std::chrono::year{2025} / 10 / 13}.time_since_epoch()).count());
+        const auto day1 = day0 + 24ull * 60 * 60 * 1000;
+        const auto all = std::numeric_limits<std::uint64_t>::max();
+        const TelemetryStore::Config config{root, 3, std::chrono::seconds{3600}};
+
+        const auto replay = [&](TelemetryStore& store) {
+            const auto veldspar = store.resourceId("Veldspar");
+            return std::vector<bool>{
+                store.append("combat.txt", TelemetryRecord::combat(day0 + 10'000, true, 100.0, 2)),
+                store.append("combat.txt", TelemetryRecord::combat(day0 + 10'000, false, 40.0, 1)),
+                store.append("combat.txt", TelemetryRecord::mining(day0 + 20'000, 12.5, veldspar)),
+                store.append("combat.txt", TelemetryRecord::combat(day1 + 5'000, true, 7.0, 3))
+            };
+        };
+
+        {
+            TelemetryStore store(config);
+            if (replay(store) != std::vector<bool>{true, true, true, true})
+            {
+                throw std::runtime_error("Expected every first-time event to be stored");
+            }
+            const auto daily = store.query(0, all, 24ull * 60 * 60 * 1000);
+            if (daily.size() != 2 || daily[0].startMs != day0 || daily[0].dealt != 100.0 || daily[0].taken != 40.0 || daily[0].miningM3 != 12.5 ||
+                daily[0].combatEvents != 2 || daily[0].miningEvents != 1 || daily[1].dealt != 7.0)
+            {
+                throw std::runtime_error("Expected one point per day, including unflushed rows");
+            }
+        }
+        if (!std::filesystem::exists(root / "20251013.eftc") || !std::filesystem::exists(root / "20251014.eftc"))
+        {
+            throw std::runtime_error("Expected one partition per UTC day");
+        }
+
+        {
+            // Reading the same log again from the start adds nothing; the next event at the newest timestamp does.
+            TelemetryStore store(config);
+            if (replay(store) != std::vector<bool>{false, false, false, false} ||
+                !store.append("combat.txt", TelemetryRecord::combat(day1 + 5'000, true, 3.0, 2)))
+            {
+                throw std::runtime_error("Expected replayed events to be dropped after reopening");
+            }
+
+            const auto fine = store.query(day0, day1, 10'000);
+            if (fine.size() != 2 || fine[0].startMs != day0 + 10'000 || fine[0].combatEvents != 2 || fine[1].miningM3 != 12.5)
+            {
+                throw std::runtime_error("Expected 10 s buckets within the first day only");
+            }
+
+            std::vector<TelemetryRecord> rows;
+            store.scan(day0 + 15'000, all, [&](const TelemetryRecord& row) { rows.push_back(row); });
+            if (rows.size() != 3 || rows[0].quality != TelemetryRecord::no_quality || store.resourceName(rows[0].resourceId) != "Veldspar" ||
+                rows[1].quality != 3 || rows[2].dealt != 3.0)
+            {
+                throw std::runtime_error("Expected scanned rows to decode every column");
+            }
+        }
+
+        {
+            // A chunk torn by a crash is ignored by readers and cut off before the next append.
+            std::ofstream(root / "20251014.eftc", std::ios::binary | std::ios::app) << "EFTC\x01\x00garbage";
+            TelemetryStore store(config);
+            store.append("other.txt", TelemetryRecord::combat(day1 + 6'000, false, 5.0, 2));
+            store.flush();
+            const auto daily = store.query(day1, all, 24ull * 60 * 60 * 1000);
+            if (daily.size() != 1 || daily[0].dealt != 10.0 || daily[0].taken != 5.0 || daily[0].combatEvents != 3)
+            {
+                throw std::runtime_error("Expected the damaged tail to be replaced by the new chunk");
+            }
+
+            // Scans read the files without the lock: appending from the callback neither blocks nor shows up
+            // in the scan, even when it writes a chunk to the partition being read.
+            std::size_t seen = 0;
+            const auto revision = store.revision();
+            store.scan(day1, all, [&](const TelemetryRecord&) {
+                if (seen++ == 0)
+                {
+                    for (std::uint64_t i = 0; i < 3; ++i)
+                    {
+                        store.append("other.txt", TelemetryRecord::combat(day1 + 7'000 + i, true, 1.0, 2));
+                    }
+                }
+            });
+            if (seen != 3 || store.revision() != revision + 3 || store.query(day1, all, 24ull * 60 * 60 * 1000).front().combatEvents != 6)
+            {
+                throw std::runtime_error("Expected a scan to see only the rows stored when it started");
+            }
+        }
+
+        {
+            // A steady second-by-second stream compresses well below its 37 raw bytes per row.
+            std::filesystem::remove_all(root, ec);
+            TelemetryStore store({root, 4096, std::chrono::seconds{3600}});
+            for (std::uint64_t i = 0; i < 10'000; ++i)
+            {
+                store.append("combat.txt", TelemetryRecord::combat(day0 + i * 1000, true, 125.0, 2));
+            }
+            store.flush();
+            const auto bytes = std::filesystem::file_size(root / "20251013.eftc");
+            const auto hourly = store.query(day0, day1, 60ull * 60 * 1000);
+            if (bytes > 10'000 * 8 || hourly.size() != 3 || hourly[0].dealt != 3600 * 125.0 || hourly[2].combatEvents != 10'000 - 7200)
+            {
+                throw std::runtime_error("Expected compact chunks and hourly sums, got " + std::to_string(bytes) + " bytes");
+            }
+        }
+
+        std::filesystem::remove_all(root, ec);
+    }, failures);
+
+    run_case("session tracker revision", []() {
+        const auto root = std::filesystem::temp_directory_path() / "ef_overlay_tests_sessions";
+        std::error_code ec;
+        std::filesystem::remove_all(root, ec);
+
+        {
+            helper::SessionTracker tracker(root);
+            const auto initial = tracker.revision();
+            tracker.recordSystemVisitAllTime("30000001", "A 2560");
+            tracker.getAllTimeData();
+            tracker.getActiveSessionData();
+            if (tracker.revision() != initial)
+            {
+                throw std::runtime_error("Expected reads and ignored visits to leave the revision alone");
+            }
+
+            // Each change moves the revision, so a response rendered before it is never reused after it.
+            auto last = initial;
+            const auto expect_moved = [&tracker, &last](const char* change) {
+                if (tracker.revision() == last)
+                {
+                    throw std::runtime_error(std::string("Expected the revision to move on ") + change);
+                }
+                last = tracker.revision();
+            };
+            tracker.setAllTimeTrackingEnabled(true);
+            expect_moved("enabling tracking");
+            tracker.recordSystemVisitAllTime("30000001", "A 2560");
+            expect_moved("an all-time visit");
+            tracker.startSession();
+            expect_moved("starting a session");
+            tracker.recordSystemVisitSession("30000001", "A 2560");
+            expect_moved("a session visit");
+            tracker.stopSession();
+            expect_moved("stopping the session");
+        }
+
+        std::filesystem::remove_all(root, ec);
+    }, failures);
+
     if (failures == 0)
     {
         std::cout << "All overlay tests passed." << std::endl;